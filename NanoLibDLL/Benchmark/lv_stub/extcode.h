@@ -0,0 +1,60 @@
+#pragma once
+
+/*
+The part of the LabVIEW cintools extcode.h used by lv_marshal.
+The memory manager behind it is memory_manager.cpp, which counts its calls
+instead of going into LabVIEW, see memory_manager.h.
+*/
+
+#include <cstddef>
+
+#include "fundtypes.h"
+
+typedef int32 MgErr;
+
+enum {
+	mgNoErr = 0,
+	mFullErr = 2,
+	mZoneErr = 3
+};
+
+//type codes of NumericArrayResize
+enum {
+	iB = 1,
+	iW,
+	iL,
+	iQ,
+	uB = 5,
+	uW,
+	uL,
+	uQ,
+	fS = 9,
+	fD,
+	fX
+};
+
+typedef uChar* UPtr;
+typedef uChar** UHandle;
+
+typedef struct {
+	int32 cnt;
+	uChar str[1];
+} LStr, *LStrPtr, **LStrHandle;
+
+#define LStrBuf(sp) (&((sp))->str[0])
+#define LStrLen(sp) (((sp))->cnt)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+UHandle DSNewHandle(size_t size);
+MgErr DSSetHandleSize(void* h, size_t size);
+int32 DSGetHandleSize(const void* h);
+MgErr DSDisposeHandle(void* h);
+MgErr NumericArrayResize(int32 typeCode, int32 numDims, UHandle* h, size_t totalNewSize);
+void MoveBlock(const void* src, void* dest, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
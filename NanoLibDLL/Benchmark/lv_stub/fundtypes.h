@@ -0,0 +1,18 @@
+#pragma once
+
+//the part of the LabVIEW cintools fundtypes.h used by lv_marshal, so the benchmark builds without LabVIEW
+
+#include <cstdint>
+
+typedef int8_t int8;
+typedef uint8_t uInt8;
+typedef int16_t int16;
+typedef uint16_t uInt16;
+typedef int32_t int32;
+typedef uint32_t uInt32;
+typedef int64_t int64;
+typedef uint64_t uInt64;
+typedef unsigned char uChar;
+typedef double float64;
+
+typedef uInt8 LVBoolean;
@@ -0,0 +1,3 @@
+#if defined(_WIN32) && !defined(_WIN64)
+#pragma pack(pop)
+#endif
@@ -0,0 +1,4 @@
+//LabVIEW packs the structures it passes to a DLL to 1 byte on 32 bit Windows, like the cintools lv_prolog.h
+#if defined(_WIN32) && !defined(_WIN64)
+#pragma pack(push, 1)
+#endif
@@ -0,0 +1,128 @@
+#include "extcode.h"
+#include "memory_manager.h"
+#include "platdefines.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+//every block starts with its size, aligned so the data keeps the alignment of malloc
+static constexpr size_t kHeader = 16;
+
+static MemoryManagerStats stats;
+//LabVIEW serializes its memory manager, every call below but DSGetHandleSize and MoveBlock locks
+static std::mutex mutex;
+
+static size_t& BlockSize(UPtr data) {
+	return *reinterpret_cast<size_t*>(data - kHeader);
+}
+
+static UHandle NewBlock(size_t size) {
+	stats.allocations++;
+	uChar* block = static_cast<uChar*>(std::malloc(kHeader + size));
+	if (block == nullptr)
+		return nullptr;
+	UHandle h = static_cast<UHandle>(std::malloc(sizeof(UPtr)));
+	*h = block + kHeader;
+	BlockSize(*h) = size;
+	std::memset(*h, 0, size);
+	return h;
+}
+
+static MgErr ResizeBlock(UHandle h, size_t size) {
+	const size_t old = BlockSize(*h);
+	if (size == old)
+		return mgNoErr;
+	stats.allocations++;
+	uChar* block = static_cast<uChar*>(std::realloc(*h - kHeader, kHeader + size));
+	if (block == nullptr)
+		return mFullErr;
+	*h = block + kHeader;
+	BlockSize(*h) = size;
+	if (size > old)
+		std::memset(*h + old, 0, size - old);
+	return mgNoErr;
+}
+
+static size_t ElementSize(int32 typeCode) {
+	switch (typeCode) {
+	case iB:
+	case uB:
+		return 1;
+	case iW:
+	case uW:
+		return 2;
+	case iL:
+	case uL:
+	case fS:
+		return 4;
+	case fX:
+		return 16;
+	default:
+		return 8;
+	}
+}
+
+extern "C" {
+
+	UHandle DSNewHandle(size_t size) {
+		std::lock_guard<std::mutex> lock(mutex);
+		stats.calls++;
+		return NewBlock(size);
+	}
+
+	MgErr DSSetHandleSize(void* h, size_t size) {
+		std::lock_guard<std::mutex> lock(mutex);
+		stats.calls++;
+		if (h == nullptr)
+			return mZoneErr;
+		return ResizeBlock(static_cast<UHandle>(h), size);
+	}
+
+	int32 DSGetHandleSize(const void* h) {
+		if (h == nullptr)
+			return 0;
+		return static_cast<int32>(BlockSize(*static_cast<const UPtr*>(h)));
+	}
+
+	MgErr DSDisposeHandle(void* h) {
+		std::lock_guard<std::mutex> lock(mutex);
+		stats.calls++;
+		if (h == nullptr)
+			return mZoneErr;
+		UHandle handle = static_cast<UHandle>(h);
+		std::free(*handle - kHeader);
+		std::free(handle);
+		return mgNoErr;
+	}
+
+	MgErr NumericArrayResize(int32 typeCode, int32 numDims, UHandle* h, size_t totalNewSize) {
+		std::lock_guard<std::mutex> lock(mutex);
+		stats.calls++;
+		const size_t element = ElementSize(typeCode);
+		//dimension sizes first, 8 byte elements start 8 byte aligned on 64 bit
+		size_t header = numDims * sizeof(int32);
+		if (IsOpSystem64Bit && element >= 8)
+			header = (header + 7) / 8 * 8;
+		const size_t size = header + totalNewSize * element;
+		if (*h == nullptr) {
+			*h = NewBlock(size);
+			return *h != nullptr ? mgNoErr : mFullErr;
+		}
+		return ResizeBlock(*h, size);
+	}
+
+	void MoveBlock(const void* src, void* dest, size_t size) {
+		std::memmove(dest, src, size);
+	}
+}
+
+MemoryManagerStats GetMemoryManagerStats() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
+
+void ResetMemoryManagerStats() {
+	std::lock_guard<std::mutex> lock(mutex);
+	stats = MemoryManagerStats();
+}
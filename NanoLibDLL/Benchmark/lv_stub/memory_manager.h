@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+//calls into the stubbed LabVIEW memory manager, each of them takes the memory manager lock in LabVIEW
+struct MemoryManagerStats {
+	//DSNewHandle, DSSetHandleSize, DSDisposeHandle and NumericArrayResize
+	uint64_t calls = 0;
+	//blocks allocated or moved to another size
+	uint64_t allocations = 0;
+};
+
+MemoryManagerStats GetMemoryManagerStats();
+void ResetMemoryManagerStats();
@@ -0,0 +1,9 @@
+#pragma once
+
+//the part of the LabVIEW cintools platdefines.h used by lv_marshal
+
+#if defined(_WIN64) || defined(__x86_64__) || defined(__aarch64__)
+#define IsOpSystem64Bit 1
+#else
+#define IsOpSystem64Bit 0
+#endif
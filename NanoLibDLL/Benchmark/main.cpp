@@ -0,0 +1,181 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "lv_marshal.h"
+#include "memory_manager.h"
+
+/*
+Marshaling into LabVIEW handles, the copy helpers of lv_marshal against the way nanolibwrapper copied before.
+Every case calls the same export shape in a loop with one handle, the way a VI polls in a while loop,
+and reports the time per call and the calls into the LabVIEW memory manager (stubbed in lv_stub) per call.
+*/
+
+//nanolibwrapper before lv_marshal: every call resizes, numeric arrays are copied element by element
+namespace Baseline {
+
+	int32_t StdStrToLVStr(const std::string& s, LStrHandle* str) {
+		int32_t err = NumericArrayResize(uB, 1, (UHandle*)str, s.length());
+		if (!err) {
+			MoveBlock(s.c_str(), LStrBuf(**str), s.length());
+			LStrLen(**str) = static_cast<int32_t>(s.length());
+			return EXIT_SUCCESS;
+		}
+		return err;
+	}
+
+	int32_t VecStrToLVStrArr(const std::vector<std::string>& s, LStrArrayHdl* arr) {
+		int32_t err = 0;
+		for (int i = static_cast<int>(s.size()); i < (**arr)->dimSize; i++) {
+			LStrHandle* elt = &((**arr)->elt[i]);
+			if (*elt) {
+				err = DSDisposeHandle(*elt);
+				*elt = NULL;
+			}
+		}
+		err = NumericArrayResize(uPtr, 1, (UHandle*)arr, s.size());
+		for (size_t i = 0; !err && i < s.size(); i++)
+			err = StdStrToLVStr(s[i], &((**arr)->elt[i]));
+		if (err)
+			return err;
+		(**arr)->dimSize = static_cast<int32_t>(s.size());
+		return err;
+	}
+
+	template <class Array, class T>
+	int32_t VecToLVArr(const std::vector<T>& s, Array*** arr) {
+		MgErr err = DSSetHandleSize(*arr, offsetof(Array, elt) + s.size() * sizeof(T));
+		if (err != mFullErr && err != mZoneErr) {
+			(**arr)->dimSize = static_cast<int32_t>(s.size());
+			for (size_t i = 0; i < s.size(); i++)
+				(**arr)->elt[i] = s.at(i);
+			return EXIT_SUCCESS;
+		}
+		return err;
+	}
+}
+
+struct Result {
+	double nsPerCall;
+	double managerCallsPerCall;
+	double allocationsPerCall;
+};
+
+static Result Measure(int calls, const std::function<void(int)>& call) {
+	//the first calls size the handle, as the first iterations of a VI loop do
+	for (int i = 0; i < calls / 10 + 2; i++)
+		call(i);
+	ResetMemoryManagerStats();
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 1; i <= calls; i++)
+		call(i);
+	const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	const MemoryManagerStats stats = GetMemoryManagerStats();
+	return { ns / calls, static_cast<double>(stats.calls) / calls, static_cast<double>(stats.allocations) / calls };
+}
+
+static void Report(const char* name, const Result& baseline, const Result& reused) {
+	std::printf("%-34s %10.1f ns %8.2f mm calls %8.2f allocs | %10.1f ns %8.2f mm calls %8.2f allocs | %5.1fx\n", name,
+		baseline.nsPerCall, baseline.managerCallsPerCall, baseline.allocationsPerCall,
+		reused.nsPerCall, reused.managerCallsPerCall, reused.allocationsPerCall,
+		reused.nsPerCall > 0.0 ? baseline.nsPerCall / reused.nsPerCall : 0.0);
+}
+
+//empty handle as LabVIEW passes it for an unwired array
+template <class Array>
+static Array** EmptyArray() {
+	Array** arr = nullptr;
+	NumericArrayResize(NanoLibWrapper::LVTypeCode<NanoLibWrapper::LVElement<Array>>::value, 1, reinterpret_cast<UHandle*>(&arr), 0);
+	(*arr)->dimSize = 0;
+	return arr;
+}
+
+static void DisposeStrArray(LStrArrayHdl arr) {
+	for (int32_t i = 0; i < (*arr)->dimSize; i++) {
+		if ((*arr)->elt[i])
+			DSDisposeHandle((*arr)->elt[i]);
+	}
+	DSDisposeHandle(arr);
+}
+
+static bool SameStrings(LStrArrayHdl a, LStrArrayHdl b) {
+	if ((*a)->dimSize != (*b)->dimSize)
+		return false;
+	for (int32_t i = 0; i < (*a)->dimSize; i++) {
+		LStrHandle x = (*a)->elt[i];
+		LStrHandle y = (*b)->elt[i];
+		if (LStrLen(*x) != LStrLen(*y) || std::memcmp(LStrBuf(*x), LStrBuf(*y), LStrLen(*x)) != 0)
+			return false;
+	}
+	return true;
+}
+
+template <class Array>
+static bool SameArrays(Array** a, Array** b) {
+	return (*a)->dimSize == (*b)->dimSize && std::memcmp((*a)->elt, (*b)->elt, (*a)->dimSize * sizeof(NanoLibWrapper::LVElement<Array>)) == 0;
+}
+
+//strings of the same length every call, like the port list or the error stack polled by a VI
+static bool BenchStrings(int calls, size_t count) {
+	std::vector<std::string> strings;
+	for (size_t i = 0; i < count; i++)
+		strings.push_back(std::to_string(i) + ". USB Bus protocol: MSC, node " + std::to_string(i + 1));
+
+	LStrArrayHdl baseline = EmptyArray<LStrArrayRec>();
+	LStrArrayHdl reused = EmptyArray<LStrArrayRec>();
+	const Result baselineResult = Measure(calls, [&](int) { Baseline::VecStrToLVStrArr(strings, &baseline); });
+	const Result reusedResult = Measure(calls, [&](int) { NanoLibWrapper::VecStrToLVStrArr(strings, &reused); });
+	char name[64];
+	std::snprintf(name, sizeof(name), "string array, %zu strings", count);
+	Report(name, baselineResult, reusedResult);
+
+	const bool same = SameStrings(baseline, reused);
+	DisposeStrArray(baseline);
+	DisposeStrArray(reused);
+	return same;
+}
+
+//rows of a telemetry drain, the count changes from call to call
+template <class Array, class T>
+static bool BenchNumbers(const char* type, int calls, size_t count, int32_t (*copy)(const std::vector<T>&, Array***)) {
+	std::vector<T> full(count);
+	for (size_t i = 0; i < count; i++)
+		full[i] = static_cast<T>(i * 3 + 1);
+	//every other drain finds fewer rows
+	std::vector<T> partial(full.begin(), full.begin() + count * 3 / 4);
+
+	Array** baseline = EmptyArray<Array>();
+	Array** reused = EmptyArray<Array>();
+	const Result baselineResult = Measure(calls, [&](int i) { Baseline::VecToLVArr((i & 1) ? partial : full, &baseline); });
+	const Result reusedResult = Measure(calls, [&](int i) { copy((i & 1) ? partial : full, &reused); });
+	char name[64];
+	std::snprintf(name, sizeof(name), "%s array, %zu/%zu values", type, count, partial.size());
+	Report(name, baselineResult, reusedResult);
+
+	const bool same = SameArrays(baseline, reused);
+	DSDisposeHandle(baseline);
+	DSDisposeHandle(reused);
+	return same;
+}
+
+int main() {
+	const int calls = 200000;
+	std::printf("%-34s %-48s | %-48s |\n", "", "before lv_marshal", "lv_marshal");
+
+	bool same = true;
+	same &= BenchStrings(calls, 4);
+	same &= BenchStrings(calls / 4, 64);
+	same &= BenchNumbers<LVuint32Array, uint32_t>("uint32", calls, 64, NanoLibWrapper::VecUint32ToLVuint32Arr);
+	same &= BenchNumbers<LVint32Array, int32_t>("int32", calls / 4, 4000, NanoLibWrapper::VecInt32ToLVint32Arr);
+	same &= BenchNumbers<LVfloat64Array, double>("float64", calls / 4, 4000, NanoLibWrapper::VecFloat64ToLVfloat64Arr);
+
+	if (!same) {
+		std::printf("results differ\n");
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -1,13 +1,31 @@
-#include <chrono>
 #include "auto_setup_motor.h"
 
-int AutoSetupMotor::AutoSetupMotPams() {
+int AutoSetupMotor::AutoSetupMotPams(CompletionWaiter& waiter) {
+
+	if (StartAutoSetup())
+		return EXIT_FAILURE;
+
+	//wait till its done
+	CompletionWaiter::Result result = waiter.Wait(CompletionWaiter::Kind::AutoSetup, [this] {
+		DBOUT("Auto Setup running\n");
+		return IsAutoSetupDone() ? CompletionWaiter::Poll::Done : CompletionWaiter::Poll::Pending;
+	});
+	if (result != CompletionWaiter::Result::Done)
+		return EXIT_FAILURE;
+	DBOUT("Auto Setup done\n");
+
+	FinishAutoSetup();
+
+	return EXIT_SUCCESS;
+}
+
+int AutoSetupMotor::StartAutoSetup() {
 
 	if (powerSM_->Shutdown())
 		return EXIT_FAILURE;
 
 	//lese 6041h:00h(Bit 9(remote), 5(quick_stop) und 0(ready to switch on) = 1 ? )
-	uint32_t uWord32 = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6041, 0x00)));
+	uint32_t uWord32 = static_cast<uint32_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x6041, 0x00)));
 	if (uWord32 << 0 == 0 || uWord32 << 5 == 0 || uWord32 << 9 == 1) {
 		throw(nanolib_exception("state either in remote,quickstop or not ready to switch on"));
 		return EXIT_FAILURE;
@@ -17,30 +35,16 @@ int AutoSetupMotor::AutoSetupMotPams() {
 	if (powerSM_->EnableOperation())
 		return EXIT_FAILURE;
 	//start auto-setup
-	uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6040, 0x00)));
-	uWord16 |= 1UL << 4;
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
-	//wait till its done
-	using namespace std::chrono_literals; // ns, us, ms, s, h, etc.
-
-	uint16_t iterationsDone = 0;
-	uint16_t maxIterations = 3000;
-
-	do {
-		uWord16 = static_cast<uint16_t>(
-			nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6041, 0x00)));
-		DBOUT("Auto Setup running\n");
-		std::this_thread::sleep_for(10ms);
-		iterationsDone += 1;
-		if (iterationsDone == maxIterations) {
-			return EXIT_FAILURE;
-		}
-	} while (
-		((uWord16 >> 12) & 1U) == 0);
-	DBOUT("Auto Setup done\n");
+	controlWord_->Modify((1U << 4), 0);
+	return EXIT_SUCCESS;
+}
 
-	uWord16 = 0;
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
+bool AutoSetupMotor::IsAutoSetupDone() {
+	uint16_t uWord16 = static_cast<uint16_t>(
+		nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x6041, 0x00)));
+	return ((uWord16 >> 12) & 1U) != 0;
+}
 
-	return EXIT_SUCCESS;
-}
\ No newline at end of file
+void AutoSetupMotor::FinishAutoSetup() {
+	controlWord_->Write(0);
+}
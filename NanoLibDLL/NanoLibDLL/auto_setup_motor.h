@@ -5,11 +5,14 @@
 class AutoSetupMotor : public Motor402 {
 
 public:
-
-	AutoSetupMotor(NanoLibHelper* nanolibHelper, std::optional<nlc::DeviceHandle>* connectedDeviceHandle, PowerSM* powerSM) :
-		Motor402(nanolibHelper, connectedDeviceHandle, powerSM)
+	AutoSetupMotor(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle, PowerSM *powerSM, std::optional<int8_t> *activeMode) :
+		Motor402(nanolibHelper, connectedDeviceHandle, powerSM, activeMode)
 	{
-		SetModeOfOperation(OperationMode::AutoSetup);
+	}
+
+	//switch the drive to this mode, only touches the bus if the mode differs
+	int Activate() {
+		return SetModeOfOperation(OperationMode::AutoSetup);
 	}
 
 
@@ -22,7 +25,14 @@ public:
 	(Encoder/Hall-Sensoren) nicht ndern, ist das Auto-Setup nur einmal bei der Erstinbetriebnahme
 	durchzufhren. ->Der Motor muss lastfrei sein.
 	*/
-	int AutoSetupMotPams();
+	int AutoSetupMotPams(CompletionWaiter& waiter);
+
+	//AutoSetupMotPams in steps, for callers that must not block
+	int StartAutoSetup();
+	//statusword bit 12 signals the end of the auto setup
+	bool IsAutoSetupDone();
+	//clear the start bit, also aborts a running auto setup
+	void FinishAutoSetup();
 
 private:
 
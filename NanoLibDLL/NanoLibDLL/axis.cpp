@@ -0,0 +1,21 @@
+#include "axis.h"
+
+Axis::Axis(uint32_t id, NanoLibHelper* nanolibHelper, BusExecutor* busExecutor) :
+	id(id)
+{
+	powerSM = std::make_unique<PowerSM>(nanolibHelper, &deviceHandle);
+	connectionMonitor = std::make_unique<ConnectionMonitor>(nanolibHelper, busExecutor);
+
+	//mode objects live as long as the axis, the mode is only switched when a mode specific command needs it
+	motor = std::make_unique<Motor402>(nanolibHelper, &deviceHandle, powerSM.get(), &activeMode);
+	profilePositionMotor = std::make_unique<ProfilePositionMotor>(nanolibHelper, &deviceHandle, powerSM.get(), &activeMode);
+	velocityMotor = std::make_unique<VelocityMotor>(nanolibHelper, &deviceHandle, powerSM.get(), &activeMode);
+	profileVelocityMotor = std::make_unique<ProfileVelocityMotor>(nanolibHelper, &deviceHandle, powerSM.get(), &activeMode);
+	homingMotor = std::make_unique<HomingMotor>(nanolibHelper, &deviceHandle, powerSM.get(), &activeMode);
+	autoSetupMotor = std::make_unique<AutoSetupMotor>(nanolibHelper, &deviceHandle, powerSM.get(), &activeMode);
+	cyclicPositionMotor = std::make_unique<CyclicPositionMotor>(nanolibHelper, &deviceHandle, powerSM.get(), &activeMode);
+	interpolatedPositionMotor = std::make_unique<InterpolatedPositionMotor>(nanolibHelper, &deviceHandle, powerSM.get(), &activeMode);
+	profileTorqueMotor = std::make_unique<ProfileTorqueMotor>(nanolibHelper, &deviceHandle, powerSM.get(), &activeMode);
+	waypoints = std::make_unique<WaypointQueue>();
+	feeder = std::make_unique<SetpointFeeder>(nanolibHelper, busExecutor);
+}
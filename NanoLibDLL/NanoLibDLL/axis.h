@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "nanolib_helper.hpp"
+
+#include "auto_setup_motor.h"
+#include "connection_monitor.h"
+#include "cyclic_position_motor.h"
+#include "homing_motor.h"
+#include "interpolated_position_motor.h"
+#include "power_sm.h"
+#include "profile_position_motor.h"
+#include "profile_torque_motor.h"
+#include "profile_velocity_motor.h"
+#include "setpoint_feeder.h"
+#include "velocity_motor.h"
+#include "waypoint_queue.h"
+
+/*
+One drive on the opened bus.
+Everything that belongs to a single device lives here: its handle, the power state machine
+with the controlword shadow, the cached mode of operation and the mode objects working on them.
+The controller keeps one Axis per axis id, the mode objects point into it, so an Axis never moves.
+*/
+struct Axis {
+
+	Axis(uint32_t id, NanoLibHelper* nanolibHelper, BusExecutor* busExecutor);
+
+	Axis(const Axis&) = delete;
+	void operator=(const Axis&) = delete;
+
+	uint32_t id;
+
+	std::optional<nlc::DeviceHandle> deviceHandle;
+	//device id from the scan, to refuse connecting one device to two axes
+	std::optional<nlc::DeviceId> deviceId;
+	//mode of operation of the device, empty until read from 6061h
+	std::optional<int8_t> activeMode;
+
+	std::unique_ptr<PowerSM> powerSM;
+	std::unique_ptr<ConnectionMonitor> connectionMonitor;
+
+	std::unique_ptr<Motor402> motor;
+	std::unique_ptr<ProfilePositionMotor> profilePositionMotor;
+	std::unique_ptr<VelocityMotor> velocityMotor;
+	std::unique_ptr<ProfileVelocityMotor> profileVelocityMotor;
+	std::unique_ptr<HomingMotor> homingMotor;
+	std::unique_ptr<AutoSetupMotor> autoSetupMotor;
+	std::unique_ptr<CyclicPositionMotor> cyclicPositionMotor;
+	std::unique_ptr<InterpolatedPositionMotor> interpolatedPositionMotor;
+	std::unique_ptr<ProfileTorqueMotor> profileTorqueMotor;
+
+	//profile position targets waiting for the drive, see Controller::QueueTargets
+	std::unique_ptr<WaypointQueue> waypoints;
+	//set points of cyclic synchronous and interpolated position, see Controller::PushSetpoints
+	std::unique_ptr<SetpointFeeder> feeder;
+};
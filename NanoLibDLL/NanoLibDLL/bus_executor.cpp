@@ -0,0 +1,175 @@
+#include "bus_executor.h"
+
+#include <cstdlib>
+
+BusExecutor::Queue::Queue() :
+	head(&stub),
+	tail(&stub)
+{
+}
+
+BusExecutor::BusExecutor() :
+	depth_(0),
+	maxDepth_(0),
+	executed_(0),
+	posted_(0),
+	waitNsSum_(0),
+	waitNsMax_(0),
+	running_(false),
+	stop_(false)
+{
+	Start();
+}
+
+BusExecutor::~BusExecutor() {
+	//Stop was not called, leave the thread to the unload instead of deadlocking it
+	if (thread_.joinable())
+		thread_.detach();
+}
+
+void BusExecutor::Start() {
+	if (running_.load(std::memory_order_acquire))
+		return;
+	std::lock_guard<std::mutex> lock(startMutex_);
+	if (running_.load(std::memory_order_relaxed))
+		return;
+	stop_ = false;
+	thread_ = std::thread(&BusExecutor::Run, this);
+	running_.store(true, std::memory_order_release);
+}
+
+void BusExecutor::Stop() {
+	std::lock_guard<std::mutex> lock(startMutex_);
+	if (!running_.load(std::memory_order_relaxed))
+		return;
+	//queued behind everything that is still pending
+	Enqueue([this] { stop_ = true; return 0; }, queue_);
+	thread_.join();
+	running_.store(false, std::memory_order_release);
+}
+
+void BusExecutor::Post(std::function<int()> command) {
+	Start();
+	Enqueue(std::move(command), queue_);
+}
+
+void BusExecutor::PostUrgent(std::function<int()> command) {
+	Start();
+	Enqueue(std::move(command), urgent_);
+}
+
+void BusExecutor::Enqueue(std::function<int()> command, Queue& queue) {
+	Command* queued = new Command();
+	queued->posted = std::move(command);
+	posted_++;
+	Push(queued, queue);
+}
+
+BusExecutor::Stats BusExecutor::GetStats() const {
+	Stats stats;
+	stats.depth = depth_;
+	stats.maxDepth = maxDepth_;
+	stats.executed = executed_;
+	stats.posted = posted_;
+	if (stats.executed > 0)
+		stats.avgWaitUs = static_cast<double>(waitNsSum_) / 1000.0 / static_cast<double>(stats.executed);
+	stats.maxWaitUs = static_cast<double>(waitNsMax_) / 1000.0;
+	return stats;
+}
+
+void BusExecutor::ResetStats() {
+	maxDepth_ = depth_.load();
+	executed_ = 0;
+	posted_ = 0;
+	waitNsSum_ = 0;
+	waitNsMax_ = 0;
+}
+
+void BusExecutor::Push(Command* command, Queue& queue) {
+	//counted before linking, so the bus thread never sees more commands than depth_
+	const uint32_t depth = depth_.fetch_add(1) + 1;
+	uint32_t maxDepth = maxDepth_.load();
+	while (depth > maxDepth && !maxDepth_.compare_exchange_weak(maxDepth, depth)) {
+	}
+
+	command->queued = std::chrono::steady_clock::now();
+	queue.Push(command);
+	depth_.notify_one();
+}
+
+void BusExecutor::Queue::Push(Command* command) {
+	command->next.store(nullptr, std::memory_order_relaxed);
+	Command* prev = head.exchange(command, std::memory_order_acq_rel);
+	prev->next.store(command, std::memory_order_release);
+}
+
+BusExecutor::Command* BusExecutor::Queue::Pop() {
+	Command* first = tail;
+	Command* next = first->next.load(std::memory_order_acquire);
+	if (first == &stub) {
+		if (next == nullptr)
+			return nullptr;
+		tail = next;
+		first = next;
+		next = next->next.load(std::memory_order_acquire);
+	}
+	if (next != nullptr) {
+		tail = next;
+		return first;
+	}
+	//a producer is between exchange and linking, try again later
+	if (first != head.load(std::memory_order_acquire))
+		return nullptr;
+	//first is the last command, put the stub behind it to take it out
+	stub.next.store(nullptr, std::memory_order_relaxed);
+	Command* prev = head.exchange(&stub, std::memory_order_acq_rel);
+	prev->next.store(&stub, std::memory_order_release);
+	next = first->next.load(std::memory_order_acquire);
+	if (next != nullptr) {
+		tail = next;
+		return first;
+	}
+	return nullptr;
+}
+
+void BusExecutor::Run() {
+	while (!stop_) {
+		Command* command = urgent_.Pop();
+		if (command == nullptr)
+			command = queue_.Pop();
+		if (command == nullptr) {
+			if (depth_.load() == 0)
+				depth_.wait(0);
+			else
+				std::this_thread::yield();
+			continue;
+		}
+
+		const uint64_t waitNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - command->queued).count());
+		waitNsSum_ += waitNs;
+		uint64_t waitNsMax = waitNsMax_.load();
+		while (waitNs > waitNsMax && !waitNsMax_.compare_exchange_weak(waitNsMax, waitNs)) {
+		}
+
+		int result = EXIT_FAILURE;
+		try {
+			result = command->posted ? command->posted() : command->invoke(command->context);
+		}
+		catch (...) {
+			//the controller records its own errors, anything else must not end the bus thread
+		}
+
+		if (command->posted) {
+			delete command;
+		}
+		else {
+			std::lock_guard<std::mutex> lock(doneMutex_);
+			command->result = result;
+			command->done = true;
+		}
+		executed_++;
+		depth_--;
+		doneCv_.notify_all();
+	}
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+/*
+Runs all bus commands on one thread.
+LabVIEW calls the DLL from several loops at once; every exported call is queued here
+and executed in order, so the controller state and NanoLib are only touched by the bus thread.
+Commands are queued through a lock-free multi producer queue (intrusive, Vyukov style).
+Urgent commands (halt, quick stop) have a queue of their own that is served first,
+they only wait for the command that is running.
+The thread is ended with Stop before the DLL is unloaded, the next command starts it again.
+*/
+class BusExecutor {
+public:
+
+	struct Stats {
+		//commands queued but not finished
+		uint32_t depth = 0;
+		uint32_t maxDepth = 0;
+		//commands run on the bus thread
+		uint64_t executed = 0;
+		//commands queued without waiting
+		uint64_t posted = 0;
+		//time between queueing and start of a command
+		double avgWaitUs = 0.0;
+		double maxWaitUs = 0.0;
+	};
+
+	BusExecutor();
+	//joining here would block on the loader lock at DLL unload, without Stop the thread is left to the unload
+	~BusExecutor();
+
+	//runs command on the bus thread and waits for its result, runs it inline on the bus thread itself
+	template <class F>
+	int Execute(F&& command) {
+		return Wait(command, queue_);
+	}
+	//like Execute, but ahead of every command queued with Execute or Post
+	template <class F>
+	int ExecuteUrgent(F&& command) {
+		return Wait(command, urgent_);
+	}
+
+	//queues command and returns at once, the result is dropped
+	void Post(std::function<int()> command);
+	//like Post, but ahead of every command queued with Execute or Post
+	void PostUrgent(std::function<int()> command);
+
+	//runs the commands queued so far and ends the bus thread, never call it on the bus thread
+	//no command may be queued meanwhile
+	void Stop();
+
+	bool IsBusThread() const { return std::this_thread::get_id() == thread_.get_id(); }
+
+	Stats GetStats() const;
+	void ResetStats();
+
+private:
+
+	struct Command {
+		std::atomic<Command*> next{ nullptr };
+		int (*invoke)(void*) = nullptr;
+		void* context = nullptr;
+		//set for posted commands, those are owned by the queue
+		std::function<int()> posted;
+		std::chrono::steady_clock::time_point queued;
+		int result = 0;
+		bool done = false;
+	};
+
+	//producers swap in at head, the bus thread takes from tail
+	struct Queue {
+		Queue();
+		void Push(Command* command);
+		//nullptr if empty or a producer is not done linking yet
+		Command* Pop();
+
+		std::atomic<Command*> head;
+		Command* tail;
+		Command stub;
+	};
+
+	template <class F>
+	int Wait(F& command, Queue& queue) {
+		Start();
+		if (IsBusThread())
+			return command();
+		Command queued;
+		queued.invoke = [](void* context) { return (*static_cast<F*>(context))(); };
+		queued.context = &command;
+		Push(&queued, queue);
+		std::unique_lock<std::mutex> lock(doneMutex_);
+		doneCv_.wait(lock, [&queued] { return queued.done; });
+		return queued.result;
+	}
+
+	//starts the bus thread unless it runs
+	void Start();
+	void Enqueue(std::function<int()> command, Queue& queue);
+	void Push(Command* command, Queue& queue);
+	void Run();
+
+	Queue queue_;
+	Queue urgent_;
+
+	//commands in both queues
+	std::atomic<uint32_t> depth_;
+	std::atomic<uint32_t> maxDepth_;
+	std::atomic<uint64_t> executed_;
+	std::atomic<uint64_t> posted_;
+	std::atomic<uint64_t> waitNsSum_;
+	std::atomic<uint64_t> waitNsMax_;
+
+	//completion of waiting commands, the command lives on the caller's stack
+	std::mutex doneMutex_;
+	std::condition_variable doneCv_;
+
+	//guards starting and stopping the bus thread
+	std::mutex startMutex_;
+	std::atomic<bool> running_;
+	//only touched by the bus thread
+	bool stop_;
+	std::thread thread_;
+};
@@ -0,0 +1,113 @@
+#include "bus_probe.h"
+#include "device_identity.h"
+#include "nano_lib_hw_strings.hpp"
+
+#include <chrono>
+#include <format>
+
+BusProbe::BusProbe(NanoLibHelper* nanolibHelper) :
+	nanolibHelper_(nanolibHelper)
+{
+}
+
+std::vector<BusProbe::Setting> BusProbe::Candidates(const nlc::BusHardwareId& busHwId, const std::map<std::string, std::string>& base) {
+	const nlc::BusHwOptionsDefault& defaults = nlc::busHwOptionsDefaults;
+	std::vector<Setting> settings;
+
+	if (busHwId.getProtocol() == nlc::BUS_HARDWARE_ID_PROTOCOL_CANOPEN) {
+		const nlc::CanBaudRate& baudRate = defaults.canBus.baudRate;
+		//below 50k a single probe takes longer than anyone would wait for
+		for (const std::string& baud : { baudRate.BAUD_RATE_1000K, baudRate.BAUD_RATE_800K, baudRate.BAUD_RATE_500K,
+			baudRate.BAUD_RATE_250K, baudRate.BAUD_RATE_125K, baudRate.BAUD_RATE_100K, baudRate.BAUD_RATE_50K }) {
+			Setting setting{ baud, base };
+			setting.options[defaults.canBus.BAUD_RATE_OPTIONS_NAME] = baud;
+			settings.push_back(setting);
+		}
+	}
+	else if (busHwId.getProtocol() == nlc::BUS_HARDWARE_ID_PROTOCOL_MODBUS_RTU) {
+		const nlc::SerialBaudRate& baudRate = defaults.serial.baudRate;
+		const nlc::SerialParity& parity = defaults.serial.parity;
+		for (const std::string& baud : { baudRate.BAUD_RATE_256000, baudRate.BAUD_RATE_128000, baudRate.BAUD_RATE_115200,
+			baudRate.BAUD_RATE_57600, baudRate.BAUD_RATE_38400, baudRate.BAUD_RATE_19200, baudRate.BAUD_RATE_9600 }) {
+			for (const std::string& bits : { parity.EVEN, parity.NONE, parity.ODD }) {
+				Setting setting{ std::format("{} {}", baud, bits), base };
+				setting.options[defaults.serial.BAUD_RATE_OPTIONS_NAME] = baud;
+				setting.options[defaults.serial.PARITY_OPTIONS_NAME] = bits;
+				settings.push_back(setting);
+			}
+		}
+	}
+	return settings;
+}
+
+BusProbe::Result BusProbe::Measure(const nlc::BusHardwareId& busHwId, const Setting& setting, uint32_t nodeId, uint32_t roundTrips) const {
+	Result result;
+	result.setting = setting;
+
+	try {
+		nanolibHelper_->openBusHardware(busHwId, nlc::BusHardwareOptions(setting.options));
+	}
+	catch (const nanolib_exception&) {
+		//the adapter does not support the setting
+		return result;
+	}
+
+	try {
+		std::vector<nlc::DeviceId> devices;
+		if (nodeId != 0) {
+			//a single connect, a scan with a wrong baud rate waits for every node id to time out
+			devices.emplace_back(busHwId, nodeId, std::format("node {}", nodeId));
+		}
+		else {
+			devices = nanolibHelper_->scanBus(busHwId);
+		}
+
+		if (!devices.empty()) {
+			const nlc::DeviceHandle deviceHandle = nanolibHelper_->addDevice(devices.front());
+			try {
+				nanolibHelper_->connectDevice(deviceHandle);
+				result.devices = static_cast<uint32_t>(devices.size());
+
+				const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				for (uint32_t i = 0; i < roundTrips; i++) {
+					try {
+						nanolibHelper_->readInteger(deviceHandle, DeviceIdentity::kDeviceType);
+						result.roundTrips++;
+					}
+					catch (const nanolib_exception&) {
+						result.errors++;
+					}
+				}
+				const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				if (seconds > 0.0)
+					result.roundTripsPerSecond = result.roundTrips / seconds;
+
+				nanolibHelper_->disconnectDevice(deviceHandle);
+			}
+			catch (const nanolib_exception&) {
+				//no answer with this setting
+			}
+			nanolibHelper_->removeDevice(deviceHandle);
+		}
+	}
+	catch (const nanolib_exception&) {
+		//scan failed, nothing found with this setting
+	}
+
+	try {
+		nanolibHelper_->closeBusHardware(busHwId);
+	}
+	catch (const nanolib_exception&) {
+		//the next setting opens it again, a failure shows there
+	}
+	return result;
+}
+
+int32_t BusProbe::Recommend(const std::vector<Result>& results) {
+	int32_t recommended = -1;
+	for (int32_t i = 0; i < static_cast<int32_t>(results.size()); i++) {
+		if (results[i].IsStable() && (recommended < 0 || results[i].roundTripsPerSecond > results[recommended].roundTripsPerSecond))
+			recommended = i;
+	}
+	return recommended;
+}
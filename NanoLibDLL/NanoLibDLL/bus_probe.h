@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "nanolib_helper.hpp"
+
+/*
+Finds the baud rate (and for Modbus RTU the parity) the devices on a bus answer with
+and measures SDO round trips per second with each of them.
+createBusHardwareOptions defaults to 1000k on CAN and 19200 even on Modbus RTU, the slowest realistic serial setting,
+the fastest stable setting found here can be used for OpenPort instead.
+The bus must not be open, it is opened and closed for every setting.
+*/
+class BusProbe {
+public:
+
+	struct Setting {
+		//"500k", "115200 even"
+		std::string label;
+		std::map<std::string, std::string> options;
+	};
+
+	struct Result {
+		Setting setting;
+		//0 if no device answered with the setting
+		uint32_t devices = 0;
+		uint32_t roundTrips = 0;
+		uint32_t errors = 0;
+		double roundTripsPerSecond = 0.0;
+
+		bool IsStable() const { return devices > 0 && errors == 0; }
+	};
+
+	BusProbe(NanoLibHelper* nanolibHelper);
+
+	//settings worth trying for the bus hardware, fastest first, empty if it has no baud rate
+	//base is used for every option the probe does not vary (e.g. the IXXAT bus number)
+	static std::vector<Setting> Candidates(const nlc::BusHardwareId& busHwId, const std::map<std::string, std::string>& base);
+
+	//opens the bus with the setting, connects nodeId (the first device of a scan if 0) and reads the device type roundTrips times
+	Result Measure(const nlc::BusHardwareId& busHwId, const Setting& setting, uint32_t nodeId, uint32_t roundTrips) const;
+
+	//stable result with the most round trips per second, -1 if none is stable
+	static int32_t Recommend(const std::vector<Result>& results);
+
+private:
+
+	NanoLibHelper* nanolibHelper_;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+/*
+Set point slot where a newer value replaces one that is not written yet.
+Any thread may store, the write posted to the bus thread takes the newest value when it runs.
+While a write is pending a store only overwrites the slot, so a control loop faster than the bus
+never queues stale set points and the device gets the latest one with the next free bus slot.
+*/
+template <class T>
+class CoalescingSetpoint {
+public:
+
+	struct Stats {
+		uint64_t stored = 0;
+		uint64_t written = 0;
+		//values replaced by a newer one before they were written
+		uint64_t coalesced = 0;
+	};
+
+	CoalescingSetpoint() :
+		value_(T()),
+		pending_(false),
+		stored_(0),
+		written_(0)
+	{
+	}
+
+	CoalescingSetpoint(const CoalescingSetpoint&) = delete;
+	CoalescingSetpoint& operator=(const CoalescingSetpoint&) = delete;
+
+	//true if no write was pending, the caller has to post one that calls Take
+	bool Store(T value) {
+		value_.store(value, std::memory_order_relaxed);
+		stored_.fetch_add(1, std::memory_order_relaxed);
+		return !pending_.exchange(true, std::memory_order_acq_rel);
+	}
+
+	//newest value for the posted write, empty if an earlier write took it already
+	std::optional<T> Take() {
+		if (!pending_.exchange(false, std::memory_order_acq_rel))
+			return std::nullopt;
+		written_.fetch_add(1, std::memory_order_relaxed);
+		return value_.load(std::memory_order_relaxed);
+	}
+
+	Stats GetStats() const {
+		Stats stats;
+		stats.stored = stored_.load(std::memory_order_relaxed);
+		stats.written = written_.load(std::memory_order_relaxed);
+		//a store racing with a take can be written twice
+		stats.coalesced = stats.stored > stats.written ? stats.stored - stats.written : 0;
+		return stats;
+	}
+
+private:
+
+	std::atomic<T> value_;
+	std::atomic<bool> pending_;
+	std::atomic<uint64_t> stored_;
+	std::atomic<uint64_t> written_;
+};
@@ -0,0 +1,146 @@
+#include "completion_waiter.h"
+
+#include <algorithm>
+#include <bit>
+#include <thread>
+
+CompletionWaiter::CompletionWaiter() {
+	using namespace std::chrono_literals;
+
+	//1010h:xx is written back to 1 after some 100 ms
+	entries_[static_cast<size_t>(Kind::Save)].policy = { 20ms, 200ms, 30s, 1.5 };
+	//auto setup takes seconds, polling it often only loads the bus
+	entries_[static_cast<size_t>(Kind::AutoSetup)].policy = { 50ms, 250ms, 30s, 1.5 };
+	entries_[static_cast<size_t>(Kind::Homing)].policy = { 20ms, 200ms, 120s, 1.5 };
+	entries_[static_cast<size_t>(Kind::TargetReached)].policy = { 5ms, 100ms, 60s, 1.5 };
+	//the acknowledge comes within a few cycles of the drive, every ms waited delays the next set point
+	entries_[static_cast<size_t>(Kind::SetPointAcknowledge)].policy = { 1ms, 2ms, 1s, 1.0 };
+	//the buffer frees when the active move ends, which can take as long as any move
+	entries_[static_cast<size_t>(Kind::SetPointBuffer)].policy = { 1ms, 20ms, 60s, 1.5 };
+	//kept apart from TargetReached, targets queued meanwhile end it early and must not be waited for long
+	entries_[static_cast<size_t>(Kind::LastWaypoint)].policy = { 2ms, 20ms, 60s, 1.5 };
+}
+
+CompletionWaiter::Result CompletionWaiter::Wait(Kind kind, const Condition& condition, const Sleeper& sleep,
+	std::optional<std::chrono::milliseconds> deadline) {
+	using namespace std::chrono;
+
+	Policy policy;
+	milliseconds delay(0);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		const Entry& entry = entries_[static_cast<size_t>(kind)];
+		policy = entry.policy;
+		//nothing finished faster so far, polling earlier is wasted bus time
+		if (entry.stats.completed > 0)
+			delay = duration_cast<milliseconds>(duration<double, std::milli>(entry.earliestMs));
+	}
+	const milliseconds limit = deadline.value_or(policy.deadline);
+
+	const steady_clock::time_point start = steady_clock::now();
+	auto elapsed = [&start] { return duration<double, std::milli>(steady_clock::now() - start); };
+
+	double interval = static_cast<double>(policy.minInterval.count());
+	uint64_t polls = 0;
+	//last poll that found the condition pending, the completion happened after it
+	double pendingMs = 0.0;
+	while (true) {
+		if (delay.count() > 0) {
+			//the last poll is made at the deadline
+			const milliseconds remaining = std::max(ceil<milliseconds>(limit - elapsed()), milliseconds(0));
+			delay = std::min(delay, remaining);
+			const bool running = sleep ? sleep(delay) : (std::this_thread::sleep_for(delay), true);
+			if (!running) {
+				Record(kind, Result::Cancelled, elapsed().count(), pendingMs, polls);
+				return Result::Cancelled;
+			}
+		}
+
+		Poll poll;
+		const double polledMs = elapsed().count();
+		try {
+			polls++;
+			poll = condition();
+		}
+		catch (...) {
+			Record(kind, Result::Failed, elapsed().count(), pendingMs, polls);
+			throw;
+		}
+
+		if (poll != Poll::Pending) {
+			const Result result = poll == Poll::Done ? Result::Done : Result::Failed;
+			Record(kind, result, elapsed().count(), pendingMs, polls);
+			return result;
+		}
+		pendingMs = polledMs;
+		if (elapsed() >= limit) {
+			Record(kind, Result::TimedOut, elapsed().count(), pendingMs, polls);
+			return Result::TimedOut;
+		}
+
+		delay = milliseconds(static_cast<int64_t>(interval));
+		interval = std::min(interval * policy.growth, static_cast<double>(policy.maxInterval.count()));
+	}
+}
+
+void CompletionWaiter::SetPolicy(Kind kind, const Policy& policy) {
+	Policy checked = policy;
+	checked.minInterval = std::max(checked.minInterval, std::chrono::milliseconds(1));
+	checked.maxInterval = std::max(checked.maxInterval, checked.minInterval);
+	checked.growth = std::max(checked.growth, 1.0);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	entries_[static_cast<size_t>(kind)].policy = checked;
+}
+
+CompletionWaiter::Policy CompletionWaiter::GetPolicy(Kind kind) const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return entries_[static_cast<size_t>(kind)].policy;
+}
+
+CompletionWaiter::Stats CompletionWaiter::GetStats(Kind kind) const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	const Entry& entry = entries_[static_cast<size_t>(kind)];
+	Stats stats = entry.stats;
+	if (stats.completed > 0)
+		stats.avgMs = entry.sumMs / static_cast<double>(stats.completed);
+	return stats;
+}
+
+void CompletionWaiter::ResetStats(Kind kind) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	Entry& entry = entries_[static_cast<size_t>(kind)];
+	entry.stats = Stats();
+	entry.sumMs = 0.0;
+	entry.earliestMs = 0.0;
+}
+
+void CompletionWaiter::Record(Kind kind, Result result, double elapsedMs, double pendingMs, uint64_t polls) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	Entry& entry = entries_[static_cast<size_t>(kind)];
+	Stats& stats = entry.stats;
+	stats.polls += polls;
+
+	switch (result) {
+	case Result::Done: {
+		stats.minMs = stats.completed == 0 ? elapsedMs : std::min(stats.minMs, elapsedMs);
+		entry.earliestMs = stats.completed == 0 ? pendingMs : std::min(entry.earliestMs, pendingMs);
+		stats.maxMs = std::max(stats.maxMs, elapsedMs);
+		stats.completed++;
+		entry.sumMs += elapsedMs;
+		//below 1 ms in bucket 0, below 2 ms in bucket 1, ...
+		const size_t bucket = std::bit_width(static_cast<uint64_t>(elapsedMs));
+		stats.histogram[std::min(bucket, kHistogramSize - 1)]++;
+		break;
+	}
+	case Result::Failed:
+		stats.failed++;
+		break;
+	case Result::TimedOut:
+		stats.timedOut++;
+		break;
+	case Result::Cancelled:
+		stats.cancelled++;
+		break;
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+
+/*
+Waits for a device condition (save finished, auto setup done, homing attained, target reached,
+set point acknowledged, last waypoint reached)
+by polling it with a growing interval instead of a fixed sleep.
+The first poll is delayed to the earliest time a condition of the same kind was still seen pending before it completed,
+after that the interval grows from minInterval by growth up to maxInterval until the deadline.
+Time to completion is recorded per kind.
+*/
+class CompletionWaiter {
+public:
+
+	enum class Kind : int32_t {
+		Save,
+		AutoSetup,
+		Homing,
+		TargetReached,
+		//profile position handshake: 6041h bit 12 set after a new set point, cleared once the buffer is free
+		SetPointAcknowledge,
+		SetPointBuffer,
+		//last target of a waypoint queue reached, or more targets queued meanwhile
+		LastWaypoint,
+		Count
+	};
+
+	//answer of one poll of the condition
+	enum class Poll {
+		Pending,
+		Done,
+		Failed
+	};
+
+	enum class Result {
+		Done,
+		Failed,
+		TimedOut,
+		Cancelled
+	};
+
+	struct Policy {
+		std::chrono::milliseconds minInterval;
+		std::chrono::milliseconds maxInterval;
+		std::chrono::milliseconds deadline;
+		//factor applied to the interval after every pending poll
+		double growth;
+	};
+
+	//bucket i counts completions below 2^i ms, the last one everything above
+	static constexpr size_t kHistogramSize = 18;
+
+	struct Stats {
+		uint64_t completed = 0;
+		uint64_t failed = 0;
+		uint64_t timedOut = 0;
+		uint64_t cancelled = 0;
+		uint64_t polls = 0;
+		double avgMs = 0.0;
+		double minMs = 0.0;
+		double maxMs = 0.0;
+		std::array<uint64_t, kHistogramSize> histogram{};
+	};
+
+	using Condition = std::function<Poll()>;
+	//sleeps for the given time, false if the wait was cancelled
+	using Sleeper = std::function<bool(std::chrono::milliseconds)>;
+
+	CompletionWaiter();
+
+	//condition may throw, the exception is passed on and the wait counted as failed
+	Result Wait(Kind kind, const Condition& condition, const Sleeper& sleep = {},
+		std::optional<std::chrono::milliseconds> deadline = std::nullopt);
+
+	void SetPolicy(Kind kind, const Policy& policy);
+	Policy GetPolicy(Kind kind) const;
+	Stats GetStats(Kind kind) const;
+	void ResetStats(Kind kind);
+
+private:
+
+	struct Entry {
+		Policy policy;
+		Stats stats;
+		//sum of the completion times, avgMs is derived from it
+		double sumMs = 0.0;
+		//earliest pending poll before a completion, the first poll of the next wait is delayed to it
+		double earliestMs = 0.0;
+	};
+
+	void Record(Kind kind, Result result, double elapsedMs, double pendingMs, uint64_t polls);
+
+	mutable std::mutex mutex_;
+	std::array<Entry, static_cast<size_t>(Kind::Count)> entries_;
+};
@@ -0,0 +1,166 @@
+#include "connection_monitor.h"
+
+#include <chrono>
+#include <cstdlib>
+
+ConnectionMonitor::ConnectionMonitor(NanoLibHelper* nanolibHelper, BusExecutor* busExecutor) :
+	nanolibHelper_(nanolibHelper),
+	busExecutor_(busExecutor),
+	state_(State::Disconnected),
+	checksAvoided_(0),
+	checksQueried_(0),
+	probes_(0),
+	transportErrors_(0),
+	stopProbe_(false),
+	probePeriodMs_(0),
+	probeGeneration_(0),
+	probePending_(false)
+{
+}
+
+ConnectionMonitor::~ConnectionMonitor() {
+	//the probe was not stopped, leave it to the unload instead of deadlocking it
+	if (probeThread_.joinable())
+		probeThread_.detach();
+}
+
+void ConnectionMonitor::OnConnected(const nlc::DeviceHandle& deviceHandle) {
+	StopProbe();
+	{
+		std::lock_guard<std::mutex> lock(probeMutex_);
+		deviceHandle_ = deviceHandle;
+	}
+	state_ = State::Connected;
+	StartProbe();
+}
+
+void ConnectionMonitor::OnDisconnected() {
+	StopProbe();
+	{
+		std::lock_guard<std::mutex> lock(probeMutex_);
+		deviceHandle_.reset();
+	}
+	state_ = State::Disconnected;
+}
+
+void ConnectionMonitor::OnError(nlc::NlcErrorCode errorCode) {
+	switch (errorCode) {
+	case nlc::NlcErrorCode::BusUnavailable:
+	case nlc::NlcErrorCode::CommunicationError:
+	case nlc::NlcErrorCode::ResourceUnavailable:
+	case nlc::NlcErrorCode::TimeoutError: {
+		transportErrors_++;
+		//keep Disconnected, a connected device has to be verified
+		State expected = State::Connected;
+		state_.compare_exchange_strong(expected, State::Unknown);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+bool ConnectionMonitor::IsConnected(const nlc::DeviceHandle& deviceHandle) {
+	switch (state_.load()) {
+	case State::Connected:
+		checksAvoided_++;
+		return true;
+	case State::Disconnected:
+		checksAvoided_++;
+		return false;
+	default:
+		break;
+	}
+
+	checksQueried_++;
+	bool connected = nanolibHelper_->checkedResult("getConnectionState", nanolibHelper_->getConnectionState(deviceHandle)).getResult() == nlc::DeviceConnectionStateInfo::Connected;
+	//only leave Unknown, a concurrent disconnect wins
+	State expected = State::Unknown;
+	state_.compare_exchange_strong(expected, connected ? State::Connected : State::Disconnected);
+	return connected;
+}
+
+void ConnectionMonitor::SetProbePeriod(uint32_t periodMs) {
+	StopProbe();
+	{
+		std::lock_guard<std::mutex> lock(probeMutex_);
+		probePeriodMs_ = periodMs;
+	}
+	StartProbe();
+}
+
+ConnectionMonitor::Stats ConnectionMonitor::GetStats() const {
+	Stats stats;
+	stats.checksAvoided = checksAvoided_;
+	stats.checksQueried = checksQueried_;
+	stats.probes = probes_;
+	stats.transportErrors = transportErrors_;
+	return stats;
+}
+
+void ConnectionMonitor::ResetStats() {
+	checksAvoided_ = 0;
+	checksQueried_ = 0;
+	probes_ = 0;
+	transportErrors_ = 0;
+}
+
+void ConnectionMonitor::StartProbe() {
+	std::lock_guard<std::mutex> lock(probeMutex_);
+	if (probeThread_.joinable() || !deviceHandle_.has_value() || probePeriodMs_ == 0)
+		return;
+	stopProbe_ = false;
+	probePending_ = false;
+	probeGeneration_++;
+	probeThread_ = std::thread(&ConnectionMonitor::ProbeLoop, this, *deviceHandle_, probePeriodMs_, probeGeneration_);
+}
+
+void ConnectionMonitor::StopProbe() {
+	{
+		std::lock_guard<std::mutex> lock(probeMutex_);
+		stopProbe_ = true;
+	}
+	probeCv_.notify_all();
+	if (probeThread_.joinable())
+		probeThread_.join();
+}
+
+void ConnectionMonitor::ProbeLoop(nlc::DeviceHandle deviceHandle, uint32_t periodMs, uint64_t generation) {
+	std::unique_lock<std::mutex> lock(probeMutex_);
+	while (!probeCv_.wait_for(lock, std::chrono::milliseconds(periodMs), [this] { return stopProbe_; })) {
+		//a busy bus thread gets one probe, not one per period
+		if (probePending_)
+			continue;
+		probePending_ = true;
+		//never waits for the bus thread, StopProbe joins this thread from there
+		busExecutor_->Post([this, deviceHandle, generation] {
+			Probe(deviceHandle, generation);
+			return EXIT_SUCCESS;
+		});
+	}
+}
+
+void ConnectionMonitor::Probe(const nlc::DeviceHandle& deviceHandle, uint64_t generation) {
+	{
+		std::lock_guard<std::mutex> lock(probeMutex_);
+		if (generation != probeGeneration_)
+			return;
+		probePending_ = false;
+		//a disconnect queued before the probe wins
+		if (stopProbe_)
+			return;
+	}
+
+	State probed;
+	try {
+		probed = nanolibHelper_->checkConnectionState(deviceHandle).getResult() == nlc::DeviceConnectionStateInfo::Connected ? State::Connected : State::Disconnected;
+	}
+	catch (const nanolib_exception&) {
+		probed = State::Unknown;
+	}
+	probes_++;
+
+	std::lock_guard<std::mutex> lock(probeMutex_);
+	if (!stopProbe_ && generation == probeGeneration_)
+		state_ = probed;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "bus_executor.h"
+#include "nanolib_helper.hpp"
+
+/*
+Host side connection state of the connected device.
+The state follows ConnectDevice/DisconnectDevice and the errors returned by the bus,
+so the usual check before each call is an atomic load instead of a call into NanoLib.
+Optionally a background thread probes the device with checkConnectionState.
+The probe itself is posted to the bus thread, the probe thread only times it and never touches NanoLib.
+*/
+class ConnectionMonitor {
+public:
+
+	enum class State : uint8_t {
+		Disconnected,
+		Connected,
+		//a transport error was seen, ask NanoLib on the next check
+		Unknown
+	};
+
+	struct Stats {
+		//checks answered from the cached state
+		uint64_t checksAvoided = 0;
+		//checks that had to ask NanoLib (getConnectionState)
+		uint64_t checksQueried = 0;
+		//checkConnectionState calls of the probe
+		uint64_t probes = 0;
+		//bus or communication errors reported by calls
+		uint64_t transportErrors = 0;
+	};
+
+	ConnectionMonitor(NanoLibHelper* nanolibHelper, BusExecutor* busExecutor);
+	//joining the probe here would block on the loader lock at DLL unload, without OnDisconnected it is left to the unload
+	~ConnectionMonitor();
+
+	void OnConnected(const nlc::DeviceHandle& deviceHandle);
+	void OnDisconnected();
+	//called with the error code of every failed call
+	void OnError(nlc::NlcErrorCode errorCode);
+
+	//true if the device is connected, only asks NanoLib if the cached state is Unknown
+	bool IsConnected(const nlc::DeviceHandle& deviceHandle);
+
+	State GetState() const { return state_.load(); }
+
+	//period of the background probe in ms, 0 disables the probe
+	void SetProbePeriod(uint32_t periodMs);
+	uint32_t GetProbePeriod() const { return probePeriodMs_; }
+
+	Stats GetStats() const;
+	void ResetStats();
+
+private:
+
+	void StartProbe();
+	void StopProbe();
+	void ProbeLoop(nlc::DeviceHandle deviceHandle, uint32_t periodMs, uint64_t generation);
+	//bus thread
+	void Probe(const nlc::DeviceHandle& deviceHandle, uint64_t generation);
+
+	NanoLibHelper* nanolibHelper_;
+	BusExecutor* busExecutor_;
+
+	std::atomic<State> state_;
+
+	std::atomic<uint64_t> checksAvoided_;
+	std::atomic<uint64_t> checksQueried_;
+	std::atomic<uint64_t> probes_;
+	std::atomic<uint64_t> transportErrors_;
+
+	//guards the members below
+	std::mutex probeMutex_;
+	std::condition_variable probeCv_;
+	std::thread probeThread_;
+	bool stopProbe_;
+	uint32_t probePeriodMs_;
+	//counts StartProbe, a probe still queued from an earlier device is dropped
+	uint64_t probeGeneration_;
+	//a probe is queued on the bus thread, the next one waits for it
+	bool probePending_;
+	std::optional<nlc::DeviceHandle> deviceHandle_;
+};
@@ -0,0 +1,49 @@
+#include "control_word.h"
+
+ControlWord::ControlWord(NanoLibHelper* nanolibHelper, std::optional<nlc::DeviceHandle>* connectedDeviceHandle) :
+	nanolibHelper_(nanolibHelper),
+	connectedDeviceHandle_(connectedDeviceHandle),
+	value_(0),
+	valid_(false)
+{
+}
+
+void ControlWord::Seed() {
+	valid_ = false;
+	value_ = static_cast<uint16_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x6040, 0x00)));
+	stats_.reads++;
+	valid_ = true;
+}
+
+void ControlWord::Invalidate() {
+	valid_ = false;
+}
+
+uint16_t ControlWord::Get() {
+	if (!valid_)
+		Seed();
+	return value_;
+}
+
+void ControlWord::Write(uint16_t value) {
+	try {
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), value, nlc::OdIndex(0x6040, 0x00));
+	}
+	catch (const nanolib_exception&) {
+		//unknown what reached the device
+		valid_ = false;
+		throw;
+	}
+	stats_.writes++;
+	value_ = value;
+	valid_ = true;
+}
+
+void ControlWord::Modify(uint16_t setMask, uint16_t clearMask) {
+	if (valid_)
+		stats_.readsAvoided++;
+	uint16_t uWord16 = Get();
+	uWord16 &= ~clearMask;
+	uWord16 |= setMask;
+	Write(uWord16);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "nanolib_helper.hpp"
+
+/*
+Host side shadow of the controlword 6040h.
+The controlword is only written by the master, so after seeding it once on connect
+every edit can be done on the shadow and sent with a single write.
+*/
+class ControlWord {
+public:
+
+	struct Stats {
+		//reads of 6040h sent to the device
+		uint64_t reads = 0;
+		//writes of 6040h sent to the device
+		uint64_t writes = 0;
+		//read-modify-write cycles served from the shadow
+		uint64_t readsAvoided = 0;
+	};
+
+	ControlWord(NanoLibHelper* nanolibHelper, std::optional<nlc::DeviceHandle>* connectedDeviceHandle);
+
+	//read 6040h once and take it as shadow
+	void Seed();
+	//drop the shadow, next access seeds again
+	void Invalidate();
+	//same as Seed, used when someone else might have written 6040h
+	inline void Resync() { Seed(); }
+
+	bool IsValid() const { return valid_; }
+
+	uint16_t Get();
+	void Write(uint16_t value);
+	//clear the bits of clearMask, set the bits of setMask and write the result
+	void Modify(uint16_t setMask, uint16_t clearMask);
+
+	const Stats& GetStats() const { return stats_; }
+	void ResetStats() { stats_ = Stats(); }
+
+private:
+
+	NanoLibHelper* nanolibHelper_;
+	std::optional<nlc::DeviceHandle>* connectedDeviceHandle_;
+
+	uint16_t value_;
+	bool valid_;
+
+	Stats stats_;
+};
@@ -1,56 +1,120 @@
+#include <array>
 #include <format>
 #include <cstdint>
 
 #include "controller.h"
+#include "device_identity.h"
 #include "user_units.h"
 #include "magic_enum.hpp"
+#include "nano_lib_hw_strings.hpp"
 
 
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
 #include <Windows.h>
+#endif
 #include <iostream>
+#include <sstream>
+
+//every comparison of device ids in the controller goes through here
+//on CANopen the node id is the device, a node connected by NodeDeviceId has no description and no extra ids,
+//so a scan of the same node would not be equal to it; DeviceId::equals ignores the description only
+static bool SameDevice(const nlc::DeviceId& a, const nlc::DeviceId& b) {
+	if (a.getBusHardwareId().getProtocol() == nlc::BUS_HARDWARE_ID_PROTOCOL_CANOPEN) {
+		return a.getBusHardwareId().equals(b.getBusHardwareId()) && a.getDeviceId() == b.getDeviceId();
+	}
+	return a.equals(b);
+}
+
 #ifndef DBOUT
+#ifdef _WIN32
 #define DBOUT( s )            \
 {                             \
    std::wostringstream os_;    \
    os_ << s;                   \
    OutputDebugStringW( os_.str().c_str() );  \
 }
+#else
+//OutputDebugString only exists on Windows
+#define DBOUT( s )
+#endif
 #endif
 
-Controller::Controller() {
+Controller::Controller() :
+	sessionProfilePath_(SessionProfile::DefaultPath()),
+	axis_(nullptr),
+	probePeriodMs_(0)
+{
 	// its possible to set the logging level to a different level
 	nanolibHelper_.setLoggingLevel(nlc::LogLevel::Error);
+	nanolibHelper_.setPerfStats(&perf_);
 
-	powerSM_ = std::make_unique<PowerSM>(&nanolibHelper_, &connectedDeviceHandle_);
+	telemetry_ = std::make_unique<Telemetry>(&nanolibHelper_);
+	jobs_ = std::make_unique<JobManager>();
+	discovery_ = std::make_unique<Discovery>();
+
+	//axis 0 is there from the start, single axis callers never select one
+	axes_[0] = std::make_unique<Axis>(0, &nanolibHelper_, &busExecutor_);
+	axis_ = axes_[0].get();
 }
 
 Controller::~Controller() {
-	
-	if (openedBusHardware_.has_value() && connectedDeviceHandle_.has_value()) {
-		powerSM_->Shutdown();
-	}
+	//no thread may be joined from here, the members leave the ones Shutdown did not stop to the unload
+	if (openedBusHardware_.has_value())
+		ReleaseHardware();
+}
 
-	// Always finalize connected hardware
-	if (connectedDeviceHandle_.has_value()) {
-		//"Disconnecting the device."
-		nanolibHelper_.disconnectDevice(connectedDeviceHandle_.value());
+void Controller::ReleaseHardware() {
+	for (auto& [id, axis] : axes_) {
+		if (!axis->deviceHandle.has_value())
+			continue;
+		try {
+			axis->powerSM->DisableOperation();
+		}
+		catch (const nanolib_exception&) {
+			//disconnect anyway, nobody reads the errors anymore
+		}
+		try {
+			nanolibHelper_.disconnectDevice(*axis->deviceHandle);
+			nanolibHelper_.removeDevice(*axis->deviceHandle);
+		}
+		catch (const nanolib_exception&) {
+		}
 	}
-
-	if (openedBusHardware_.has_value()) {
-		//"Closing the hardware bus."
-		nanolibHelper_.closeBusHardware(openedBusHardware_.value());
+	try {
+		nanolibHelper_.closeBusHardware(*openedBusHardware_);
 	}
+	catch (const nanolib_exception&) {
+	}
+	openedBusHardware_.reset();
+}
+
+int Controller::Shutdown() {
+	//discovery workers use the bus thread as well
+	discovery_->Stop();
+
+	//jobs use the bus thread, let them finish while it is still there
+	jobs_->Stop();
+
+	//closing the port stops the sampler, the set points and the probes of every connected axis,
+	//without a device none of them runs
+	const int result = Execute([this] {
+		return openedBusHardware_.has_value() ? ClosePort() : EXIT_SUCCESS;
+	});
+
+	busExecutor_.Stop();
+	return result;
 }
 
 //***GENERALS***
 
 int Controller::CheckConnection() {
-	if (!openedBusHardware_.has_value() || !connectedDeviceHandle_.has_value()) {
+	if (!openedBusHardware_.has_value() || !axis_->deviceHandle.has_value()) {
 		throw nanolib_exception("No connected device");
 		return EXIT_FAILURE;
 	}
-	if (nanolibHelper_.checkedResult("getDeviceState", nanolibHelper_->getConnectionState(*connectedDeviceHandle_)).getResult() != nlc::DeviceConnectionStateInfo::Connected) {
+	//cached state, NanoLib is only asked after a transport error
+	if (!axis_->connectionMonitor->IsConnected(*axis_->deviceHandle)) {
 		throw nanolib_exception("No connected device");
 		return EXIT_FAILURE;
 	}
@@ -59,26 +123,36 @@ int Controller::CheckConnection() {
 
 int Controller::ClosePort() {
 	try {
-		CheckConnection();
-		powerSM_->DisableOperation();
-
-		// Always finalize connected hardware
-
-		if (connectedDeviceHandle_.has_value()) {
-			//"Disconnecting the device."
-			nanolibHelper_.disconnectDevice(*connectedDeviceHandle_);
-			nanolibHelper_.removeDevice(*connectedDeviceHandle_);
-			connectedDeviceHandle_.reset();
+		if (!openedBusHardware_.has_value()) {
+			throw nanolib_exception("No Port opened");
+			return EXIT_FAILURE;
 		}
 
-		if (openedBusHardware_.has_value()) {
-			//"Closing the hardware bus."
-			nanolibHelper_.closeBusHardware(*openedBusHardware_);
-			openedBusHardware_.reset();
+		// Always finalize connected hardware
+		for (auto& [id, axis] : axes_) {
+			//a bus probe works on another bus and keeps running
+			jobs_->CancelOwnedBy(id);
+			if (axis->deviceHandle.has_value()) {
+				OnAxis(axis.get(), [this] {
+					try {
+						axis_->powerSM->DisableOperation();
+					}
+					catch (const nanolib_exception& e) {
+						//disconnect anyway
+						RecordException(e);
+					}
+					//"Disconnecting the device."
+					ReleaseDevice();
+					return EXIT_SUCCESS;
+				});
+			}
 		}
+		//"Closing the hardware bus."
+		nanolibHelper_.closeBusHardware(*openedBusHardware_);
+		openedBusHardware_.reset();
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
@@ -87,10 +161,17 @@ int Controller::ClosePort() {
 int Controller::RebootDevice() {
 	try {
 		CheckConnection();
-		nanolibHelper_.checkedResult("rebootDevice", nanolibHelper_->rebootDevice(*connectedDeviceHandle_));
+		jobs_->CancelOwnedBy(axis_->id);
+		if (telemetry_->IsRunningOn(*axis_->deviceHandle))
+			telemetry_->Stop();
+		StopFeeder();
+		nanolibHelper_.checkedResult("rebootDevice", nanolibHelper_->rebootDevice(*axis_->deviceHandle));
+		//device starts over with a cleared controlword and its saved mode
+		axis_->powerSM->GetControlWord().Invalidate();
+		axis_->activeMode.reset();
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
@@ -99,19 +180,34 @@ int Controller::RebootDevice() {
 int Controller::GetDeviceFirmwareBuildId(std::string& version) {
 	try {
 		CheckConnection();
-		version = nanolibHelper_.checkedResult("getDeviceFirmwareBuildId", nanolibHelper_->getDeviceFirmwareBuildId(*connectedDeviceHandle_)).getResult();
+		version = nanolibHelper_.checkedResult("getDeviceFirmwareBuildId", nanolibHelper_->getDeviceFirmwareBuildId(*axis_->deviceHandle)).getResult();
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
 
+void Controller::RecordException(const nanolib_exception& e) {
+	//bus errors make the cached connection state unreliable
+	axis_->connectionMonitor->OnError(e.getErrorCode());
+	errors_.Add(e, axis_->id);
+}
+
 int Controller::GetExceptions(std::vector<std::string>& exceptions) {
-	for (auto e : exceptions_)
-		exceptions.push_back(e.what());
+	exceptions = errors_.GetMessages();
+	return EXIT_SUCCESS;
+}
+
+int Controller::DrainErrors(uint64_t sinceSeq, std::vector<ErrorJournal::Record>& records, uint64_t& nextSeq, uint64_t& missed) {
+	nextSeq = errors_.Drain(sinceSeq, records, missed);
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetErrorStats(uint64_t& recorded, uint64_t& dropped) {
+	errors_.GetStats(recorded, dropped);
 	return EXIT_SUCCESS;
 }
 
@@ -139,7 +235,7 @@ int Controller::GetAvailablePorts(std::vector<std::string>& ports) {
 	}
 
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
@@ -147,6 +243,10 @@ int Controller::GetAvailablePorts(std::vector<std::string>& ports) {
 
 int Controller::OpenPort(uint32_t portToOpen) {
 	try {
+		//the buses are opened by the discovery workers or the probe
+		if (discovery_->IsRunning() || IsBusProbeRunning()) {
+			throw nanolib_exception("can't open port: discovery or bus probe is running");
+		}
 		if (openedBusHardware_.has_value()) {
 			ClosePort();
 		}
@@ -169,628 +269,2130 @@ int Controller::OpenPort(uint32_t portToOpen) {
 		nlc::BusHardwareId busHwId = busHardwareIds[portToOpen];
 
 		// create bus hardware options for opening the hardware
-		nlc::BusHardwareOptions busHwOptions = nanolibHelper_.createBusHardwareOptions(busHwId);
+		nlc::BusHardwareOptions busHwOptions = nanolibHelper_.createBusHardwareOptions(busHwId, busOptions_);
 		// now able to open the hardware itself
 		nanolibHelper_.openBusHardware(busHwId, busHwOptions);
 		openedBusHardware_ = busHwId;
+		//saved with the first device connected on it
+		session_ = SessionProfile{ busHwId, busHwOptions, {} };
+
+	}
+
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+
+int Controller::ScanBus(std::vector<std::string>& devices) {
+	try {
+		if (!openedBusHardware_.has_value()) {
+			throw nanolib_exception("No Port opened");
+			return EXIT_FAILURE;
+		}
+		// Scan the bus for available devices
+		const ScanCache::Entry& scan = ScanOpenedBus(true);
+
+		devices.clear();
+
+		for (int i = 0; i < scan.devices.size(); i++) {
+			std::stringstream ss;
+			ss << i << ". " << scan.devices[i].getDescription();
+			devices.push_back(ss.str());
+		}
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::ConnectDevice(uint32_t deviceToOpen) {
+	try {
+		if (!openedBusHardware_.has_value()) {
+			throw(nanolib_exception("can't connect: no port opened."));
+			return EXIT_FAILURE;
+		}
+		//the indices are the ones of the last scan of this bus, only scan if there was none
+		ConnectScannedDevice(ScanOpenedBus(false).generation, deviceToOpen);
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int Controller::ConnectDeviceOfScan(uint32_t generation, uint32_t deviceToOpen) {
+	try {
+		if (!openedBusHardware_.has_value()) {
+			throw(nanolib_exception("can't connect: no port opened."));
+			return EXIT_FAILURE;
+		}
+		ConnectScannedDevice(generation, deviceToOpen);
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+void Controller::ConnectScannedDevice(uint32_t generation, uint32_t deviceToOpen) {
+	const ScanCache::Entry* scan = scanCache_.Find(*openedBusHardware_);
+	if (scan == nullptr || scan->generation != generation)
+		throw nanolib_exception(std::format("scan {} is outdated, scan the bus again", generation), nlc::NlcErrorCode::InvalidOperation);
+	if (deviceToOpen >= scan->devices.size()) {
+		throw(nanolib_exception("Invalid bus hardware number."));
+	}
+	//copied, a rescan below replaces the list
+	const nlc::DeviceId deviceId = scan->devices[deviceToOpen];
+
+	if (axis_->deviceHandle.has_value()) {
+		DisconnectDevice();
+	}
+	if (const Axis* axis = AxisConnectedTo(deviceId)) {
+		throw nanolib_exception(std::format("device {} is already connected as axis {}", deviceToOpen, axis->id));
+	}
+
+	nlc::DeviceHandle deviceHandle;
+	try {
+		deviceHandle = AttachDevice(deviceId);
+	}
+	catch (const nanolib_exception&) {
+		//a CANopen node answers under its node id, probing it is a single connect instead of walking all 127 ids;
+		//taken only if it is the device connected there before, anything else might be another device on the node
+		const auto known = scan->identities.find(deviceId.getDeviceId());
+		if (openedBusHardware_->getProtocol() == nlc::BUS_HARDWARE_ID_PROTOCOL_CANOPEN && known != scan->identities.end()) {
+			const DeviceIdentity identity = known->second;
+			const nlc::DeviceId nodeDeviceId = NodeDeviceId(deviceId.getDeviceId());
+			if (std::optional<nlc::DeviceHandle> probed = ProbeDevice(nodeDeviceId)) {
+				bool same = false;
+				try {
+					same = DeviceIdentity::Read(nanolibHelper_, *probed) == identity;
+				}
+				catch (const nanolib_exception&) {
+				}
+				if (same) {
+					AdoptDevice(*probed, nodeDeviceId);
+					return;
+				}
+				nanolibHelper_.disconnectDevice(*probed);
+				nanolibHelper_.removeDevice(*probed);
+			}
+		}
+		//the cached id may be stale (device replaced or moved), scan once more and look for the same device
+		const ScanCache::Entry& rescan = ScanOpenedBus(true);
+		auto it = std::find_if(rescan.devices.begin(), rescan.devices.end(), [&deviceId](const nlc::DeviceId& found) { return SameDevice(found, deviceId); });
+		if (it == rescan.devices.end())
+			throw nanolib_exception(std::format("device {} is no longer on the bus", deviceId.getDescription()), nlc::NlcErrorCode::ResourceNotFound);
+		deviceHandle = AttachDevice(*it);
+	}
+	AdoptDevice(deviceHandle, deviceId);
+
+	//for the probe above on the next connect of this device
+	try {
+		scanCache_.StoreIdentity(*openedBusHardware_, deviceId.getDeviceId(), DeviceIdentity::Read(nanolibHelper_, deviceHandle));
+	}
+	catch (const nanolib_exception&) {
+		//connected anyway, a failed connect later rescans instead of probing
+	}
+}
+
+void Controller::AdoptDevice(const nlc::DeviceHandle& deviceHandle, const nlc::DeviceId& deviceId) {
+	//type, length and access of the objects, from the assigned object dictionary if there is one
+	nanolibHelper_.loadObjectMetadata(deviceHandle);
+
+	axis_->deviceHandle = deviceHandle;
+	axis_->deviceId = deviceId;
+	axis_->activeMode.reset();
+	axis_->connectionMonitor->OnConnected(deviceHandle);
+	SaveSession(deviceId);
+
+	//seed the controlword shadow once, every later edit is a single write
+	axis_->powerSM->GetControlWord().Seed();
+}
+
+void Controller::SaveSession(const nlc::DeviceId& deviceId) {
+	if (!session_.has_value())
+		return;
+	auto it = session_->devices.find(axis_->id);
+	if (it != session_->devices.end() && SameDevice(it->second, deviceId))
+		return;
+	session_->devices[axis_->id] = deviceId;
+	try {
+		session_->Save(sessionProfilePath_);
+	}
+	catch (const nanolib_exception& e) {
+		//the device is connected, only the next OpenLastSession will miss it
+		RecordException(e);
+	}
+}
+
+int Controller::OpenLastSession(double& loadMs, double& openMs, double& connectMs) {
+	try {
+		//the buses are opened by the discovery workers or the probe
+		if (discovery_->IsRunning() || IsBusProbeRunning()) {
+			throw nanolib_exception("can't open port: discovery or bus probe is running");
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		auto lap = [&start] {
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			const double ms = std::chrono::duration<double, std::milli>(now - start).count();
+			start = now;
+			return ms;
+		};
+		loadMs = 0.0;
+		openMs = 0.0;
+		connectMs = 0.0;
+
+		const SessionProfile profile = SessionProfile::Load(sessionProfilePath_);
+		loadMs = lap();
+
+		if (openedBusHardware_.has_value()) {
+			ClosePort();
+		}
+		//no listing of the bus hardware, the profile has the id and the options
+		nanolibHelper_.openBusHardware(profile.busHardwareId, profile.busHardwareOptions);
+		openedBusHardware_ = profile.busHardwareId;
+		//devices that fail to connect below stay in the profile for the next time
+		session_ = profile;
+		openMs = lap();
+
+		//no scan, the device ids are connected as they are
+		size_t failedAxes = 0;
+		for (const auto& [axisId, deviceId] : profile.devices) {
+			try {
+				OnAxis(AddAxis(axisId), [&] {
+					AdoptDevice(AttachDevice(deviceId), deviceId);
+					return EXIT_SUCCESS;
+				});
+			}
+			catch (const nanolib_exception& e) {
+				//journaled for the axis that failed, the remaining axes are connected anyway
+				errors_.Add(e, axisId);
+				failedAxes++;
+			}
+		}
+		connectMs = lap();
+
+		if (failedAxes > 0) {
+			throw nanolib_exception(std::format("{} of {} axes of the last session not connected", failedAxes, profile.devices.size()));
+		}
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::SetSessionProfilePath(const std::string& path) {
+	sessionProfilePath_ = path.empty() ? SessionProfile::DefaultPath() : std::filesystem::path(path);
+	return EXIT_SUCCESS;
+}
+
+int Controller::UseAccessor(nlc::NanoLibAccessor* accessor) {
+	try {
+		if (openedBusHardware_.has_value()) {
+			throw nanolib_exception("can't change the accessor: close the port first");
+		}
+		//discovery and the probe use the accessor from their own threads
+		if (discovery_->IsRunning() || IsBusProbeRunning()) {
+			throw nanolib_exception("can't change the accessor: discovery or bus probe is running");
+		}
+		nanolibHelper_.setAccessor(accessor);
+		//the devices found belong to the other bus
+		scanCache_.InvalidateAll();
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+const Axis* Controller::AxisConnectedTo(const nlc::DeviceId& deviceId) const {
+	for (const auto& [id, axis] : axes_) {
+		if (axis.get() != axis_ && axis->deviceId.has_value() && SameDevice(*axis->deviceId, deviceId))
+			return axis.get();
+	}
+	return nullptr;
+}
+
+//stops the scan at the first device match accepts, scans the whole bus without match
+class FindDeviceCallback : public nlc::NlcScanBusCallback {
+public:
+	explicit FindDeviceCallback(std::function<bool(const nlc::DeviceId&)> match) : match_(std::move(match)) {}
+
+	nlc::ResultVoid callback(nlc::BusScanInfo info, std::vector<nlc::DeviceId> const& devicesFound, int32_t data) override {
+		(void)data;
+		//devicesFound holds everything found so far, the new device is the last one
+		if (info == nlc::BusScanInfo::FoundDevice && match_ && !devicesFound.empty() && match_(devicesFound.back())) {
+			found_ = devicesFound;
+			return nlc::ResultVoid(nlc::NlcErrorCode::OperationAborted, "device found");
+		}
+		return nlc::ResultVoid();
+	}
+
+	//devices up to the match, empty if the scan ran to the end
+	const std::vector<nlc::DeviceId>& GetFound() const { return found_; }
+
+private:
+	std::function<bool(const nlc::DeviceId&)> match_;
+	std::vector<nlc::DeviceId> found_;
+};
+
+int Controller::FindDevice(uint32_t nodeId, const std::string& serialNumber, uint32_t& nodeIdFound) {
+	try {
+		if (!openedBusHardware_.has_value()) {
+			throw(nanolib_exception("can't connect: no port opened."));
+			return EXIT_FAILURE;
+		}
+		if (nodeId == 0 && serialNumber.empty()) {
+			throw nanolib_exception("can't find device: neither node id nor serial number given");
+		}
+		if (axis_->deviceHandle.has_value()) {
+			DisconnectDevice();
+		}
+
+		auto matches = [nodeId](const nlc::DeviceId& deviceId) { return nodeId == 0 || deviceId.getDeviceId() == nodeId; };
+
+		//no scan at all if the device is where the last scan saw it
+		std::vector<nlc::DeviceId> candidates;
+		if (const ScanCache::Entry* scan = scanCache_.Find(*openedBusHardware_)) {
+			std::copy_if(scan->devices.begin(), scan->devices.end(), std::back_inserter(candidates), matches);
+		}
+		//a CANopen node answers under its node id, probing it is a single connect instead of walking all 127 ids
+		if (candidates.empty() && nodeId != 0 && openedBusHardware_->getProtocol() == nlc::BUS_HARDWARE_ID_PROTOCOL_CANOPEN) {
+			candidates.push_back(NodeDeviceId(nodeId));
+		}
+		std::optional<nlc::DeviceId> deviceId = ConnectFirstMatch(candidates, serialNumber, {});
+
+		if (!deviceId.has_value()) {
+			//with a node id the scan ends at that node, a serial number alone needs the whole bus
+			FindDeviceCallback callback(nodeId != 0 ? std::function<bool(const nlc::DeviceId&)>(matches) : nullptr);
+			std::vector<nlc::DeviceId> found;
+			try {
+				found = nanolibHelper_.scanBus(*openedBusHardware_, &callback);
+				scanCache_.Store(*openedBusHardware_, found);
+			}
+			catch (const nanolib_exception&) {
+				if (callback.GetFound().empty())
+					throw;
+				//aborted by the callback, a partial scan is not cached
+				found = callback.GetFound();
+			}
+			std::vector<nlc::DeviceId> rescanned;
+			std::copy_if(found.begin(), found.end(), std::back_inserter(rescanned), matches);
+			deviceId = ConnectFirstMatch(rescanned, serialNumber, candidates);
+		}
+
+		if (!deviceId.has_value()) {
+			throw nanolib_exception(std::format("no device with node id {} and serial number '{}' on the bus", nodeId, serialNumber), nlc::NlcErrorCode::ResourceNotFound);
+		}
+		nodeIdFound = deviceId->getDeviceId();
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+std::optional<nlc::DeviceId> Controller::ConnectFirstMatch(const std::vector<nlc::DeviceId>& candidates, const std::string& serialNumber,
+	const std::vector<nlc::DeviceId>& tried) {
+	for (const nlc::DeviceId& deviceId : candidates) {
+		auto same = [&deviceId](const nlc::DeviceId& other) { return SameDevice(other, deviceId); };
+		if (AxisConnectedTo(deviceId) != nullptr || std::any_of(tried.begin(), tried.end(), same))
+			continue;
+
+		std::optional<nlc::DeviceHandle> probed = ProbeDevice(deviceId);
+		if (!probed.has_value()) {
+			//not there or not answering, try the next one
+			continue;
+		}
+		const nlc::DeviceHandle deviceHandle = *probed;
+
+		bool wanted = true;
+		if (!serialNumber.empty()) {
+			try {
+				wanted = nanolibHelper_.getDeviceSerialNumber(deviceHandle) == serialNumber;
+			}
+			catch (const nanolib_exception&) {
+				wanted = false;
+			}
+		}
+		if (!wanted) {
+			nanolibHelper_.disconnectDevice(deviceHandle);
+			nanolibHelper_.removeDevice(deviceHandle);
+			continue;
+		}
+		AdoptDevice(deviceHandle, deviceId);
+		return deviceId;
+	}
+	return std::nullopt;
+}
+
+nlc::DeviceHandle Controller::AttachDevice(const nlc::DeviceId& deviceId) {
+	// Register the device id
+	nlc::DeviceHandle deviceHandle = nanolibHelper_.addDevice(deviceId);
+	try {
+		// Establishing a connection with the device
+		nanolibHelper_.connectDevice(deviceHandle);
+	}
+	catch (const nanolib_exception&) {
+		nanolibHelper_.removeDevice(deviceHandle);
+		throw;
+	}
+	return deviceHandle;
+}
+
+std::optional<nlc::DeviceHandle> Controller::ProbeDevice(const nlc::DeviceId& deviceId) {
+	nlc::DeviceHandle deviceHandle;
+	try {
+		deviceHandle = AttachDevice(deviceId);
+	}
+	catch (const nanolib_exception&) {
+		return std::nullopt;
+	}
+	try {
+		//a connect alone can succeed without the node answering
+		nanolibHelper_.readInteger(deviceHandle, DeviceIdentity::kDeviceType);
+	}
+	catch (const nanolib_exception&) {
+		nanolibHelper_.disconnectDevice(deviceHandle);
+		nanolibHelper_.removeDevice(deviceHandle);
+		return std::nullopt;
+	}
+	return deviceHandle;
+}
+
+nlc::DeviceId Controller::NodeDeviceId(uint32_t nodeId) const {
+	//no description, a made up one would show up as the device's in the session profile; see SameDevice
+	return nlc::DeviceId(*openedBusHardware_, nodeId, "");
+}
+
+const ScanCache::Entry& Controller::ScanOpenedBus(bool rescan) {
+	const ScanCache::Entry* scan = scanCache_.Find(*openedBusHardware_);
+	if (scan == nullptr || rescan) {
+		scanCache_.Store(*openedBusHardware_, nanolibHelper_.scanBus(*openedBusHardware_));
+		scan = scanCache_.Find(*openedBusHardware_);
+	}
+	return *scan;
+}
+
+int Controller::InvalidateScanCache() {
+	scanCache_.InvalidateAll();
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetScanInfo(uint32_t& generation, uint32_t& deviceCount, double& ageMs) {
+	try {
+		if (!openedBusHardware_.has_value()) {
+			throw nanolib_exception("No Port opened");
+			return EXIT_FAILURE;
+		}
+		const ScanCache::Entry* scan = scanCache_.Find(*openedBusHardware_);
+		if (scan == nullptr) {
+			//not scanned, nothing to connect from yet
+			generation = scanCache_.GetGeneration();
+			deviceCount = 0;
+			ageMs = -1.0;
+			return EXIT_SUCCESS;
+		}
+		generation = scan->generation;
+		deviceCount = static_cast<uint32_t>(scan->devices.size());
+		ageMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - scan->scanned).count();
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+//devices of a scan for the discovery table, serialNumber may be empty to skip reading it
+static std::vector<Discovery::Device> ToDiscoveredDevices(const std::vector<nlc::DeviceId>& deviceIds,
+	const std::function<std::string(const nlc::DeviceId&)>& serialNumber) {
+	std::vector<Discovery::Device> devices;
+	for (uint32_t i = 0; i < deviceIds.size(); i++) {
+		Discovery::Device device;
+		device.index = i;
+		device.nodeId = deviceIds[i].getDeviceId();
+		device.description = deviceIds[i].getDescription();
+		if (serialNumber) {
+			try {
+				device.serialNumber = serialNumber(deviceIds[i]);
+			}
+			catch (const nanolib_exception&) {
+				//the device stays in the table without it
+			}
+		}
+		devices.push_back(std::move(device));
+	}
+	return devices;
+}
+
+int Controller::StartDiscovery(bool readSerialNumbers) {
+	try {
+		std::vector<nlc::BusHardwareId> busHardwareIds = nanolibHelper_.getBusHardware();
+		if (busHardwareIds.empty()) {
+			throw nanolib_exception("No bus found");
+		}
+
+		if (IsBusProbeRunning()) {
+			throw nanolib_exception("can't start discovery: bus probe is running");
+		}
+
+		std::optional<nlc::BusHardwareId> opened = openedBusHardware_;
+		Discovery::Scan scan = [this, opened, busOptions = busOptions_, readSerialNumbers](const nlc::BusHardwareId& busHwId, nlc::NlcScanBusCallback* callback) {
+			if (opened.has_value() && opened->equals(busHwId))
+				return DiscoverOpenedBus(busHwId, callback, readSerialNumbers);
+			return DiscoverBus(busHwId, busOptions, callback, readSerialNumbers);
+		};
+		if (!discovery_->Start(busHardwareIds, std::move(scan))) {
+			throw nanolib_exception("discovery is already running");
+		}
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+std::vector<Discovery::Device> Controller::DiscoverOpenedBus(const nlc::BusHardwareId& busHwId, nlc::NlcScanBusCallback* callback, bool readSerialNumbers) {
+	std::vector<Discovery::Device> devices;
+	std::optional<nanolib_exception> error;
+	//the axes use this bus, so its scan takes its turn on the bus thread like ScanBus
+	Execute([&] {
+		try {
+			if (!openedBusHardware_.has_value() || !openedBusHardware_->equals(busHwId)) {
+				throw nanolib_exception("port was closed during discovery");
+			}
+			scanCache_.Store(busHwId, nanolibHelper_.scanBus(busHwId, callback));
+			std::function<std::string(const nlc::DeviceId&)> serialNumber;
+			if (readSerialNumbers) {
+				serialNumber = [this](const nlc::DeviceId& deviceId) {
+					//connected devices can't be added a second time
+					for (const auto& [id, axis] : axes_) {
+						if (axis->deviceId.has_value() && SameDevice(*axis->deviceId, deviceId))
+							return nanolibHelper_.getDeviceSerialNumber(*axis->deviceHandle);
+					}
+					return nanolibHelper_.readSerialNumber(deviceId);
+				};
+			}
+			devices = ToDiscoveredDevices(scanCache_.Find(busHwId)->devices, serialNumber);
+		}
+		catch (const nanolib_exception& e) {
+			error = e;
+		}
+		return EXIT_SUCCESS;
+	});
+	if (error.has_value())
+		throw *error;
+	return devices;
+}
+
+std::vector<Discovery::Device> Controller::DiscoverBus(const nlc::BusHardwareId& busHwId, const std::map<std::string, std::string>& busOptions,
+	nlc::NlcScanBusCallback* callback, bool readSerialNumbers) {
+	nlc::BusHardwareOptions busHwOptions = nanolibHelper_.createBusHardwareOptions(busHwId, busOptions);
+	nanolibHelper_.openBusHardware(busHwId, busHwOptions);
+
+	std::vector<nlc::DeviceId> deviceIds;
+	std::vector<Discovery::Device> devices;
+	try {
+		deviceIds = nanolibHelper_.scanBus(busHwId, callback);
+		std::function<std::string(const nlc::DeviceId&)> serialNumber;
+		if (readSerialNumbers) {
+			serialNumber = [this](const nlc::DeviceId& deviceId) { return nanolibHelper_.readSerialNumber(deviceId); };
+		}
+		devices = ToDiscoveredDevices(deviceIds, serialNumber);
+	}
+	catch (const nanolib_exception&) {
+		nanolibHelper_.closeBusHardware(busHwId);
+		throw;
+	}
+	nanolibHelper_.closeBusHardware(busHwId);
 
+	//the cache belongs to the bus thread, a later OpenPort of this bus connects from it without scanning
+	Post([this, busHwId, deviceIds] {
+		scanCache_.Store(busHwId, deviceIds);
+		return EXIT_SUCCESS;
+	});
+	return devices;
+}
+
+//***BUS OPTIONS***
+
+int Controller::SetBusOption(const std::string& name, const std::string& value) {
+	try {
+		if (!NanoLibHelper::isBusHardwareOptionName(name)) {
+			throw nanolib_exception(std::format("unknown bus option '{}'", name), nlc::NlcErrorCode::InvalidArguments);
+		}
+		if (value.empty()) {
+			busOptions_.erase(name);
+		}
+		else {
+			busOptions_[name] = value;
+		}
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetBusOptions(uint32_t port, std::vector<std::string>& names, std::vector<std::string>& values) {
+	try {
+		std::vector<nlc::BusHardwareId> busHardwareIds = nanolibHelper_.getBusHardware();
+		if (port >= busHardwareIds.size()) {
+			throw nanolib_exception("Invalid bus hardware number.", nlc::NlcErrorCode::InvalidArguments);
+		}
+
+		names.clear();
+		values.clear();
+		for (const auto& [name, value] : nanolibHelper_.createBusHardwareOptions(busHardwareIds[port], busOptions_).getOptions()) {
+			names.push_back(name);
+			values.push_back(value);
+		}
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::StartBusProbeAsync(uint32_t port, uint32_t nodeId, uint32_t roundTrips, bool applyRecommended, uint32_t& jobId) {
+	try {
+		if (discovery_->IsRunning() || IsBusProbeRunning()) {
+			throw nanolib_exception("can't probe: discovery or bus probe is running");
+		}
+		std::vector<nlc::BusHardwareId> busHardwareIds = nanolibHelper_.getBusHardware();
+		if (port >= busHardwareIds.size()) {
+			throw nanolib_exception("Invalid bus hardware number.", nlc::NlcErrorCode::InvalidArguments);
+		}
+		const nlc::BusHardwareId busHwId = busHardwareIds[port];
+		if (openedBusHardware_.has_value() && openedBusHardware_->equals(busHwId)) {
+			throw nanolib_exception("can't probe the opened port, close it first");
+		}
+
+		//options the probe does not vary stay as OpenPort would set them
+		std::vector<BusProbe::Setting> settings = BusProbe::Candidates(busHwId, nanolibHelper_.createBusHardwareOptions(busHwId, busOptions_).getOptions());
+		if (settings.empty()) {
+			throw nanolib_exception(std::format("{} has no baud rate to probe", busHwId.getName()), nlc::NlcErrorCode::OperationNotSupported);
+		}
+		roundTrips = std::max(roundTrips, 1u);
+
+		{
+			std::lock_guard<std::mutex> lock(busProbeMutex_);
+			busProbeResults_.clear();
+			busProbeRecommended_ = -1;
+		}
+
+		//the bus is not open, so the probe does not need the bus thread until it applies the result
+		jobId = jobs_->Start([this, busHwId, settings, nodeId, roundTrips, applyRecommended](JobContext& job) {
+			BusProbe probe(&nanolibHelper_);
+			std::vector<BusProbe::Result> results;
+			for (size_t i = 0; i < settings.size(); i++) {
+				if (job.IsCancelled())
+					return JobState::Cancelled;
+				results.push_back(probe.Measure(busHwId, settings[i], nodeId, roundTrips));
+				{
+					std::lock_guard<std::mutex> lock(busProbeMutex_);
+					busProbeResults_ = results;
+				}
+				job.SetProgress(static_cast<int32_t>((i + 1) * 100 / settings.size()));
+			}
+
+			const int32_t recommended = BusProbe::Recommend(results);
+			{
+				std::lock_guard<std::mutex> lock(busProbeMutex_);
+				busProbeRecommended_ = recommended;
+			}
+			if (recommended < 0) {
+				RecordJobError("Bus probe: no setting answered without errors");
+				return JobState::Failed;
+			}
+			if (applyRecommended) {
+				Execute([&] {
+					for (const auto& [name, value] : results[recommended].setting.options)
+						busOptions_[name] = value;
+					return EXIT_SUCCESS;
+				});
+			}
+			return JobState::Succeeded;
+		}, kBusJobOwner);
+		busProbeJobId_ = jobId;
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetBusProbeResults(std::vector<BusProbe::Result>& results, int32_t& recommended) {
+	std::lock_guard<std::mutex> lock(busProbeMutex_);
+	results = busProbeResults_;
+	recommended = busProbeRecommended_;
+	return EXIT_SUCCESS;
+}
+
+bool Controller::IsBusProbeRunning() {
+	int32_t progress;
+	JobState state;
+	//finished jobs are pruned eventually, an unknown id is finished as well
+	return busProbeJobId_ != 0 && jobs_->Poll(busProbeJobId_, progress, state) && !JobManager::IsFinished(state);
+}
+
+int Controller::CancelDiscovery() {
+	discovery_->Cancel();
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetDiscoveryState(bool& running, uint32_t& busesTotal, uint32_t& busesDone) {
+	running = discovery_->IsRunning();
+	discovery_->GetProgress(busesTotal, busesDone);
+	return EXIT_SUCCESS;
+}
+
+int Controller::ReadDiscoveryEvent(bool& available, int32_t& type, uint32_t& bus, int32_t& value, std::string& text) {
+	Discovery::Event event;
+	available = discovery_->PopEvent(event);
+	if (available) {
+		type = static_cast<int32_t>(event.type);
+		bus = event.bus;
+		value = event.value;
+		text = event.text;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetDiscoveredDevices(std::vector<Discovery::Device>& devices) {
+	devices = discovery_->GetDevices();
+	return EXIT_SUCCESS;
+}
+
+int Controller::DisconnectDevice() {
+	try {
+		CheckConnection();
+		ReleaseDevice();
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+void Controller::ReleaseDevice() {
+	const nlc::DeviceHandle deviceHandle = *axis_->deviceHandle;
+	jobs_->CancelOwnedBy(axis_->id);
+	if (telemetry_->IsRunningOn(deviceHandle))
+		telemetry_->Stop();
+	StopFeeder();
+	axis_->connectionMonitor->OnDisconnected();
+	axis_->deviceHandle.reset();
+	axis_->deviceId.reset();
+	axis_->powerSM->GetControlWord().Invalidate();
+	axis_->activeMode.reset();
+	nanolibHelper_.disconnectDevice(deviceHandle);
+	nanolibHelper_.removeDevice(deviceHandle);
+	nanolibHelper_.forgetObjectMetadata(deviceHandle);
+}
+
+//***AXES***
+
+Axis* Controller::FindAxis(uint32_t axisId) {
+	auto it = axes_.find(axisId);
+	return it == axes_.end() ? nullptr : it->second.get();
+}
+
+int Controller::UnknownAxis(uint32_t axisId) {
+	RecordException(nanolib_exception(std::format("unknown axis {}", axisId), nlc::NlcErrorCode::InvalidArguments));
+	return EXIT_FAILURE;
+}
+
+int Controller::ConnectAxis(uint32_t axisId, uint32_t deviceToOpen) {
+	Axis* axis;
+	try {
+		axis = AddAxis(axisId);
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return OnAxis(axis, [&] { return ConnectDevice(deviceToOpen); });
+}
+
+Axis* Controller::AddAxis(uint32_t axisId) {
+	if (axisId >= kMaxAxes) {
+		throw nanolib_exception(std::format("axis id {} out of range, {} axes at most", axisId, kMaxAxes), nlc::NlcErrorCode::InvalidArguments);
+	}
+	std::unique_ptr<Axis>& axis = axes_[axisId];
+	if (!axis) {
+		axis = std::make_unique<Axis>(axisId, &nanolibHelper_, &busExecutor_);
+		axis->connectionMonitor->SetProbePeriod(probePeriodMs_);
+	}
+	return axis.get();
+}
+
+int Controller::ConnectAxes(const std::vector<uint32_t>& devicesToOpen) {
+	try {
+		if (!openedBusHardware_.has_value()) {
+			throw(nanolib_exception("can't connect: no port opened."));
+			return EXIT_FAILURE;
+		}
+		//one scan for all axes
+		ScanOpenedBus(false);
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+
+	for (uint32_t axisId = 0; axisId < devicesToOpen.size(); axisId++) {
+		if (ConnectAxis(axisId, devicesToOpen[axisId]))
+			return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::SelectAxis(uint32_t axisId) {
+	Axis* axis = FindAxis(axisId);
+	if (axis == nullptr)
+		return UnknownAxis(axisId);
+	axis_ = axis;
+	selectedAxisId_.store(axisId);
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetSelectedAxis(uint32_t& axisId) {
+	axisId = axis_->id;
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetConnectedAxes(std::vector<uint32_t>& axisIds) {
+	axisIds.clear();
+	for (const auto& [id, axis] : axes_) {
+		if (axis->deviceHandle.has_value())
+			axisIds.push_back(id);
+	}
+	return EXIT_SUCCESS;
+}
+
+void Controller::PostOnAxis(uint32_t axisId, std::function<int()> command, const std::source_location& where) {
+	Post([this, axisId, command = std::move(command)] {
+		Axis* axis = FindAxis(axisId);
+		if (axis == nullptr)
+			return UnknownAxis(axisId);
+		return OnAxis(axis, command);
+	}, where);
+}
+
+int Controller::SetMotorParameters(uint32_t polePairCount, uint32_t ratedCurrent, uint32_t maxCurrent,uint32_t maxCurrentDuration, uint32_t idleCurrent, uint32_t driveMode) {
+	try {
+		CheckConnection();
+		//take whichever motor for this
+		if (axis_->motor->SetMotorParameters(polePairCount, ratedCurrent, maxCurrent, maxCurrentDuration,idleCurrent, static_cast<Motor402::DriveMode>(driveMode)))
+			return EXIT_FAILURE;
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetMotorParameters(uint32_t& polePairCount, uint32_t& ratedCurrent, uint32_t& maxCurrent, uint32_t& maxCurrentTime, uint32_t &idleCurrent, uint32_t& driveMode) {
+	try{ 
+		CheckConnection();
+		Motor402::DriveMode driveMode_t;
+		axis_->motor->GetMotorParameters(polePairCount, ratedCurrent, maxCurrent, maxCurrentTime,idleCurrent, driveMode_t);
+		driveMode = driveMode_t;
+	}
+	catch (nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::Halt() {
+	try {
+		CheckConnection();
+		axis_->motor->Halt();
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+
+
+int Controller::GetDeviceErrorStack(std::vector<std::string>& errorStackStrings) {
+	try {
+		CheckConnection();
+		std::vector<int64_t> errorStack = nanolibHelper_.readArray(*axis_->deviceHandle, 0x1003);
+		uint8_t numberOfErrors = static_cast<uint8_t>(errorStack.at(0));
+		DBOUT("Elements in error stack: " << std::to_string(numberOfErrors).c_str() << std::endl);
+		for (size_t i = 1; i <= numberOfErrors; i++) {
+			uint32_t error = static_cast<uint32_t>(errorStack.at(i));
+
+			std::string errorString = std::string(std::format("Error Number: {} Code: {}", std::to_string(error >> 24), std::format("{:x}", error & 0xFFFF)));
+			DBOUT(errorString.c_str());
+			errorStackStrings.push_back(errorString);
+		}
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+
+
+}
+
+int Controller::QuickStop() {
+	try {
+		CheckConnection();
+		//set points would move the drive again once it is enabled
+		StopFeeder();
+		axis_->waypoints->Clear();
+		if (const uint32_t jobId = axis_->waypoints->GetJobId())
+			jobs_->Cancel(jobId);
+		//quick stop
+		if (axis_->powerSM->QuickStop())
+			return EXIT_FAILURE;
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetPositionActual(int32_t& position) {
+	try {
+		CheckConnection();
+		position = axis_->motor->GetPositionActual();
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+int Controller::SetUserUnitsFeed(uint32_t feedPer,uint32_t shaftRevolutions) {
+	try {
+		CheckConnection();
+		axis_->motor->SetUserUnitsFeed(feedPer,shaftRevolutions);
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetUserUnitsFeed(uint32_t& feedPer,uint32_t &shaftRevolutions) {
+	try {
+		CheckConnection();
+		const std::array<nlc::OdIndex, 2> odIndices{ { nlc::OdIndex(0x6092, 0x01), nlc::OdIndex(0x6092, 0x02) } };
+		std::vector<int64_t> values = nanolibHelper_.readMany(*axis_->deviceHandle, odIndices);
+		feedPer = static_cast<uint32_t>(values[0]);
+		shaftRevolutions = static_cast<uint32_t>(values[1]);
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+int Controller::GetUserUnitsGearRatio(uint32_t& gearRatioMotorRevs,uint32_t& gearRatioShaftRevs) {
+	try {
+		CheckConnection();
+		const std::array<nlc::OdIndex, 2> odIndices{ { nlc::OdIndex(0x6091, 0x01), nlc::OdIndex(0x6091, 0x02) } };
+		std::vector<int64_t> values = nanolibHelper_.readMany(*axis_->deviceHandle, odIndices);
+		gearRatioMotorRevs = static_cast<uint32_t>(values[0]);
+		gearRatioShaftRevs = static_cast<uint32_t>(values[1]);
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+//all user defined units in one go, no mode switch needed for reading
+int Controller::GetUserUnits(uint32_t& feed, uint32_t& shaftRevs, uint32_t& posUnit, uint32_t& posExp, uint32_t& velUnit, uint32_t& velExp, uint32_t& velTime, uint32_t& gearRatioMotorRevs, uint32_t& gearRatioShaftRevs) {
+	try {
+		CheckConnection();
+		const std::array<nlc::OdIndex, 6> odIndices{ {
+			nlc::OdIndex(0x6092, 0x01),
+			nlc::OdIndex(0x6092, 0x02),
+			nlc::OdIndex(0x60A8, 0x00),
+			nlc::OdIndex(0x60A9, 0x00),
+			nlc::OdIndex(0x6091, 0x01),
+			nlc::OdIndex(0x6091, 0x02)
+		} };
+		std::vector<int64_t> values = nanolibHelper_.readMany(*axis_->deviceHandle, odIndices);
+
+		feed = static_cast<uint32_t>(values[0]);
+		shaftRevs = static_cast<uint32_t>(values[1]);
+
+		uint32_t val = static_cast<uint32_t>(values[2]);
+		posExp = (val >> 24) & 0xff;
+		posUnit = (val >> 16) & 0xff;
+
+		val = static_cast<uint32_t>(values[3]);
+		velExp = (val >> 24) & 0xff;
+		velUnit = (val >> 16) & 0xff;
+		velTime = (val >> 8) & 0xff;
+
+		gearRatioMotorRevs = static_cast<uint32_t>(values[4]);
+		gearRatioShaftRevs = static_cast<uint32_t>(values[5]);
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+//read all 5 inputs
+int Controller::ReadDigitalInputs(uint8_t& states) {
+	try {
+		CheckConnection();
+		uint32_t uWord32 = static_cast<uint32_t>(nanolibHelper_.readValue(*axis_->deviceHandle, nlc::OdIndex(0x60FD, 0x00)));
+		states = (uWord32 >> 16) & 0xFF;
+
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+
+int Controller::ConfigureInputs() {
+	try {
+		CheckConnection();
+		uint32_t uWord32 = 0;
+		//set digital inputs to range 24V
+		uWord32 |= (1UL << 0);
+		uWord32 |= (1UL << 1);
+		nanolibHelper_.writeValue(*axis_->deviceHandle, uWord32, nlc::OdIndex(0x3240, 0x06));
+
+		//set opener logic
+		nanolibHelper_.writeValue(*axis_->deviceHandle, uWord32, nlc::OdIndex(0x3240, 0x02));
+
+		//set input 1 to negative
+		//set input 2 to positive endswitch
+		nanolibHelper_.writeValue(*axis_->deviceHandle, uWord32, nlc::OdIndex(0x3240, 0x01));
+		//Limit Switch Error Option Code
+		/*
+		keine Reaktion (um z. B. eine Referenzfahrt durchzufhren), auer
+		Vermerken der Endschalterposition
+		*/
+		nanolibHelper_.writeValue(*axis_->deviceHandle, -1, nlc::OdIndex(0x3701, 0x00));
+
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetModeOfOperation(std::string& mode) {
+	try {
+		CheckConnection();
+		Motor402::OperationMode opMode=static_cast<Motor402::OperationMode>(axis_->motor->GetModeOfOperation());
+		auto enum_name = magic_enum::enum_name(opMode);
+		mode = enum_name;
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::ResyncControlWord() {
+	try {
+		CheckConnection();
+		axis_->powerSM->GetControlWord().Resync();
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetControlWordStats(uint64_t& reads, uint64_t& writes, uint64_t& readsAvoided) {
+	const ControlWord::Stats& stats = axis_->powerSM->GetControlWord().GetStats();
+	reads = stats.reads;
+	writes = stats.writes;
+	readsAvoided = stats.readsAvoided;
+	return EXIT_SUCCESS;
+}
+
+int Controller::SetConnectionProbePeriod(uint32_t periodMs) {
+	probePeriodMs_ = periodMs;
+	for (auto& [id, axis] : axes_)
+		axis->connectionMonitor->SetProbePeriod(periodMs);
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetConnectionStats(uint64_t& checksAvoided, uint64_t& checksQueried, uint64_t& probes, uint64_t& transportErrors) {
+	ConnectionMonitor::Stats stats = axis_->connectionMonitor->GetStats();
+	checksAvoided = stats.checksAvoided;
+	checksQueried = stats.checksQueried;
+	probes = stats.probes;
+	transportErrors = stats.transportErrors;
+	return EXIT_SUCCESS;
+}
+
+int Controller::StartTelemetry(const std::vector<nlc::OdIndex>& objects, uint16_t periodMs) {
+	try {
+		CheckConnection();
+		telemetry_->Start(*axis_->deviceHandle, objects, periodMs);
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::StopTelemetry() {
+	try {
+		telemetry_->Stop();
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::DrainTelemetry(int64_t* rows, int32_t maxRows, int32_t& rowsCopied, int32_t& channels) {
+	channels = static_cast<int32_t>(telemetry_->GetChannelCount());
+	rowsCopied = 0;
+	if (rows == nullptr || maxRows <= 0)
+		return EXIT_SUCCESS;
+	rowsCopied = static_cast<int32_t>(telemetry_->Drain(rows, static_cast<size_t>(maxRows)));
+	return EXIT_SUCCESS;
+}
+
+int Controller::DrainTelemetry(double* timesMs, int32_t* values, int32_t maxRows, int32_t& rowsCopied, int32_t& channels) {
+	return DrainTelemetryAs(timesMs, values, maxRows, rowsCopied, channels);
+}
+
+int Controller::DrainTelemetry(double* timesMs, double* values, int32_t maxRows, int32_t& rowsCopied, int32_t& channels) {
+	return DrainTelemetryAs(timesMs, values, maxRows, rowsCopied, channels);
+}
+
+int Controller::GetTelemetryStats(double& sampleRate, uint64_t& samples, uint64_t& overruns, uint64_t& drops, uint64_t& errors) {
+	Telemetry::Stats stats = telemetry_->GetStats();
+	sampleRate = stats.sampleRate;
+	samples = stats.samples;
+	overruns = stats.overruns;
+	drops = stats.drops;
+	errors = stats.errors;
+	return EXIT_SUCCESS;
+}
+
+int Controller::StartCyclicPosition(uint32_t periodUs) {
+	try {
+		CheckConnection();
+		StopFeeder();
+		if (axis_->cyclicPositionMotor->Activate())
+			return EXIT_FAILURE;
+		axis_->cyclicPositionMotor->SetInterpolationPeriod(periodUs);
+		if (axis_->cyclicPositionMotor->startCyclicPosition())
+			return EXIT_FAILURE;
+		axis_->feeder->Start(*axis_->deviceHandle, SetpointFeeder::kTargetPosition, periodUs, 0);
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::StopCyclicPosition() {
+	StopFeeder();
+	return EXIT_SUCCESS;
+}
+
+int Controller::PushSetpoints(const int32_t* setpoints, int32_t count, bool last, int32_t& accepted, int32_t& free) {
+	accepted = 0;
+	free = static_cast<int32_t>(axis_->feeder->GetFree());
+	try {
+		if (!axis_->feeder->IsRunning()) {
+			throw nanolib_exception("can't push set points: cyclic position is not started", nlc::NlcErrorCode::InvalidOperation);
+		}
+		if (setpoints != nullptr && count > 0)
+			accepted = static_cast<int32_t>(axis_->feeder->Push(setpoints, static_cast<size_t>(count), last));
+		free = static_cast<int32_t>(axis_->feeder->GetFree());
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetSetpointFeederStats(SetpointFeeder::Stats& stats) {
+	stats = axis_->feeder->GetStats();
+	RecordFeederError();
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetFollowingError(int32_t& followingError) {
+	try {
+		CheckConnection();
+		followingError = axis_->cyclicPositionMotor->getFollowingError();
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::StartInterpolatedPosition(uint32_t periodUs) {
+	try {
+		CheckConnection();
+		StopFeeder();
+		if (axis_->interpolatedPositionMotor->Activate())
+			return EXIT_FAILURE;
+		axis_->interpolatedPositionMotor->SetInterpolationPeriod(periodUs);
+		//one record is taken in the current period, the rest can be written ahead
+		const uint32_t lead = std::max(axis_->interpolatedPositionMotor->getBufferSize(), 1u) - 1;
+		if (axis_->interpolatedPositionMotor->startInterpolation())
+			return EXIT_FAILURE;
+		axis_->feeder->Start(*axis_->deviceHandle, SetpointFeeder::kInterpolationData, periodUs, lead);
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::StopInterpolatedPosition() {
+	try {
+		CheckConnection();
+		StopFeeder();
+		axis_->interpolatedPositionMotor->stopInterpolation();
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+int Controller::UploadTrajectory(const int32_t* positions, int32_t count, uint32_t timeBaseUs) {
+	try {
+		CheckConnection();
+		if (positions == nullptr || count <= 0) {
+			throw nanolib_exception("can't upload an empty trajectory", nlc::NlcErrorCode::InvalidArguments);
+		}
+		const nlc::OdIndex& object = axis_->feeder->GetObject();
+		const bool running = axis_->feeder->IsRunning() && axis_->feeder->GetStats().running &&
+			object.getIndex() == SetpointFeeder::kInterpolationData.getIndex() && object.getSubIndex() == SetpointFeeder::kInterpolationData.getSubIndex() &&
+			axis_->feeder->GetPeriodUs() == timeBaseUs;
+		if (!running && StartInterpolatedPosition(timeBaseUs))
+			return EXIT_FAILURE;
+		if (static_cast<size_t>(count) > axis_->feeder->GetFree()) {
+			throw nanolib_exception(std::format("trajectory of {} set points does not fit, {} are free", count, axis_->feeder->GetFree()), nlc::NlcErrorCode::InvalidArguments);
+		}
+		axis_->feeder->Push(positions, static_cast<size_t>(count), true);
+	}
+	catch (const nanolib_exception& e) {
+		RecordException(e);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+void Controller::RecordFeederError() {
+	if (std::optional<nanolib_exception> error = axis_->feeder->TakeError())
+		RecordException(*error);
+}
+
+void Controller::StopFeeder() {
+	axis_->feeder->Stop();
+	RecordFeederError();
+}
+
+int Controller::GetBusQueueStats(uint32_t& depth, uint32_t& maxDepth, uint64_t& executed, uint64_t& posted, double& avgWaitUs, double& maxWaitUs) {
+	BusExecutor::Stats stats = busExecutor_.GetStats();
+	depth = stats.depth;
+	maxDepth = stats.maxDepth;
+	executed = stats.executed;
+	posted = stats.posted;
+	avgWaitUs = stats.avgWaitUs;
+	maxWaitUs = stats.maxWaitUs;
+	return EXIT_SUCCESS;
+}
+
+int Controller::SetPerfStatsEnabled(bool enabled) {
+	perf_.SetEnabled(enabled);
+	return EXIT_SUCCESS;
+}
+
+int Controller::ResetPerfStats() {
+	perf_.Reset();
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetPerfStats(std::vector<PerfStats::SiteStats>& sites) {
+	sites = perf_.GetSites();
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetPerfReport(std::string& report) {
+	report = perf_.Report();
+	return EXIT_SUCCESS;
+}
+
+int Controller::GetCiA402State(std::string& state, bool &fault,bool &voltageEnabled,bool &quickStop,bool &warning, bool &targetReached, bool &limitReached, bool &bit12, bool &bit13) {
+	try {
+		CheckConnection();
+		//state and flags from a single read
+		StatusWord statusWord;
+		if (axis_->powerSM->GetStatusWord(statusWord))
+			return EXIT_FAILURE;
+		auto enum_name = magic_enum::enum_name(static_cast<PowerSM::States>(statusWord.state));
+		state = enum_name;
+		fault = statusWord.fault;
+		voltageEnabled = statusWord.voltageEnabled;
+		quickStop = statusWord.quickStop;
+		warning = statusWord.warning;
+		targetReached = statusWord.targetReached;
+		limitReached = statusWord.limitReached;
+		bit12 = statusWord.bit12;
+		bit13 = statusWord.bit13;
 	}
-
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
+//***HOMING***
 
-int Controller::ScanBus(std::vector<std::string>& devices) {
+int Controller::Home(uint32_t speedZero, uint32_t speedSwitch) {
 	try {
-		if (!openedBusHardware_.has_value()) {
-			throw nanolib_exception("No Port opened");
+		CheckConnection();
+
+		//enable reference switches, set inputs to 24V range
+		if (ConfigureInputs())
+			EXIT_FAILURE;
+
+		if (axis_->homingMotor->Activate())
 			return EXIT_FAILURE;
-		}
-		// Scan the bus for available devices
-		std::vector<nlc::DeviceId> deviceIds = nanolibHelper_.scanBus(*openedBusHardware_);
 
-		devices.clear();
+		if (axis_->homingMotor->home(speedZero, speedSwitch))
+			return EXIT_FAILURE;
 
-		for (int i = 0; i < deviceIds.size(); i++) {
-			std::stringstream ss;
-			ss << i << ". " << deviceIds[i].getDescription();
-			devices.push_back(ss.str());
-		}
 	}
-	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+	catch (nanolib_exception e) {
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::ConnectDevice(uint32_t deviceToOpen) {
-	try {
-		if (!openedBusHardware_.has_value()) {
-			throw(nanolib_exception("can't connect: no port opened."));
-			return EXIT_FAILURE;
-		}
-		if (connectedDeviceHandle_.has_value()) {
-			DisconnectDevice();
-		}
-
-		std::vector<nlc::DeviceId> deviceIds = nanolibHelper_.scanBus(openedBusHardware_.value());
-		if (deviceToOpen >= deviceIds.size()) {
-			throw(nanolib_exception("Invalid bus hardware number."));
-			return EXIT_FAILURE;
-		}
-		nlc::DeviceHandle deviceHandle;
-		// Register the device id
-
-		deviceHandle = nanolibHelper_.addDevice(deviceIds[deviceToOpen]);
-
-		// Establishing a connection with the device
-		nanolibHelper_.connectDevice(deviceHandle);
+//***JOBS***
 
-		connectedDeviceHandle_ = deviceHandle;
+//waits of a job end early when the job is cancelled
+static CompletionWaiter::Sleeper JobSleeper(JobContext& job) {
+	return [&job](std::chrono::milliseconds duration) { return job.Sleep(duration); };
+}
 
+static JobState ToJobState(CompletionWaiter::Result result) {
+	switch (result) {
+	case CompletionWaiter::Result::Done:
+		return JobState::Succeeded;
+	case CompletionWaiter::Result::TimedOut:
+		return JobState::TimedOut;
+	case CompletionWaiter::Result::Cancelled:
+		return JobState::Cancelled;
+	default:
+		return JobState::Failed;
 	}
-	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+}
+
+void Controller::RecordJobError(const char* message) {
+	Execute([&] {
+		RecordException(nanolib_exception(message));
 		return EXIT_FAILURE;
-	}
+	});
+}
 
+int Controller::StartSaveGroupsAsync(const std::vector<uint8_t>& groups, uint32_t& jobId) {
+	jobId = jobs_->Start([this, axis = axis_, groups](JobContext& job) {
+		for (size_t i = 0; i < groups.size(); i++) {
+			const uint8_t group = groups[i];
+			if (JobStep(axis, [&] { return axis_->motor->StartSaveGroup(group); }))
+				return JobState::Failed;
+
+			//the device finishes storing regardless, a cancel only gives up the waiting
+			CompletionWaiter::Result result = waiter_.Wait(CompletionWaiter::Kind::Save, [&] {
+				bool done = false;
+				if (JobStep(axis, [&] { done = axis_->motor->IsSaveGroupDone(group); return EXIT_SUCCESS; }))
+					return CompletionWaiter::Poll::Failed;
+				return done ? CompletionWaiter::Poll::Done : CompletionWaiter::Poll::Pending;
+			}, JobSleeper(job));
+			if (result == CompletionWaiter::Result::TimedOut)
+				RecordJobError("Saving timeout");
+			if (result != CompletionWaiter::Result::Done)
+				return ToJobState(result);
+			job.SetProgress(static_cast<int32_t>((i + 1) * 100 / groups.size()));
+		}
+		return JobState::Succeeded;
+	}, axis_->id);
 	return EXIT_SUCCESS;
 }
 
-int Controller::DisconnectDevice() {
-	try {
-		CheckConnection();
-		nanolibHelper_.disconnectDevice(*connectedDeviceHandle_);
-		nanolibHelper_.removeDevice(*connectedDeviceHandle_);
-		connectedDeviceHandle_.reset();
-	}
-	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
-		return EXIT_FAILURE;
-	}
+int Controller::StartAutoSetupMotPamsAsync(uint32_t& jobId) {
+	jobId = jobs_->Start([this, axis = axis_](JobContext& job) {
+		if (JobStep(axis, [&] {
+			if (axis_->autoSetupMotor->Activate())
+				return EXIT_FAILURE;
+			return axis_->autoSetupMotor->StartAutoSetup();
+		}))
+			return JobState::Failed;
+		job.SetProgress(10);
+
+		CompletionWaiter::Result result = waiter_.Wait(CompletionWaiter::Kind::AutoSetup, [&] {
+			bool done = false;
+			if (JobStep(axis, [&] { done = axis_->autoSetupMotor->IsAutoSetupDone(); return EXIT_SUCCESS; }))
+				return CompletionWaiter::Poll::Failed;
+			return done ? CompletionWaiter::Poll::Done : CompletionWaiter::Poll::Pending;
+		}, JobSleeper(job));
+		if (result == CompletionWaiter::Result::TimedOut)
+			RecordJobError("Auto setup timeout");
+
+		//clearing the start bit ends the auto setup, also a running one on timeout or cancel
+		if (JobStep(axis, [&] { axis_->autoSetupMotor->FinishAutoSetup(); return EXIT_SUCCESS; }))
+			return JobState::Failed;
+		return ToJobState(result);
+	}, axis_->id);
+	return EXIT_SUCCESS;
+}
 
+int Controller::StartHomeAsync(uint32_t speedZeroUserUnit, uint32_t speedSwitchUserUnit, uint32_t& jobId) {
+	jobId = jobs_->Start([this, axis = axis_, speedZeroUserUnit, speedSwitchUserUnit](JobContext& job) {
+		if (Execute([&] { return OnAxis(axis, [&] { return Home(speedZeroUserUnit, speedSwitchUserUnit); }); }))
+			return JobState::Failed;
+		job.SetProgress(10);
+
+		bool seenInProgress = false;
+		CompletionWaiter::Result result = waiter_.Wait(CompletionWaiter::Kind::Homing, [&] {
+			uint16_t state = HomingMotor::H_INCOMPLETE;
+			if (JobStep(axis, [&] { state = axis_->homingMotor->getState(); return EXIT_SUCCESS; }))
+				return CompletionWaiter::Poll::Failed;
+
+			switch (state) {
+			case HomingMotor::H_IN_PROGRESS:
+				seenInProgress = true;
+				job.SetProgress(50);
+				return CompletionWaiter::Poll::Pending;
+			case HomingMotor::H_COMPLETED:
+				return CompletionWaiter::Poll::Done;
+			case HomingMotor::H_ERROR_STILL_MOVING:
+			case HomingMotor::H_ERROR_HALT:
+				RecordJobError("Homing error");
+				return CompletionWaiter::Poll::Failed;
+			case HomingMotor::H_INCOMPLETE:
+				//not started yet right after the start bit, interrupted later on
+				if (seenInProgress) {
+					RecordJobError("Homing interrupted");
+					return CompletionWaiter::Poll::Failed;
+				}
+				return CompletionWaiter::Poll::Pending;
+			default:
+				return CompletionWaiter::Poll::Pending;
+			}
+		}, JobSleeper(job));
+
+		if (result == CompletionWaiter::Result::TimedOut)
+			RecordJobError("Homing timeout");
+		if (result == CompletionWaiter::Result::TimedOut || result == CompletionWaiter::Result::Cancelled)
+			JobStep(axis, [&] { return axis_->homingMotor->Halt(); });
+		return ToJobState(result);
+	}, axis_->id);
 	return EXIT_SUCCESS;
 }
 
-int Controller::SetMotorParameters(uint32_t polePairCount, uint32_t ratedCurrent, uint32_t maxCurrent,uint32_t maxCurrentDuration, uint32_t idleCurrent, uint32_t driveMode) {
-	try {
-		CheckConnection();
-		//take whichever motor for this
-		Motor402 mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		if (mot.SetMotorParameters(polePairCount, ratedCurrent, maxCurrent, maxCurrentDuration,idleCurrent, static_cast<Motor402::DriveMode>(driveMode)))
-			return EXIT_FAILURE;
-	}
-	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+int Controller::PollJob(uint32_t jobId, int32_t& progress, int32_t& state) {
+	JobState jobState;
+	if (!jobs_->Poll(jobId, progress, jobState))
 		return EXIT_FAILURE;
-	}
+	state = static_cast<int32_t>(jobState);
 	return EXIT_SUCCESS;
 }
 
-int Controller::GetMotorParameters(uint32_t& polePairCount, uint32_t& ratedCurrent, uint32_t& maxCurrent, uint32_t& maxCurrentTime, uint32_t &idleCurrent, uint32_t& driveMode) {
-	try{ 
-		CheckConnection();
-		Motor402 mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		Motor402::DriveMode driveMode_t;
-		mot.GetMotorParameters(polePairCount, ratedCurrent, maxCurrent, maxCurrentTime,idleCurrent, driveMode_t);
-		driveMode = driveMode_t;
-	}
-	catch (nanolib_exception& e) {
-		exceptions_.push_back(e);
+int Controller::WaitJob(uint32_t jobId, uint32_t timeoutMs) {
+	JobState jobState;
+	if (!jobs_->Wait(jobId, timeoutMs, jobState))
 		return EXIT_FAILURE;
-	}
+	return jobState == JobState::Succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int Controller::CancelJob(uint32_t jobId) {
+	return jobs_->Cancel(jobId) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//***WAITING***
+
+int Controller::WaitTargetReached(uint32_t timeoutMs) {
+	return WaitTargetReached(std::nullopt, timeoutMs);
+}
+
+int Controller::WaitTargetReachedOnAxis(uint32_t axisId, uint32_t timeoutMs) {
+	return WaitTargetReached(axisId, timeoutMs);
+}
+
+int Controller::WaitTargetReached(std::optional<uint32_t> axisId, uint32_t timeoutMs) {
+	//polled through the bus thread, other calls keep running in between
+	CompletionWaiter::Result result = waiter_.Wait(CompletionWaiter::Kind::TargetReached, [this, axisId] {
+		bool reached = false;
+		auto poll = [&] {
+			try {
+				CheckConnection();
+				StatusWord statusWord;
+				axis_->powerSM->GetStatusWord(statusWord);
+				reached = statusWord.targetReached;
+			}
+			catch (const nanolib_exception& e) {
+				RecordException(e);
+				return EXIT_FAILURE;
+			}
+			return EXIT_SUCCESS;
+		};
+		int failed = axisId.has_value() ? ExecuteOnAxis(*axisId, poll) : Execute(poll);
+		if (failed)
+			return CompletionWaiter::Poll::Failed;
+		return reached ? CompletionWaiter::Poll::Done : CompletionWaiter::Poll::Pending;
+	}, {}, std::chrono::milliseconds(timeoutMs));
+	return result == CompletionWaiter::Result::Done ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int Controller::SetWaitPolicy(int32_t kind, uint32_t minIntervalMs, uint32_t maxIntervalMs, uint32_t deadlineMs, double growth) {
+	if (kind < 0 || kind >= static_cast<int32_t>(CompletionWaiter::Kind::Count))
+		return EXIT_FAILURE;
+	CompletionWaiter::Policy policy{ std::chrono::milliseconds(minIntervalMs), std::chrono::milliseconds(maxIntervalMs),
+		std::chrono::milliseconds(deadlineMs), growth };
+	waiter_.SetPolicy(static_cast<CompletionWaiter::Kind>(kind), policy);
 	return EXIT_SUCCESS;
 }
 
-int Controller::SaveGroupMovement() {
-	try {
-		CheckConnection();
-		Motor402 mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.SaveGroup(0x05);
-	}
-	catch (nanolib_exception& e) {
-		exceptions_.push_back(e);
+int Controller::GetWaitStats(int32_t kind, uint64_t& completed, uint64_t& failed, uint64_t& timedOut, uint64_t& cancelled, uint64_t& polls,
+	double& avgMs, double& minMs, double& maxMs, uint64_t* histogram, int32_t histogramSize) {
+	if (kind < 0 || kind >= static_cast<int32_t>(CompletionWaiter::Kind::Count))
 		return EXIT_FAILURE;
-	}
+	CompletionWaiter::Stats stats = waiter_.GetStats(static_cast<CompletionWaiter::Kind>(kind));
+	completed = stats.completed;
+	failed = stats.failed;
+	timedOut = stats.timedOut;
+	cancelled = stats.cancelled;
+	polls = stats.polls;
+	avgMs = stats.avgMs;
+	minMs = stats.minMs;
+	maxMs = stats.maxMs;
+	for (int32_t i = 0; histogram != nullptr && i < histogramSize; i++)
+		histogram[i] = static_cast<size_t>(i) < stats.histogram.size() ? stats.histogram[i] : 0;
 	return EXIT_SUCCESS;
 }
 
-int Controller::SaveGroupApplication() {
+int Controller::SetHomingAcceleration(uint32_t acc) {
 	try {
 		CheckConnection();
-		Motor402 mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.SaveGroup(0x03);
+		axis_->homingMotor->setHomingAcceleration(acc);
 	}
-	catch (nanolib_exception& e) {
-		exceptions_.push_back(e);
+	catch (const nanolib_exception& e) {
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::SaveGroupTuning() {
+//***POSITIONING***
+
+
+int Controller::SetTargetPosition(int32_t value, uint32_t absRel) {
 	try {
 		CheckConnection();
-		Motor402 mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.SaveGroup(0x06);
+		if (axis_->profilePositionMotor->Activate())
+			return EXIT_FAILURE;
+		axis_->profilePositionMotor->setTargetPosition(value,absRel);
 	}
-	catch (nanolib_exception& e) {
-		exceptions_.push_back(e);
+	catch (const nanolib_exception& e) {
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::Halt() {
+int Controller::SetProfileAcceleration(uint32_t acc) {
 	try {
 		CheckConnection();
-		Motor402 mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.Halt();
+		axis_->profilePositionMotor->setProfileAcceleration(acc);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-
-
-int Controller::GetDeviceErrorStack(std::vector<std::string>& errorStackStrings) {
+int Controller::SetProfileVelocity(uint32_t speed) {
 	try {
 		CheckConnection();
-		std::vector<int64_t> errorStack = nanolibHelper_.readArray(*connectedDeviceHandle_, 0x1003);
-		uint8_t numberOfErrors = static_cast<uint8_t>(errorStack.at(0));
-		DBOUT("Elements in error stack: " << std::to_string(numberOfErrors).c_str() << std::endl);
-		for (size_t i = 1; i <= numberOfErrors; i++) {
-			uint32_t error = static_cast<uint32_t>(errorStack.at(i));
-
-			std::string errorString = std::string(std::format("Error Number: {} Code: {}", std::to_string(error >> 24), std::format("{:x}", error & 0xFFFF)));
-			DBOUT(errorString.c_str());
-			errorStackStrings.push_back(errorString);
-		}
+		axis_->profilePositionMotor->setProfileVelocity(speed);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
-
 	return EXIT_SUCCESS;
-
-
 }
 
-int Controller::QuickStop() {
+int Controller::GetPositioningParameters(uint32_t& profileVelocity, int32_t& targetPosition) {
 	try {
 		CheckConnection();
-		//quick stop
-		if (powerSM_->QuickStop())
-			return EXIT_FAILURE;
+		const std::array<nlc::OdIndex, 2> odIndices{ { nlc::OdIndex(0x6081, 0x00), nlc::OdIndex(0x607A, 0x00) } };
+		std::vector<int64_t> values = nanolibHelper_.readMany(*axis_->deviceHandle, odIndices);
+		profileVelocity = static_cast<uint32_t>(values[0]);
+		targetPosition = static_cast<int32_t>(values[1]);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::GetPositionActual(int32_t& position) {
+int Controller::StartPositioning() {
 	try {
 		CheckConnection();
-		Motor402 mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		position = mot.GetPositionActual();
+		if (axis_->profilePositionMotor->Activate())
+			return EXIT_FAILURE;
+		axis_->profilePositionMotor->startPositioning();
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
-
 	return EXIT_SUCCESS;
 }
 
-int Controller::SetUserUnitsFeed(uint32_t feedPer,uint32_t shaftRevolutions) {
+int Controller::GetUserUnitsPositioning(uint32_t& unit, uint32_t& exp) {
 	try {
 		CheckConnection();
-		Motor402 mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.SetUserUnitsFeed(feedPer,shaftRevolutions);
+		axis_->profilePositionMotor->getUserUnitsPositioning(unit,exp);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::GetUserUnitsFeed(uint32_t& feedPer,uint32_t &shaftRevolutions) {
+int Controller::SetUserUnitsPositioning(uint32_t posUnit, uint32_t posExp) {
 	try {
 		CheckConnection();
-		feedPer = static_cast<uint32_t>(nanolibHelper_.readInteger(*connectedDeviceHandle_, nlc::OdIndex(0x6092, 0x01)));
-		shaftRevolutions = static_cast<uint32_t>(nanolibHelper_.readInteger(*connectedDeviceHandle_, nlc::OdIndex(0x6092, 0x02)));
+		axis_->profilePositionMotor->setUserUnitsPositioning(posUnit, posExp);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		DBOUT("exception: " << e.what());
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
+
 	return EXIT_SUCCESS;
 }
-int Controller::GetUserUnitsGearRatio(uint32_t& gearRatioMotorRevs,uint32_t& gearRatioShaftRevs) {
+
+//***WAYPOINTS***
+
+int Controller::QueueTargets(const int32_t* positions, const uint32_t* velocities, int32_t count, uint32_t absRel, uint32_t& jobId) {
 	try {
 		CheckConnection();
-		gearRatioMotorRevs = static_cast<uint32_t>(nanolibHelper_.readInteger(*connectedDeviceHandle_, nlc::OdIndex(0x6091, 0x01)));
-		gearRatioShaftRevs = static_cast<uint32_t>(nanolibHelper_.readInteger(*connectedDeviceHandle_, nlc::OdIndex(0x6091, 0x02)));
+		if (positions == nullptr || count <= 0) {
+			throw nanolib_exception("can't queue an empty list of targets", nlc::NlcErrorCode::InvalidArguments);
+		}
+		WaypointQueue& waypoints = *axis_->waypoints;
+		if (waypoints.Append(positions, velocities, static_cast<size_t>(count), absRel == 1)) {
+			//set points of another mode would fight the targets
+			StopFeeder();
+			//the job only touches the bus through the bus thread, it can't finish before its id is stored
+			waypoints.SetJobId(jobs_->Start([this, axis = axis_](JobContext& job) {
+				const JobState state = RunWaypoints(job, axis);
+				if (state != JobState::Succeeded)
+					axis->waypoints->Stop();
+				return state;
+			}, axis_->id));
+		}
+		jobId = waypoints.GetJobId();
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
+	return EXIT_SUCCESS;
+}
 
+int Controller::ClearWaypoints() {
+	axis_->waypoints->Clear();
 	return EXIT_SUCCESS;
 }
 
-//read all 5 inputs
-int Controller::ReadDigitalInputs(uint8_t& states) {
+int Controller::GetWaypointQueueStats(WaypointQueue::Stats& stats) {
+	stats = axis_->waypoints->GetStats();
+	return EXIT_SUCCESS;
+}
+
+JobState Controller::RunWaypoints(JobContext& job, Axis* axis) {
+	WaypointQueue& waypoints = *axis->waypoints;
+	bool started = false;
+	//6081h is latched with each set point, it is only written when it changes
+	std::optional<uint32_t> velocity;
+	uint64_t sent = 0;
+
+	auto setPointAcknowledged = [&](bool expected) {
+		return [&, expected] {
+			bool acknowledged = false;
+			if (JobStep(axis, [&] { acknowledged = axis_->profilePositionMotor->isSetPointAcknowledged(); return EXIT_SUCCESS; }))
+				return CompletionWaiter::Poll::Failed;
+			return acknowledged == expected ? CompletionWaiter::Poll::Done : CompletionWaiter::Poll::Pending;
+		};
+	};
+
+	while (true) {
+		const std::optional<WaypointQueue::Waypoint> waypoint = waypoints.Next();
+		if (!waypoint.has_value()) {
+			//the last target is run to without a follower, done once it is reached unless more targets came in
+			CompletionWaiter::Result result = waiter_.Wait(CompletionWaiter::Kind::LastWaypoint, [&] {
+				if (!waypoints.IsEmpty())
+					return CompletionWaiter::Poll::Done;
+				StatusWord statusWord;
+				if (JobStep(axis, [&] { return axis_->powerSM->GetStatusWord(statusWord); }))
+					return CompletionWaiter::Poll::Failed;
+				return statusWord.targetReached ? CompletionWaiter::Poll::Done : CompletionWaiter::Poll::Pending;
+			}, JobSleeper(job));
+			if (result != CompletionWaiter::Result::Done)
+				return ToJobState(result);
+			if (waypoints.Finish())
+				return JobState::Succeeded;
+			continue;
+		}
+
+		if (JobStep(axis, [&] {
+			if (!started) {
+				if (axis_->profilePositionMotor->Activate())
+					return EXIT_FAILURE;
+				if (axis_->profilePositionMotor->startWaypoints())
+					return EXIT_FAILURE;
+			}
+			if (waypoint->velocity.has_value() && waypoint->velocity != velocity)
+				axis_->profilePositionMotor->setProfileVelocity(*waypoint->velocity);
+			axis_->profilePositionMotor->sendWaypoint(waypoint->position, waypoint->relative);
+			return EXIT_SUCCESS;
+		}))
+			return JobState::Failed;
+		started = true;
+		if (waypoint->velocity.has_value())
+			velocity = waypoint->velocity;
+		sent++;
+
+		CompletionWaiter::Result result = waiter_.Wait(CompletionWaiter::Kind::SetPointAcknowledge, setPointAcknowledged(true), JobSleeper(job));
+		if (result == CompletionWaiter::Result::TimedOut)
+			RecordJobError("Set point not acknowledged");
+		if (result != CompletionWaiter::Result::Done)
+			return ToJobState(result);
+		waypoints.Acknowledged();
+		if (JobStep(axis, [&] { axis_->profilePositionMotor->releaseWaypoint(); return EXIT_SUCCESS; }))
+			return JobState::Failed;
+
+		//bit 12 stays set while the target is buffered behind the running move, the next one fits once it clears
+		result = waiter_.Wait(CompletionWaiter::Kind::SetPointBuffer, setPointAcknowledged(false), JobSleeper(job));
+		if (result == CompletionWaiter::Result::TimedOut)
+			RecordJobError("Set point buffer not freed");
+		if (result != CompletionWaiter::Result::Done)
+			return ToJobState(result);
+
+		const size_t depth = waypoints.GetStats().depth;
+		job.SetProgress(static_cast<int32_t>(sent * 100 / (sent + depth)));
+	}
+}
+
+
+//***VELOCITY***
+
+int Controller::SetTargetVelocity(int16_t vel) {
 	try {
 		CheckConnection();
-		uint32_t uWord32 = static_cast<uint32_t>(nanolibHelper_.readInteger(*connectedDeviceHandle_, nlc::OdIndex(0x60FD, 0x00)));
-		states = (uWord32 >> 16) & 0xFF;
-
+		axis_->velocityMotor->SetTargetVelocity(vel);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-
-int Controller::ConfigureInputs() {
+int Controller::StartVelocity() {
 	try {
 		CheckConnection();
-		uint32_t uWord32 = 0;
-		//set digital inputs to range 24V
-		uWord32 |= (1UL << 0);
-		uWord32 |= (1UL << 1);
-		nanolibHelper_.writeInteger(*connectedDeviceHandle_, uWord32, nlc::OdIndex(0x3240, 0x06), 32);
-
-		//set opener logic
-		nanolibHelper_.writeInteger(*connectedDeviceHandle_, uWord32, nlc::OdIndex(0x3240, 0x02), 32);
-
-		//set input 1 to negative
-		//set input 2 to positive endswitch
-		nanolibHelper_.writeInteger(*connectedDeviceHandle_, uWord32, nlc::OdIndex(0x3240, 0x01), 32);
-		//Limit Switch Error Option Code
-		/*
-		keine Reaktion (um z. B. eine Referenzfahrt durchzufhren), auer
-		Vermerken der Endschalterposition
-		*/
-		nanolibHelper_.writeInteger(*connectedDeviceHandle_, -1, nlc::OdIndex(0x3701, 0x00), 16);
-
+		if (axis_->velocityMotor->Activate())
+			return EXIT_FAILURE;
+		axis_->velocityMotor->StartVelocity();
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
+int Controller::SetVelocityAcceleration(uint32_t deltaSpeed, uint16_t deltaTime) {
+try {
+	CheckConnection();
+	axis_->velocityMotor->SetVelocityAcceleration(deltaSpeed,deltaTime );
+}
+catch (const nanolib_exception& e) {
+	RecordException(e);
+	return EXIT_FAILURE;
+}
+return EXIT_SUCCESS;
+}
 
-int Controller::GetModeOfOperation(std::string& mode) {
+int Controller::GetVelocityDemanded(int16_t &velDemanded) {
 	try {
 		CheckConnection();
-		Motor402 mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		Motor402::OperationMode opMode=static_cast<Motor402::OperationMode>(mot.GetModeOfOperation());
-		auto enum_name = magic_enum::enum_name(opMode);
-		mode = enum_name;
+		axis_->motor->GetVelocityDemanded(velDemanded);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::GetCiA402State(std::string& state, bool &fault,bool &voltageEnabled,bool &quickStop,bool &warning, bool &targetReached, bool &limitReached, bool &bit12, bool &bit13) {
+int Controller::GetVelocityStatus(int16_t& velDemanded, int16_t& velActual) {
 	try {
 		CheckConnection();
-		uint8_t opState;
-		if (powerSM_->GetCurrentState(opState))
-			return EXIT_FAILURE;
-		auto enum_name = magic_enum::enum_name(static_cast<PowerSM::States>(opState));
-		state = enum_name;
-		uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper_.readInteger(*connectedDeviceHandle_, nlc::OdIndex(0x6041, 0x00)));
-		fault = uWord16 & (1U << 3);
-		voltageEnabled = uWord16 & (1U << 4);
-		quickStop = uWord16 & (1U << 5);
-		warning = uWord16 & (1U << 7);
-		targetReached = uWord16 & (1U << 10);
-		limitReached = uWord16 & (1U << 11);
-		bit12 = uWord16 & (1U << 12);
-		bit13 = uWord16 & (1U << 13);
+		const std::array<nlc::OdIndex, 2> odIndices{ { nlc::OdIndex(0x6043, 0x00), nlc::OdIndex(0x6044, 0x00) } };
+		std::vector<int64_t> values = nanolibHelper_.readMany(*axis_->deviceHandle, odIndices);
+		velDemanded = static_cast<int16_t>(values[0]);
+		velActual = static_cast<int16_t>(values[1]);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-//**AUTO-SETUP***
-
-int Controller::AutoSetupMotPams() {
+int Controller::GetVelocityActual(int16_t& velActual) {
 	try {
 		CheckConnection();
-		AutoSetupMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.AutoSetupMotPams();
+		axis_->motor->GetVelocityActual(velActual);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-//***HOMING***
-
-int Controller::Home(uint32_t speedZero, uint32_t speedSwitch) {
+int Controller::SetVelocityDeceleration(uint32_t deltaSpeed, uint16_t deltaTime) {
 	try {
 		CheckConnection();
-
-		//enable reference switches, set inputs to 24V range
-		if (ConfigureInputs())
-			EXIT_FAILURE;
-
-		HomingMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		if (mot.home(speedZero, speedSwitch))
-			return EXIT_FAILURE;
-
+		axis_->velocityMotor->SetVelocityDeceleration(deltaSpeed, deltaTime);
 	}
-	catch (nanolib_exception e) {
-		exceptions_.push_back(e);
+	catch (const nanolib_exception& e) {
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-
-int Controller::SetHomingAcceleration(uint32_t acc) {
+int Controller::GetTargetVelocity(int16_t& vel) {
 	try {
 		CheckConnection();
-		HomingMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.setHomingAcceleration(acc);
+		axis_->velocityMotor->GetTargetVelocity(vel);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
-
-//***POSITIONING***
-
-
-int Controller::SetTargetPosition(int32_t value, uint32_t absRel) {
+//target velocity, acceleration and deceleration in one go, no mode switch needed for reading
+int Controller::GetVelocityParameters(int16_t& vel, uint32_t& deltaSpeedAcc, uint16_t& deltaTimeAcc, uint32_t& deltaSpeedDec, uint16_t& deltaTimeDec) {
 	try {
 		CheckConnection();
-		ProfilePositionMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.setTargetPosition(value,absRel);
+		const std::array<nlc::OdIndex, 5> odIndices{ {
+			nlc::OdIndex(0x6042, 0x00),
+			nlc::OdIndex(0x6048, 0x01),
+			nlc::OdIndex(0x6048, 0x02),
+			nlc::OdIndex(0x6049, 0x01),
+			nlc::OdIndex(0x6049, 0x02)
+		} };
+		std::vector<int64_t> values = nanolibHelper_.readMany(*axis_->deviceHandle, odIndices);
+		vel = static_cast<int16_t>(values[0]);
+		//6048h:01 and 6049h:01 are UNSIGNED32, the times UNSIGNED16
+		deltaSpeedAcc = static_cast<uint32_t>(values[1]);
+		deltaTimeAcc = static_cast<uint16_t>(values[2]);
+		deltaSpeedDec = static_cast<uint32_t>(values[3]);
+		deltaTimeDec = static_cast<uint16_t>(values[4]);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::SetProfileAcceleration(uint32_t acc) {
+void Controller::PostTargetVelocity(std::optional<uint32_t> axisId, int16_t vel) {
+	PostLatest(targetVelocities_, axisId, vel, &Controller::SetTargetVelocity);
+}
+
+CoalescingSetpoint<int16_t>::Stats Controller::GetTargetVelocityStats() const {
+	return SumStats(targetVelocities_);
+}
+
+int Controller::GetVelocityAcceleration(uint32_t& deltaSpeed, uint16_t& deltaTime){
 	try {
 		CheckConnection();
-		ProfilePositionMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.setProfileAcceleration(acc);
+		axis_->velocityMotor->GetVelocityAcceleration(deltaSpeed,deltaTime);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
-
-int Controller::SetProfileVelocity(uint32_t speed) {
+int Controller::GetVelocityDeceleration(uint32_t& deltaSpeed, uint16_t& deltaTime){
 	try {
 		CheckConnection();
-		ProfilePositionMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.setProfileVelocity(speed);
+		axis_->velocityMotor->GetVelocityDeceleration(deltaSpeed,deltaTime);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::GetPositioningParameters(uint32_t& profileVelocity, int32_t& targetPosition) {
+
+//***PROFILE TORQUE***
+
+int Controller::StartProfileTorque() {
 	try {
 		CheckConnection();
-		ProfilePositionMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.getPositioningParameters(profileVelocity, targetPosition);
+		if (axis_->profileTorqueMotor->Activate())
+			return EXIT_FAILURE;
+		if (axis_->profileTorqueMotor->startProfileTorque())
+			return EXIT_FAILURE;
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::StartPositioning() {
+int Controller::SetTargetTorque(int16_t torque) {
 	try {
 		CheckConnection();
-		ProfilePositionMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.startPositioning();
+		axis_->profileTorqueMotor->setTargetTorque(torque);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::GetUserUnitsPositioning(uint32_t& unit, uint32_t& exp) {
+int Controller::SetTorqueSlope(uint32_t slope) {
 	try {
 		CheckConnection();
-		ProfilePositionMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.getUserUnitsPositioning(unit,exp);
+		axis_->profileTorqueMotor->setTorqueSlope(slope);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::SetUserUnitsPositioning(uint32_t posUnit, uint32_t posExp) {
+int Controller::SetMaxTorque(uint16_t maxTorque) {
 	try {
 		CheckConnection();
-		ProfilePositionMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.setUserUnitsPositioning(posUnit, posExp);
+		axis_->profileTorqueMotor->setMaxTorque(maxTorque);
 	}
 	catch (const nanolib_exception& e) {
-		DBOUT("exception: " << e.what());
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
-
 	return EXIT_SUCCESS;
 }
 
-
-//***VELOCITY***
-
-int Controller::SetTargetVelocity(int16_t vel) {
+int Controller::GetProfileTorqueParameters(int16_t& targetTorque, uint32_t& slope, uint16_t& maxTorque) {
 	try {
 		CheckConnection();
-		VelocityMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.SetTargetVelocity(vel);
+		axis_->profileTorqueMotor->getProfileTorqueParameters(targetTorque, slope, maxTorque);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::StartVelocity() {
+int Controller::GetTorqueStatus(int16_t& torqueActual, int16_t& currentActual) {
 	try {
 		CheckConnection();
-		VelocityMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.StartVelocity();
+		axis_->profileTorqueMotor->getTorqueStatus(torqueActual, currentActual);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
-int Controller::SetVelocityAcceleration(uint32_t deltaSpeed, uint16_t deltaTime) {
-try {
-	CheckConnection();
-	VelocityMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-	mot.SetVelocityAcceleration(deltaSpeed,deltaTime );
-}
-catch (const nanolib_exception& e) {
-	exceptions_.push_back(e);
-	return EXIT_FAILURE;
+
+void Controller::PostTargetTorque(std::optional<uint32_t> axisId, int16_t torque) {
+	PostLatest(targetTorques_, axisId, torque, &Controller::SetTargetTorque);
 }
-return EXIT_SUCCESS;
+
+CoalescingSetpoint<int16_t>::Stats Controller::GetTargetTorqueStats() const {
+	return SumStats(targetTorques_);
 }
 
-int Controller::GetVelocityDemanded(int16_t &velDemanded) {
+//***PROFILE VELOCITY***
+
+int Controller::StartProfileVelocity() {
 	try {
 		CheckConnection();
-		Motor402 mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.GetVelocityDemanded(velDemanded);
+		if (axis_->profileVelocityMotor->Activate())
+			return EXIT_FAILURE;
+		if (axis_->profileVelocityMotor->startProfileVelocity())
+			return EXIT_FAILURE;
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::GetVelocityActual(int16_t& velActual) {
+int Controller::SetTargetProfileVelocity(int32_t vel) {
 	try {
 		CheckConnection();
-		Motor402 mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.GetVelocityActual(velActual);
+		axis_->profileVelocityMotor->setTargetProfileVelocity(vel);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::SetVelocityDeceleration(uint32_t deltaSpeed, uint16_t deltaTime) {
+int Controller::SetProfileVelocityAcceleration(uint32_t acc) {
 	try {
 		CheckConnection();
-		VelocityMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.SetVelocityDeceleration(deltaSpeed, deltaTime);
+		axis_->profileVelocityMotor->setProfileVelocityAcceleration(acc);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
-int Controller::GetTargetVelocity(int16_t& vel) {
+int Controller::SetProfileVelocityDeceleration(uint32_t dec) {
 	try {
 		CheckConnection();
-		VelocityMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.GetTargetVelocity(vel);
+		axis_->profileVelocityMotor->setProfileVelocityDeceleration(dec);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
-int Controller::GetVelocityAcceleration(uint32_t& deltaSpeed, uint16_t& deltaTime){
+
+int Controller::GetProfileVelocityParameters(int32_t& vel, uint32_t& acc, uint32_t& dec) {
 	try {
 		CheckConnection();
-		VelocityMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.GetVelocityAcceleration(deltaSpeed,deltaTime);
+		axis_->profileVelocityMotor->getProfileVelocityParameters(vel, acc, dec);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
-int Controller::GetVelocityDeceleration(uint32_t& deltaSpeed, uint16_t& deltaTime){
+
+int Controller::GetProfileVelocityStatus(int32_t& demandedVel, int32_t& velActual) {
 	try {
 		CheckConnection();
-		VelocityMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.GetVelocityDeceleration(deltaSpeed,deltaTime);
+		axis_->profileVelocityMotor->getProfileVelocityStatus(demandedVel, velActual);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 	return EXIT_SUCCESS;
 }
 
+void Controller::PostTargetProfileVelocity(std::optional<uint32_t> axisId, int32_t vel) {
+	PostLatest(targetProfileVelocities_, axisId, vel, &Controller::SetTargetProfileVelocity);
+}
+
+CoalescingSetpoint<int32_t>::Stats Controller::GetTargetProfileVelocityStats() const {
+	return SumStats(targetProfileVelocities_);
+}
 
 int Controller::SetUserUnitsVelocity(uint32_t velUnit, uint32_t velExp, uint32_t velTime) {
 	try {
 		CheckConnection();
-		VelocityMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.SetUserUnitsVelocity(velUnit, velExp,velTime);
+		axis_->velocityMotor->SetUserUnitsVelocity(velUnit, velExp,velTime);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 
@@ -802,11 +2404,10 @@ int Controller::SetUserUnitsVelocity(uint32_t velUnit, uint32_t velExp, uint32_t
 int Controller::GetUserUnitsVelocity(uint32_t &unit, uint32_t& exp, uint32_t& time) {
 	try {
 		CheckConnection();
-		VelocityMotor mot(&nanolibHelper_, &connectedDeviceHandle_, &(*powerSM_));
-		mot.GetUserUnitsVelocity(unit,exp, time);
+		axis_->velocityMotor->GetUserUnitsVelocity(unit,exp, time);
 	}
 	catch (const nanolib_exception& e) {
-		exceptions_.push_back(e);
+		RecordException(e);
 		return EXIT_FAILURE;
 	}
 
@@ -1,14 +1,28 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
 #include <optional>
+#include <source_location>
 #include <vector>
 
 #include "nanolib_helper.hpp"
 
-#include "auto_setup_motor.h"
-#include "homing_motor.h"
-#include "profile_position_motor.h"
-#include "velocity_motor.h"
+#include "axis.h"
+#include "bus_executor.h"
+#include "bus_probe.h"
+#include "coalescing_setpoint.h"
+#include "completion_waiter.h"
+#include "discovery.h"
+#include "error_journal.h"
+#include "job_manager.h"
+#include "perf_stats.h"
+#include "scan_cache.h"
+#include "session_profile.h"
+#include "setpoint_feeder.h"
+#include "telemetry.h"
 
 
 class Controller {
@@ -19,8 +33,14 @@ public:
 	Controller(const Controller&) = delete;
 	void operator=(const Controller &) = delete;
 
+	//runs at DLL unload under the loader lock, without Shutdown it switches the drives off and closes the port
+	//but leaves the threads running; at process exit they are gone already, before FreeLibrary call Shutdown
 	~Controller();
 
+	//stops the jobs, the discovery, the probes and the set points, closes the port and ends the bus thread
+	//not on the bus thread and with no other call running, the next call starts the threads again
+	int Shutdown();
+
 	//***GENERAL***
 	int QuickStop();
 	int Halt();
@@ -31,31 +51,196 @@ public:
 	int GetDeviceErrorStack(std::vector<std::string>& errorStack);
 
 
-	//exceptions thrown from nanolib
+	//messages of the errors still in the journal, oldest first
 	int GetExceptions(std::vector<std::string>& exceptions);
+	//errors recorded after sinceSeq, nextSeq is the sinceSeq for the next call, missed the ones overwritten in between
+	//thread-safe, does not wait for the bus thread
+	int DrainErrors(uint64_t sinceSeq, std::vector<ErrorJournal::Record>& records, uint64_t& nextSeq, uint64_t& missed);
+	//thread-safe
+	int GetErrorStats(uint64_t& recorded, uint64_t& dropped);
 
 	int OpenPort(uint32_t portToOpen);
+	//connects the selected axis, deviceToOpen is an index into the last ScanBus result
 	int ConnectDevice(uint32_t deviceToOpen);
 	int DisconnectDevice();
+	//always scans, the result is kept per bus for ConnectDevice
 	int ScanBus(std::vector<std::string>& devices);
+	//like ConnectDevice, fails if the bus was scanned again since generation
+	int ConnectDeviceOfScan(uint32_t generation, uint32_t deviceToOpen);
+	//connects the device with nodeId and/or serialNumber (0 and empty match any) to the selected axis,
+	//tries the cached scan and on CANopen the node id itself before scanning, a scan stops at the first node id match
+	int FindDevice(uint32_t nodeId, const std::string& serialNumber, uint32_t& nodeIdFound);
+	//the next connect scans again
+	int InvalidateScanCache();
+	//scan of the opened bus, ageMs is -1 if it was not scanned yet
+	int GetScanInfo(uint32_t& generation, uint32_t& deviceCount, double& ageMs);
+
+	//***DISCOVERY***
+	//scans all buses at once, the opened bus through the bus thread, the others are opened and closed by their worker
+	int StartDiscovery(bool readSerialNumbers);
+	//thread safe
+	int CancelDiscovery();
+	int GetDiscoveryState(bool& running, uint32_t& busesTotal, uint32_t& busesDone);
+	//available is false if there is no event
+	int ReadDiscoveryEvent(bool& available, int32_t& type, uint32_t& bus, int32_t& value, std::string& text);
+	int GetDiscoveredDevices(std::vector<Discovery::Device>& devices);
+
+	//***BUS OPTIONS***
+	//replaces the default of an option of bus_hw_options_defaults.hpp for the following OpenPort, an empty value restores the default
+	int SetBusOption(const std::string& name, const std::string& value);
+	//options OpenPort would use for port
+	int GetBusOptions(uint32_t port, std::vector<std::string>& names, std::vector<std::string>& values);
+	//tries the baud rates of port on the job pool, see BusProbe, applyRecommended keeps the fastest stable setting for OpenPort
+	int StartBusProbeAsync(uint32_t port, uint32_t nodeId, uint32_t roundTrips, bool applyRecommended, uint32_t& jobId);
+	//thread safe, results of the last probe so far, recommended is -1 until it is finished
+	int GetBusProbeResults(std::vector<BusProbe::Result>& results, int32_t& recommended);
+
+	//***SESSION***
+	//opens the bus and connects the axes of the last session without listing the bus hardware or scanning, with the time of each phase
+	//every axis is tried, fails if any of them did not connect, the error of each one is journaled with its axis id
+	int OpenLastSession(double& loadMs, double& openMs, double& connectMs);
+	//empty for the default path, see SessionProfile::DefaultPath
+	int SetSessionProfilePath(const std::string& path);
+
+	//***ACCESSOR***
+	//sends every NanoLib call to accessor instead, e.g. the SimulatedAccessor of the tests, nullptr goes back to NanoLib
+	//only while no port is open, accessor must outlive its use
+	int UseAccessor(nlc::NanoLibAccessor* accessor);
+
+	//***AXES***
+	//every device call works on the selected axis, axis 0 is selected from the start
+	static constexpr uint32_t kMaxAxes = 32;
+	//creates the axis if needed and connects it, does not change the selection
+	int ConnectAxis(uint32_t axisId, uint32_t deviceToOpen);
+	//connects devicesToOpen[i] as axis i, with at most one scan for all of them
+	int ConnectAxes(const std::vector<uint32_t>& devicesToOpen);
+	int SelectAxis(uint32_t axisId);
+	int GetSelectedAxis(uint32_t& axisId);
+	int GetConnectedAxes(std::vector<uint32_t>& axisIds);
+
+	//like Execute, command sees axisId as the selected axis, the selection itself is kept
+	template <class F>
+	int ExecuteOnAxis(uint32_t axisId, F&& command, const std::source_location& where = std::source_location::current()) {
+		return Execute([&] {
+			Axis* axis = FindAxis(axisId);
+			if (axis == nullptr)
+				return UnknownAxis(axisId);
+			return OnAxis(axis, command);
+		}, where);
+	}
+	template <class F>
+	int ExecuteUrgentOnAxis(uint32_t axisId, F&& command, const std::source_location& where = std::source_location::current()) {
+		return ExecuteUrgent([&] {
+			Axis* axis = FindAxis(axisId);
+			if (axis == nullptr)
+				return UnknownAxis(axisId);
+			return OnAxis(axis, command);
+		}, where);
+	}
+	void PostOnAxis(uint32_t axisId, std::function<int()> command, const std::source_location& where = std::source_location::current());
 
 	int ConfigureInputs();
 
 	int GetModeOfOperation(std::string& mode);
 
+	//controlword shadow
+	int ResyncControlWord();
+	int GetControlWordStats(uint64_t& reads, uint64_t& writes, uint64_t& readsAvoided);
+
+	//connection state
+	int SetConnectionProbePeriod(uint32_t periodMs);
+	int GetConnectionStats(uint64_t& checksAvoided, uint64_t& checksQueried, uint64_t& probes, uint64_t& transportErrors);
+
+	//telemetry
+	int StartTelemetry(const std::vector<nlc::OdIndex>& objects, uint16_t periodMs);
+	int StopTelemetry();
+	//rows holds maxRows * (1 + channels) values, see Telemetry::Drain
+	int DrainTelemetry(int64_t* rows, int32_t maxRows, int32_t& rowsCopied, int32_t& channels);
+	//timesMs holds maxRows values, values maxRows * Telemetry::kMaxChannels
+	int DrainTelemetry(double* timesMs, int32_t* values, int32_t maxRows, int32_t& rowsCopied, int32_t& channels);
+	int DrainTelemetry(double* timesMs, double* values, int32_t maxRows, int32_t& rowsCopied, int32_t& channels);
+	int GetTelemetryStats(double& sampleRate, uint64_t& samples, uint64_t& overruns, uint64_t& drops, uint64_t& errors);
+
+	//***CYCLIC SYNCHRONOUS POSITION***
+	//switches the selected axis to cyclic synchronous position, holds its position and writes a set point every periodUs from then on
+	int StartCyclicPosition(uint32_t periodUs);
+	int StopCyclicPosition();
+	//every axis has a feeder of its own, the calls below work on the one of the selected axis
+	//copies as many set points as fit into the feeder, free is the room left; last marks the end of the trajectory
+	int PushSetpoints(const int32_t* setpoints, int32_t count, bool last, int32_t& accepted, int32_t& free);
+	int GetSetpointFeederStats(SetpointFeeder::Stats& stats);
+	int GetFollowingError(int32_t& followingError);
+
+	//***INTERPOLATED POSITION***
+	//switches the selected axis to interpolated position and feeds one record of 60C1h:01 every periodUs,
+	//keeping the buffer of the drive filled as far as it reaches
+	int StartInterpolatedPosition(uint32_t periodUs);
+	int StopInterpolatedPosition();
+	//the whole trajectory at once, starts interpolated position with timeBaseUs unless it runs with it already,
+	//fails without pushing anything if it does not fit, PushSetpoints appends more
+	int UploadTrajectory(const int32_t* positions, int32_t count, uint32_t timeBaseUs);
+
+	//bus thread, every exported call runs through Execute or Post
+	//where names the call in the perf stats, the exported function calling Execute
+	template <class F>
+	int Execute(F&& command, const std::source_location& where = std::source_location::current()) {
+		return busExecutor_.Execute([&] {
+			PerfStats::Call call(perf_, where.function_name());
+			return command();
+		});
+	}
+	//ahead of every queued call, for halt and quick stop
+	template <class F>
+	int ExecuteUrgent(F&& command, const std::source_location& where = std::source_location::current()) {
+		return busExecutor_.ExecuteUrgent([&] {
+			PerfStats::Call call(perf_, where.function_name());
+			return command();
+		});
+	}
+	void Post(std::function<int()> command, const std::source_location& where = std::source_location::current()) {
+		busExecutor_.Post([this, command = std::move(command), name = where.function_name()] {
+			PerfStats::Call call(perf_, name);
+			return command();
+		});
+	}
+	int GetBusQueueStats(uint32_t& depth, uint32_t& maxDepth, uint64_t& executed, uint64_t& posted, double& avgWaitUs, double& maxWaitUs);
+
+	//time and SDO count per exported call and time per object read or written, thread-safe, off by default
+	int SetPerfStatsEnabled(bool enabled);
+	int ResetPerfStats();
+	int GetPerfStats(std::vector<PerfStats::SiteStats>& sites);
+	//GetPerfStats and the slowest calls as a text table
+	int GetPerfReport(std::string& report);
+
 	int GetCiA402State(std::string& state, bool& fault, bool& voltageEnabled, bool& quickStop, bool& warning, bool& targetReached, bool& limitReached, bool& bit12, bool& bit13);
 
 	//motor specific
 	int SetMotorParameters(uint32_t polePairCount, uint32_t ratedCurrent, uint32_t maxCurrent, uint32_t maxCurrentDuration,uint32_t openLoopIdleCurrent, uint32_t driveMode);
 	int GetMotorParameters(uint32_t &polePairCount, uint32_t &ratedCurrent, uint32_t &maxCurrent, uint32_t &maxCurrentDuration, uint32_t& openLoopIdleCurrent, uint32_t &driveMode);
-	int SaveGroupMovement();
-	int SaveGroupApplication();
-	int SaveGroupTuning();
-	int AutoSetupMotPams();
 
 	//***HOMING***
 	int Home(uint32_t speedZeroUserUnit = 10, uint32_t speedSwitchUserUnit = 50);
 
+	//***JOBS***
+	//long operations on the job pool, they return a job id at once
+	int StartSaveGroupsAsync(const std::vector<uint8_t>& groups, uint32_t& jobId);
+	int StartAutoSetupMotPamsAsync(uint32_t& jobId);
+	int StartHomeAsync(uint32_t speedZeroUserUnit, uint32_t speedSwitchUserUnit, uint32_t& jobId);
+	//thread safe, must not be called on the bus thread while waiting for a job
+	int PollJob(uint32_t jobId, int32_t& progress, int32_t& state);
+	int WaitJob(uint32_t jobId, uint32_t timeoutMs);
+	int CancelJob(uint32_t jobId);
+
+	//***WAITING***
+	//blocks the caller until statusword bit 10 is set, polls go through the bus thread
+	int WaitTargetReached(uint32_t timeoutMs);
+	int WaitTargetReachedOnAxis(uint32_t axisId, uint32_t timeoutMs);
+	//kind is a CompletionWaiter::Kind, thread safe
+	int SetWaitPolicy(int32_t kind, uint32_t minIntervalMs, uint32_t maxIntervalMs, uint32_t deadlineMs, double growth);
+	//histogram bucket i counts completions below 2^i ms
+	int GetWaitStats(int32_t kind, uint64_t& completed, uint64_t& failed, uint64_t& timedOut, uint64_t& cancelled, uint64_t& polls,
+		double& avgMs, double& minMs, double& maxMs, uint64_t* histogram, int32_t histogramSize);
+
 	//***POSITIONING***
 	int StartPositioning();
 	int SetTargetPosition(int32_t val, uint32_t absRel);
@@ -64,6 +249,15 @@ public:
 	int SetProfileVelocity(uint32_t speed);
 	int GetPositioningParameters(uint32_t &profileVelocity, int32_t &targetPosition);
 
+	//***WAYPOINTS***
+	//appends profile position targets for the selected axis, velocities (6081h per target) may be nullptr to keep the profile velocity
+	//a job hands them to the drive one by one as soon as its set point buffer is free, the moves blend without stopping
+	//jobId is the job feeding the drive, also when it was started by an earlier call
+	int QueueTargets(const int32_t* positions, const uint32_t* velocities, int32_t count, uint32_t absRel, uint32_t& jobId);
+	//drops the targets not sent yet, the drive completes the ones it has
+	int ClearWaypoints();
+	int GetWaypointQueueStats(WaypointQueue::Stats& stats);
+
 	//***VELOCITY***
 	int StartVelocity();
 	int SetTargetVelocity(int16_t vel);
@@ -74,12 +268,43 @@ public:
 	int GetVelocityDeceleration(uint32_t &deltaSpeed, uint16_t &deltaTime);
 	int GetVelocityDemanded(int16_t &demandedSpeed);
 	int GetVelocityActual(int16_t &velActual);
+	int GetVelocityStatus(int16_t &demandedSpeed, int16_t &velActual);
+	int GetVelocityParameters(int16_t &vel, uint32_t &deltaSpeedAcc, uint16_t &deltaTimeAcc, uint32_t &deltaSpeedDec, uint16_t &deltaTimeDec);
+	//any thread, latest value wins like PostTargetTorque
+	void PostTargetVelocity(std::optional<uint32_t> axisId, int16_t vel);
+	CoalescingSetpoint<int16_t>::Stats GetTargetVelocityStats() const;
+
+	//***PROFILE VELOCITY***
+	int StartProfileVelocity();
+	int SetTargetProfileVelocity(int32_t vel);
+	int SetProfileVelocityAcceleration(uint32_t acc);
+	int SetProfileVelocityDeceleration(uint32_t dec);
+	int GetProfileVelocityParameters(int32_t& vel, uint32_t& acc, uint32_t& dec);
+	int GetProfileVelocityStatus(int32_t& demandedVel, int32_t& velActual);
+	//any thread, latest value wins like PostTargetTorque
+	void PostTargetProfileVelocity(std::optional<uint32_t> axisId, int32_t vel);
+	CoalescingSetpoint<int32_t>::Stats GetTargetProfileVelocityStats() const;
+
+	//***PROFILE TORQUE***
+	//torques in per mille of the rated torque, currents in per mille of the rated current
+	int StartProfileTorque();
+	int SetTargetTorque(int16_t torque);
+	int SetTorqueSlope(uint32_t slope);
+	int SetMaxTorque(uint16_t maxTorque);
+	int GetProfileTorqueParameters(int16_t& targetTorque, uint32_t& slope, uint16_t& maxTorque);
+	int GetTorqueStatus(int16_t& torqueActual, int16_t& currentActual);
+	//any thread, latest value wins: a torque posted while the previous one still waits for the bus thread replaces it
+	//axisId empty for the axis selected when the torque is posted, a later SelectAxis does not move it
+	void PostTargetTorque(std::optional<uint32_t> axisId, int16_t torque);
+	//summed over all axes
+	CoalescingSetpoint<int16_t>::Stats GetTargetTorqueStats() const;
 
 	//getter user defined units
 	int GetUserUnitsPositioning(uint32_t &unit, uint32_t &exp);
 	int GetUserUnitsVelocity(uint32_t& unit, uint32_t &exp, uint32_t &time );
 	int GetUserUnitsFeed(uint32_t& feed, uint32_t& shaftsRevolutions);
 	int GetUserUnitsGearRatio(uint32_t& gearRatioMotorRevs, uint32_t& gearRatioShaftRevs);
+	int GetUserUnits(uint32_t& feed, uint32_t& shaftRevs, uint32_t& posUnit, uint32_t& posExp, uint32_t& velUnit, uint32_t& velExp, uint32_t& velTime, uint32_t& gearRatioMotorRevs, uint32_t& gearRatioShaftRevs);
 
 	//spindelsteigung 
 	int SetUserUnitsFeed(uint32_t feed, uint32_t shaftsRevolutions);
@@ -102,18 +327,178 @@ private:
 
 	static Controller* instancePtr_;
 
-	std::unique_ptr<PowerSM> powerSM_;
+	//declared first, the bus thread and NanoLibHelper record into it until they are gone
+	PerfStats perf_;
+
+	std::unique_ptr<Telemetry> telemetry_;
+	std::unique_ptr<JobManager> jobs_;
+	std::unique_ptr<Discovery> discovery_;
 
 	NanoLibHelper nanolibHelper_;
 	std::optional<nlc::BusHardwareId> openedBusHardware_;
-	std::optional<nlc::DeviceHandle> connectedDeviceHandle_;
-
-	std::vector<nanolib_exception> exceptions_;
+	//options replacing the defaults of createBusHardwareOptions, by option name
+	std::map<std::string, std::string> busOptions_;
+	//owner of jobs that belong to no axis
+	static constexpr uint32_t kBusJobOwner = kMaxAxes;
+	//slot i for axis i; fixed so posting never touches axes_
+	std::array<CoalescingSetpoint<int16_t>, kMaxAxes> targetTorques_;
+	std::array<CoalescingSetpoint<int16_t>, kMaxAxes> targetVelocities_;
+	std::array<CoalescingSetpoint<int32_t>, kMaxAxes> targetProfileVelocities_;
+	uint32_t busProbeJobId_ = 0;
+	std::mutex busProbeMutex_;
+	std::vector<BusProbe::Result> busProbeResults_;
+	int32_t busProbeRecommended_ = -1;
+
+	//bus, options and devices of this session, written to sessionProfilePath_ whenever a device is connected
+	std::optional<SessionProfile> session_;
+	std::filesystem::path sessionProfilePath_;
+	//devices of the last scan of each bus, ConnectDevice picks from them without scanning again
+	ScanCache scanCache_;
+
+	//axes by id, an axis is never removed once created
+	std::map<uint32_t, std::unique_ptr<Axis>> axes_;
+	//selected axis, only touched on the bus thread
+	Axis* axis_;
+	//id of the axis SelectAxis selected last, read by the posts from any thread; OnAxis does not change it
+	std::atomic<uint32_t> selectedAxisId_{ 0 };
+	uint32_t probePeriodMs_;
+
+	//polling of save, auto setup, homing and target reached
+	CompletionWaiter waiter_;
+
+	//every error recorded by RecordException, bounded
+	ErrorJournal errors_;
 
 	int CheckConnection();
+	void RecordException(const nanolib_exception& e);
+	//records the write error that stopped the feeder of the selected axis, if any
+	void RecordFeederError();
+	//stops the feeder of the selected axis
+	void StopFeeder();
+	//disconnects the device of the selected axis and drops everything cached for it
+	void ReleaseDevice();
+	//ClosePort for the destructor, on the calling thread and without stopping the threads of the axes
+	void ReleaseHardware();
+	//connects device deviceToOpen of scan generation to the selected axis, if the cached id fails
+	//probes its node id (CANopen) and rescans only if that fails as well
+	void ConnectScannedDevice(uint32_t generation, uint32_t deviceToOpen);
+	//makes the connected device the one of the selected axis
+	void AdoptDevice(const nlc::DeviceHandle& deviceHandle, const nlc::DeviceId& deviceId);
+	//remembers deviceId as the device of the selected axis in the session profile
+	void SaveSession(const nlc::DeviceId& deviceId);
+	//axis other than the selected one the device is connected to, nullptr if none
+	const Axis* AxisConnectedTo(const nlc::DeviceId& deviceId) const;
+	//connects and adopts the first candidate not in tried that answers and has serialNumber (if not empty)
+	std::optional<nlc::DeviceId> ConnectFirstMatch(const std::vector<nlc::DeviceId>& candidates, const std::string& serialNumber,
+		const std::vector<nlc::DeviceId>& tried);
+	//addDevice and connectDevice, the device is removed again if the connect fails
+	nlc::DeviceHandle AttachDevice(const nlc::DeviceId& deviceId);
+	//AttachDevice and a read of the device type, empty and nothing left attached if the device does not answer
+	std::optional<nlc::DeviceHandle> ProbeDevice(const nlc::DeviceId& deviceId);
+	//CANopen node of the opened bus, to connect it under its node id without a scan, matches a scanned id of the node
+	nlc::DeviceId NodeDeviceId(uint32_t nodeId) const;
+	//cached scan of the opened bus, scans if there is none or rescan is set
+	const ScanCache::Entry& ScanOpenedBus(bool rescan);
+
+	//discovery workers, the opened bus is scanned on the bus thread, any other bus on the worker itself
+	std::vector<Discovery::Device> DiscoverOpenedBus(const nlc::BusHardwareId& busHwId, nlc::NlcScanBusCallback* callback, bool readSerialNumbers);
+	std::vector<Discovery::Device> DiscoverBus(const nlc::BusHardwareId& busHwId, const std::map<std::string, std::string>& busOptions,
+		nlc::NlcScanBusCallback* callback, bool readSerialNumbers);
+
+	bool IsBusProbeRunning();
+
+	Axis* FindAxis(uint32_t axisId);
+	//creates the axis if it does not exist yet
+	Axis* AddAxis(uint32_t axisId);
+	int UnknownAxis(uint32_t axisId);
+	//runs command with axis selected and selects the previous axis again afterwards, bus thread only
+	template <class F>
+	int OnAxis(Axis* axis, F&& command) {
+		struct Restore {
+			Axis*& selected;
+			Axis* previous;
+			~Restore() { selected = previous; }
+		} restore{ axis_, axis_ };
+		axis_ = axis;
+		return command();
+	}
+
+	int WaitTargetReached(std::optional<uint32_t> axisId, uint32_t timeoutMs);
+
+	//one bus step of a job on the axis it was started for, runs on the bus thread and records errors like any other call
+	template <class F>
+	int JobStep(Axis* axis, F&& step) {
+		return Execute([&] {
+			return OnAxis(axis, [&] {
+				try {
+					CheckConnection();
+					return static_cast<int>(step());
+				}
+				catch (const nanolib_exception& e) {
+					RecordException(e);
+					return EXIT_FAILURE;
+				}
+			});
+		});
+	}
+	void RecordJobError(const char* message);
+
+	//job body of QueueTargets, runs until the queue is empty and the last target is reached
+	JobState RunWaypoints(JobContext& job, Axis* axis);
+
+	//posts a write of the newest value of the slot of axisId unless one is pending already, write runs on the bus thread
+	//with axisId selected; empty takes the axis selected now, so a value is never written to an axis selected later
+	template <class T>
+	void PostLatest(std::array<CoalescingSetpoint<T>, kMaxAxes>& slots, std::optional<uint32_t> axisId, T value, int (Controller::*write)(T),
+		const std::source_location& where = std::source_location::current()) {
+		const uint32_t id = axisId.value_or(selectedAxisId_.load());
+		if (id >= kMaxAxes) {
+			//no slot, reported as unknown axis on the bus thread
+			PostOnAxis(id, [this, value, write] { return (this->*write)(value); }, where);
+			return;
+		}
+		CoalescingSetpoint<T>& slot = slots[id];
+		if (!slot.Store(value))
+			return;
+		Post([this, &slot, id, write] {
+			//taken before anything can fail, a slot left pending would swallow every later value
+			const std::optional<T> latest = slot.Take();
+			if (!latest.has_value())
+				return EXIT_SUCCESS;
+			Axis* axis = FindAxis(id);
+			if (axis == nullptr)
+				return UnknownAxis(id);
+			return OnAxis(axis, [&] { return (this->*write)(*latest); });
+		}, where);
+	}
+
+	template <class T>
+	static typename CoalescingSetpoint<T>::Stats SumStats(const std::array<CoalescingSetpoint<T>, kMaxAxes>& slots) {
+		typename CoalescingSetpoint<T>::Stats total;
+		for (const CoalescingSetpoint<T>& slot : slots) {
+			const typename CoalescingSetpoint<T>::Stats stats = slot.GetStats();
+			total.stored += stats.stored;
+			total.written += stats.written;
+			total.coalesced += stats.coalesced;
+		}
+		return total;
+	}
+
+	template <class T>
+	int DrainTelemetryAs(double* timesMs, T* values, int32_t maxRows, int32_t& rowsCopied, int32_t& channels) {
+		channels = static_cast<int32_t>(telemetry_->GetChannelCount());
+		rowsCopied = 0;
+		if (timesMs == nullptr || values == nullptr || maxRows <= 0)
+			return EXIT_SUCCESS;
+		rowsCopied = static_cast<int32_t>(telemetry_->Drain(timesMs, values, static_cast<size_t>(maxRows)));
+		return EXIT_SUCCESS;
+	}
 
 	int ReadDigitalInputs(uint8_t& states);
 
+	//last member, so the bus thread is stopped before anything it uses is destroyed
+	BusExecutor busExecutor_;
+
 };
 
 
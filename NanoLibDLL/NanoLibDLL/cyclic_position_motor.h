@@ -0,0 +1,47 @@
+#pragma once
+
+#include "motor.h"
+
+/* Motor in Cyclic Synchronous Position Mode
+ the drive follows 607Ah, which must be written once per interpolation period (SetInterpolationPeriod), see SetpointFeeder
+ special function: there is no ramp in the drive, the set points are the trajectory
+*/
+class CyclicPositionMotor : public Motor402 {
+
+public:
+	CyclicPositionMotor(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle, PowerSM *powerSM, std::optional<int8_t> *activeMode) :
+		Motor402(nanolibHelper, connectedDeviceHandle, powerSM, activeMode)
+	{
+	}
+
+	//switch the drive to this mode, only touches the bus if the mode differs
+	int Activate() {
+		return SetModeOfOperation(OperationMode::CyclicSynchronousPosition);
+	}
+
+	int startCyclicPosition() {
+		//hold the actual position, a stale 607Ah would make the drive jump to it
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), GetPositionActual(), nlc::OdIndex(0x607A, 0x00));
+
+		//reset halt bit
+		controlWord_->Modify(0, (1U << 8));
+
+		//power sm to operation enabled, the drive follows 607Ah from now on
+		if (powerSM_->EnableOperation())
+			return EXIT_FAILURE;
+
+		return EXIT_SUCCESS;
+	}
+
+	//difference between the demanded and the actual position in user defined units
+	int32_t getFollowingError() {
+		return static_cast<int32_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x60F4, 0x00)));
+	}
+
+private:
+
+	uint16_t getState() {
+		return EXIT_SUCCESS;
+	}
+
+};
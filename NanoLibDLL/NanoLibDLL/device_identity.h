@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+#include "nanolib_helper.hpp"
+
+/*
+Objects of CiA 301 every device has.
+A read of the device type tells whether a node answers, the identity object which device it is:
+a node id on the bus may answer with another device than the one connected there before.
+*/
+struct DeviceIdentity {
+	//device type
+	static inline const nlc::OdIndex kDeviceType{ 0x1000, 0x00 };
+	//identity object 1018h
+	static inline const nlc::OdIndex kVendorId{ 0x1018, 0x01 };
+	static inline const nlc::OdIndex kProductCode{ 0x1018, 0x02 };
+	static inline const nlc::OdIndex kSerialNumber{ 0x1018, 0x04 };
+
+	uint32_t vendorId = 0;
+	uint32_t productCode = 0;
+	uint32_t serialNumber = 0;
+
+	bool operator==(const DeviceIdentity&) const = default;
+
+	//three SDO reads, throws if the device does not answer
+	static DeviceIdentity Read(const NanoLibHelper& nanolibHelper, const nlc::DeviceHandle& deviceHandle) {
+		DeviceIdentity identity;
+		identity.vendorId = static_cast<uint32_t>(nanolibHelper.readInteger(deviceHandle, kVendorId));
+		identity.productCode = static_cast<uint32_t>(nanolibHelper.readInteger(deviceHandle, kProductCode));
+		identity.serialNumber = static_cast<uint32_t>(nanolibHelper.readInteger(deviceHandle, kSerialNumber));
+		return identity;
+	}
+};
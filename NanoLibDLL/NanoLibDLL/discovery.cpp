@@ -0,0 +1,124 @@
+#include "discovery.h"
+
+#include <algorithm>
+
+Discovery::~Discovery() {
+	//Stop was not called, leave the workers to the unload instead of deadlocking it
+	for (std::thread& worker : workers_)
+		worker.detach();
+}
+
+bool Discovery::Start(const std::vector<nlc::BusHardwareId>& buses, Scan scan) {
+	if (IsRunning())
+		return false;
+	//the workers of the last discovery are done, joining them does not block
+	Join();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		events_.clear();
+		devices_.clear();
+		busesTotal_ = static_cast<uint32_t>(buses.size());
+		busesDone_ = 0;
+	}
+	scan_ = std::move(scan);
+	cancel_ = false;
+	running_ = static_cast<uint32_t>(buses.size());
+	for (uint32_t bus = 0; bus < buses.size(); bus++)
+		workers_.emplace_back(&Discovery::Run, this, bus, buses[bus]);
+	return true;
+}
+
+void Discovery::Cancel() {
+	cancel_ = true;
+}
+
+void Discovery::Stop() {
+	Cancel();
+	Join();
+}
+
+bool Discovery::PopEvent(Event& event) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (events_.empty())
+		return false;
+	event = std::move(events_.front());
+	events_.pop_front();
+	return true;
+}
+
+std::vector<Discovery::Device> Discovery::GetDevices() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return devices_;
+}
+
+void Discovery::GetProgress(uint32_t& busesTotal, uint32_t& busesDone) const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	busesTotal = busesTotal_;
+	busesDone = busesDone_;
+}
+
+nlc::ResultVoid Discovery::Callback::callback(nlc::BusScanInfo info, std::vector<nlc::DeviceId> const& devicesFound, int32_t data) {
+	switch (info) {
+	case nlc::BusScanInfo::Progress:
+		owner_->Push({ EventType::Progress, bus_, data, {} });
+		break;
+
+	case nlc::BusScanInfo::FoundDevice:
+		//devicesFound holds everything found so far, the new device is the last one
+		if (!devicesFound.empty()) {
+			const nlc::DeviceId& device = devicesFound.back();
+			owner_->Push({ EventType::Found, bus_, static_cast<int32_t>(device.getDeviceId()), device.getDescription() });
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	if (owner_->cancel_)
+		return nlc::ResultVoid(nlc::NlcErrorCode::OperationAborted, "discovery cancelled");
+	return nlc::ResultVoid();
+}
+
+void Discovery::Run(uint32_t bus, nlc::BusHardwareId busHwId) {
+	Push({ EventType::Started, bus, 0, busHwId.getName() });
+
+	std::vector<Device> found;
+	try {
+		Callback callback(this, bus);
+		found = scan_(busHwId, &callback);
+		Push({ EventType::Finished, bus, static_cast<int32_t>(found.size()), {} });
+	}
+	catch (const nanolib_exception& e) {
+		Push({ EventType::Failed, bus, 0, e.what() });
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (Device& device : found) {
+			device.bus = bus;
+			device.busName = busHwId.getName();
+			devices_.push_back(std::move(device));
+		}
+		std::sort(devices_.begin(), devices_.end(), [](const Device& a, const Device& b) {
+			return a.bus != b.bus ? a.bus < b.bus : a.index < b.index;
+		});
+		busesDone_++;
+	}
+	//last, Start only joins workers that got here
+	running_--;
+}
+
+void Discovery::Push(Event event) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (events_.size() >= kMaxEvents)
+		events_.pop_front();
+	events_.push_back(std::move(event));
+}
+
+void Discovery::Join() {
+	for (std::thread& worker : workers_)
+		worker.join();
+	workers_.clear();
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nanolib_helper.hpp"
+
+/*
+Scans all bus hardware at the same time, one worker thread per bus.
+A commissioning run with USB, CAN and Modbus adapters then takes as long as the slowest bus instead of the sum of all of them.
+The callbacks of NanoLib are turned into events in a bounded queue that LabVIEW polls,
+the devices of all buses are merged into one table.
+*/
+class Discovery {
+public:
+
+	enum class EventType : int32_t {
+		//value is 0, text the name of the bus
+		Started,
+		//value is the progress reported by NanoLib
+		Progress,
+		//value is the node id, text the description of the device
+		Found,
+		//value is the number of devices found
+		Finished,
+		//text is the error
+		Failed
+	};
+
+	struct Event {
+		EventType type;
+		uint32_t bus;
+		int32_t value;
+		std::string text;
+	};
+
+	struct Device {
+		//index into the list of bus hardware, same as OpenPort
+		uint32_t bus = 0;
+		//index into the scan of the bus, same as ConnectDevice
+		uint32_t index = 0;
+		uint32_t nodeId = 0;
+		std::string busName;
+		std::string description;
+		//empty if it could not be read
+		std::string serialNumber;
+	};
+
+	//scans one bus reporting to callback, returns the devices with index, node id, description and serial number
+	using Scan = std::function<std::vector<Device>(const nlc::BusHardwareId& busHwId, nlc::NlcScanBusCallback* callback)>;
+
+	//oldest events are dropped when the queue is full
+	static constexpr size_t kMaxEvents = 1024;
+
+	//joining here would block on the loader lock at DLL unload, without Stop the workers are left to the unload
+	~Discovery();
+
+	//starts one worker per bus, bus i of the events and devices is buses[i], false while a discovery is running
+	bool Start(const std::vector<nlc::BusHardwareId>& buses, Scan scan);
+	//the running scans are aborted at their next callback
+	void Cancel();
+	//cancels and waits for the workers
+	void Stop();
+	bool IsRunning() const { return running_ > 0; }
+
+	//false if the queue is empty
+	bool PopEvent(Event& event);
+	//devices of all buses finished so far, ordered by bus and index
+	std::vector<Device> GetDevices() const;
+	void GetProgress(uint32_t& busesTotal, uint32_t& busesDone) const;
+
+private:
+
+	class Callback : public nlc::NlcScanBusCallback {
+	public:
+		Callback(Discovery* owner, uint32_t bus) : owner_(owner), bus_(bus) {}
+		nlc::ResultVoid callback(nlc::BusScanInfo info, std::vector<nlc::DeviceId> const& devicesFound, int32_t data) override;
+	private:
+		Discovery* owner_;
+		uint32_t bus_;
+	};
+
+	void Run(uint32_t bus, nlc::BusHardwareId busHwId);
+	void Push(Event event);
+	void Join();
+
+	mutable std::mutex mutex_;
+	std::deque<Event> events_;
+	std::vector<Device> devices_;
+	uint32_t busesTotal_ = 0;
+	uint32_t busesDone_ = 0;
+
+	Scan scan_;
+	std::atomic<uint32_t> running_{ 0 };
+	std::atomic<bool> cancel_{ false };
+	std::vector<std::thread> workers_;
+};
@@ -0,0 +1,57 @@
+#include "error_journal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+void ErrorJournal::Add(const nanolib_exception& e, uint32_t axisId) {
+	const int64_t timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+	const char* message = e.what();
+	const size_t length = std::min(std::strlen(message), kMessageSize - 1);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	Record& record = records_[nextSeq_ % kCapacity];
+	if (record.seq > drainedSeq_)
+		dropped_++;
+
+	record.seq = nextSeq_++;
+	record.timeMs = timeMs;
+	record.errorCode = e.getErrorCode();
+	record.exErrorCode = e.getExErrorCode();
+	record.hasOdIndex = e.getOdIndex().has_value();
+	record.index = record.hasOdIndex ? e.getOdIndex()->getIndex() : 0;
+	record.subIndex = record.hasOdIndex ? e.getOdIndex()->getSubIndex() : 0;
+	record.axisId = axisId;
+	std::memcpy(record.message.data(), message, length);
+	record.message[length] = '\0';
+}
+
+uint64_t ErrorJournal::Drain(uint64_t sinceSeq, std::vector<Record>& records, uint64_t& missed) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	const uint64_t oldestSeq = nextSeq_ > kCapacity ? nextSeq_ - kCapacity : 1;
+	const uint64_t first = std::max(sinceSeq + 1, oldestSeq);
+	missed = first - (sinceSeq + 1);
+
+	records.clear();
+	for (uint64_t seq = first; seq < nextSeq_; seq++)
+		records.push_back(records_[seq % kCapacity]);
+
+	drainedSeq_ = std::max(drainedSeq_, nextSeq_ - 1);
+	return nextSeq_ - 1;
+}
+
+std::vector<std::string> ErrorJournal::GetMessages() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	const uint64_t oldestSeq = nextSeq_ > kCapacity ? nextSeq_ - kCapacity : 1;
+	std::vector<std::string> messages;
+	for (uint64_t seq = oldestSeq; seq < nextSeq_; seq++)
+		messages.emplace_back(records_[seq % kCapacity].message.data());
+	return messages;
+}
+
+void ErrorJournal::GetStats(uint64_t& recorded, uint64_t& dropped) const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	recorded = nextSeq_ - 1;
+	dropped = dropped_;
+}
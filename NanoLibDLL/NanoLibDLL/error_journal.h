@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "nanolib_helper.hpp"
+
+/*
+Last errors recorded by the controller in a fixed ring of records, the oldest is overwritten when it is full.
+Recording copies into a preallocated slot and does not allocate, messages longer than a slot are cut.
+Readers keep the sequence number of the last record they saw and drain everything after it,
+records overwritten before they were drained are counted.
+*/
+class ErrorJournal {
+public:
+
+	static constexpr size_t kCapacity = 256;
+	static constexpr size_t kMessageSize = 240;
+
+	struct Record {
+		//starts at 1, 0 is "nothing seen yet" for Drain
+		uint64_t seq = 0;
+		//ms since 1970
+		int64_t timeMs = 0;
+		nlc::NlcErrorCode errorCode = nlc::NlcErrorCode::Success;
+		uint32_t exErrorCode = 0;
+		bool hasOdIndex = false;
+		uint16_t index = 0;
+		uint8_t subIndex = 0;
+		uint32_t axisId = 0;
+		//zero terminated
+		std::array<char, kMessageSize> message{};
+	};
+
+	void Add(const nanolib_exception& e, uint32_t axisId);
+
+	//copies the records after sinceSeq, oldest first, missed counts the ones already overwritten
+	//returns the sequence number to pass next time
+	uint64_t Drain(uint64_t sinceSeq, std::vector<Record>& records, uint64_t& missed);
+
+	//messages of all records still in the ring, oldest first
+	std::vector<std::string> GetMessages() const;
+
+	//recorded in total and overwritten before they were drained by anyone
+	void GetStats(uint64_t& recorded, uint64_t& dropped) const;
+
+private:
+
+	mutable std::mutex mutex_;
+	std::array<Record, kCapacity> records_;
+	//sequence number of the next record
+	uint64_t nextSeq_ = 1;
+	//highest sequence number drained by any reader
+	uint64_t drainedSeq_ = 0;
+	uint64_t dropped_ = 0;
+};
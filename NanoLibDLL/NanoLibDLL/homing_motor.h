@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <bitset>
 
 #include "motor.h"
@@ -10,10 +11,14 @@ Encoder - Index bzw.Positionsschalter auszurichten.
 class HomingMotor : public Motor402 {
 
 public:
-	HomingMotor(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle, PowerSM *powerSM) :
-		Motor402(nanolibHelper, connectedDeviceHandle, powerSM)
+	HomingMotor(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle, PowerSM *powerSM, std::optional<int8_t> *activeMode) :
+		Motor402(nanolibHelper, connectedDeviceHandle, powerSM, activeMode)
 	{
-		SetModeOfOperation(OperationMode::Homing);
+	}
+
+	//switch the drive to this mode, only touches the bus if the mode differs
+	int Activate() {
+		return SetModeOfOperation(OperationMode::Homing);
 	}
 
 
@@ -33,21 +38,17 @@ public:
 		uint16_t cs = getState();
 
 		if (cs == Status::H_IN_PROGRESS) {
-			uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6040, 0x00)));
-			uWord16 &= ~(1U << 4);
-			nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
+			controlWord_->Modify(0, (1U << 4));
 		}
 
 		//Limit Switch Error Option Code
 		
 		/*keine Reaktion(um z.B.eine Referenzfahrt durchzufhren), auer
 		Vermerken der Endschalterposition*/
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), -1, nlc::OdIndex(0x3701, 0x00), 16);
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), -1, nlc::OdIndex(0x3701, 0x00));
 
-		uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6040, 0x00)));
 		//go set start bit
-		uWord16 |= (1U << 4);
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);		
+		controlWord_->Modify((1U << 4), 0);
 
 		if (powerSM_->EnableOperation())
 			return EXIT_FAILURE;
@@ -56,10 +57,8 @@ public:
 	}
 
 	int Halt() override {
-		uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6040, 0x00)));
 		//reset start bit
-		uWord16 &= ~(1U << 4);
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
+		controlWord_->Modify(0, (1U << 4));
 		return EXIT_SUCCESS;
 	}
 
@@ -76,12 +75,12 @@ public:
 	}
 
 	void setHomingAcceleration(uint32_t acc){
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), acc, nlc::OdIndex(0x609A, 0x00), 32);
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), acc, nlc::OdIndex(0x609A, 0x00));
 	}
 
 	void setHomingMode(uint8_t method)
 	{
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), method, nlc::OdIndex(0x6098, 0x00), 8);
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), method, nlc::OdIndex(0x6098, 0x00));
 	}
 
 	int setHomingSpeed(uint32_t speedZero, uint32_t speedSwitch) {
@@ -91,9 +90,9 @@ public:
 			return EXIT_FAILURE;
 		}
 		//set speed during search for zero
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), speedZero, nlc::OdIndex(0x6099, 0x02), 32);
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), speedZero, nlc::OdIndex(0x6099, 0x02));
 		//set speed during search for switch
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value() , speedSwitch, nlc::OdIndex(0x6099, 0x01), 32);
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value() , speedSwitch, nlc::OdIndex(0x6099, 0x01));
 		return EXIT_SUCCESS;
 	}
 
@@ -105,65 +104,40 @@ public:
 	*/
 
 	uint16_t getState() {
-		uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6041, 0x00)));
-		//Referenzfahrt wird ausgefhrt?
-		if (
-			!(uWord16 & (1U << 13)) &&
-			!(uWord16 & (1U << 12)) &&
-			!(uWord16 & (1U << 10))
-			)
-		{
-			return Status::H_IN_PROGRESS;
-		}
-		//Referenzfahrt ist unterbrochen oder nicht gestartet?
-		else if (
-			!(uWord16 & (1U << 13)) &&
-			!(uWord16 & (1U << 12)) &&
-			(uWord16 & (1U << 10))
-			) 
-		{
-			return Status::H_INCOMPLETE;
-		}
+		StatusWord statusWord;
+		powerSM_->GetStatusWord(statusWord);
+		return getState(statusWord);
+	}
+
+	//homing status from an already read statusword snapshot
+	static uint16_t getState(const StatusWord& statusWord) {
+		//index: bit 10 (target reached) | bit 12 (homing attained) << 1 | bit 13 (homing error) << 2
+		uint8_t idx = static_cast<uint8_t>(statusWord.targetReached | (statusWord.bit12 << 1) | (statusWord.bit13 << 2));
+		uint16_t status = kStatusTable[idx];
+		if (status == 0xFF)
+			throw(nanolib_exception("Unknown Homing State"));
+		return status;
+	}
+
+private:
+
+	static constexpr std::array<uint16_t, 8> kStatusTable{ {
+		//Referenzfahrt wird ausgefhrt
+		Status::H_IN_PROGRESS,
+		//Referenzfahrt ist unterbrochen oder nicht gestartet
+		Status::H_INCOMPLETE,
 		//Referenzfahrt ist seit dem letzten Neustart bereits durchgefhrt
 		//worden, aber Ziel ist aktuell nicht erreicht
-		else if (
-			!(uWord16 & (1U << 13)) &&
-			(uWord16 & (1U << 12)) &&
-			!(uWord16 & (1U << 10))
-			)
-		{
-			return Status::H_UNACHIEVED;
-		}
+		Status::H_UNACHIEVED,
 		//Referenzfahrt vollstndig abgeschlossen
-		else if (
-			!(uWord16 & (1U << 13)) &&
-			(uWord16 & (1U << 12)) &&
-			(uWord16 & (1U << 10))
-			)
-		{
-			return Status::H_COMPLETED;
-		}
+		Status::H_COMPLETED,
 		//Fehler whrend der Referenzfahrt, Motor dreht sich noch
-		else if (
-			(uWord16 & (1U << 13)) &&
-			!(uWord16 & (1U << 12)) &&
-			!(uWord16 & (1U << 10))
-			)
-		{
-			return Status::H_ERROR_STILL_MOVING;
-		}
+		Status::H_ERROR_STILL_MOVING,
 		//Fehler whrend der Referenzfahrt, Motor im Stillstand
-		else if (
-			(uWord16 & (1U << 13)) &&
-			!(uWord16 & (1U << 12)) &&
-			(uWord16 & (1U << 10))
-			)
-		{
-			return Status::H_ERROR_HALT;
-		}
-		throw(nanolib_exception("Unknown Homing State"));
-		return 0xFF;
-	}
+		Status::H_ERROR_HALT,
+		0xFF,
+		0xFF
+	} };
 
 };
 
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "motor.h"
+
+/* Motor in Interpolated Position Mode
+ the drive takes one record of 60C1h:01 per interpolation period (SetInterpolationPeriod) from its buffer, see SetpointFeeder
+ special function: Bit 4 in 6040h enables the interpolation, Bit 12 in 6041h shows it is active
+*/
+class InterpolatedPositionMotor : public Motor402 {
+
+public:
+	InterpolatedPositionMotor(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle, PowerSM *powerSM, std::optional<int8_t> *activeMode) :
+		Motor402(nanolibHelper, connectedDeviceHandle, powerSM, activeMode)
+	{
+	}
+
+	//switch the drive to this mode, only touches the bus if the mode differs
+	int Activate() {
+		return SetModeOfOperation(OperationMode::InterpolatedPosition);
+	}
+
+	//records the drive can buffer (60C4h:01), at least 1; a drive without the object or reporting 0 has no buffer,
+	//nor has one without the buffer position (60C4h:04), writing ahead needs to know how many records it holds
+	uint32_t getBufferSize() {
+		try {
+			const int64_t size = nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x60C4, 0x01));
+			if (size <= 1)
+				return 1;
+			nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x60C4, 0x04));
+			return static_cast<uint32_t>(std::clamp<int64_t>(size, 1, UINT32_MAX));
+		}
+		catch (const nanolib_exception& e) {
+			if (e.getErrorCode() != nlc::NlcErrorCode::ODDoesNotExist)
+				throw;
+			return 1;
+		}
+	}
+
+	int startInterpolation() {
+		//the first record holds the actual position, a stale one would make the drive jump to it
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), GetPositionActual(), nlc::OdIndex(0x60C1, 0x01));
+
+		//reset halt bit and enable ip mode (bit 4) once operation is enabled
+		controlWord_->Modify(0, (1U << 8) | (1U << 4));
+		if (powerSM_->EnableOperation())
+			return EXIT_FAILURE;
+		controlWord_->Modify((1U << 4), 0);
+
+		return EXIT_SUCCESS;
+	}
+
+	int stopInterpolation() {
+		//the drive stays where the last record took it
+		controlWord_->Modify(0, (1U << 4));
+		return EXIT_SUCCESS;
+	}
+
+private:
+
+	uint16_t getState() {
+		return EXIT_SUCCESS;
+	}
+
+};
@@ -0,0 +1,167 @@
+#include "job_manager.h"
+
+
+bool JobContext::Sleep(std::chrono::milliseconds duration) {
+	std::unique_lock<std::mutex> lock(mutex_);
+	return !cv_.wait_for(lock, duration, [this] { return cancel_.load(); });
+}
+
+JobManager::JobManager(size_t workers) :
+	nextId_(1),
+	workerCount_(workers),
+	stop_(false)
+{
+	for (size_t i = 0; i < workerCount_; i++)
+		workers_.emplace_back(&JobManager::Run, this);
+}
+
+JobManager::~JobManager() {
+	//Stop was not called, leave the workers to the unload instead of deadlocking it
+	for (std::thread& worker : workers_)
+		worker.detach();
+}
+
+void JobManager::Stop() {
+	CancelAll();
+	std::vector<std::thread> workers;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+		workers.swap(workers_);
+	}
+	queueCv_.notify_all();
+	for (std::thread& worker : workers)
+		worker.join();
+}
+
+uint32_t JobManager::Start(Body body, uint32_t owner) {
+	auto job = std::make_shared<Job>();
+	job->body = std::move(body);
+	job->owner = owner;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		job->id = nextId_++;
+		jobs_[job->id] = job;
+		queue_.push_back(job);
+		if (workers_.empty()) {
+			stop_ = false;
+			for (size_t i = 0; i < workerCount_; i++)
+				workers_.emplace_back(&JobManager::Run, this);
+		}
+	}
+	queueCv_.notify_one();
+	return job->id;
+}
+
+bool JobManager::Poll(uint32_t id, int32_t& progress, JobState& state) {
+	std::shared_ptr<Job> job = Find(id);
+	if (!job)
+		return false;
+	state = job->state;
+	progress = job->context.progress_;
+	return true;
+}
+
+bool JobManager::Wait(uint32_t id, uint32_t timeoutMs, JobState& state) {
+	std::unique_lock<std::mutex> lock(mutex_);
+	auto it = jobs_.find(id);
+	if (it == jobs_.end())
+		return false;
+	std::shared_ptr<Job> job = it->second;
+	finishedCv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&job] { return IsFinished(job->state); });
+	state = job->state;
+	return true;
+}
+
+bool JobManager::Cancel(uint32_t id) {
+	std::shared_ptr<Job> job = Find(id);
+	if (!job)
+		return false;
+	{
+		std::lock_guard<std::mutex> lock(job->context.mutex_);
+		job->context.cancel_ = true;
+	}
+	job->context.cv_.notify_all();
+	return true;
+}
+
+void JobManager::CancelAll() {
+	CancelIf([](const Job&) { return true; });
+}
+
+void JobManager::CancelOwnedBy(uint32_t owner) {
+	CancelIf([owner](const Job& job) { return job.owner == owner; });
+}
+
+void JobManager::CancelIf(const std::function<bool(const Job&)>& match) {
+	std::vector<uint32_t> ids;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (const auto& [id, job] : jobs_) {
+			if (!IsFinished(job->state) && match(*job))
+				ids.push_back(id);
+		}
+	}
+	for (uint32_t id : ids)
+		Cancel(id);
+}
+
+std::shared_ptr<JobManager::Job> JobManager::Find(uint32_t id) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = jobs_.find(id);
+	return it == jobs_.end() ? nullptr : it->second;
+}
+
+void JobManager::Prune() {
+	size_t finished = 0;
+	for (const auto& [id, job] : jobs_) {
+		if (IsFinished(job->state))
+			finished++;
+	}
+	//ids grow, so the map starts with the oldest jobs
+	for (auto it = jobs_.begin(); finished > kKeepFinished && it != jobs_.end();) {
+		if (IsFinished(it->second->state)) {
+			it = jobs_.erase(it);
+			finished--;
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+void JobManager::Run() {
+	while (true) {
+		std::shared_ptr<Job> job;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			queueCv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+			if (stop_ && queue_.empty())
+				return;
+			job = queue_.front();
+			queue_.pop_front();
+		}
+
+		JobState result = JobState::Cancelled;
+		if (!job->context.IsCancelled()) {
+			job->state = JobState::Running;
+			try {
+				result = job->body(job->context);
+			}
+			catch (...) {
+				result = JobState::Failed;
+			}
+		}
+		if (result == JobState::Succeeded)
+			job->context.SetProgress(100);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			job->state = result;
+			//the body may hold references into the controller, drop it early
+			job->body = nullptr;
+			Prune();
+		}
+		finishedCv_.notify_all();
+	}
+}
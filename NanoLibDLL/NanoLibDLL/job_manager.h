@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum class JobState : int32_t {
+	Queued,
+	Running,
+	Succeeded,
+	Failed,
+	Cancelled,
+	TimedOut
+};
+
+/*
+Handed to a running job to report progress and to notice cancellation.
+*/
+class JobContext {
+public:
+
+	//0..100
+	void SetProgress(int32_t progress) { progress_ = progress; }
+	bool IsCancelled() const { return cancel_; }
+	//sleeps for duration, false if the job was cancelled in the meantime
+	bool Sleep(std::chrono::milliseconds duration);
+
+private:
+	friend class JobManager;
+
+	std::atomic<int32_t> progress_{ 0 };
+	std::atomic<bool> cancel_{ false };
+	std::mutex mutex_;
+	std::condition_variable cv_;
+};
+
+/*
+Runs long operations (save, auto setup, homing) on a small worker pool.
+Jobs are identified by an id, callers poll or wait for them instead of blocking in the DLL call.
+Bus access of a job still goes through the bus thread, the waiting in between does not.
+*/
+class JobManager {
+public:
+
+	using Body = std::function<JobState(JobContext&)>;
+
+	JobManager(size_t workers = 2);
+	//joining here would block on the loader lock at DLL unload, without Stop the workers are left to the unload
+	~JobManager();
+
+	//owner groups jobs for CancelOwnedBy, the controller passes the axis id, starts the workers again after Stop
+	uint32_t Start(Body body, uint32_t owner = 0);
+	//false for unknown ids
+	bool Poll(uint32_t id, int32_t& progress, JobState& state);
+	//false for unknown ids, state is the state after timeoutMs at most
+	bool Wait(uint32_t id, uint32_t timeoutMs, JobState& state);
+	bool Cancel(uint32_t id);
+	void CancelAll();
+	void CancelOwnedBy(uint32_t owner);
+	//cancels all jobs and ends the workers once the running ones return
+	void Stop();
+
+	static bool IsFinished(JobState state) { return state != JobState::Queued && state != JobState::Running; }
+
+private:
+
+	struct Job {
+		uint32_t id = 0;
+		uint32_t owner = 0;
+		Body body;
+		JobContext context;
+		std::atomic<JobState> state{ JobState::Queued };
+	};
+
+	void Run();
+	std::shared_ptr<Job> Find(uint32_t id);
+	void CancelIf(const std::function<bool(const Job&)>& match);
+	//drops the oldest finished jobs, mutex_ must be held
+	void Prune();
+
+	//finished jobs kept for Poll and Wait
+	static constexpr size_t kKeepFinished = 64;
+
+	std::mutex mutex_;
+	std::condition_variable queueCv_;
+	//signalled whenever a job finishes
+	std::condition_variable finishedCv_;
+	std::deque<std::shared_ptr<Job>> queue_;
+	std::map<uint32_t, std::shared_ptr<Job>> jobs_;
+	uint32_t nextId_;
+	size_t workerCount_;
+	bool stop_;
+	std::vector<std::thread> workers_;
+};
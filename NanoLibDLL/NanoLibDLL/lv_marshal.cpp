@@ -0,0 +1,76 @@
+#include "lv_marshal.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace NanoLibWrapper {
+
+	int32_t StdStrToLVStr(const std::string& s, LStrHandle* str) {
+		MgErr err = mgNoErr;
+		// Resize string handle only if it can't hold the string data yet
+		if (*str == nullptr || static_cast<size_t>(DSGetHandleSize(reinterpret_cast<UHandle>(*str))) < offsetof(LStr, str) + s.length())
+			err = NumericArrayResize(uB, 1, reinterpret_cast<UHandle*>(str), s.length());
+		if (!err)
+		{
+			MoveBlock(s.c_str(), LStrBuf(**str), s.length());
+			LStrLen(**str) = static_cast<int32_t>(s.length());
+			return EXIT_SUCCESS;
+		}
+		return err;
+	}
+
+	int32_t VecStrToLVStrArr(const std::vector<std::string>& s, LStrArrayHdl* arr) {
+		const size_t used = *arr != nullptr ? static_cast<size_t>((**arr)->dimSize) : 0;
+
+		/* LabVIEW only disposes the first dimSize strings, so the ones beyond the new size
+		have to be deallocated here to avoid memory leaks */
+		for (size_t i = s.size(); i < used; i++)
+		{
+			LStrHandle* elt = &((**arr)->elt[i]);
+			if (*elt)
+			{
+				DSDisposeHandle(*elt);
+				*elt = NULL;
+			}
+		}
+
+		MgErr err = ReserveLVArray(arr, s.size());
+		if (err)
+			return err;
+
+		for (size_t i = 0; i < s.size(); i++)
+		{
+			LStrHandle* elt = &((**arr)->elt[i]);
+			// Slots beyond the old size hold no string, whatever is left in the memory
+			if (i >= used)
+				*elt = NULL;
+			// Strings of the last call are overwritten in place
+			err = StdStrToLVStr(s[i], elt);
+			if (err)
+			{
+				// keep every valid handle within dimSize, LabVIEW disposes them
+				SetLVArraySize(*arr, std::max(i, std::min(used, s.size())));
+				return err;
+			}
+		}
+		SetLVArraySize(*arr, s.size());
+
+		return EXIT_SUCCESS;
+	}
+
+	int32_t VecUint32ToLVuint32Arr(const std::vector<uint32_t>& s, LVuint32ArrayHdl* arr) {
+		return CopyToLVArray(s.data(), s.size(), arr);
+	}
+
+	int32_t VecUint64ToLVuint64Arr(const std::vector<uint64_t>& s, LVuint64ArrayHdl* arr) {
+		return CopyToLVArray(s.data(), s.size(), arr);
+	}
+
+	int32_t VecInt32ToLVint32Arr(const std::vector<int32_t>& s, LVint32ArrayHdl* arr) {
+		return CopyToLVArray(s.data(), s.size(), arr);
+	}
+
+	int32_t VecFloat64ToLVfloat64Arr(const std::vector<double>& s, LVfloat64ArrayHdl* arr) {
+		return CopyToLVArray(s.data(), s.size(), arr);
+	}
+}
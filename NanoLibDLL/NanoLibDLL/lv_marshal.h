@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "fundtypes.h"
+#include "extcode.h"
+
+// This prolog and epilog should be used around any typedef that is passed from LabVIEW
+// to a DLL for parameters configured as LabVIEW type or Adapt to Type
+#include "lv_prolog.h"
+#include "platdefines.h"
+typedef struct
+{
+    int32_t dimSize;
+    LStrHandle elt[1];
+} LStrArrayRec, *LStrArrayPtr, **LStrArrayHdl;
+
+typedef struct {
+	int32_t dimSize;
+	uint32_t elt[1];
+} LVuint32Array;
+typedef LVuint32Array** LVuint32ArrayHdl;
+
+typedef struct {
+	int32_t dimSize;
+	uint64_t elt[1];
+} LVuint64Array;
+typedef LVuint64Array** LVuint64ArrayHdl;
+
+typedef struct {
+	int32_t dimSize;
+	int32_t elt[1];
+} LVint32Array;
+typedef LVint32Array** LVint32ArrayHdl;
+
+typedef struct {
+	int32_t dimSize;
+	double elt[1];
+} LVfloat64Array;
+typedef LVfloat64Array** LVfloat64ArrayHdl;
+
+#include "lv_epilog.h"
+
+#if IsOpSystem64Bit
+#define uPtr uQ //unsigned Quad aka 64-bit
+#else
+#define uPtr uL //unsigned Long aka 32-bit
+#endif
+
+/*
+Copying into arrays and strings allocated by LabVIEW.
+A handle that is large enough already is reused as it is, so a VI calling the same export in a loop
+resizes its buffers once and afterwards every call is a plain copy, numeric arrays with a single MoveBlock.
+*/
+namespace NanoLibWrapper {
+
+	//type code of NumericArrayResize for the element type
+	template <class T> struct LVTypeCode;
+	template <> struct LVTypeCode<uint32_t> { static constexpr int32_t value = uL; };
+	template <> struct LVTypeCode<uint64_t> { static constexpr int32_t value = uQ; };
+	template <> struct LVTypeCode<int32_t> { static constexpr int32_t value = iL; };
+	template <> struct LVTypeCode<double> { static constexpr int32_t value = fD; };
+	template <> struct LVTypeCode<LStrHandle> { static constexpr int32_t value = uPtr; };
+
+	template <class Array>
+	using LVElement = std::remove_extent_t<decltype(Array::elt)>;
+
+	//makes room for count elements, the handle is only resized if it is too small, dimSize is left alone
+	template <class Array>
+	MgErr ReserveLVArray(Array*** arr, size_t count) {
+		//offsetof includes the padding in front of 8 byte elements on 64 bit
+		const size_t needed = offsetof(Array, elt) + count * sizeof(LVElement<Array>);
+		if (*arr != nullptr && static_cast<size_t>(DSGetHandleSize(reinterpret_cast<UHandle>(*arr))) >= needed)
+			return mgNoErr;
+		return NumericArrayResize(LVTypeCode<LVElement<Array>>::value, 1, reinterpret_cast<UHandle*>(arr), count);
+	}
+
+	//dimSize of an array filled in place after ReserveLVArray
+	template <class Array>
+	void SetLVArraySize(Array** arr, size_t count) {
+		(*arr)->dimSize = static_cast<int32_t>(count);
+	}
+
+	template <class Array>
+	MgErr CopyToLVArray(const LVElement<Array>* data, size_t count, Array*** arr) {
+		MgErr err = ReserveLVArray(arr, count);
+		if (err)
+			return err;
+		if (count > 0)
+			MoveBlock(data, (**arr)->elt, count * sizeof(LVElement<Array>));
+		SetLVArraySize(*arr, count);
+		return mgNoErr;
+	}
+
+	int32_t StdStrToLVStr(const std::string& s, LStrHandle* str);
+
+	int32_t VecStrToLVStrArr(const std::vector<std::string>& s, LStrArrayHdl* arr);
+
+	int32_t VecUint32ToLVuint32Arr(const std::vector<uint32_t>& s, LVuint32ArrayHdl* arr);
+
+	int32_t VecUint64ToLVuint64Arr(const std::vector<uint64_t>& s, LVuint64ArrayHdl* arr);
+
+	int32_t VecInt32ToLVint32Arr(const std::vector<int32_t>& s, LVint32ArrayHdl* arr);
+
+	int32_t VecFloat64ToLVfloat64Arr(const std::vector<double>& s, LVfloat64ArrayHdl* arr);
+}
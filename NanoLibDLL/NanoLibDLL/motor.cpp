@@ -1,24 +1,35 @@
+#include <array>
 #include <chrono>
-#include <thread>
+#include <format>
 #include "motor.h"
 
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
 #include <Windows.h>
+#endif
 #include <iostream>
+#include <sstream>
 #ifndef DBOUT
+#ifdef _WIN32
 #define DBOUT( s )            \
 {                             \
    std::wostringstream os_;    \
    os_ << s;                   \
    OutputDebugStringW( os_.str().c_str() );  \
 }
+#else
+//OutputDebugString only exists on Windows
+#define DBOUT( s )
+#endif
 #endif
 
 
-Motor402::Motor402(NanoLibHelper* nanolibHelper, std::optional<nlc::DeviceHandle>* connectedDeviceHandle, PowerSM* powerSM) :
+Motor402::Motor402(NanoLibHelper* nanolibHelper, std::optional<nlc::DeviceHandle>* connectedDeviceHandle, PowerSM* powerSM, std::optional<int8_t>* activeMode) :
 	nanolibHelper_(nanolibHelper),
 	connectedDeviceHandle_(connectedDeviceHandle),
-	powerSM_(powerSM)
+	powerSM_(powerSM),
+	controlWord_(&powerSM->GetControlWord()),
+	activeMode_(activeMode)
 {
 }
 
@@ -31,24 +42,66 @@ int Motor402::SetModeOfOperation(int8_t mode) {
 	if (powerSM_->DisableOperation())
 		return EXIT_FAILURE;
 
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), mode, nlc::OdIndex(0x6060, 0x00), 8);
+	//unknown until 6061h shows the drive took the new mode
+	activeMode_->reset();
+	nanolibHelper_->writeValue(connectedDeviceHandle_->value(), mode, nlc::OdIndex(0x6060, 0x00));
 
-	return EXIT_SUCCESS;
+	const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + kModeTimeout;
+	int8_t modeDisplay = 0;
+	do {
+		modeDisplay = static_cast<int8_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x6061, 0x00)));
+		if (modeDisplay == mode) {
+			*activeMode_ = mode;
+			return EXIT_SUCCESS;
+		}
+	} while (std::chrono::steady_clock::now() < deadline);
+
+	throw nanolib_exception(std::format("mode of operation {} not taken, 6061h shows {}", mode, modeDisplay), nlc::NlcErrorCode::InvalidOperation);
+	return EXIT_FAILURE;
+}
+
+void Motor402::SetInterpolationPeriod(uint32_t periodUs) {
+	//60C2h:01 is an UNSIGNED8 in units of 10^60C2h:02 s, take the coarsest unit that holds the period exactly
+	int8_t exponent = -6;
+	uint32_t value = periodUs;
+	if (periodUs % 1000 == 0 && periodUs / 1000 <= 0xFF) {
+		exponent = -3;
+		value = periodUs / 1000;
+	}
+	else if (periodUs % 100 == 0 && periodUs / 100 <= 0xFF) {
+		exponent = -4;
+		value = periodUs / 100;
+	}
+	if (value == 0 || value > 0xFF)
+		throw nanolib_exception(std::format("interpolation period of {} us can't be set in 60C2h", periodUs), nlc::NlcErrorCode::InvalidArguments);
+
+	nanolibHelper_->writeValue(connectedDeviceHandle_->value(), value, nlc::OdIndex(0x60C2, 0x01));
+	nanolibHelper_->writeValue(connectedDeviceHandle_->value(), exponent, nlc::OdIndex(0x60C2, 0x02));
 }
 
 void Motor402::GetMotorParameters(uint32_t& polePairCount, uint32_t& ratedCurrent, uint32_t& maxCurrent, uint32_t& maxCurrentDuration, uint32_t& idleCurrent, DriveMode& driveMode) {
+	const std::array<nlc::OdIndex, 6> odIndices{ {
+		nlc::OdIndex(0x2030, 0x00),
+		nlc::OdIndex(0x2031, 0x00),
+		nlc::OdIndex(0x203B, 0x01),
+		nlc::OdIndex(0x203B, 0x02),
+		nlc::OdIndex(0x2037, 0x00),
+		nlc::OdIndex(0x3202, 0x00)
+	} };
+	std::vector<int64_t> values = nanolibHelper_->readMany(connectedDeviceHandle_->value(), odIndices);
+
 	//get polpaarzahl
-	polePairCount = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x2030, 0x00)));
+	polePairCount = static_cast<uint32_t>(values[0]);
 	// get motorstrom  maximal zulssigen Motorstrom (Motorschutz) in mA
-	maxCurrent = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x2031, 0x00)));
+	maxCurrent = static_cast<uint32_t>(values[1]);
 	//  Nennstrom des Motors in mA (siehe Motordatenblatt) e
-	ratedCurrent = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x203B, 0x01)));
+	ratedCurrent = static_cast<uint32_t>(values[2]);
 	//max duration of max current in ms
-	maxCurrentDuration = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x203B, 0x02)));
+	maxCurrentDuration = static_cast<uint32_t>(values[3]);
 	//idle current in mA
-	idleCurrent = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x2037, 0x00)));
+	idleCurrent = static_cast<uint32_t>(values[4]);
 
-	uint32_t uWord32 = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x3202, 0x00)));
+	uint32_t uWord32 = static_cast<uint32_t>(values[5]);
 	if (!(uWord32 & (1U << 0))) {//open loop
 		if (uWord32 & (1U << 3))
 			driveMode = DriveMode::STEPPER_OPEN_LOOP_W_CURR_REDUCTION;
@@ -64,7 +117,9 @@ void Motor402::GetMotorParameters(uint32_t& polePairCount, uint32_t& ratedCurren
 
 int8_t Motor402::GetModeOfOperation() {
 	// get current mode of operation
-	return static_cast<int8_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6061, 0x00)));
+	if (!activeMode_->has_value())
+		*activeMode_ = static_cast<int8_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x6061, 0x00)));
+	return activeMode_->value();
 }
 
 int Motor402::SetMotorParameters(uint32_t polePairCount, uint32_t ratedCurrent, uint32_t maxCurrent, uint32_t maxCurrentDuration, uint32_t idleCurrent, DriveMode driveMode) {
@@ -73,17 +128,17 @@ int Motor402::SetMotorParameters(uint32_t polePairCount, uint32_t ratedCurrent,
 		return EXIT_FAILURE;
 
 	//write polpaarzahl
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), polePairCount, nlc::OdIndex(0x2030, 0x00), 32);
+	nanolibHelper_->writeValue(connectedDeviceHandle_->value(), polePairCount, nlc::OdIndex(0x2030, 0x00));
 	// write motorstrom  maximal zulssigen Motorstrom (Motorschutz) in mA
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), maxCurrent, nlc::OdIndex(0x2031, 0x00), 32);
+	nanolibHelper_->writeValue(connectedDeviceHandle_->value(), maxCurrent, nlc::OdIndex(0x2031, 0x00));
 	//  Nennstrom des Motors in mA (siehe Motordatenblatt) e
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), ratedCurrent, nlc::OdIndex(0x203B, 0x01), 32);
+	nanolibHelper_->writeValue(connectedDeviceHandle_->value(), ratedCurrent, nlc::OdIndex(0x203B, 0x01));
 	//max duration of max current in ms
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), maxCurrentDuration, nlc::OdIndex(0x203B, 0x02), 32);
+	nanolibHelper_->writeValue(connectedDeviceHandle_->value(), maxCurrentDuration, nlc::OdIndex(0x203B, 0x02));
 	//open loop idle current
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), idleCurrent, nlc::OdIndex(0x2037, 0x00), 32);
+	nanolibHelper_->writeValue(connectedDeviceHandle_->value(), idleCurrent, nlc::OdIndex(0x2037, 0x00));
 	//motor type
-	uint32_t uWord32 = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x3202, 0x00)));
+	uint32_t uWord32 = static_cast<uint32_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x3202, 0x00)));
 
 	switch (driveMode) {
 	case DriveMode::BLDC:
@@ -107,41 +162,43 @@ int Motor402::SetMotorParameters(uint32_t polePairCount, uint32_t ratedCurrent,
 		throw(nanolib_exception("unknown drive mode"));
 		break;
 	}
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), uWord32, nlc::OdIndex(0x3202, 0x00), 32);
+	nanolibHelper_->writeValue(connectedDeviceHandle_->value(), uWord32, nlc::OdIndex(0x3202, 0x00));
 
 	return EXIT_SUCCESS;
 
 }
 
-int Motor402::SaveGroup(uint8_t group) {
-	if (powerSM_->DisableOperation())
+int Motor402::SaveGroup(uint8_t group, CompletionWaiter& waiter) {
+	if (StartSaveGroup(group))
 		return EXIT_FAILURE;
 
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), 1702257011, nlc::OdIndex(0x1010, group), 32);
-
-	uint16_t iterationsDone = 0;
-	uint16_t maxIterations = 300;
-
-	uint32_t uWord32;
-
-	using namespace std::chrono_literals; // ns, us, ms, s, h, etc.
-
-	do {
-		uWord32 = static_cast<uint32_t>(
-			nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x1010, group)));
+	CompletionWaiter::Result result = waiter.Wait(CompletionWaiter::Kind::Save, [this, group] {
 		DBOUT("Save running\n");
-		std::this_thread::sleep_for(100ms);
-		iterationsDone += 1;
-		if (iterationsDone == maxIterations) {
-			throw(nanolib_exception("Saving timeout"));
-			return EXIT_FAILURE;
-		}
-	} while (uWord32 != 1);
+		return IsSaveGroupDone(group) ? CompletionWaiter::Poll::Done : CompletionWaiter::Poll::Pending;
+	});
+	if (result != CompletionWaiter::Result::Done) {
+		throw(nanolib_exception("Saving timeout"));
+		return EXIT_FAILURE;
+	}
 	DBOUT("Saving done\n");
 
 	return EXIT_SUCCESS;
 }
 
+int Motor402::StartSaveGroup(uint8_t group) {
+	if (powerSM_->DisableOperation())
+		return EXIT_FAILURE;
+
+	//"save"
+	nanolibHelper_->writeValue(connectedDeviceHandle_->value(), 1702257011, nlc::OdIndex(0x1010, group));
+	return EXIT_SUCCESS;
+}
+
+bool Motor402::IsSaveGroupDone(uint8_t group) {
+	//1010h:xx reads 1 again once the group is stored
+	return nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x1010, group)) == 1;
+}
+
 
 int Motor402::SetUserUnitsFeed(uint32_t feedPer, uint32_t shaftRevolutions) {
 	//make sure operation is disabled before changing user defined units
@@ -150,21 +207,21 @@ int Motor402::SetUserUnitsFeed(uint32_t feedPer, uint32_t shaftRevolutions) {
 		return EXIT_FAILURE;
 	}
 
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), feedPer, nlc::OdIndex(0x6092, 0x01), 32);
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), shaftRevolutions, nlc::OdIndex(0x6092, 0x02), 32);
+	nanolibHelper_->writeValue(connectedDeviceHandle_->value(), feedPer, nlc::OdIndex(0x6092, 0x01));
+	nanolibHelper_->writeValue(connectedDeviceHandle_->value(), shaftRevolutions, nlc::OdIndex(0x6092, 0x02));
 	return EXIT_SUCCESS;
 }
 
 int32_t Motor402::GetSpeedActual() {
-	return static_cast<int32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x606C, 0x00)));
+	return static_cast<int32_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x606C, 0x00)));
 }
 
 int32_t Motor402::GetPositionActual() {
-	return static_cast<int32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6064, 0x00)));
+	return static_cast<int32_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x6064, 0x00)));
 }
 
 void Motor402::SetMaxMotorSpeed(uint32_t maxSpeed) {
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), maxSpeed, nlc::OdIndex(0x6080, 0x00), 32);
+	nanolibHelper_->writeValue(connectedDeviceHandle_->value(), maxSpeed, nlc::OdIndex(0x6080, 0x00));
 }
 
 int Motor402::Halt() {
@@ -175,11 +232,10 @@ int Motor402::Halt() {
 		return EXIT_FAILURE;
 	}
 	//halt option: slow down ramp
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), 1, nlc::OdIndex(0x605D, 0x00), 16);
+	nanolibHelper_->writeValue(connectedDeviceHandle_->value(), 1, nlc::OdIndex(0x605D, 0x00));
 
-	int16_t word16 = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x605D, 0x00)));
-	word16 |= (1 << 8);
-	nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), word16, nlc::OdIndex(0x6040, 0x00), 16);
+	//set halt bit
+	controlWord_->Modify((1U << 8), 0);
 	return EXIT_SUCCESS;
 }
 
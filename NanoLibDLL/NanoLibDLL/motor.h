@@ -1,21 +1,31 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 
+#include "completion_waiter.h"
 #include "nanolib_helper.hpp"
 #include "power_sm.h"
 #include "user_units.h"
 
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
 #include <Windows.h>
+#endif
 #include <iostream>
+#include <sstream>
 #ifndef DBOUT
+#ifdef _WIN32
 #define DBOUT( s )            \
 {                             \
    std::wostringstream os_;    \
    os_ << s;                   \
    OutputDebugStringW( os_.str().c_str() );  \
 }
+#else
+//OutputDebugString only exists on Windows
+#define DBOUT( s )
+#endif
 #endif
 
 //general motor class
@@ -47,7 +57,7 @@ public:
 		BLDC = 65
 	};
 
-	Motor402(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle, PowerSM *powerSM);
+	Motor402(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle, PowerSM *powerSM, std::optional<int8_t> *activeMode);
 	~Motor402() {
 		DBOUT("destructing motor");
 	};
@@ -64,15 +74,23 @@ public:
 	//pams in mA and ms
 	int SetMotorParameters(uint32_t polePairCount, uint32_t ratedCurrent, uint32_t maxCurrent, uint32_t maxCurrentDuration, uint32_t idleCurrent, DriveMode driveMode);
 	void GetMotorParameters(uint32_t& polePairCount, uint32_t& ratedCurrent, uint32_t& maxCurrent, uint32_t& maxCurrentDuration, uint32_t& idleCurrent, DriveMode& driveMode);
-	int SaveGroup(uint8_t group);
+	//waits for the device to store the group
+	int SaveGroup(uint8_t group, CompletionWaiter& waiter);
+	//SaveGroup in steps, for callers that must not block
+	int StartSaveGroup(uint8_t group);
+	bool IsSaveGroupDone(uint8_t group);
+	//writes 6060h and waits for 6061h to show mode, throws if it doesn't within kModeTimeout
 	int SetModeOfOperation(int8_t mode);
+	//time between two set points of the cyclic and interpolated modes (60C2h)
+	void SetInterpolationPeriod(uint32_t periodUs);
+	//cached, 6061h is only read again after setting the mode failed or the connection was reset
 	int8_t GetModeOfOperation();
 
 	//general user units
 	int SetUserUnitsFeed(uint32_t feedPer, uint32_t shaftRevolutions);
 
-	inline void GetVelocityDemanded(int16_t& demandedVel) {demandedVel = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6043, 0x00)));}
-	inline void GetVelocityActual(int16_t& velActual) {velActual = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6044, 0x00)));}
+	inline void GetVelocityDemanded(int16_t& demandedVel) {demandedVel = static_cast<int16_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x6043, 0x00)));}
+	inline void GetVelocityActual(int16_t& velActual) {velActual = static_cast<int16_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x6044, 0x00)));}
 
 protected:
 
@@ -80,6 +98,11 @@ protected:
 	std::optional<nlc::DeviceHandle>* connectedDeviceHandle_;
 
 	PowerSM* powerSM_;
+	ControlWord* controlWord_;
+	//mode of operation last read from 6061h, shared by all motor objects of a device
+	std::optional<int8_t>* activeMode_;
+	//6061h follows a write of 6060h within a few ms
+	static constexpr std::chrono::milliseconds kModeTimeout{ 100 };
 
 
 
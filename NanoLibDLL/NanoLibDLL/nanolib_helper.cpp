@@ -1,9 +1,13 @@
 #include "nanolib_helper.hpp"
 #include "nano_lib_hw_strings.hpp"
+#include "perf_stats.h"
 
+#include <algorithm>
 #include <iostream>
 #include <format>
 
+const OdMetadataCache NanoLibHelper::builtinObjectMetadata;
+
 NanoLibHelper::NanoLibHelper() : nanolibAccessor(getNanoLibAccessor()) {
 }
 
@@ -12,14 +16,14 @@ NanoLibHelper::~NanoLibHelper() {
 	std::cout << "deleting nanolibHelper" << std::endl;
 }
 
-void NanoLibHelper::checkResult(const char *fault, const nlc::Result &result) {
+void NanoLibHelper::checkResult(const char *fault, const nlc::Result &result, std::optional<nlc::OdIndex> odIndex) {
 	if (result.hasError()) {
 		std::string errorDesc(fault);
 
 		errorDesc += " failed with error: ";
 		errorDesc += std::format("code {} ", static_cast<uint16_t>(result.getErrorCode()));
 		errorDesc += result.getError();
-		throw nanolib_exception(errorDesc);
+		throw nanolib_exception(errorDesc, result.getErrorCode(), result.getExErrorCode(), odIndex);
 	}
 }
 
@@ -57,6 +61,58 @@ NanoLibHelper::createBusHardwareOptions(const nlc::BusHardwareId &busHardwareId)
 	return busHwOptions;
 }
 
+nlc::BusHardwareOptions
+NanoLibHelper::createBusHardwareOptions(const nlc::BusHardwareId &busHardwareId,
+										const std::map<std::string, std::string> &overrides) const {
+	std::map<std::string, std::string> options = createBusHardwareOptions(busHardwareId).getOptions();
+	for (const std::string &name : getBusHardwareOptionNames(busHardwareId)) {
+		auto it = overrides.find(name);
+		if (it != overrides.end())
+			options[name] = it->second;
+	}
+	return nlc::BusHardwareOptions(options);
+}
+
+std::vector<std::string> NanoLibHelper::getBusHardwareOptionNames(const nlc::BusHardwareId &busHardwareId) {
+	const nlc::BusHwOptionsDefault &defaults = nlc::busHwOptionsDefaults;
+	const std::string protocol = busHardwareId.getProtocol();
+
+	if (protocol == nlc::BUS_HARDWARE_ID_PROTOCOL_CANOPEN) {
+		if (busHardwareId.getBusHardware() == nlc::BUS_HARDWARE_ID_IXXAT)
+			return { defaults.canBus.BAUD_RATE_OPTIONS_NAME, defaults.canBus.ixxat.ADAPTER_BUS_NUMBER_OPTIONS_NAME };
+		return { defaults.canBus.BAUD_RATE_OPTIONS_NAME };
+	}
+	if (protocol == nlc::BUS_HARDWARE_ID_PROTOCOL_MODBUS_RTU)
+		return { defaults.serial.BAUD_RATE_OPTIONS_NAME, defaults.serial.PARITY_OPTIONS_NAME };
+	if (protocol == nlc::BUS_HARDWARE_ID_PROTOCOL_RESTFULL_API) {
+		return { defaults.restfulBus.CONNECT_TIMEOUT_OPTION_NAME, defaults.restfulBus.REQUEST_TIMEOUT_OPTION_NAME,
+			defaults.restfulBus.RESPONSE_TIMEOUT_OPTION_NAME };
+	}
+	if (protocol == nlc::BUS_HARDWARE_ID_PROTOCOL_ETHERCAT) {
+		return { defaults.ethercatBus.NETWORK_FIRMWARE_STATE_OPTION_NAME, defaults.ethercatBus.EXCLUSIVE_LOCK_TIMEOUT_OPTION_NAME,
+			defaults.ethercatBus.SHARED_LOCK_TIMEOUT_OPTION_NAME, defaults.ethercatBus.READ_TIMEOUT_OPTION_NAME,
+			defaults.ethercatBus.WRITE_TIMEOUT_OPTION_NAME, defaults.ethercatBus.READ_WRITE_ATTEMPTS_OPTION_NAME,
+			defaults.ethercatBus.CHANGE_NETWORK_STATE_ATTEMPTS_OPTION_NAME, defaults.ethercatBus.PDO_IO_ENABLED_OPTION_NAME };
+	}
+	return {};
+}
+
+bool NanoLibHelper::isBusHardwareOptionName(const std::string &name) {
+	//one bus hardware of every protocol with options, IXXAT for the adapter bus number
+	const nlc::BusHardwareId protocols[] = {
+		nlc::BusHardwareId(nlc::BUS_HARDWARE_ID_IXXAT, nlc::BUS_HARDWARE_ID_PROTOCOL_CANOPEN, "", ""),
+		nlc::BusHardwareId("", nlc::BUS_HARDWARE_ID_PROTOCOL_MODBUS_RTU, "", ""),
+		nlc::BusHardwareId("", nlc::BUS_HARDWARE_ID_PROTOCOL_RESTFULL_API, "", ""),
+		nlc::BusHardwareId("", nlc::BUS_HARDWARE_ID_PROTOCOL_ETHERCAT, "", ""),
+	};
+	for (const nlc::BusHardwareId &busHardwareId : protocols) {
+		const std::vector<std::string> names = getBusHardwareOptionNames(busHardwareId);
+		if (std::find(names.begin(), names.end(), name) != names.end())
+			return true;
+	}
+	return false;
+}
+
 void NanoLibHelper::openBusHardware(const nlc::BusHardwareId &busHwId,
 									const nlc::BusHardwareOptions &busHwOptions) const {
 	checkResult("openBusHardwareWithProtocol",
@@ -102,7 +158,11 @@ public:
 
 std::vector<nlc::DeviceId> NanoLibHelper::scanBus(const nlc::BusHardwareId &busHwId) const {
 	ScanBusCallback scanBusCallback;
-	return checkedResult("scanDevices", nanolibAccessor->scanDevices(busHwId, &scanBusCallback)).getResult();
+	return scanBus(busHwId, &scanBusCallback);
+}
+
+std::vector<nlc::DeviceId> NanoLibHelper::scanBus(const nlc::BusHardwareId &busHwId, nlc::NlcScanBusCallback *callback) const {
+	return checkedResult("scanDevices", nanolibAccessor->scanDevices(busHwId, callback)).getResult();
 }
 
 nlc::DeviceHandle NanoLibHelper::addDevice(const nlc::DeviceId &deviceId) const {
@@ -113,6 +173,32 @@ void NanoLibHelper::connectDevice(const nlc::DeviceHandle &deviceId) const {
 	checkResult("connectDevice", nanolibAccessor->connectDevice(deviceId));
 }
 
+std::string NanoLibHelper::getDeviceSerialNumber(const nlc::DeviceHandle &deviceHandle) const {
+	return checkedResult("getDeviceSerialNumber", nanolibAccessor->getDeviceSerialNumber(deviceHandle)).getResult();
+}
+
+std::string NanoLibHelper::readSerialNumber(const nlc::DeviceId &deviceId) const {
+	nlc::DeviceHandle deviceHandle = addDevice(deviceId);
+	std::string serialNumber;
+	try {
+		connectDevice(deviceHandle);
+		try {
+			serialNumber = getDeviceSerialNumber(deviceHandle);
+		}
+		catch (const nanolib_exception&) {
+			disconnectDevice(deviceHandle);
+			throw;
+		}
+		disconnectDevice(deviceHandle);
+	}
+	catch (const nanolib_exception&) {
+		removeDevice(deviceHandle);
+		throw;
+	}
+	removeDevice(deviceHandle);
+	return serialNumber;
+}
+
 nlc::DeviceId NanoLibHelper::getDeviceId(const nlc::DeviceHandle& deviceHandle) const {
 	return checkedResult("getDeviceId", nanolibAccessor->getDeviceId(deviceHandle)).getResult();
 }
@@ -125,6 +211,10 @@ nlc::ResultConnectionState NanoLibHelper::getConnectionState(const nlc::DeviceHa
 	return checkedResult("getConnectionState", nanolibAccessor->getConnectionState(deviceId));
 }
 
+nlc::ResultConnectionState NanoLibHelper::checkConnectionState(const nlc::DeviceHandle& deviceId) const {
+	return checkedResult("checkConnectionState", nanolibAccessor->checkConnectionState(deviceId));
+}
+
 void NanoLibHelper::disconnectDevice(const nlc::DeviceHandle &deviceId) const {
 	checkResult("disconnectDevice", nanolibAccessor->disconnectDevice(deviceId));
 }
@@ -135,28 +225,128 @@ void NanoLibHelper::removeDevice(const nlc::DeviceHandle& deviceId) const {
 
 int64_t NanoLibHelper::readInteger(const nlc::DeviceHandle &deviceId,
 								   const nlc::OdIndex &odIndex) const {
-	return checkedResult("readNumber", nanolibAccessor->readNumber(deviceId, odIndex)).getResult();
+	PerfStats::Sdo sdo(perfStats, false, odIndex);
+	return checkedResult("readNumber", nanolibAccessor->readNumber(deviceId, odIndex), odIndex).getResult();
+}
+
+std::vector<int64_t> NanoLibHelper::readMany(const nlc::DeviceHandle &deviceId,
+											  std::span<const nlc::OdIndex> odIndices) const {
+	std::vector<int64_t> values(odIndices.size());
+
+	for (size_t i = 0; i < odIndices.size(); i++) {
+		// same object requested before, take the value already read
+		size_t j = 0;
+		while (j < i && (odIndices[j].getIndex() != odIndices[i].getIndex() ||
+						 odIndices[j].getSubIndex() != odIndices[i].getSubIndex())) {
+			j++;
+		}
+		if (j < i) {
+			values[i] = values[j];
+			continue;
+		}
+
+		PerfStats::Sdo sdo(perfStats, false, odIndices[i]);
+		const nlc::ResultInt result = nanolibAccessor->readNumber(deviceId, odIndices[i]);
+		if (result.hasError()) {
+			checkResult(("readNumber " + odIndices[i].toString()).c_str(), result, odIndices[i]);
+		}
+		const OdMetadata *metadata = findObjectMetadata(deviceId, odIndices[i]);
+		values[i] = metadata != nullptr ? metadata->SignExtend(result.getResult()) : result.getResult();
+	}
+
+	return values;
 }
 
 void NanoLibHelper::writeInteger(const nlc::DeviceHandle &deviceId, int64_t value,
 								 const nlc::OdIndex &odIndex, unsigned int bitLength) const {
-	checkResult("writeNumber", nanolibAccessor->writeNumber(deviceId, value, odIndex, bitLength));
+	PerfStats::Sdo sdo(perfStats, true, odIndex);
+	checkResult("writeNumber", nanolibAccessor->writeNumber(deviceId, value, odIndex, bitLength), odIndex);
+}
+
+size_t NanoLibHelper::loadObjectMetadata(const nlc::DeviceHandle &deviceId) {
+	OdMetadataCache cache;
+	size_t found = 0;
+
+	const nlc::ResultObjectDictionary od = nanolibAccessor->getAssignedObjectDictionary(deviceId);
+	if (!od.hasError()) {
+		// getObject only looks up the dictionary, it is not const in the interface
+		found = cache.Refine(const_cast<nlc::ObjectDictionary &>(od.getResult()));
+	}
+
+	objectMetadata[deviceId.get()] = std::move(cache);
+	return found;
+}
+
+void NanoLibHelper::forgetObjectMetadata(const nlc::DeviceHandle &deviceId) {
+	objectMetadata.erase(deviceId.get());
+}
+
+const OdMetadata *NanoLibHelper::findObjectMetadata(const nlc::DeviceHandle &deviceId,
+													const nlc::OdIndex &odIndex) const {
+	auto it = objectMetadata.find(deviceId.get());
+	const OdMetadataCache &cache = it != objectMetadata.end() ? it->second : builtinObjectMetadata;
+	return cache.Find(odIndex);
+}
+
+const OdMetadata &NanoLibHelper::getObjectMetadata(const nlc::DeviceHandle &deviceId,
+												   const nlc::OdIndex &odIndex) const {
+	const OdMetadata *metadata = findObjectMetadata(deviceId, odIndex);
+	if (metadata == nullptr) {
+		throw nanolib_exception(std::format("object {} unknown", odIndex.toString()),
+								nlc::NlcErrorCode::ODDoesNotExist, 0, odIndex);
+	}
+	return *metadata;
+}
+
+int64_t NanoLibHelper::readValue(const nlc::DeviceHandle &deviceId,
+								 const nlc::OdIndex &odIndex) const {
+	const OdMetadata &metadata = getObjectMetadata(deviceId, odIndex);
+	if (!metadata.IsReadable()) {
+		throw nanolib_exception(std::format("readNumber {} rejected: object is not readable", odIndex.toString()),
+								nlc::NlcErrorCode::ODInvalidAccess, 0, odIndex);
+	}
+	return metadata.SignExtend(readInteger(deviceId, odIndex));
+}
+
+void NanoLibHelper::writeValue(const nlc::DeviceHandle &deviceId, int64_t value,
+							   const nlc::OdIndex &odIndex) const {
+	const OdMetadata &metadata = getObjectMetadata(deviceId, odIndex);
+	if (!metadata.IsWritable()) {
+		throw nanolib_exception(std::format("writeNumber {} rejected: object is not writable", odIndex.toString()),
+								nlc::NlcErrorCode::ODInvalidAccess, 0, odIndex);
+	}
+	if (value < metadata.Min() || value > metadata.Max()) {
+		throw nanolib_exception(std::format("writeNumber {} rejected: {} is out of range [{}, {}]", odIndex.toString(),
+											value, metadata.Min(), metadata.Max()),
+								nlc::NlcErrorCode::InvalidArguments, 0, odIndex);
+	}
+	writeInteger(deviceId, value, odIndex, metadata.bitLength);
 }
 
 std::vector<std::int64_t> NanoLibHelper::readArray(const nlc::DeviceHandle &deviceId,
 												   const uint16_t odIndex) const {
-	return checkedResult("readNumberArray", nanolibAccessor->readNumberArray(deviceId, odIndex)).getResult();
+	PerfStats::Sdo sdo(perfStats, false, nlc::OdIndex(odIndex, 0));
+	return checkedResult("readNumberArray", nanolibAccessor->readNumberArray(deviceId, odIndex), nlc::OdIndex(odIndex, 0)).getResult();
 }
 
 std::string NanoLibHelper::readString(const nlc::DeviceHandle &deviceId,
 									  const nlc::OdIndex &odIndex) const {
-	return checkedResult("readString", nanolibAccessor->readString(deviceId, odIndex)).getResult();
+	PerfStats::Sdo sdo(perfStats, false, odIndex);
+	return checkedResult("readString", nanolibAccessor->readString(deviceId, odIndex), odIndex).getResult();
 }
 
 void NanoLibHelper::setLoggingLevel(nlc::LogLevel logLevel) {
 	nanolibAccessor->setLoggingLevel(logLevel);
 }
 
+void NanoLibHelper::setPerfStats(PerfStats *perfStats) {
+	this->perfStats = perfStats;
+}
+
+void NanoLibHelper::setAccessor(nlc::NanoLibAccessor *accessor) {
+	nanolibAccessor = accessor != nullptr ? accessor : getNanoLibAccessor();
+}
+
 void NanoLibHelper::configureSampler(const nlc::DeviceHandle deviceHandle,
 									 const nlc::SamplerConfiguration &samplerConfiguration) {
 	checkResult("SamplerInterface::configure", nanolibAccessor->getSamplerInterface().configure(deviceHandle, samplerConfiguration));
@@ -1,18 +1,45 @@
 #pragma once
 
+#include <map>
+#include <optional>
+#include <span>
+#include <unordered_map>
+
 #include "accessor_factory.hpp"
+#include "od_metadata.h"
+
+class PerfStats;
 
 class nanolib_exception : public std::exception {
 public:
-	nanolib_exception(const std::string& msg) : message(msg) {
+	nanolib_exception(const std::string& msg, nlc::NlcErrorCode errorCode = nlc::NlcErrorCode::GeneralError,
+		uint32_t exErrorCode = 0, std::optional<nlc::OdIndex> odIndex = std::nullopt) :
+		message(msg), errorCode(errorCode), exErrorCode(exErrorCode), odIndex(odIndex) {
 	}
 
 	virtual char const *what() const noexcept {
 		return message.c_str();
 	}
 
+	nlc::NlcErrorCode getErrorCode() const noexcept {
+		return errorCode;
+	}
+
+	//extended error code of NanoLib, e.g. the SDO abort code
+	uint32_t getExErrorCode() const noexcept {
+		return exErrorCode;
+	}
+
+	//object the failed access was for, if it was an object access
+	const std::optional<nlc::OdIndex>& getOdIndex() const noexcept {
+		return odIndex;
+	}
+
 private:
 	std::string message;
+	nlc::NlcErrorCode errorCode;
+	uint32_t exErrorCode;
+	std::optional<nlc::OdIndex> odIndex;
 };
 
 class NanoLibHelper {
@@ -25,20 +52,22 @@ public:
 	 * 
 	 * @param fault  - context description 
 	 * @param result - the result from the operation
+	 * @param odIndex - the object accessed, if any
 	 */
-	static void checkResult(const char* fault, const nlc::Result &result);
+	static void checkResult(const char* fault, const nlc::Result &result, std::optional<nlc::OdIndex> odIndex = std::nullopt);
 
 	/**
 	 * @brief Checks the result and throws an exception if unsuccessful.
 	 *
 	 * @param fault  - context description
 	 * @param result - the result from the operation
+	 * @param odIndex - the object accessed, if any
 	 * 
 	 * @return The result of the operation 
 	 */
 	template <class ResultClass>
-	static ResultClass checkedResult(const char *fault, const ResultClass &result) {
-		checkResult(fault, result);
+	static ResultClass checkedResult(const char *fault, const ResultClass &result, std::optional<nlc::OdIndex> odIndex = std::nullopt) {
+		checkResult(fault, result, odIndex);
 		return result;
 	}
 
@@ -60,6 +89,29 @@ public:
 	 */
 	nlc::BusHardwareOptions createBusHardwareOptions(const nlc::BusHardwareId &busHardwareId) const;
 
+	/**
+	 * @brief Create bus hardware options object with some of the defaults replaced
+	 *
+	 * @param busHardwareId The bus hardware the options are for
+	 * @param overrides Option name and value, only the options of getBusHardwareOptionNames(busHardwareId) are used
+	 * @return nlc::BusHardwareOptions A set of options for opening the bus hardware
+	 */
+	nlc::BusHardwareOptions createBusHardwareOptions(const nlc::BusHardwareId &busHardwareId,
+		const std::map<std::string, std::string> &overrides) const;
+
+	/**
+	 * @brief Names of the options (see bus_hw_options_defaults.hpp) that apply to the bus hardware
+	 *
+	 * @param busHardwareId The bus hardware
+	 * @return std::vector<std::string> Option names, empty if the bus hardware has none
+	 */
+	static std::vector<std::string> getBusHardwareOptionNames(const nlc::BusHardwareId &busHardwareId);
+
+	/**
+	 * @brief Checks whether name is an option of any bus hardware
+	 */
+	static bool isBusHardwareOptionName(const std::string &name);
+
 	/**
 	 * @brief Opens the bus hardware with given id and options
 	 *
@@ -96,6 +148,16 @@ public:
 	 */
 	std::vector<nlc::DeviceId> scanBus(const nlc::BusHardwareId &busHwId) const;
 
+	/**
+	 * @brief Scans bus and reports the progress to the given callback
+	 *
+	 * @param busHwId The bus hardware to scan
+	 * @param callback Receives start, progress, found devices and end of the scan,
+	 * 		returning an error from it aborts the scan
+	 * @return std::vector<nlc::DeviceId> Vector with found devices
+	 */
+	std::vector<nlc::DeviceId> scanBus(const nlc::BusHardwareId &busHwId, nlc::NlcScanBusCallback *callback) const;
+
 	/**
 	 * @brief Registers the device id into NanoLib internal list
 	 *
@@ -111,6 +173,25 @@ public:
 	 */
 	void connectDevice(const nlc::DeviceHandle &deviceId) const;
 
+	/**
+	 * @brief Gets the serial number of a connected device
+	 *
+	 * @param deviceHandle The device handle
+	 * @return std::string The serial number
+	 */
+	std::string getDeviceSerialNumber(const nlc::DeviceHandle &deviceHandle) const;
+
+	/**
+	 * @brief Reads the serial number of a device that is not connected yet
+	 *
+	 * Note: the device is added, connected, read and removed again,
+	 * so this costs a connect. The bus hardware must be open.
+	 *
+	 * @param deviceId The device id from a scan
+	 * @return std::string The serial number
+	 */
+	std::string readSerialNumber(const nlc::DeviceId &deviceId) const;
+
 
 	std::vector<nlc::DeviceId> getDeviceIds() const;
 
@@ -118,6 +199,15 @@ public:
 
 	nlc::ResultConnectionState getConnectionState(const nlc::DeviceHandle& deviceId) const;
 
+	/**
+	 * @brief Checks the connection state on the bus
+	 *
+	 * Note: other than getConnectionState this sends a request to the device.
+	 *
+	 * @param deviceId The device to check
+	 */
+	nlc::ResultConnectionState checkConnectionState(const nlc::DeviceHandle& deviceId) const;
+
 	/**
 	 * @brief Disconnects given device
 	 *
@@ -143,6 +233,21 @@ public:
 	 */
 	int64_t readInteger(const nlc::DeviceHandle &deviceId, const nlc::OdIndex &odIndex) const;
 
+	/**
+	 * @brief Reads out several integers of given device in one call
+	 *
+	 * Note: NanoLib offers no block or segmented transfer for single numbers, so the
+	 * objects are still read one by one. Duplicate entries are read only once.
+	 * Signed objects known to the object metadata are sign extended.
+	 *
+	 * @param deviceId The id of the device to read from
+	 * @param odIndices The indices and sub-indices of the object dictionary to read from
+	 *
+	 * @return std::vector<int64_t> The values in the order of odIndices
+	 */
+	std::vector<int64_t> readMany(const nlc::DeviceHandle &deviceId,
+								  std::span<const nlc::OdIndex> odIndices) const;
+
 	/**
 	 * @brief Writes given value to the device
 	 *
@@ -155,6 +260,64 @@ public:
 	void writeInteger(const nlc::DeviceHandle &deviceId, int64_t value, const nlc::OdIndex &odIndex,
 					  unsigned int bitLength) const;
 
+	/**
+	 * @brief Loads the object metadata of a device
+	 *
+	 * Starts with the built-in C5-E table and takes over data type, bit length and
+	 * access of every number object of the object dictionary assigned to the device,
+	 * if there is one, including the objects missing in the table.
+	 *
+	 * @param deviceId The id of the device
+	 *
+	 * @return size_t The number of objects taken from the assigned object dictionary
+	 */
+	size_t loadObjectMetadata(const nlc::DeviceHandle &deviceId);
+
+	/**
+	 * @brief Drops the object metadata of a device
+	 *
+	 * @param deviceId The id of the device
+	 */
+	void forgetObjectMetadata(const nlc::DeviceHandle &deviceId);
+
+	/**
+	 * @brief Returns data type, bit length and access of an object
+	 *
+	 * Note: devices without loaded metadata use the built-in C5-E table.
+	 *
+	 * @param deviceId The id of the device
+	 * @param odIndex The index and sub-index of the object
+	 *
+	 * @return const OdMetadata&
+	 */
+	const OdMetadata &getObjectMetadata(const nlc::DeviceHandle &deviceId,
+										const nlc::OdIndex &odIndex) const;
+
+	/**
+	 * @brief Reads out a number of given device
+	 *
+	 * Other than readInteger the sign of the object's data type is restored.
+	 *
+	 * @param deviceId The id of the device to read from
+	 * @param odIndex The index and sub-index of the object dictionary to read from
+	 *
+	 * @return int64_t
+	 */
+	int64_t readValue(const nlc::DeviceHandle &deviceId, const nlc::OdIndex &odIndex) const;
+
+	/**
+	 * @brief Writes given value to the device
+	 *
+	 * The bit length is taken from the object metadata. Writes to read only objects and
+	 * values out of the range of the data type are rejected without bus access.
+	 *
+	 * @param deviceId The id of the device to write to
+	 * @param value The value to write to the device
+	 * @param odIndex The index and sub-index of the object dictionary to write to
+	 */
+	void writeValue(const nlc::DeviceHandle &deviceId, int64_t value,
+					const nlc::OdIndex &odIndex) const;
+
 	/**
 	 * @brief Reads out a od object array
 	 *
@@ -186,6 +349,17 @@ public:
 	 */
 	void setLoggingLevel(nlc::LogLevel logLevel);
 
+	/**
+	 * @brief Times every object read and write in perfStats, nullptr to stop
+	 */
+	void setPerfStats(PerfStats *perfStats);
+
+	/**
+	 * @brief Sends everything to accessor instead of NanoLib, e.g. a SimulatedAccessor,
+	 * nullptr goes back to NanoLib. Only while no bus hardware is open.
+	 */
+	void setAccessor(nlc::NanoLibAccessor *accessor);
+
 	/**
 	 * @brief Configure a sampler
 	 */
@@ -219,5 +393,13 @@ public:
 	nlc::ResultVoid getSamplerLastError(const nlc::DeviceHandle deviceHandle);
 	
 private:
+	const OdMetadata *findObjectMetadata(const nlc::DeviceHandle &deviceId,
+										 const nlc::OdIndex &odIndex) const;
+
 	nlc::NanoLibAccessor *nanolibAccessor;
+	PerfStats *perfStats = nullptr;
+
+	// object metadata per device handle
+	std::unordered_map<uint32_t, OdMetadataCache> objectMetadata;
+	static const OdMetadataCache builtinObjectMetadata;
 };
\ No newline at end of file
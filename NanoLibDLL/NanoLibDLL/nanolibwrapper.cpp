@@ -4,90 +4,24 @@
 
 namespace NanoLibWrapper {
 
-	//***GENERAL***
-
-	int32_t VecStrToLVStrArr(const std::vector<std::string>& s, LStrArrayHdl* arr) {
-		int32_t err = 0;
-		/* If the incoming array is bigger than what we need, we first need to loop through
-		the superfluous items to see if they contain valid string handles and if so we
-		need to deallocate them to avoid memory leaks */
-		if (arr)
-		{
-			for (int i = static_cast<int>(std::size(s)); i < (**arr)->dimSize; i++)
-			{
-				LStrHandle* elt = &((**arr)->elt[i]);
-				if (*elt)
-				{
-					err = DSDisposeHandle(*elt);
-					*elt = NULL;
-				}
-			}
-		}
-
-		/* Now we need to make sure the StringArrayHandle is large enough to hold all ports */
-		err = NumericArrayResize(uPtr, 1, (UHandle*)arr, std::size(s));
-		for (int i = 0; !err && (i < std::size(s)); i++)
-		{
-			LStrHandle* elt = &((**arr)->elt[i]);
-			// Resize string handle to be large enough to store the string data
-			err = NumericArrayResize(uB, 1, (UHandle*)elt, s[i].length());
-			if (!err)
-			{
-				MoveBlock(s[i].c_str(), LStrBuf(**elt), s[i].length());
-				LStrLen(**elt) = static_cast<int32_t>(s[i].length());
-			}
-		}
-		if (err)
-			return err;
-
-		(**arr)->dimSize = static_cast<int32_t>(std::size(s));
-
-		return err;
-	}
-
-	int32_t VecUint32ToLVuint32Arr(const std::vector<uint32_t>& s, LVuint32ArrayHdl* arr) {
-		int32_t err;
-		int32_t size = static_cast<int32_t>(s.size());
-
-		// The first 32 bits are used for size information, and then the array comes after the size
-		err = DSSetHandleSize(*arr, sizeof(int32_t) + s.size() * sizeof(uint32_t));
-		if (err != mFullErr && err != mZoneErr)
-		{
-			(**arr)->dimSize = size;
-
-			for (int32_t i = 0; i < size; i++)
-			{
-				(**arr)->elt[i] = s.at(i);
-			}
-			return EXIT_SUCCESS;
-		}
-		return err;
+	//the synchronous long operations run as a job and wait for it here, off the bus thread,
+	//so Halt and QuickStop are not queued behind them; the wait policy of the job ends it
+	static int32_t WaitForJob(Controller* c, int32_t started, uint32_t jobId) {
+		if (started)
+			return EXIT_FAILURE;
+		return c->WaitJob(jobId, UINT32_MAX);
 	}
 
-
-
-	int32_t StdStrToLVStr(const std::string& s, LStrHandle* str) {
-		int32_t err = 0;
-		// Resize string handle to be large enough to store the string data
-		err = NumericArrayResize(uB, 1, (UHandle*)str, s.length());
-		if (!err)
-		{
-			MoveBlock(s.c_str(), LStrBuf(**str), s.length());
-			LStrLen(**str) = static_cast<int>(s.length());
-			return EXIT_SUCCESS;
-		}
-		return err;
-	}
+	//***GENERAL***
 
 	int32_t RebootDevice() {
 		Controller* c = Controller::GetInstance();
-		return c->RebootDevice();
+		return c->Execute([&] { return c->RebootDevice(); });
 	}
 
 	int32_t GetExceptions(std::vector<std::string>& exceptions) {
 		Controller* c = Controller::GetInstance();
-		if (c->GetExceptions(exceptions))
-			return EXIT_FAILURE;
+		return c->Execute([&] { return c->GetExceptions(exceptions); });
 	}
 
 	int32_t GetExceptionsLV(LStrArrayHdl* LVAllocatedStrArray) {
@@ -97,10 +31,45 @@ namespace NanoLibWrapper {
 		return VecStrToLVStrArr(exceptions, LVAllocatedStrArray);
 	}
 
+	int32_t DrainErrorsLV(uint64_t sinceSeq, uint64_t& nextSeq, uint64_t& missed,
+		LVuint64ArrayHdl* seqs, LVfloat64ArrayHdl* timesMs, LVint32ArrayHdl* errorCodes, LVuint32ArrayHdl* exErrorCodes,
+		LVuint32ArrayHdl* objects, LVuint32ArrayHdl* axes, LStrArrayHdl* messages) {
+		Controller* c = Controller::GetInstance();
+		std::vector<ErrorJournal::Record> records;
+		if (c->DrainErrors(sinceSeq, records, nextSeq, missed))
+			return EXIT_FAILURE;
+
+		std::vector<uint64_t> seqs_;
+		std::vector<double> timesMs_;
+		std::vector<int32_t> errorCodes_;
+		std::vector<uint32_t> exErrorCodes_, objects_, axes_;
+		std::vector<std::string> messages_;
+		for (const ErrorJournal::Record& record : records) {
+			seqs_.push_back(record.seq);
+			timesMs_.push_back(static_cast<double>(record.timeMs));
+			errorCodes_.push_back(static_cast<int32_t>(record.errorCode));
+			exErrorCodes_.push_back(record.exErrorCode);
+			objects_.push_back(record.hasOdIndex ? (static_cast<uint32_t>(record.index) << 8 | record.subIndex) : 0);
+			axes_.push_back(record.axisId);
+			messages_.push_back(record.message.data());
+		}
+		if (VecUint64ToLVuint64Arr(seqs_, seqs) || VecFloat64ToLVfloat64Arr(timesMs_, timesMs) || VecInt32ToLVint32Arr(errorCodes_, errorCodes))
+			return EXIT_FAILURE;
+		if (VecUint32ToLVuint32Arr(exErrorCodes_, exErrorCodes) || VecUint32ToLVuint32Arr(objects_, objects) || VecUint32ToLVuint32Arr(axes_, axes))
+			return EXIT_FAILURE;
+		if (VecStrToLVStrArr(messages_, messages))
+			return EXIT_FAILURE;
+		return EXIT_SUCCESS;
+	}
+
+	int32_t GetErrorStats(uint64_t& recorded, uint64_t& dropped) {
+		return Controller::GetInstance()->GetErrorStats(recorded, dropped);
+	}
+
 
 	int32_t GetPorts(std::vector<std::string>& ports) {
 		Controller* c = Controller::GetInstance();
-		return c->GetAvailablePorts(ports);
+		return c->Execute([&] { return c->GetAvailablePorts(ports); });
 	}
 
 	int32_t GetPortsLV(LStrArrayHdl* arr) {
@@ -120,7 +89,7 @@ namespace NanoLibWrapper {
 		int32_t err;
 		Controller* c = Controller::GetInstance();
 		std::string mode;
-		if (c->GetModeOfOperation(mode))
+		if (c->Execute([&] { return c->GetModeOfOperation(mode); }))
 			return EXIT_FAILURE;
 		err = StdStrToLVStr(mode, LVAllocatedString);
 		return EXIT_SUCCESS;
@@ -130,7 +99,7 @@ namespace NanoLibWrapper {
 		Controller* c = Controller::GetInstance();
 		std::string state_;
 		bool fault_, voltageEnabled_, quickStop_, warning_, targetReached_, limitReached_, bit12_, bit13_;
-		if (c->GetCiA402State(state_, fault_, voltageEnabled_, quickStop_, warning_, targetReached_, limitReached_, bit12_, bit13_))
+		if (c->Execute([&] { return c->GetCiA402State(state_, fault_, voltageEnabled_, quickStop_, warning_, targetReached_, limitReached_, bit12_, bit13_); }))
 			return EXIT_FAILURE;
 		if (StdStrToLVStr(state_, state))
 			return EXIT_FAILURE;
@@ -146,56 +115,239 @@ namespace NanoLibWrapper {
 		return EXIT_SUCCESS;
 	}
 
-	int32_t GetUserUnits(uint32_t& feed, uint32_t& shaftRevs, uint32_t& posUnit, uint32_t& posExp, uint32_t& velUnit, uint32_t& velExp, uint32_t& velTime, uint32_t& gearRatioMotorRevs, uint32_t& gearRatioShaftRevs) {
+	int32_t ResyncControlWord() {
 		Controller* c = Controller::GetInstance();
-		if (c->GetUserUnitsFeed(feed, shaftRevs))
-			return EXIT_FAILURE;
+		return c->Execute([&] { return c->ResyncControlWord(); });
+	}
 
-		if (c->GetUserUnitsPositioning(posUnit, posExp))
-			return EXIT_FAILURE;
+	int32_t GetControlWordStats(uint64_t& reads, uint64_t& writes, uint64_t& readsAvoided) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->GetControlWordStats(reads, writes, readsAvoided); });
+	}
+
+	int32_t SetConnectionProbePeriod(uint32_t periodMs) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->SetConnectionProbePeriod(periodMs); });
+	}
+
+	int32_t GetConnectionStats(uint64_t& checksAvoided, uint64_t& checksQueried, uint64_t& probes, uint64_t& transportErrors) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->GetConnectionStats(checksAvoided, checksQueried, probes, transportErrors); });
+	}
+
+	int32_t StartTelemetry(uint16_t periodMs) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->StartTelemetry(std::vector<nlc::OdIndex>(Telemetry::kDefaultObjects.begin(), Telemetry::kDefaultObjects.end()), periodMs); });
+	}
+
+	int32_t StartTelemetryObjects(const uint32_t* objects, int32_t count, uint16_t periodMs) {
+		Controller* c = Controller::GetInstance();
+		std::vector<nlc::OdIndex> odIndices;
+		for (int32_t i = 0; objects != nullptr && i < count; i++)
+			odIndices.emplace_back(static_cast<uint16_t>(objects[i] >> 8), static_cast<uint8_t>(objects[i] & 0xFF));
+		return c->Execute([&] { return c->StartTelemetry(odIndices, periodMs); });
+	}
+
+	int32_t StopTelemetry() {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->StopTelemetry(); });
+	}
+
+	int32_t DrainTelemetry(int64_t* rows, int32_t maxRows, int32_t& rowsCopied, int32_t& channels) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->DrainTelemetry(rows, maxRows, rowsCopied, channels); });
+	}
 
-		if (c->GetUserUnitsVelocity(velUnit, velExp, velTime))
+	//the values are written into the LabVIEW arrays directly, without a buffer in between
+	template <class Array>
+	static int32_t DrainTelemetryToLV(LVfloat64ArrayHdl* timesMs, Array*** values, int32_t maxRows, int32_t& channels) {
+		Controller* c = Controller::GetInstance();
+		const size_t rows = static_cast<size_t>(std::max(maxRows, 0));
+		//room for every channel count, the handles only grow once
+		if (ReserveLVArray(timesMs, rows) || ReserveLVArray(values, rows * Telemetry::kMaxChannels))
 			return EXIT_FAILURE;
 
-		if (c->GetUserUnitsGearRatio(gearRatioMotorRevs, gearRatioShaftRevs))
+		int32_t rowsCopied = 0;
+		if (c->Execute([&] { return c->DrainTelemetry((**timesMs)->elt, (**values)->elt, static_cast<int32_t>(rows), rowsCopied, channels); }))
 			return EXIT_FAILURE;
+		SetLVArraySize(*timesMs, static_cast<size_t>(rowsCopied));
+		SetLVArraySize(*values, static_cast<size_t>(rowsCopied) * static_cast<size_t>(channels));
+		return EXIT_SUCCESS;
+	}
 
-		return EXIT_SUCCESS;;
+	int32_t DrainTelemetryInt32LV(LVfloat64ArrayHdl* timesMs, LVint32ArrayHdl* values, int32_t maxRows, int32_t& channels) {
+		return DrainTelemetryToLV(timesMs, values, maxRows, channels);
 	}
 
-	int32_t SetUserUnits(uint32_t feed, uint32_t shaftRevs, uint32_t posUnit, uint32_t posExp, uint32_t velUnit, uint32_t velExp, uint32_t velTime, uint32_t gearRatioMotorRevs, uint32_t gearRatioShaftRevs) {
+	int32_t DrainTelemetryFloat64LV(LVfloat64ArrayHdl* timesMs, LVfloat64ArrayHdl* values, int32_t maxRows, int32_t& channels) {
+		return DrainTelemetryToLV(timesMs, values, maxRows, channels);
+	}
+
+	int32_t GetTelemetryStats(double& sampleRate, uint64_t& samples, uint64_t& overruns, uint64_t& drops, uint64_t& errors) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->GetTelemetryStats(sampleRate, samples, overruns, drops, errors); });
+	}
+
+	//***CYCLIC SYNCHRONOUS POSITION***
+
+	int32_t StartCyclicPosition(uint32_t periodUs) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->StartCyclicPosition(periodUs); });
+	}
+
+	int32_t StopCyclicPosition() {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->StopCyclicPosition(); });
+	}
+
+	int32_t PushSetpoints(const int32_t* setpoints, int32_t count, uint32_t last, int32_t& accepted, int32_t& free) {
+		Controller* c = Controller::GetInstance();
+		//the bus thread is the only producer of the feeder
+		return c->Execute([&] { return c->PushSetpoints(setpoints, count, last != 0, accepted, free); });
+	}
+
+	int32_t GetSetpointFeederStats(uint64_t& cycles, uint64_t& written, uint64_t& underruns, uint64_t& lateWrites, uint64_t& skippedCycles,
+		double& meanJitterUs, double& maxJitterUs, double& meanWriteUs, double& maxWriteUs, uint32_t& buffered, uint32_t& running) {
 		Controller* c = Controller::GetInstance();
-		if (c->SetUserUnitsFeed(feed, shaftRevs))
+		SetpointFeeder::Stats stats;
+		if (c->Execute([&] { return c->GetSetpointFeederStats(stats); }))
 			return EXIT_FAILURE;
+		cycles = stats.cycles;
+		written = stats.written;
+		underruns = stats.underruns;
+		lateWrites = stats.lateWrites;
+		skippedCycles = stats.skippedCycles;
+		meanJitterUs = stats.meanJitterUs;
+		maxJitterUs = stats.maxJitterUs;
+		meanWriteUs = stats.meanWriteUs;
+		maxWriteUs = stats.maxWriteUs;
+		buffered = static_cast<uint32_t>(stats.buffered);
+		running = stats.running ? 1 : 0;
+		return EXIT_SUCCESS;
+	}
+
+	int32_t GetFollowingError(int32_t& followingError) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->GetFollowingError(followingError); });
+	}
+
+	//***INTERPOLATED POSITION***
+
+	int32_t StartInterpolatedPosition(uint32_t periodUs) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->StartInterpolatedPosition(periodUs); });
+	}
+
+	int32_t StopInterpolatedPosition() {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->StopInterpolatedPosition(); });
+	}
 
-		if (c->SetUserUnitsPositioning(posUnit, posExp))
+	int32_t UploadTrajectory(const int32_t* positions, int32_t count, uint32_t timeBaseUs) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->UploadTrajectory(positions, count, timeBaseUs); });
+	}
+
+	int32_t GetSetpointBufferStats(uint32_t& buffered, uint32_t& capacity, uint32_t& driveBuffered, uint32_t& lead, double& setpointsPerSecond) {
+		Controller* c = Controller::GetInstance();
+		SetpointFeeder::Stats stats;
+		if (c->Execute([&] { return c->GetSetpointFeederStats(stats); }))
 			return EXIT_FAILURE;
+		buffered = static_cast<uint32_t>(stats.buffered);
+		capacity = static_cast<uint32_t>(SetpointFeeder::kCapacity);
+		driveBuffered = stats.driveBuffered;
+		lead = stats.lead;
+		setpointsPerSecond = stats.setpointsPerSecond;
+		return EXIT_SUCCESS;
+	}
+
+	int32_t GetBusQueueStats(uint32_t& depth, uint32_t& maxDepth, uint64_t& executed, uint64_t& posted, double& avgWaitUs, double& maxWaitUs) {
+		Controller* c = Controller::GetInstance();
+		//read directly, queueing would distort the numbers
+		return c->GetBusQueueStats(depth, maxDepth, executed, posted, avgWaitUs, maxWaitUs);
+	}
+
+	int32_t SetPerfStatsEnabled(uint32_t enabled) {
+		return Controller::GetInstance()->SetPerfStatsEnabled(enabled != 0);
+	}
+
+	int32_t ResetPerfStats() {
+		return Controller::GetInstance()->ResetPerfStats();
+	}
 
-		if (c->SetUserUnitsVelocity(velUnit, velExp, velTime))
+	int32_t GetPerfStatsLV(LStrArrayHdl* names, LVuint64ArrayHdl* calls, LVuint64ArrayHdl* sdos,
+		LVfloat64ArrayHdl* meanUs, LVfloat64ArrayHdl* p50Us, LVfloat64ArrayHdl* p99Us, LVfloat64ArrayHdl* maxUs) {
+		std::vector<PerfStats::SiteStats> sites;
+		if (Controller::GetInstance()->GetPerfStats(sites))
 			return EXIT_FAILURE;
 
+		std::vector<std::string> names_;
+		std::vector<uint64_t> calls_, sdos_;
+		std::vector<double> meanUs_, p50Us_, p99Us_, maxUs_;
+		for (const PerfStats::SiteStats& site : sites) {
+			names_.push_back(site.name);
+			calls_.push_back(site.calls);
+			sdos_.push_back(site.sdos);
+			meanUs_.push_back(site.meanUs);
+			p50Us_.push_back(site.p50Us);
+			p99Us_.push_back(site.p99Us);
+			maxUs_.push_back(site.maxUs);
+		}
+		if (VecStrToLVStrArr(names_, names) || VecUint64ToLVuint64Arr(calls_, calls) || VecUint64ToLVuint64Arr(sdos_, sdos))
+			return EXIT_FAILURE;
+		if (VecFloat64ToLVfloat64Arr(meanUs_, meanUs) || VecFloat64ToLVfloat64Arr(p50Us_, p50Us)
+			|| VecFloat64ToLVfloat64Arr(p99Us_, p99Us) || VecFloat64ToLVfloat64Arr(maxUs_, maxUs))
+			return EXIT_FAILURE;
 		return EXIT_SUCCESS;
 	}
 
+	int32_t GetPerfReportLV(LStrHandle* report) {
+		std::string text;
+		if (Controller::GetInstance()->GetPerfReport(text))
+			return EXIT_FAILURE;
+		return StdStrToLVStr(text, report);
+	}
+
+	int32_t GetUserUnits(uint32_t& feed, uint32_t& shaftRevs, uint32_t& posUnit, uint32_t& posExp, uint32_t& velUnit, uint32_t& velExp, uint32_t& velTime, uint32_t& gearRatioMotorRevs, uint32_t& gearRatioShaftRevs) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->GetUserUnits(feed, shaftRevs, posUnit, posExp, velUnit, velExp, velTime, gearRatioMotorRevs, gearRatioShaftRevs); });
+	}
+
+	int32_t SetUserUnits(uint32_t feed, uint32_t shaftRevs, uint32_t posUnit, uint32_t posExp, uint32_t velUnit, uint32_t velExp, uint32_t velTime, uint32_t gearRatioMotorRevs, uint32_t gearRatioShaftRevs) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] {
+			if (c->SetUserUnitsFeed(feed, shaftRevs))
+				return EXIT_FAILURE;
+
+			if (c->SetUserUnitsPositioning(posUnit, posExp))
+				return EXIT_FAILURE;
+
+			if (c->SetUserUnitsVelocity(velUnit, velExp, velTime))
+				return EXIT_FAILURE;
+
+			return EXIT_SUCCESS;
+		});
+	}
+
 	int32_t OpenPort(uint32_t portToOpen) {
 		Controller* c = Controller::GetInstance();
-		return c->OpenPort(portToOpen);
+		return c->Execute([&] { return c->OpenPort(portToOpen); });
 	}
 
 	int32_t Halt() {
 		Controller* c = Controller::GetInstance();
-		return c->Halt();
+		return c->ExecuteUrgent([&] { return c->Halt(); });
 	}
 
 	int32_t QuickStop() {
 		Controller* c = Controller::GetInstance();
-		return c->QuickStop();
+		return c->ExecuteUrgent([&] { return c->QuickStop(); });
 	}
 
 	int32_t GetErrorStackLV(LStrArrayHdl* LVAllocatedStrArray) {
 		Controller* c = Controller::GetInstance();
 		std::vector<std::string> errorStack;
-		if (c->GetDeviceErrorStack(errorStack))
+		if (c->Execute([&] { return c->GetDeviceErrorStack(errorStack); }))
 			return EXIT_FAILURE;
 
 		return VecStrToLVStrArr(errorStack, LVAllocatedStrArray);
@@ -203,16 +355,21 @@ namespace NanoLibWrapper {
 
 	int32_t ClosePort() {
 		Controller* c = Controller::GetInstance();
-		return c->ClosePort();
+		return c->Execute([&] { return c->ClosePort(); });
+	}
+	int32_t Shutdown() {
+		//not through Execute, it ends the bus thread
+		return Controller::GetInstance()->Shutdown();
 	}
 	int32_t AutoSetupMotPams() {
 		Controller* c = Controller::GetInstance();
-		return c->AutoSetupMotPams();
+		uint32_t jobId = 0;
+		return WaitForJob(c, c->Execute([&] { return c->StartAutoSetupMotPamsAsync(jobId); }), jobId);
 	}
 
 	int32_t ScanBus(std::vector<std::string>& devices) {
 		Controller* c = Controller::GetInstance();
-		return c->ScanBus(devices);
+		return c->Execute([&] { return c->ScanBus(devices); });
 	}
 
 	int32_t ScanBusLV(LStrArrayHdl* LVAllocatedStrArray) {
@@ -225,56 +382,77 @@ namespace NanoLibWrapper {
 
 	int32_t DisconnectDevice() {
 		Controller* c = Controller::GetInstance();
-		return c->DisconnectDevice();
+		return c->Execute([&] { return c->DisconnectDevice(); });
 	}
 
 	int32_t ConnectDevice(uint32_t deviceToOpen) {
 		Controller* c = Controller::GetInstance();
-		return c->ConnectDevice(deviceToOpen);
+		return c->Execute([&] { return c->ConnectDevice(deviceToOpen); });
+	}
+
+	int32_t ConnectDeviceOfScan(uint32_t generation, uint32_t deviceToOpen) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->ConnectDeviceOfScan(generation, deviceToOpen); });
+	}
+
+	int32_t FindDevice(uint32_t nodeId, const char* serialNumber, uint32_t& nodeIdFound) {
+		Controller* c = Controller::GetInstance();
+		const std::string serialNumber_ = serialNumber != nullptr ? serialNumber : "";
+		return c->Execute([&] { return c->FindDevice(nodeId, serialNumber_, nodeIdFound); });
+	}
+
+	int32_t InvalidateScanCache() {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->InvalidateScanCache(); });
+	}
+
+	int32_t GetScanInfo(uint32_t& generation, uint32_t& deviceCount, double& ageMs) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->GetScanInfo(generation, deviceCount, ageMs); });
 	}
 
 	int32_t SetMotorParameters(uint32_t polePairCount, uint32_t ratedCurrent, uint32_t maxCurrent, uint32_t maxCurrentDuration, uint32_t idleCurrent, uint32_t driveMode) {
 		Controller* c = Controller::GetInstance();
-		return c->SetMotorParameters(polePairCount, ratedCurrent, maxCurrent, maxCurrentDuration, idleCurrent, driveMode);
+		return c->Execute([&] { return c->SetMotorParameters(polePairCount, ratedCurrent, maxCurrent, maxCurrentDuration, idleCurrent, driveMode); });
 	}
 
 	int32_t GetMotorParameters(uint32_t& polePairCount, uint32_t& ratedCurrent, uint32_t& maxCurrent, uint32_t& maxCurrentDuration, uint32_t& idleCurrent, uint32_t& driveMode) {
 		Controller* c = Controller::GetInstance();
-		return c->GetMotorParameters(polePairCount, ratedCurrent, maxCurrent, maxCurrentDuration, idleCurrent, driveMode);
+		return c->Execute([&] { return c->GetMotorParameters(polePairCount, ratedCurrent, maxCurrent, maxCurrentDuration, idleCurrent, driveMode); });
 	}
 
 	int32_t GetPositioningParameters(uint32_t& profileVelocity, int32_t& setTarget) {
 		Controller* c = Controller::GetInstance();
-		return c->GetPositioningParameters(profileVelocity, setTarget);
+		return c->Execute([&] { return c->GetPositioningParameters(profileVelocity, setTarget); });
 	}
 
 	int32_t SaveMotorParameters() {
 		Controller* c = Controller::GetInstance();
-		if (c->SaveGroupTuning())
-			return EXIT_FAILURE;
-		return c->SaveGroupMovement();
+		uint32_t jobId = 0;
+		return WaitForJob(c, c->Execute([&] { return c->StartSaveGroupsAsync({ 0x06, 0x05 }, jobId); }), jobId);
 	}
 
 	int32_t SaveUserUnits() {
 		Controller* c = Controller::GetInstance();
-		return c->SaveGroupApplication();
+		uint32_t jobId = 0;
+		return WaitForJob(c, c->Execute([&] { return c->StartSaveGroupsAsync({ 0x03 }, jobId); }), jobId);
 	}
 
 	int32_t GetPositionActual(int32_t& pos) {
 		Controller* c = Controller::GetInstance();
-		return c->GetPositionActual(pos);
+		return c->Execute([&] { return c->GetPositionActual(pos); });
 	}
 
 
 	int32_t GetFirmwareVersion(std::string& ver) {
 		Controller* c = Controller::GetInstance();
-		return c->GetDeviceFirmwareBuildId(ver);
+		return c->Execute([&] { return c->GetDeviceFirmwareBuildId(ver); });
 	}
 
 	int32_t GetFirmwareVersionLV(LStrHandle* LVAllocatedStr) {
 		Controller* c = Controller::GetInstance();
 		std::string ver;
-		if (c->GetDeviceFirmwareBuildId(ver))
+		if (c->Execute([&] { return c->GetDeviceFirmwareBuildId(ver); }))
 			return EXIT_FAILURE;
 		return StdStrToLVStr(ver, LVAllocatedStr);
 	}
@@ -285,23 +463,60 @@ namespace NanoLibWrapper {
 
 	int32_t SetTargetPosition(int32_t val, uint32_t absRel) {
 		Controller* c = Controller::GetInstance();
-		return c->SetTargetPosition(val, absRel);
+		return c->Execute([&] { return c->SetTargetPosition(val, absRel); });
+	}
+
+	int32_t PostTargetPosition(int32_t val, uint32_t absRel) {
+		Controller* c = Controller::GetInstance();
+		c->Post([c, val, absRel] { return c->SetTargetPosition(val, absRel); });
+		return EXIT_SUCCESS;
 	}
 
 	int32_t StartPositioning() {
 		Controller* c = Controller::GetInstance();
-		return c->StartPositioning();
+		return c->Execute([&] { return c->StartPositioning(); });
 	}
 
 	//profile positioning velocity
 	int32_t SetProfileVelocity(uint32_t speed) {
 		Controller* c = Controller::GetInstance();
-		return c->SetProfileVelocity(speed);
+		return c->Execute([&] { return c->SetProfileVelocity(speed); });
 	}
 
 	int32_t SetProfileAcceleration(uint32_t acc) {
 		Controller* c = Controller::GetInstance();
-		return c->SetProfileAcceleration(acc);
+		return c->Execute([&] { return c->SetProfileAcceleration(acc); });
+	}
+
+	//***WAYPOINTS***
+
+	int32_t QueueTargets(const int32_t* positions, const uint32_t* velocities, int32_t count, uint32_t absRel, uint32_t& jobId) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->QueueTargets(positions, velocities, count, absRel, jobId); });
+	}
+
+	int32_t ClearWaypoints() {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->ClearWaypoints(); });
+	}
+
+	int32_t GetWaypointQueueStats(uint32_t& depth, uint32_t& maxDepth, uint64_t& sent, uint64_t& acknowledged,
+		double& meanQueueMs, double& maxQueueMs, double& meanAcknowledgeMs, double& maxAcknowledgeMs, double& lastAcknowledgeMs, uint32_t& running) {
+		Controller* c = Controller::GetInstance();
+		WaypointQueue::Stats stats;
+		if (c->Execute([&] { return c->GetWaypointQueueStats(stats); }))
+			return EXIT_FAILURE;
+		depth = static_cast<uint32_t>(stats.depth);
+		maxDepth = static_cast<uint32_t>(stats.maxDepth);
+		sent = stats.sent;
+		acknowledged = stats.acknowledged;
+		meanQueueMs = stats.meanQueueMs;
+		maxQueueMs = stats.maxQueueMs;
+		meanAcknowledgeMs = stats.meanAcknowledgeMs;
+		maxAcknowledgeMs = stats.maxAcknowledgeMs;
+		lastAcknowledgeMs = stats.lastAcknowledgeMs;
+		running = stats.running ? 1 : 0;
+		return EXIT_SUCCESS;
 	}
 
 
@@ -309,44 +524,696 @@ namespace NanoLibWrapper {
 
 	int32_t StartVelocity() {
 		Controller* c = Controller::GetInstance();
-		return c->StartVelocity();
+		return c->Execute([&] { return c->StartVelocity(); });
 	}
 
 	int32_t SetVelocityPams(int16_t vel, uint32_t deltaSpeedAcc, uint16_t deltaTimeAcc, uint32_t deltaSpeedDec, uint16_t deltaTimeDec) {
 		Controller* c = Controller::GetInstance();
-		if (c->SetTargetVelocity(vel))
-			return EXIT_FAILURE;
-		if (c->SetVelocityAcceleration(deltaSpeedAcc, deltaTimeAcc))
-			return EXIT_FAILURE;
-		return (c->SetVelocityDeceleration(deltaSpeedDec, deltaTimeDec));
+		return c->Execute([&] {
+			if (c->SetTargetVelocity(vel))
+				return EXIT_FAILURE;
+			if (c->SetVelocityAcceleration(deltaSpeedAcc, deltaTimeAcc))
+				return EXIT_FAILURE;
+			return c->SetVelocityDeceleration(deltaSpeedDec, deltaTimeDec);
+		});
+	}
+
+	int32_t PostTargetVelocity(int16_t vel) {
+		Controller::GetInstance()->PostTargetVelocity(std::nullopt, vel);
+		return EXIT_SUCCESS;
+	}
+
+	int32_t GetTargetVelocityStats(uint64_t& posted, uint64_t& written, uint64_t& coalesced) {
+		//read directly, the counters are atomic
+		const CoalescingSetpoint<int16_t>::Stats stats = Controller::GetInstance()->GetTargetVelocityStats();
+		posted = stats.stored;
+		written = stats.written;
+		coalesced = stats.coalesced;
+		return EXIT_SUCCESS;
 	}
 
 	int32_t GetVelocityPams(int16_t& vel, uint32_t& deltaSpeedAcc, uint16_t& deltaTimeAcc, uint32_t& deltaSpeedDec, uint16_t& deltaTimeDec) {
 		Controller* c = Controller::GetInstance();
-		if (c->GetTargetVelocity(vel))
-			return EXIT_FAILURE;
-		if (c->GetVelocityAcceleration(deltaSpeedAcc, deltaTimeAcc))
-			return EXIT_FAILURE;
-		return (c->GetVelocityDeceleration(deltaSpeedDec, deltaTimeDec));
+		return c->Execute([&] { return c->GetVelocityParameters(vel, deltaSpeedAcc, deltaTimeAcc, deltaSpeedDec, deltaTimeDec); });
 	}
 
 	int32_t GetVelocityStatus(int16_t& demandedSpeed, int16_t& speedActual) {
 		Controller* c = Controller::GetInstance();
-		if (c->GetVelocityDemanded(demandedSpeed))
-			return EXIT_FAILURE;
-		return (c->GetVelocityDemanded(speedActual));
+		return c->Execute([&] { return c->GetVelocityStatus(demandedSpeed, speedActual); });
+	}
+
+	//***PROFILE TORQUE***
+
+	int32_t StartProfileTorque() {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->StartProfileTorque(); });
+	}
+
+	int32_t SetTargetTorque(int16_t torque) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->SetTargetTorque(torque); });
+	}
+
+	int32_t SetProfileTorquePams(int16_t torque, uint32_t slope, uint16_t maxTorque) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] {
+			//limit and slope first, the new target must not run with the old ones
+			if (c->SetMaxTorque(maxTorque))
+				return EXIT_FAILURE;
+			if (c->SetTorqueSlope(slope))
+				return EXIT_FAILURE;
+			return c->SetTargetTorque(torque);
+		});
+	}
+
+	int32_t GetProfileTorquePams(int16_t& torque, uint32_t& slope, uint16_t& maxTorque) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->GetProfileTorqueParameters(torque, slope, maxTorque); });
+	}
+
+	int32_t GetTorqueStatus(int16_t& torqueActual, int16_t& currentActual) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->GetTorqueStatus(torqueActual, currentActual); });
+	}
+
+	int32_t PostTargetTorque(int16_t torque) {
+		Controller::GetInstance()->PostTargetTorque(std::nullopt, torque);
+		return EXIT_SUCCESS;
+	}
+
+	int32_t GetTargetTorqueStats(uint64_t& posted, uint64_t& written, uint64_t& coalesced) {
+		//read directly, the counters are atomic
+		const CoalescingSetpoint<int16_t>::Stats stats = Controller::GetInstance()->GetTargetTorqueStats();
+		posted = stats.stored;
+		written = stats.written;
+		coalesced = stats.coalesced;
+		return EXIT_SUCCESS;
+	}
+
+	//***PROFILE VELOCITY***
+
+	int32_t StartProfileVelocity() {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->StartProfileVelocity(); });
+	}
+
+	int32_t SetTargetProfileVelocity(int32_t vel) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->SetTargetProfileVelocity(vel); });
+	}
+
+	int32_t SetProfileVelocityPams(int32_t vel, uint32_t acc, uint32_t dec) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] {
+			//ramps first, the new target must not run with the old ones
+			if (c->SetProfileVelocityAcceleration(acc))
+				return EXIT_FAILURE;
+			if (c->SetProfileVelocityDeceleration(dec))
+				return EXIT_FAILURE;
+			return c->SetTargetProfileVelocity(vel);
+		});
+	}
+
+	int32_t GetProfileVelocityPams(int32_t& vel, uint32_t& acc, uint32_t& dec) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->GetProfileVelocityParameters(vel, acc, dec); });
+	}
+
+	int32_t GetProfileVelocityStatus(int32_t& demandedVel, int32_t& velActual) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->GetProfileVelocityStatus(demandedVel, velActual); });
+	}
+
+	int32_t PostTargetProfileVelocity(int32_t vel) {
+		Controller::GetInstance()->PostTargetProfileVelocity(std::nullopt, vel);
+		return EXIT_SUCCESS;
+	}
+
+	int32_t GetTargetProfileVelocityStats(uint64_t& posted, uint64_t& written, uint64_t& coalesced) {
+		const CoalescingSetpoint<int32_t>::Stats stats = Controller::GetInstance()->GetTargetProfileVelocityStats();
+		posted = stats.stored;
+		written = stats.written;
+		coalesced = stats.coalesced;
+		return EXIT_SUCCESS;
 	}
 
 	//**HOMING***
 
 	int32_t SetHomingAcceleration(uint32_t acc) {
 		Controller* c = Controller::GetInstance();
-		return c->SetHomingAcceleration(acc);
+		return c->Execute([&] { return c->SetHomingAcceleration(acc); });
 	}
 
 	int32_t Home(uint32_t speedZero, uint32_t speedSwitch) {
 		Controller* c = Controller::GetInstance();
-		return c->Home(speedZero, speedSwitch);
+		return c->Execute([&] { return c->Home(speedZero, speedSwitch); });
+	}
+
+
+	//***JOBS***
+
+	int32_t StartSaveMotorParametersAsync(uint32_t& jobId) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->StartSaveGroupsAsync({ 0x06, 0x05 }, jobId); });
+	}
+
+	int32_t StartSaveUserUnitsAsync(uint32_t& jobId) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->StartSaveGroupsAsync({ 0x03 }, jobId); });
+	}
+
+	int32_t StartAutoSetupMotPamsAsync(uint32_t& jobId) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->StartAutoSetupMotPamsAsync(jobId); });
+	}
+
+	int32_t StartHomeAsync(uint32_t speedZero, uint32_t speedSwitch, uint32_t& jobId) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->StartHomeAsync(speedZero, speedSwitch, jobId); });
+	}
+
+	//the job calls below bypass the bus thread, the jobs need it while they are waited for
+
+	int32_t PollJob(uint32_t jobId, int32_t& progress, int32_t& state) {
+		Controller* c = Controller::GetInstance();
+		return c->PollJob(jobId, progress, state);
+	}
+
+	int32_t WaitJob(uint32_t jobId, uint32_t timeoutMs) {
+		Controller* c = Controller::GetInstance();
+		return c->WaitJob(jobId, timeoutMs);
+	}
+
+	int32_t CancelJob(uint32_t jobId) {
+		Controller* c = Controller::GetInstance();
+		return c->CancelJob(jobId);
+	}
+
+	//***WAITING***
+
+	//bypasses the bus thread, only the polls are queued
+	int32_t WaitTargetReached(uint32_t timeoutMs) {
+		Controller* c = Controller::GetInstance();
+		return c->WaitTargetReached(timeoutMs);
+	}
+
+	int32_t SetWaitPolicy(int32_t kind, uint32_t minIntervalMs, uint32_t maxIntervalMs, uint32_t deadlineMs, double growth) {
+		Controller* c = Controller::GetInstance();
+		return c->SetWaitPolicy(kind, minIntervalMs, maxIntervalMs, deadlineMs, growth);
+	}
+
+	int32_t GetWaitStats(int32_t kind, uint64_t& completed, uint64_t& failed, uint64_t& timedOut, uint64_t& cancelled, uint64_t& polls,
+		double& avgMs, double& minMs, double& maxMs, uint64_t* histogram, int32_t histogramSize) {
+		Controller* c = Controller::GetInstance();
+		return c->GetWaitStats(kind, completed, failed, timedOut, cancelled, polls, avgMs, minMs, maxMs, histogram, histogramSize);
+	}
+
+	//***BUS OPTIONS***
+
+	int32_t SetBusOption(const char* name, const char* value) {
+		Controller* c = Controller::GetInstance();
+		const std::string name_ = name != nullptr ? name : "";
+		const std::string value_ = value != nullptr ? value : "";
+		return c->Execute([&] { return c->SetBusOption(name_, value_); });
+	}
+
+	int32_t GetBusOptionsLV(uint32_t port, LStrArrayHdl* names, LStrArrayHdl* values) {
+		Controller* c = Controller::GetInstance();
+		std::vector<std::string> names_, values_;
+		if (c->Execute([&] { return c->GetBusOptions(port, names_, values_); }))
+			return EXIT_FAILURE;
+		if (VecStrToLVStrArr(names_, names) || VecStrToLVStrArr(values_, values))
+			return EXIT_FAILURE;
+		return EXIT_SUCCESS;
+	}
+
+	int32_t StartBusProbeAsync(uint32_t port, uint32_t nodeId, uint32_t roundTrips, uint32_t applyRecommended, uint32_t& jobId) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->StartBusProbeAsync(port, nodeId, roundTrips, applyRecommended != 0, jobId); });
+	}
+
+	int32_t GetBusProbeResultsLV(LStrArrayHdl* labels, LVuint32ArrayHdl* devices, LVuint32ArrayHdl* errors,
+		double* roundTripsPerSecond, int32_t maxResults, int32_t& recommended) {
+		Controller* c = Controller::GetInstance();
+		std::vector<BusProbe::Result> results;
+		if (c->GetBusProbeResults(results, recommended))
+			return EXIT_FAILURE;
+
+		std::vector<std::string> labels_;
+		std::vector<uint32_t> devices_, errors_;
+		for (size_t i = 0; i < results.size(); i++) {
+			labels_.push_back(results[i].setting.label);
+			devices_.push_back(results[i].devices);
+			errors_.push_back(results[i].errors);
+			if (static_cast<int32_t>(i) < maxResults)
+				roundTripsPerSecond[i] = results[i].roundTripsPerSecond;
+		}
+		if (VecStrToLVStrArr(labels_, labels))
+			return EXIT_FAILURE;
+		if (VecUint32ToLVuint32Arr(devices_, devices) || VecUint32ToLVuint32Arr(errors_, errors))
+			return EXIT_FAILURE;
+		return EXIT_SUCCESS;
+	}
+
+	//***SESSION***
+
+	int32_t OpenLastSession(double& loadMs, double& openMs, double& connectMs) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->OpenLastSession(loadMs, openMs, connectMs); });
+	}
+
+	int32_t SetSessionProfilePath(const char* path) {
+		Controller* c = Controller::GetInstance();
+		const std::string path_ = path != nullptr ? path : "";
+		return c->Execute([&] { return c->SetSessionProfilePath(path_); });
+	}
+
+	//***DISCOVERY***
+
+	int32_t StartDiscovery(uint32_t readSerialNumbers) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->StartDiscovery(readSerialNumbers != 0); });
+	}
+
+	int32_t CancelDiscovery() {
+		Controller* c = Controller::GetInstance();
+		return c->CancelDiscovery();
+	}
+
+	int32_t GetDiscoveryState(LVBoolean* running, uint32_t& busesTotal, uint32_t& busesDone) {
+		Controller* c = Controller::GetInstance();
+		bool running_;
+		if (c->GetDiscoveryState(running_, busesTotal, busesDone))
+			return EXIT_FAILURE;
+		*running = static_cast<LVBoolean>(running_);
+		return EXIT_SUCCESS;
+	}
+
+	int32_t ReadDiscoveryEventLV(LVBoolean* available, int32_t& type, uint32_t& bus, int32_t& value, LStrHandle* text) {
+		Controller* c = Controller::GetInstance();
+		bool available_;
+		std::string text_;
+		if (c->ReadDiscoveryEvent(available_, type, bus, value, text_))
+			return EXIT_FAILURE;
+		*available = static_cast<LVBoolean>(available_);
+		if (available_ && StdStrToLVStr(text_, text))
+			return EXIT_FAILURE;
+		return EXIT_SUCCESS;
+	}
+
+	int32_t GetDiscoveredDevicesLV(LVuint32ArrayHdl* buses, LVuint32ArrayHdl* indices, LVuint32ArrayHdl* nodeIds,
+		LStrArrayHdl* descriptions, LStrArrayHdl* serialNumbers) {
+		Controller* c = Controller::GetInstance();
+		std::vector<Discovery::Device> devices;
+		if (c->GetDiscoveredDevices(devices))
+			return EXIT_FAILURE;
+
+		std::vector<uint32_t> buses_, indices_, nodeIds_;
+		std::vector<std::string> descriptions_, serialNumbers_;
+		for (const Discovery::Device& device : devices) {
+			buses_.push_back(device.bus);
+			indices_.push_back(device.index);
+			nodeIds_.push_back(device.nodeId);
+			descriptions_.push_back(device.description);
+			serialNumbers_.push_back(device.serialNumber);
+		}
+		if (VecUint32ToLVuint32Arr(buses_, buses) || VecUint32ToLVuint32Arr(indices_, indices) || VecUint32ToLVuint32Arr(nodeIds_, nodeIds))
+			return EXIT_FAILURE;
+		if (VecStrToLVStrArr(descriptions_, descriptions) || VecStrToLVStrArr(serialNumbers_, serialNumbers))
+			return EXIT_FAILURE;
+		return EXIT_SUCCESS;
+	}
+
+	//***AXES***
+
+	int32_t ConnectAxis(uint32_t axis, uint32_t deviceToOpen) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->ConnectAxis(axis, deviceToOpen); });
+	}
+
+	int32_t ConnectAxes(const uint32_t* devicesToOpen, int32_t count) {
+		Controller* c = Controller::GetInstance();
+		std::vector<uint32_t> devices;
+		for (int32_t i = 0; devicesToOpen != nullptr && i < count; i++)
+			devices.push_back(devicesToOpen[i]);
+		return c->Execute([&] { return c->ConnectAxes(devices); });
+	}
+
+	int32_t SelectAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->SelectAxis(axis); });
+	}
+
+	int32_t GetSelectedAxis(uint32_t& axis) {
+		Controller* c = Controller::GetInstance();
+		return c->Execute([&] { return c->GetSelectedAxis(axis); });
+	}
+
+	int32_t GetConnectedAxesLV(LVuint32ArrayHdl* axes) {
+		Controller* c = Controller::GetInstance();
+		std::vector<uint32_t> axisIds;
+		if (c->Execute([&] { return c->GetConnectedAxes(axisIds); }))
+			return EXIT_FAILURE;
+		return VecUint32ToLVuint32Arr(axisIds, axes);
+	}
+
+	//the calls below run the export without axis on the bus thread with axis selected for it,
+	//Execute inside the export runs inline there
+
+	int32_t GetErrorStackOnAxisLV(uint32_t axis, LStrArrayHdl* LVAllocatedStrArray) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetErrorStackLV(LVAllocatedStrArray); });
+	}
+
+	int32_t GetModeOfOperationOnAxisLV(uint32_t axis, LStrHandle* LVAllocatedStr) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetModeOfOperationLV(LVAllocatedStr); });
+	}
+
+	int32_t GetCiA402StateOnAxisLV(uint32_t axis, LStrHandle* state, LVBoolean* fault, LVBoolean* voltageEnabled, LVBoolean* quickStop, LVBoolean* warning, LVBoolean* targetReached, LVBoolean* limitReached, LVBoolean* bit12, LVBoolean* bit13) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetCiA402StateLV(state, fault, voltageEnabled, quickStop, warning, targetReached, limitReached, bit12, bit13); });
+	}
+
+	int32_t ResyncControlWordOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return ResyncControlWord(); });
+	}
+
+	int32_t GetControlWordStatsOnAxis(uint32_t axis, uint64_t& reads, uint64_t& writes, uint64_t& readsAvoided) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetControlWordStats(reads, writes, readsAvoided); });
+	}
+
+	int32_t GetConnectionStatsOnAxis(uint32_t axis, uint64_t& checksAvoided, uint64_t& checksQueried, uint64_t& probes, uint64_t& transportErrors) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetConnectionStats(checksAvoided, checksQueried, probes, transportErrors); });
+	}
+
+	int32_t StartTelemetryOnAxis(uint32_t axis, uint16_t periodMs) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return StartTelemetry(periodMs); });
+	}
+
+	int32_t StartTelemetryObjectsOnAxis(uint32_t axis, const uint32_t* objects, int32_t count, uint16_t periodMs) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return StartTelemetryObjects(objects, count, periodMs); });
+	}
+
+	int32_t StartCyclicPositionOnAxis(uint32_t axis, uint32_t periodUs) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return StartCyclicPosition(periodUs); });
+	}
+
+	int32_t StopCyclicPositionOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return StopCyclicPosition(); });
+	}
+
+	int32_t PushSetpointsOnAxis(uint32_t axis, const int32_t* setpoints, int32_t count, uint32_t last, int32_t& accepted, int32_t& free) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return PushSetpoints(setpoints, count, last, accepted, free); });
+	}
+
+	int32_t GetSetpointFeederStatsOnAxis(uint32_t axis, uint64_t& cycles, uint64_t& written, uint64_t& underruns, uint64_t& lateWrites, uint64_t& skippedCycles,
+		double& meanJitterUs, double& maxJitterUs, double& meanWriteUs, double& maxWriteUs, uint32_t& buffered, uint32_t& running) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] {
+			return GetSetpointFeederStats(cycles, written, underruns, lateWrites, skippedCycles, meanJitterUs, maxJitterUs, meanWriteUs, maxWriteUs, buffered, running);
+		});
+	}
+
+	int32_t GetFollowingErrorOnAxis(uint32_t axis, int32_t& followingError) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetFollowingError(followingError); });
+	}
+
+	int32_t StartInterpolatedPositionOnAxis(uint32_t axis, uint32_t periodUs) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return StartInterpolatedPosition(periodUs); });
+	}
+
+	int32_t StopInterpolatedPositionOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return StopInterpolatedPosition(); });
+	}
+
+	int32_t UploadTrajectoryOnAxis(uint32_t axis, const int32_t* positions, int32_t count, uint32_t timeBaseUs) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return UploadTrajectory(positions, count, timeBaseUs); });
+	}
+
+	int32_t GetSetpointBufferStatsOnAxis(uint32_t axis, uint32_t& buffered, uint32_t& capacity, uint32_t& driveBuffered, uint32_t& lead, double& setpointsPerSecond) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetSetpointBufferStats(buffered, capacity, driveBuffered, lead, setpointsPerSecond); });
+	}
+
+	int32_t RebootDeviceOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return RebootDevice(); });
+	}
+
+	int32_t GetUserUnitsOnAxis(uint32_t axis, uint32_t& feed, uint32_t& shaftRevs, uint32_t& posUnit, uint32_t& posExp, uint32_t& velUnit, uint32_t& velExp, uint32_t& velTime, uint32_t& gearRatioMotorRevs, uint32_t& gearRatioShaftRevs) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetUserUnits(feed, shaftRevs, posUnit, posExp, velUnit, velExp, velTime, gearRatioMotorRevs, gearRatioShaftRevs); });
+	}
+
+	int32_t SetUserUnitsOnAxis(uint32_t axis, uint32_t feed, uint32_t shaftRevs, uint32_t posUnit, uint32_t posExp, uint32_t velUnit, uint32_t velExp, uint32_t velTime, uint32_t gearRatioMotorRevs, uint32_t gearRatioShaftRevs) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return SetUserUnits(feed, shaftRevs, posUnit, posExp, velUnit, velExp, velTime, gearRatioMotorRevs, gearRatioShaftRevs); });
+	}
+
+	int32_t ConnectDeviceOfScanOnAxis(uint32_t axis, uint32_t generation, uint32_t deviceToOpen) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return ConnectDeviceOfScan(generation, deviceToOpen); });
+	}
+
+	int32_t FindDeviceOnAxis(uint32_t axis, uint32_t nodeId, const char* serialNumber, uint32_t& nodeIdFound) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return FindDevice(nodeId, serialNumber, nodeIdFound); });
+	}
+
+	int32_t DisconnectDeviceOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return DisconnectDevice(); });
+	}
+
+	int32_t GetFirmwareVersionOnAxisLV(uint32_t axis, LStrHandle* LVAllocatedStr) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetFirmwareVersionLV(LVAllocatedStr); });
+	}
+
+	int32_t HaltOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteUrgentOnAxis(axis, [&] { return c->Halt(); });
+	}
+
+	int32_t QuickStopOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteUrgentOnAxis(axis, [&] { return c->QuickStop(); });
+	}
+
+	int32_t AutoSetupMotPamsOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		uint32_t jobId = 0;
+		return WaitForJob(c, c->ExecuteOnAxis(axis, [&] { return c->StartAutoSetupMotPamsAsync(jobId); }), jobId);
+	}
+
+	int32_t SetMotorParametersOnAxis(uint32_t axis, uint32_t polePairCount, uint32_t ratedCurrent, uint32_t maxCurrent, uint32_t maxCurrentDuration, uint32_t idleCurrent, uint32_t driveMode) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return SetMotorParameters(polePairCount, ratedCurrent, maxCurrent, maxCurrentDuration, idleCurrent, driveMode); });
+	}
+
+	int32_t GetMotorParametersOnAxis(uint32_t axis, uint32_t& polePairCount, uint32_t& ratedCurrent, uint32_t& maxCurrent, uint32_t& maxCurrentDuration, uint32_t& idleCurrent, uint32_t& driveMode) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetMotorParameters(polePairCount, ratedCurrent, maxCurrent, maxCurrentDuration, idleCurrent, driveMode); });
+	}
+
+	int32_t GetPositioningParametersOnAxis(uint32_t axis, uint32_t& profileVelocity, int32_t& setTarget) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetPositioningParameters(profileVelocity, setTarget); });
+	}
+
+	int32_t SaveMotorParametersOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		uint32_t jobId = 0;
+		return WaitForJob(c, c->ExecuteOnAxis(axis, [&] { return c->StartSaveGroupsAsync({ 0x06, 0x05 }, jobId); }), jobId);
+	}
+
+	int32_t SaveUserUnitsOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		uint32_t jobId = 0;
+		return WaitForJob(c, c->ExecuteOnAxis(axis, [&] { return c->StartSaveGroupsAsync({ 0x03 }, jobId); }), jobId);
+	}
+
+	int32_t GetPositionActualOnAxis(uint32_t axis, int32_t& pos) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetPositionActual(pos); });
+	}
+
+	int32_t SetHomingAccelerationOnAxis(uint32_t axis, uint32_t acc) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return SetHomingAcceleration(acc); });
+	}
+
+	int32_t HomeOnAxis(uint32_t axis, uint32_t speedZero, uint32_t speedSwitch) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return Home(speedZero, speedSwitch); });
+	}
+
+	int32_t StartVelocityOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return StartVelocity(); });
+	}
+
+	int32_t SetVelocityPamsOnAxis(uint32_t axis, int16_t vel, uint32_t deltaSpeedAcc, uint16_t deltaTimeAcc, uint32_t deltaSpeedDec, uint16_t deltaTimeDec) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return SetVelocityPams(vel, deltaSpeedAcc, deltaTimeAcc, deltaSpeedDec, deltaTimeDec); });
+	}
+
+	int32_t GetVelocityPamsOnAxis(uint32_t axis, int16_t& vel, uint32_t& deltaSpeedAcc, uint16_t& deltaTimeAcc, uint32_t& deltaSpeedDec, uint16_t& deltaTimeDec) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetVelocityPams(vel, deltaSpeedAcc, deltaTimeAcc, deltaSpeedDec, deltaTimeDec); });
+	}
+
+	int32_t GetVelocityStatusOnAxis(uint32_t axis, int16_t& demandedSpeed, int16_t& speedActual) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetVelocityStatus(demandedSpeed, speedActual); });
+	}
+
+	int32_t SetTargetPositionOnAxis(uint32_t axis, int32_t position, uint32_t absRel) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return SetTargetPosition(position, absRel); });
+	}
+
+	int32_t SetProfileVelocityOnAxis(uint32_t axis, uint32_t speed) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return SetProfileVelocity(speed); });
+	}
+
+	int32_t StartPositioningOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return StartPositioning(); });
+	}
+
+	int32_t SetProfileAccelerationOnAxis(uint32_t axis, uint32_t acc) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return SetProfileAcceleration(acc); });
+	}
+
+	int32_t QueueTargetsOnAxis(uint32_t axis, const int32_t* positions, const uint32_t* velocities, int32_t count, uint32_t absRel, uint32_t& jobId) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return QueueTargets(positions, velocities, count, absRel, jobId); });
+	}
+
+	int32_t ClearWaypointsOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return ClearWaypoints(); });
+	}
+
+	int32_t GetWaypointQueueStatsOnAxis(uint32_t axis, uint32_t& depth, uint32_t& maxDepth, uint64_t& sent, uint64_t& acknowledged,
+		double& meanQueueMs, double& maxQueueMs, double& meanAcknowledgeMs, double& maxAcknowledgeMs, double& lastAcknowledgeMs, uint32_t& running) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] {
+			return GetWaypointQueueStats(depth, maxDepth, sent, acknowledged, meanQueueMs, maxQueueMs, meanAcknowledgeMs, maxAcknowledgeMs, lastAcknowledgeMs, running);
+		});
+	}
+
+	int32_t StartSaveMotorParametersAsyncOnAxis(uint32_t axis, uint32_t& jobId) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return StartSaveMotorParametersAsync(jobId); });
+	}
+
+	int32_t StartSaveUserUnitsAsyncOnAxis(uint32_t axis, uint32_t& jobId) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return StartSaveUserUnitsAsync(jobId); });
+	}
+
+	int32_t StartAutoSetupMotPamsAsyncOnAxis(uint32_t axis, uint32_t& jobId) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return StartAutoSetupMotPamsAsync(jobId); });
+	}
+
+	int32_t StartHomeAsyncOnAxis(uint32_t axis, uint32_t speedZero, uint32_t speedSwitch, uint32_t& jobId) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return StartHomeAsync(speedZero, speedSwitch, jobId); });
+	}
+
+	int32_t PostTargetVelocityOnAxis(uint32_t axis, int16_t vel) {
+		Controller::GetInstance()->PostTargetVelocity(axis, vel);
+		return EXIT_SUCCESS;
+	}
+
+	int32_t StartProfileTorqueOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return StartProfileTorque(); });
+	}
+
+	int32_t SetProfileTorquePamsOnAxis(uint32_t axis, int16_t torque, uint32_t slope, uint16_t maxTorque) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return SetProfileTorquePams(torque, slope, maxTorque); });
+	}
+
+	int32_t SetTargetTorqueOnAxis(uint32_t axis, int16_t torque) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return SetTargetTorque(torque); });
+	}
+
+	int32_t GetProfileTorquePamsOnAxis(uint32_t axis, int16_t& torque, uint32_t& slope, uint16_t& maxTorque) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetProfileTorquePams(torque, slope, maxTorque); });
+	}
+
+	int32_t GetTorqueStatusOnAxis(uint32_t axis, int16_t& torqueActual, int16_t& currentActual) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetTorqueStatus(torqueActual, currentActual); });
+	}
+
+	int32_t PostTargetTorqueOnAxis(uint32_t axis, int16_t torque) {
+		Controller::GetInstance()->PostTargetTorque(axis, torque);
+		return EXIT_SUCCESS;
+	}
+
+	int32_t StartProfileVelocityOnAxis(uint32_t axis) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return StartProfileVelocity(); });
+	}
+
+	int32_t SetProfileVelocityPamsOnAxis(uint32_t axis, int32_t vel, uint32_t acc, uint32_t dec) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return SetProfileVelocityPams(vel, acc, dec); });
+	}
+
+	int32_t SetTargetProfileVelocityOnAxis(uint32_t axis, int32_t vel) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return SetTargetProfileVelocity(vel); });
+	}
+
+	int32_t GetProfileVelocityPamsOnAxis(uint32_t axis, int32_t& vel, uint32_t& acc, uint32_t& dec) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetProfileVelocityPams(vel, acc, dec); });
+	}
+
+	int32_t GetProfileVelocityStatusOnAxis(uint32_t axis, int32_t& demandedVel, int32_t& velActual) {
+		Controller* c = Controller::GetInstance();
+		return c->ExecuteOnAxis(axis, [&] { return GetProfileVelocityStatus(demandedVel, velActual); });
+	}
+
+	int32_t PostTargetProfileVelocityOnAxis(uint32_t axis, int32_t vel) {
+		Controller::GetInstance()->PostTargetProfileVelocity(axis, vel);
+		return EXIT_SUCCESS;
+	}
+
+	int32_t PostTargetPositionOnAxis(uint32_t axis, int32_t position, uint32_t absRel) {
+		Controller* c = Controller::GetInstance();
+		c->PostOnAxis(axis, [c, position, absRel] { return c->SetTargetPosition(position, absRel); });
+		return EXIT_SUCCESS;
+	}
+
+	//bypasses the bus thread like WaitTargetReached
+	int32_t WaitTargetReachedOnAxis(uint32_t axis, uint32_t timeoutMs) {
+		Controller* c = Controller::GetInstance();
+		return c->WaitTargetReachedOnAxis(axis, timeoutMs);
 	}
 
 }
\ No newline at end of file
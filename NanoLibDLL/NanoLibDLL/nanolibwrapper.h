@@ -9,32 +9,7 @@
 #endif
 
 
-#include "fundtypes.h"
-#include "extcode.h"
-
-// This prolog and epilog should be used around any typedef that is passed from LabVIEW
-// to a DLL for parameters configured as LabVIEW type or Adapt to Type
-#include "lv_prolog.h"
-#include "platdefines.h"
-typedef struct
-{
-    int32_t dimSize;
-    LStrHandle elt[1];
-} LStrArrayRec, *LStrArrayPtr, **LStrArrayHdl;
-
-typedef struct {
-	int32_t dimSize;
-	uint32_t elt[1];
-} LVuint32Array;
-typedef LVuint32Array** LVuint32ArrayHdl;
-
-#include "lv_epilog.h"
-
-#if IsOpSystem64Bit
-#define uPtr uQ //unsigned Quad aka 64-bit
-#else
-#define uPtr uL //unsigned Long aka 32-bit
-#endif
+#include "lv_marshal.h"
 
 namespace NanoLibWrapper {
 
@@ -46,17 +21,102 @@ namespace NanoLibWrapper {
 
 	extern "C" NANOLIBDLL_API int32_t GetExceptionsLV(LStrArrayHdl * LVAllocatedStrArray);
 
+	//one element per error recorded after sinceSeq (0 for all), pass nextSeq as sinceSeq of the next call
+	//missed counts the errors overwritten since sinceSeq, the journal keeps the last 256
+	//timesMs are ms since 1970, objects are index << 8 | subIndex of the object accessed, 0 if none
+	extern "C" NANOLIBDLL_API int32_t DrainErrorsLV(uint64_t sinceSeq, uint64_t & nextSeq, uint64_t & missed,
+		LVuint64ArrayHdl * seqs, LVfloat64ArrayHdl * timesMs, LVint32ArrayHdl * errorCodes, LVuint32ArrayHdl * exErrorCodes,
+		LVuint32ArrayHdl * objects, LVuint32ArrayHdl * axes, LStrArrayHdl * messages);
+
+	//recorded counts every error so far, dropped the ones overwritten before any DrainErrorsLV saw them
+	extern "C" NANOLIBDLL_API int32_t GetErrorStats(uint64_t & recorded, uint64_t & dropped);
+
 	extern "C" NANOLIBDLL_API int32_t GetErrorStackLV(LStrArrayHdl * LVAllocatedStrArray);
 
 	extern "C" NANOLIBDLL_API int32_t GetModeOfOperationLV(LStrHandle * LVAllocatedStr);
 
 	extern "C" NANOLIBDLL_API int32_t GetCiA402StateLV(LStrHandle * LVAllocatedStr, LVBoolean * fault, LVBoolean * voltageEnabled, LVBoolean * quickStop, LVBoolean * warning, LVBoolean * targetReached, LVBoolean * limitReached, LVBoolean * bit12, LVBoolean * bit13);
 
-	int32_t StdStrToLVStr(const std::string& s, LStrHandle* str);
+	extern "C" NANOLIBDLL_API int32_t ResyncControlWord();
+
+	extern "C" NANOLIBDLL_API int32_t GetControlWordStats(uint64_t & reads, uint64_t & writes, uint64_t & readsAvoided);
+
+	//periodMs 0 disables the background connection probe
+	extern "C" NANOLIBDLL_API int32_t SetConnectionProbePeriod(uint32_t periodMs);
+
+	extern "C" NANOLIBDLL_API int32_t GetConnectionStats(uint64_t & checksAvoided, uint64_t & checksQueried, uint64_t & probes, uint64_t & transportErrors);
+
+	//***TELEMETRY***
+
+	//samples position actual, velocity actual, statusword and current actual
+	extern "C" NANOLIBDLL_API int32_t StartTelemetry(uint16_t periodMs);
+
+	//objects are given as index << 8 | subIndex, at most 12
+	extern "C" NANOLIBDLL_API int32_t StartTelemetryObjects(const uint32_t * objects, int32_t count, uint16_t periodMs);
+
+	extern "C" NANOLIBDLL_API int32_t StopTelemetry();
+
+	//non-blocking, rows must hold maxRows * (1 + channels) values: timestamp in ms followed by the values
+	extern "C" NANOLIBDLL_API int32_t DrainTelemetry(int64_t * rows, int32_t maxRows, int32_t & rowsCopied, int32_t & channels);
+
+	//non-blocking, LabVIEW arrays sized by the DLL: timesMs gets one timestamp per row, values the channels of each row
+	//the arrays keep their memory from call to call, so draining in a loop allocates once
+	extern "C" NANOLIBDLL_API int32_t DrainTelemetryInt32LV(LVfloat64ArrayHdl * timesMs, LVint32ArrayHdl * values, int32_t maxRows, int32_t & channels);
+
+	extern "C" NANOLIBDLL_API int32_t DrainTelemetryFloat64LV(LVfloat64ArrayHdl * timesMs, LVfloat64ArrayHdl * values, int32_t maxRows, int32_t & channels);
+
+	extern "C" NANOLIBDLL_API int32_t GetTelemetryStats(double& sampleRate, uint64_t & samples, uint64_t & overruns, uint64_t & drops, uint64_t & errors);
+
+	//***CYCLIC SYNCHRONOUS POSITION***
+
+	//switches to cyclic synchronous position and starts writing one set point (607Ah) every periodUs, at least 250 us
+	//the drive holds its actual position until the first set point is pushed
+	extern "C" NANOLIBDLL_API int32_t StartCyclicPosition(uint32_t periodUs);
+
+	extern "C" NANOLIBDLL_API int32_t StopCyclicPosition();
+
+	//appends a chunk of the trajectory, accepted is the number of set points that fit and free the room left in the buffer
+	//last is 1 for the final chunk, the buffer running empty before it counts as an underrun
+	extern "C" NANOLIBDLL_API int32_t PushSetpoints(const int32_t * setpoints, int32_t count, uint32_t last, int32_t & accepted, int32_t & free);
+
+	//cycles run, set points written, underruns, writes that missed the next cycle and the cycles skipped by them,
+	//wake up jitter and write time in us, set points buffered, running is 0 once a write failed
+	extern "C" NANOLIBDLL_API int32_t GetSetpointFeederStats(uint64_t & cycles, uint64_t & written, uint64_t & underruns, uint64_t & lateWrites, uint64_t & skippedCycles,
+		double& meanJitterUs, double& maxJitterUs, double& meanWriteUs, double& maxWriteUs, uint32_t & buffered, uint32_t & running);
 
-	int32_t VecStrToLVStrArr(const std::vector<std::string>& s, LStrArrayHdl* arr);
+	//60F4h in user defined units
+	extern "C" NANOLIBDLL_API int32_t GetFollowingError(int32_t & followingError);
 
-	int32_t VecUint32ToLVuint32Arr(const std::vector<std::string>& s, LVuint32ArrayHdl* arr);
+	//***INTERPOLATED POSITION***
+
+	//switches to interpolated position, the set points go to 60C1h:01 every periodUs and fill the buffer of the drive ahead of time
+	extern "C" NANOLIBDLL_API int32_t StartInterpolatedPosition(uint32_t periodUs);
+
+	extern "C" NANOLIBDLL_API int32_t StopInterpolatedPosition();
+
+	//a whole trajectory with one position every timeBaseUs, up to 65536 positions in one call
+	//starts interpolated position unless it is running with the same time base, then the positions are appended
+	extern "C" NANOLIBDLL_API int32_t UploadTrajectory(const int32_t * positions, int32_t count, uint32_t timeBaseUs);
+
+	//fill level of the set point buffer for interpolated and cyclic synchronous position, driveBuffered is the one of
+	//the drive as read from 60C4h:04 by the last cycle, without write ahead (lead 0) it is counted instead
+	extern "C" NANOLIBDLL_API int32_t GetSetpointBufferStats(uint32_t & buffered, uint32_t & capacity, uint32_t & driveBuffered, uint32_t & lead, double& setpointsPerSecond);
+
+	//all calls are executed in order on the bus thread, depth and wait times of its queue
+	extern "C" NANOLIBDLL_API int32_t GetBusQueueStats(uint32_t & depth, uint32_t & maxDepth, uint64_t & executed, uint64_t & posted, double& avgWaitUs, double& maxWaitUs);
+
+	//times every exported call that runs on the bus thread and every object read and write, off by default
+	extern "C" NANOLIBDLL_API int32_t SetPerfStatsEnabled(uint32_t enabled);
+
+	extern "C" NANOLIBDLL_API int32_t ResetPerfStats();
+
+	//one element per exported call, then per object read or written ("read 0x6041:00"), each ordered by total time
+	//sdos counts the object reads and writes of the calls, times are in us, percentiles within 12%
+	extern "C" NANOLIBDLL_API int32_t GetPerfStatsLV(LStrArrayHdl * names, LVuint64ArrayHdl * calls, LVuint64ArrayHdl * sdos,
+		LVfloat64ArrayHdl * meanUs, LVfloat64ArrayHdl * p50Us, LVfloat64ArrayHdl * p99Us, LVfloat64ArrayHdl * maxUs);
+
+	//GetPerfStatsLV and the slowest calls as a text table
+	extern "C" NANOLIBDLL_API int32_t GetPerfReportLV(LStrHandle * report);
 
 	//***GENERAL***
 
@@ -73,22 +133,42 @@ namespace NanoLibWrapper {
 
 	extern "C" NANOLIBDLL_API int32_t ScanBus(std::vector<std::string> &ports);
 
+	//deviceToOpen is an index of the last scan of the opened bus, the bus is only scanned if it never was
 	extern "C" NANOLIBDLL_API int32_t ConnectDevice(uint32_t deviceToOpen);
 
+	//like ConnectDevice, fails if the bus was scanned again after the scan generation (see GetScanInfo)
+	extern "C" NANOLIBDLL_API int32_t ConnectDeviceOfScan(uint32_t generation, uint32_t deviceToOpen);
+
+	//connects the device with nodeId and/or serialNumber (0 or empty/NULL match any) to the selected axis,
+	//on CANopen a known node id is probed directly instead of scanning the whole bus
+	extern "C" NANOLIBDLL_API int32_t FindDevice(uint32_t nodeId, const char* serialNumber, uint32_t & nodeIdFound);
+
+	//drops all cached scans, the next connect scans again
+	extern "C" NANOLIBDLL_API int32_t InvalidateScanCache();
+
+	//generation and size of the cached scan of the opened bus, ageMs is -1 if there is none
+	extern "C" NANOLIBDLL_API int32_t GetScanInfo(uint32_t & generation, uint32_t & deviceCount, double& ageMs);
+
 	extern "C" NANOLIBDLL_API int32_t DisconnectDevice();
 
 	extern "C" NANOLIBDLL_API int32_t ClosePort();
 
+	//closes the port and ends every thread of the DLL, call it before the DLL is unloaded
+	//with no other call running, unloading with the threads still there can hang LabVIEW; later calls start them again
+	extern "C" NANOLIBDLL_API int32_t Shutdown();
+
 	extern "C" NANOLIBDLL_API int32_t Home(uint32_t speedZero, uint32_t speedSwitch);
 
 	extern "C" NANOLIBDLL_API int32_t GetFirmwareVersion(std::string & ver);
 
 	extern "C" NANOLIBDLL_API int32_t GetFirmwareVersionLV(LStrHandle * ver);
 
+	//Halt and QuickStop run ahead of all queued calls
 	extern "C" NANOLIBDLL_API int32_t Halt();
 
 	extern "C" NANOLIBDLL_API int32_t QuickStop();
 
+	//runs as a job like StartAutoSetupMotPamsAsync and waits for it, other calls are served meanwhile
 	extern "C" NANOLIBDLL_API int32_t AutoSetupMotPams();
 
 	extern "C" NANOLIBDLL_API int32_t SetMotorParameters(uint32_t polePairCount, uint32_t ratedCurrent, uint32_t maxCurrent, uint32_t maxCurrentDuration, uint32_t idleCurrent, uint32_t driveMode);
@@ -97,6 +177,7 @@ namespace NanoLibWrapper {
 
 	extern "C" NANOLIBDLL_API int32_t GetPositioningParameters(uint32_t & profileVelocity, int32_t & setTarget);
 
+	//jobs as well, see AutoSetupMotPams
 	extern "C" NANOLIBDLL_API int32_t SaveMotorParameters();
 
 	extern "C" NANOLIBDLL_API int32_t SaveUserUnits();
@@ -122,15 +203,312 @@ namespace NanoLibWrapper {
 
 	extern "C" NANOLIBDLL_API int32_t GetVelocityStatus(int16_t & demandedSpeed, int16_t & speedActual);
 
+	//returns without waiting, errors end up in GetExceptions
+	//latest value wins: a velocity posted before the previous one was written replaces it, see PostTargetTorque
+	extern "C" NANOLIBDLL_API int32_t PostTargetVelocity(int16_t vel);
+
+	//velocities posted, written to the drive and replaced by a newer one before they were written
+	extern "C" NANOLIBDLL_API int32_t GetTargetVelocityStats(uint64_t & posted, uint64_t & written, uint64_t & coalesced);
+
+	//***PROFILE VELOCITY***
+
+	//switches to profile velocity and enables operation, the drive ramps to the target velocity (60FFh)
+	extern "C" NANOLIBDLL_API int32_t StartProfileVelocity();
+
+	extern "C" NANOLIBDLL_API int32_t SetTargetProfileVelocity(int32_t vel);
+
+	//acceleration 6083h and deceleration 6084h, the latter also ramps down on halt
+	extern "C" NANOLIBDLL_API int32_t SetProfileVelocityPams(int32_t vel, uint32_t acc, uint32_t dec);
+
+	extern "C" NANOLIBDLL_API int32_t GetProfileVelocityPams(int32_t & vel, uint32_t & acc, uint32_t & dec);
+
+	//velocity demand 606Bh and velocity actual 606Ch
+	extern "C" NANOLIBDLL_API int32_t GetProfileVelocityStatus(int32_t & demandedVel, int32_t & velActual);
+
+	//for UI sliders and control loops: returns at once, only the newest velocity is written once the bus thread gets to it
+	extern "C" NANOLIBDLL_API int32_t PostTargetProfileVelocity(int32_t vel);
+
+	extern "C" NANOLIBDLL_API int32_t GetTargetProfileVelocityStats(uint64_t & posted, uint64_t & written, uint64_t & coalesced);
+
+	//***PROFILE TORQUE***
+
+	//switches to profile torque and enables operation, the drive ramps to the target torque with the torque slope
+	//torques in per mille of the rated torque (6076h), currents in per mille of the rated current (6075h)
+	extern "C" NANOLIBDLL_API int32_t StartProfileTorque();
+
+	extern "C" NANOLIBDLL_API int32_t SetTargetTorque(int16_t torque);
+
+	//slope in per mille of the rated torque per second, maxTorque limits the torque in both directions
+	extern "C" NANOLIBDLL_API int32_t SetProfileTorquePams(int16_t torque, uint32_t slope, uint16_t maxTorque);
+
+	extern "C" NANOLIBDLL_API int32_t GetProfileTorquePams(int16_t & torque, uint32_t & slope, uint16_t & maxTorque);
+
+	extern "C" NANOLIBDLL_API int32_t GetTorqueStatus(int16_t & torqueActual, int16_t & currentActual);
+
+	//for control loops: returns at once, a torque posted before the previous one was written replaces it,
+	//so the drive always gets the newest value and nothing piles up; errors end up in GetExceptions
+	//it goes to the axis selected at the time of the call, even if another one is selected before it is written
+	extern "C" NANOLIBDLL_API int32_t PostTargetTorque(int16_t torque);
+
+	//torques posted, written to the drive and replaced by a newer one before they were written
+	extern "C" NANOLIBDLL_API int32_t GetTargetTorqueStats(uint64_t & posted, uint64_t & written, uint64_t & coalesced);
+
 
 	//***POSITIONING***
 
 	extern "C" NANOLIBDLL_API int32_t SetTargetPosition(int32_t position, uint32_t absRel);
 
+	//queues the setpoint and returns without waiting, errors end up in GetExceptions
+	extern "C" NANOLIBDLL_API int32_t PostTargetPosition(int32_t position, uint32_t absRel);
+
 	extern "C" NANOLIBDLL_API int32_t SetProfileVelocity(uint32_t speed);
 
 	extern "C" NANOLIBDLL_API int32_t StartPositioning();
 
 	extern "C" NANOLIBDLL_API int32_t SetProfileAcceleration(uint32_t acc);
 
+	//***WAYPOINTS***
+
+	//appends count targets (absRel 1: relative to the previous target), velocities holds the profile velocity of each move or is NULL
+	//a job sends each target as soon as the drive has a free set point buffer, the moves blend into each other without stopping
+	//jobId is the job feeding the targets, it succeeds once the queue is empty and the last target reached
+	extern "C" NANOLIBDLL_API int32_t QueueTargets(const int32_t * positions, const uint32_t * velocities, int32_t count, uint32_t absRel, uint32_t & jobId);
+
+	//drops the targets not sent yet, the drive still runs to the ones it has
+	extern "C" NANOLIBDLL_API int32_t ClearWaypoints();
+
+	//depth of the queue, targets sent and acknowledged by the drive, time waited in the queue and time to the acknowledge in ms
+	extern "C" NANOLIBDLL_API int32_t GetWaypointQueueStats(uint32_t & depth, uint32_t & maxDepth, uint64_t & sent, uint64_t & acknowledged,
+		double& meanQueueMs, double& maxQueueMs, double& meanAcknowledgeMs, double& maxAcknowledgeMs, double& lastAcknowledgeMs, uint32_t & running);
+
+
+	//***JOBS***
+
+	//long operations return a job id at once, see PollJob and WaitJob
+	extern "C" NANOLIBDLL_API int32_t StartSaveMotorParametersAsync(uint32_t & jobId);
+
+	extern "C" NANOLIBDLL_API int32_t StartSaveUserUnitsAsync(uint32_t & jobId);
+
+	extern "C" NANOLIBDLL_API int32_t StartAutoSetupMotPamsAsync(uint32_t & jobId);
+
+	extern "C" NANOLIBDLL_API int32_t StartHomeAsync(uint32_t speedZero, uint32_t speedSwitch, uint32_t & jobId);
+
+	//progress 0..100, state 0 queued, 1 running, 2 succeeded, 3 failed, 4 cancelled, 5 timed out
+	extern "C" NANOLIBDLL_API int32_t PollJob(uint32_t jobId, int32_t & progress, int32_t & state);
+
+	//EXIT_SUCCESS if the job succeeded within timeoutMs
+	extern "C" NANOLIBDLL_API int32_t WaitJob(uint32_t jobId, uint32_t timeoutMs);
+
+	extern "C" NANOLIBDLL_API int32_t CancelJob(uint32_t jobId);
+
+	//***WAITING***
+
+	//EXIT_SUCCESS once statusword bit 10 (target reached) is set within timeoutMs
+	extern "C" NANOLIBDLL_API int32_t WaitTargetReached(uint32_t timeoutMs);
+
+	//kind 0 save, 1 auto setup, 2 homing, 3 target reached, 4 set point acknowledge, 5 set point buffer free,
+	//6 last target of QueueTargets reached
+	//the poll interval starts at minIntervalMs and grows by growth up to maxIntervalMs
+	extern "C" NANOLIBDLL_API int32_t SetWaitPolicy(int32_t kind, uint32_t minIntervalMs, uint32_t maxIntervalMs, uint32_t deadlineMs, double growth);
+
+	//histogram bucket i counts completions below 2^i ms, the last bucket everything above
+	extern "C" NANOLIBDLL_API int32_t GetWaitStats(int32_t kind, uint64_t & completed, uint64_t & failed, uint64_t & timedOut, uint64_t & cancelled, uint64_t & polls,
+		double & avgMs, double & minMs, double & maxMs, uint64_t * histogram, int32_t histogramSize);
+
+	//***BUS OPTIONS***
+
+	//name and value as in bus_hw_options_defaults.hpp (e.g. "serial baud rate", "115200"), used by the following OpenPort
+	//an empty or NULL value restores the default
+	extern "C" NANOLIBDLL_API int32_t SetBusOption(const char* name, const char* value);
+
+	//options OpenPort would use for port (index of GetPorts)
+	extern "C" NANOLIBDLL_API int32_t GetBusOptionsLV(uint32_t port, LStrArrayHdl * names, LStrArrayHdl * values);
+
+	//tries every baud rate (and parity) of a closed port and measures roundTrips SDO reads with each, runs as a job (see PollJob)
+	//nodeId 0 scans for a device with every setting, which is a lot slower than probing a known node id
+	//applyRecommended keeps the fastest setting without errors for the following OpenPort
+	extern "C" NANOLIBDLL_API int32_t StartBusProbeAsync(uint32_t port, uint32_t nodeId, uint32_t roundTrips, uint32_t applyRecommended, uint32_t & jobId);
+
+	//one element per setting tried so far, recommended is the index of the fastest stable one, -1 if none (yet)
+	//roundTripsPerSecond has room for maxResults values
+	extern "C" NANOLIBDLL_API int32_t GetBusProbeResultsLV(LStrArrayHdl * labels, LVuint32ArrayHdl * devices, LVuint32ArrayHdl * errors,
+		double* roundTripsPerSecond, int32_t maxResults, int32_t & recommended);
+
+	//***SESSION***
+
+	//opens the bus and connects the devices of the last session (saved on every connect) without listing ports or scanning
+	//loadMs, openMs and connectMs are the time of reading the profile, opening the bus and connecting all axes
+	//an axis that fails to connect does not stop the others, the call fails and DrainErrorsLV has an error per failed axis
+	extern "C" NANOLIBDLL_API int32_t OpenLastSession(double& loadMs, double& openMs, double& connectMs);
+
+	//file of the session profile, empty or NULL for %LOCALAPPDATA%\NanoLibDLL\last_session.bin
+	extern "C" NANOLIBDLL_API int32_t SetSessionProfilePath(const char* path);
+
+	//***DISCOVERY***
+
+	//scans all buses at the same time, a bus is the index of GetPorts, a device the index for ConnectDevice after OpenPort of its bus
+	//reading the serial numbers connects every device once
+	extern "C" NANOLIBDLL_API int32_t StartDiscovery(uint32_t readSerialNumbers);
+
+	extern "C" NANOLIBDLL_API int32_t CancelDiscovery();
+
+	extern "C" NANOLIBDLL_API int32_t GetDiscoveryState(LVBoolean * running, uint32_t & busesTotal, uint32_t & busesDone);
+
+	//type 0 started (text bus name), 1 progress (value), 2 found (value node id, text description), 3 finished (value device count), 4 failed (text error)
+	extern "C" NANOLIBDLL_API int32_t ReadDiscoveryEventLV(LVBoolean * available, int32_t & type, uint32_t & bus, int32_t & value, LStrHandle * text);
+
+	//one element per device of all buses, empty serial numbers could not be read
+	extern "C" NANOLIBDLL_API int32_t GetDiscoveredDevicesLV(LVuint32ArrayHdl * buses, LVuint32ArrayHdl * indices, LVuint32ArrayHdl * nodeIds,
+		LStrArrayHdl * descriptions, LStrArrayHdl * serialNumbers);
+
+	//***AXES***
+
+	//connects device deviceToOpen of the last scan as axis (0..31), the selected axis stays the same
+	extern "C" NANOLIBDLL_API int32_t ConnectAxis(uint32_t axis, uint32_t deviceToOpen);
+
+	//connects devicesToOpen[i] as axis i, the bus is scanned once for all of them
+	extern "C" NANOLIBDLL_API int32_t ConnectAxes(const uint32_t * devicesToOpen, int32_t count);
+
+	//axis the exports without axis parameter work on, 0 after loading the DLL
+	extern "C" NANOLIBDLL_API int32_t SelectAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t GetSelectedAxis(uint32_t & axis);
+
+	extern "C" NANOLIBDLL_API int32_t GetConnectedAxesLV(LVuint32ArrayHdl * axes);
+
+	//***OnAxis: same as the export without OnAxis, for the given axis instead of the selected one
+
+	extern "C" NANOLIBDLL_API int32_t GetErrorStackOnAxisLV(uint32_t axis, LStrArrayHdl * LVAllocatedStrArray);
+
+	extern "C" NANOLIBDLL_API int32_t GetModeOfOperationOnAxisLV(uint32_t axis, LStrHandle * LVAllocatedStr);
+
+	extern "C" NANOLIBDLL_API int32_t GetCiA402StateOnAxisLV(uint32_t axis, LStrHandle * state, LVBoolean * fault, LVBoolean * voltageEnabled, LVBoolean * quickStop, LVBoolean * warning, LVBoolean * targetReached, LVBoolean * limitReached, LVBoolean * bit12, LVBoolean * bit13);
+
+	extern "C" NANOLIBDLL_API int32_t ResyncControlWordOnAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t GetControlWordStatsOnAxis(uint32_t axis, uint64_t & reads, uint64_t & writes, uint64_t & readsAvoided);
+
+	extern "C" NANOLIBDLL_API int32_t GetConnectionStatsOnAxis(uint32_t axis, uint64_t & checksAvoided, uint64_t & checksQueried, uint64_t & probes, uint64_t & transportErrors);
+
+	extern "C" NANOLIBDLL_API int32_t StartTelemetryOnAxis(uint32_t axis, uint16_t periodMs);
+
+	extern "C" NANOLIBDLL_API int32_t StartTelemetryObjectsOnAxis(uint32_t axis, const uint32_t * objects, int32_t count, uint16_t periodMs);
+
+	extern "C" NANOLIBDLL_API int32_t StartCyclicPositionOnAxis(uint32_t axis, uint32_t periodUs);
+
+	extern "C" NANOLIBDLL_API int32_t StopCyclicPositionOnAxis(uint32_t axis);
+
+	//every axis has a set point buffer of its own
+	extern "C" NANOLIBDLL_API int32_t PushSetpointsOnAxis(uint32_t axis, const int32_t * setpoints, int32_t count, uint32_t last, int32_t & accepted, int32_t & free);
+
+	extern "C" NANOLIBDLL_API int32_t GetSetpointFeederStatsOnAxis(uint32_t axis, uint64_t & cycles, uint64_t & written, uint64_t & underruns, uint64_t & lateWrites, uint64_t & skippedCycles,
+		double& meanJitterUs, double& maxJitterUs, double& meanWriteUs, double& maxWriteUs, uint32_t & buffered, uint32_t & running);
+
+	extern "C" NANOLIBDLL_API int32_t GetFollowingErrorOnAxis(uint32_t axis, int32_t & followingError);
+
+	extern "C" NANOLIBDLL_API int32_t StartInterpolatedPositionOnAxis(uint32_t axis, uint32_t periodUs);
+
+	extern "C" NANOLIBDLL_API int32_t StopInterpolatedPositionOnAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t UploadTrajectoryOnAxis(uint32_t axis, const int32_t * positions, int32_t count, uint32_t timeBaseUs);
+
+	extern "C" NANOLIBDLL_API int32_t GetSetpointBufferStatsOnAxis(uint32_t axis, uint32_t & buffered, uint32_t & capacity, uint32_t & driveBuffered, uint32_t & lead, double& setpointsPerSecond);
+
+	extern "C" NANOLIBDLL_API int32_t RebootDeviceOnAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t GetUserUnitsOnAxis(uint32_t axis, uint32_t & feed, uint32_t & shaftRevs, uint32_t & posUnit, uint32_t & posExp, uint32_t & velUnit, uint32_t & velExp, uint32_t & velTime, uint32_t & gearRatioMotorRevs, uint32_t & gearRatioShaftRevs);
+
+	extern "C" NANOLIBDLL_API int32_t SetUserUnitsOnAxis(uint32_t axis, uint32_t feed, uint32_t shaftRevs, uint32_t posUnit, uint32_t posExp, uint32_t velUnit, uint32_t velExp, uint32_t velTime, uint32_t gearRatioMotorRevs, uint32_t gearRatioShaftRevs);
+
+	extern "C" NANOLIBDLL_API int32_t ConnectDeviceOfScanOnAxis(uint32_t axis, uint32_t generation, uint32_t deviceToOpen);
+
+	extern "C" NANOLIBDLL_API int32_t FindDeviceOnAxis(uint32_t axis, uint32_t nodeId, const char* serialNumber, uint32_t & nodeIdFound);
+
+	extern "C" NANOLIBDLL_API int32_t DisconnectDeviceOnAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t GetFirmwareVersionOnAxisLV(uint32_t axis, LStrHandle * LVAllocatedStr);
+
+	extern "C" NANOLIBDLL_API int32_t HaltOnAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t QuickStopOnAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t AutoSetupMotPamsOnAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t SetMotorParametersOnAxis(uint32_t axis, uint32_t polePairCount, uint32_t ratedCurrent, uint32_t maxCurrent, uint32_t maxCurrentDuration, uint32_t idleCurrent, uint32_t driveMode);
+
+	extern "C" NANOLIBDLL_API int32_t GetMotorParametersOnAxis(uint32_t axis, uint32_t & polePairCount, uint32_t & ratedCurrent, uint32_t & maxCurrent, uint32_t & maxCurrentDuration, uint32_t & idleCurrent, uint32_t & driveMode);
+
+	extern "C" NANOLIBDLL_API int32_t GetPositioningParametersOnAxis(uint32_t axis, uint32_t & profileVelocity, int32_t & setTarget);
+
+	extern "C" NANOLIBDLL_API int32_t SaveMotorParametersOnAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t SaveUserUnitsOnAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t GetPositionActualOnAxis(uint32_t axis, int32_t & pos);
+
+	extern "C" NANOLIBDLL_API int32_t SetHomingAccelerationOnAxis(uint32_t axis, uint32_t acc);
+
+	extern "C" NANOLIBDLL_API int32_t HomeOnAxis(uint32_t axis, uint32_t speedZero, uint32_t speedSwitch);
+
+	extern "C" NANOLIBDLL_API int32_t StartVelocityOnAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t SetVelocityPamsOnAxis(uint32_t axis, int16_t vel, uint32_t deltaSpeedAcc, uint16_t deltaTimeAcc, uint32_t deltaSpeedDec, uint16_t deltaTimeDec);
+
+	extern "C" NANOLIBDLL_API int32_t GetVelocityPamsOnAxis(uint32_t axis, int16_t & vel, uint32_t & deltaSpeedAcc, uint16_t & deltaTimeAcc, uint32_t & deltaSpeedDec, uint16_t & deltaTimeDec);
+
+	extern "C" NANOLIBDLL_API int32_t GetVelocityStatusOnAxis(uint32_t axis, int16_t & demandedSpeed, int16_t & speedActual);
+
+	extern "C" NANOLIBDLL_API int32_t SetTargetPositionOnAxis(uint32_t axis, int32_t position, uint32_t absRel);
+
+	extern "C" NANOLIBDLL_API int32_t SetProfileVelocityOnAxis(uint32_t axis, uint32_t speed);
+
+	extern "C" NANOLIBDLL_API int32_t StartPositioningOnAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t SetProfileAccelerationOnAxis(uint32_t axis, uint32_t acc);
+
+	extern "C" NANOLIBDLL_API int32_t QueueTargetsOnAxis(uint32_t axis, const int32_t * positions, const uint32_t * velocities, int32_t count, uint32_t absRel, uint32_t & jobId);
+
+	extern "C" NANOLIBDLL_API int32_t ClearWaypointsOnAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t GetWaypointQueueStatsOnAxis(uint32_t axis, uint32_t & depth, uint32_t & maxDepth, uint64_t & sent, uint64_t & acknowledged,
+		double& meanQueueMs, double& maxQueueMs, double& meanAcknowledgeMs, double& maxAcknowledgeMs, double& lastAcknowledgeMs, uint32_t & running);
+
+	extern "C" NANOLIBDLL_API int32_t StartSaveMotorParametersAsyncOnAxis(uint32_t axis, uint32_t & jobId);
+
+	extern "C" NANOLIBDLL_API int32_t StartSaveUserUnitsAsyncOnAxis(uint32_t axis, uint32_t & jobId);
+
+	extern "C" NANOLIBDLL_API int32_t StartAutoSetupMotPamsAsyncOnAxis(uint32_t axis, uint32_t & jobId);
+
+	extern "C" NANOLIBDLL_API int32_t StartHomeAsyncOnAxis(uint32_t axis, uint32_t speedZero, uint32_t speedSwitch, uint32_t & jobId);
+
+	extern "C" NANOLIBDLL_API int32_t PostTargetVelocityOnAxis(uint32_t axis, int16_t vel);
+
+	extern "C" NANOLIBDLL_API int32_t StartProfileTorqueOnAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t SetProfileTorquePamsOnAxis(uint32_t axis, int16_t torque, uint32_t slope, uint16_t maxTorque);
+
+	extern "C" NANOLIBDLL_API int32_t SetTargetTorqueOnAxis(uint32_t axis, int16_t torque);
+
+	extern "C" NANOLIBDLL_API int32_t GetProfileTorquePamsOnAxis(uint32_t axis, int16_t & torque, uint32_t & slope, uint16_t & maxTorque);
+
+	extern "C" NANOLIBDLL_API int32_t GetTorqueStatusOnAxis(uint32_t axis, int16_t & torqueActual, int16_t & currentActual);
+
+	extern "C" NANOLIBDLL_API int32_t PostTargetTorqueOnAxis(uint32_t axis, int16_t torque);
+
+	extern "C" NANOLIBDLL_API int32_t StartProfileVelocityOnAxis(uint32_t axis);
+
+	extern "C" NANOLIBDLL_API int32_t SetProfileVelocityPamsOnAxis(uint32_t axis, int32_t vel, uint32_t acc, uint32_t dec);
+
+	extern "C" NANOLIBDLL_API int32_t SetTargetProfileVelocityOnAxis(uint32_t axis, int32_t vel);
+
+	extern "C" NANOLIBDLL_API int32_t GetProfileVelocityPamsOnAxis(uint32_t axis, int32_t & vel, uint32_t & acc, uint32_t & dec);
+
+	extern "C" NANOLIBDLL_API int32_t GetProfileVelocityStatusOnAxis(uint32_t axis, int32_t & demandedVel, int32_t & velActual);
+
+	extern "C" NANOLIBDLL_API int32_t PostTargetProfileVelocityOnAxis(uint32_t axis, int32_t vel);
+
+	extern "C" NANOLIBDLL_API int32_t PostTargetPositionOnAxis(uint32_t axis, int32_t position, uint32_t absRel);
+
+	extern "C" NANOLIBDLL_API int32_t WaitTargetReachedOnAxis(uint32_t axis, uint32_t timeoutMs);
+
 }
\ No newline at end of file
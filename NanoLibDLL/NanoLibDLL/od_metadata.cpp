@@ -0,0 +1,235 @@
+#include "od_metadata.h"
+
+#include <array>
+#include <limits>
+
+namespace {
+
+	using Type = nlc::ObjectEntryDataType;
+	using Access = nlc::ObjectSdoAccessAttribute;
+
+	struct BuiltinObject {
+		uint16_t index;
+		uint8_t subIndex;
+		Type dataType;
+		Access access;
+	};
+
+	//objects of the C5-E used by this library, see the C5-E technical manual
+	constexpr std::array<BuiltinObject, 73> kC5EObjects{ {
+		//error register and predefined error field
+		{0x1001, 0x00, Type::Unsigned8, Access::ReadOnly},
+		{0x1003, 0x00, Type::Unsigned8, Access::ReadWrite},
+		//store parameters
+		{0x1010, 0x01, Type::Unsigned32, Access::ReadWrite},
+		{0x1010, 0x02, Type::Unsigned32, Access::ReadWrite},
+		{0x1010, 0x03, Type::Unsigned32, Access::ReadWrite},
+		{0x1010, 0x04, Type::Unsigned32, Access::ReadWrite},
+		{0x1010, 0x05, Type::Unsigned32, Access::ReadWrite},
+		{0x1010, 0x06, Type::Unsigned32, Access::ReadWrite},
+		{0x1010, 0x07, Type::Unsigned32, Access::ReadWrite},
+		{0x1010, 0x08, Type::Unsigned32, Access::ReadWrite},
+		{0x1010, 0x09, Type::Unsigned32, Access::ReadWrite},
+		{0x1010, 0x0A, Type::Unsigned32, Access::ReadWrite},
+		{0x1010, 0x0B, Type::Unsigned32, Access::ReadWrite},
+		{0x1010, 0x0C, Type::Unsigned32, Access::ReadWrite},
+		{0x1010, 0x0D, Type::Unsigned32, Access::ReadWrite},
+		//motor
+		{0x2030, 0x00, Type::Unsigned32, Access::ReadWrite},
+		{0x2031, 0x00, Type::Unsigned32, Access::ReadWrite},
+		{0x2037, 0x00, Type::Unsigned32, Access::ReadWrite},
+		{0x203B, 0x01, Type::Unsigned32, Access::ReadWrite},
+		{0x203B, 0x02, Type::Unsigned32, Access::ReadWrite},
+		{0x3202, 0x00, Type::Unsigned32, Access::ReadWrite},
+		//digital inputs control
+		{0x3240, 0x01, Type::Unsigned32, Access::ReadWrite},
+		{0x3240, 0x02, Type::Unsigned32, Access::ReadWrite},
+		{0x3240, 0x03, Type::Unsigned32, Access::ReadWrite},
+		{0x3240, 0x04, Type::Unsigned32, Access::ReadWrite},
+		{0x3240, 0x05, Type::Unsigned32, Access::ReadOnly},
+		{0x3240, 0x06, Type::Unsigned32, Access::ReadWrite},
+		//limit switch error option code
+		{0x3701, 0x00, Type::Integer16, Access::ReadWrite},
+		//CiA 402
+		{0x6040, 0x00, Type::Unsigned16, Access::ReadWrite},
+		{0x6041, 0x00, Type::Unsigned16, Access::ReadOnly},
+		{0x6042, 0x00, Type::Integer16, Access::ReadWrite},
+		{0x6043, 0x00, Type::Integer16, Access::ReadOnly},
+		{0x6044, 0x00, Type::Integer16, Access::ReadOnly},
+		{0x6048, 0x01, Type::Unsigned32, Access::ReadWrite},
+		{0x6048, 0x02, Type::Unsigned16, Access::ReadWrite},
+		{0x6049, 0x01, Type::Unsigned32, Access::ReadWrite},
+		{0x6049, 0x02, Type::Unsigned16, Access::ReadWrite},
+		{0x605A, 0x00, Type::Integer16, Access::ReadWrite},
+		{0x605D, 0x00, Type::Integer16, Access::ReadWrite},
+		{0x6060, 0x00, Type::Integer8, Access::ReadWrite},
+		{0x6061, 0x00, Type::Integer8, Access::ReadOnly},
+		{0x6062, 0x00, Type::Integer32, Access::ReadOnly},
+		{0x6064, 0x00, Type::Integer32, Access::ReadOnly},
+		{0x606B, 0x00, Type::Integer32, Access::ReadOnly},
+		{0x606C, 0x00, Type::Integer32, Access::ReadOnly},
+		{0x6071, 0x00, Type::Integer16, Access::ReadWrite},
+		{0x6072, 0x00, Type::Unsigned16, Access::ReadWrite},
+		{0x6077, 0x00, Type::Integer16, Access::ReadOnly},
+		{0x6078, 0x00, Type::Integer16, Access::ReadOnly},
+		{0x607A, 0x00, Type::Integer32, Access::ReadWrite},
+		{0x6080, 0x00, Type::Unsigned32, Access::ReadWrite},
+		{0x6081, 0x00, Type::Unsigned32, Access::ReadWrite},
+		{0x6083, 0x00, Type::Unsigned32, Access::ReadWrite},
+		{0x6084, 0x00, Type::Unsigned32, Access::ReadWrite},
+		{0x6087, 0x00, Type::Unsigned32, Access::ReadWrite},
+		{0x6091, 0x01, Type::Unsigned32, Access::ReadWrite},
+		{0x6091, 0x02, Type::Unsigned32, Access::ReadWrite},
+		{0x6092, 0x01, Type::Unsigned32, Access::ReadWrite},
+		{0x6092, 0x02, Type::Unsigned32, Access::ReadWrite},
+		{0x6098, 0x00, Type::Integer8, Access::ReadWrite},
+		{0x6099, 0x01, Type::Unsigned32, Access::ReadWrite},
+		{0x6099, 0x02, Type::Unsigned32, Access::ReadWrite},
+		{0x609A, 0x00, Type::Unsigned32, Access::ReadWrite},
+		{0x60A8, 0x00, Type::Unsigned32, Access::ReadWrite},
+		{0x60A9, 0x00, Type::Unsigned32, Access::ReadWrite},
+		{0x60C1, 0x01, Type::Integer32, Access::ReadWrite},
+		{0x60C2, 0x01, Type::Unsigned8, Access::ReadWrite},
+		{0x60C2, 0x02, Type::Integer8, Access::ReadWrite},
+		//interpolation data configuration, maximum buffer size and buffer position (records held by a FIFO buffer)
+		{0x60C4, 0x01, Type::Unsigned32, Access::ReadOnly},
+		{0x60C4, 0x04, Type::Unsigned16, Access::ReadWrite},
+		{0x60F4, 0x00, Type::Integer32, Access::ReadOnly},
+		{0x60FD, 0x00, Type::Unsigned32, Access::ReadOnly},
+		{0x60FF, 0x00, Type::Integer32, Access::ReadWrite},
+	} };
+}
+
+bool OdMetadata::IsSigned() const {
+	switch (dataType) {
+	case Type::Integer8:
+	case Type::Integer16:
+	case Type::Integer24:
+	case Type::Integer32:
+	case Type::Integer40:
+	case Type::Integer48:
+	case Type::Integer56:
+	case Type::Integer64:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool OdMetadata::IsReadable() const {
+	return access == Access::ReadOnly || access == Access::ReadWrite;
+}
+
+bool OdMetadata::IsWritable() const {
+	return access == Access::WriteOnly || access == Access::ReadWrite;
+}
+
+bool OdMetadata::IsInteger() const {
+	switch (dataType) {
+	case Type::Boolean:
+	case Type::Real32:
+	case Type::Real64:
+		return false;
+	default:
+		return bitLength > 0;
+	}
+}
+
+int64_t OdMetadata::Min() const {
+	if (!IsInteger() || !IsSigned())
+		return 0;
+	if (bitLength >= 64)
+		return std::numeric_limits<int64_t>::min();
+	return -(int64_t(1) << (bitLength - 1));
+}
+
+int64_t OdMetadata::Max() const {
+	if (dataType == Type::Boolean)
+		return 1;
+	if (!IsInteger())
+		return 0;
+	if (bitLength >= 64)
+		return std::numeric_limits<int64_t>::max();
+	if (IsSigned())
+		return (int64_t(1) << (bitLength - 1)) - 1;
+	return (int64_t(1) << bitLength) - 1;
+}
+
+int64_t OdMetadata::SignExtend(int64_t raw) const {
+	if (!IsSigned() || bitLength == 0 || bitLength >= 64)
+		return raw;
+	const int shift = 64 - bitLength;
+	return static_cast<int64_t>(static_cast<uint64_t>(raw) << shift) >> shift;
+}
+
+OdMetadataCache::OdMetadataCache() {
+	entries_.reserve(kC5EObjects.size());
+	for (const BuiltinObject& o : kC5EObjects)
+		Insert(nlc::OdIndex(o.index, o.subIndex), OdMetadata{ o.dataType, BitLength(o.dataType), o.access });
+}
+
+size_t OdMetadataCache::Refine(nlc::ObjectDictionary& od) {
+	size_t found = 0;
+	//the interface can't list its objects, every index of the communication, manufacturer and profile areas is looked up
+	for (uint32_t index = kFirstIndex; index <= kLastIndex; index++) {
+		const nlc::ResultObjectEntry result = od.getObjectEntry(static_cast<uint16_t>(index));
+		if (result.hasError())
+			continue;
+		// getSubEntry only looks up the entry, it is not const in the interface
+		nlc::ObjectEntry& entry = const_cast<nlc::ObjectEntry&>(result.getResult());
+		for (uint32_t subIndex = 0; subIndex <= entry.getMaxSubIndex(); subIndex++) {
+			const nlc::ObjectSubEntry& subEntry = entry.getSubEntry(static_cast<uint8_t>(subIndex));
+			//strings and domains are not read or written as numbers
+			if (BitLength(subEntry.getDataType()) == 0 || subEntry.getBitLength() == 0 || subEntry.getBitLength() > 64)
+				continue;
+			//objects of the table that the dictionary has are replaced, the others added
+			Insert(nlc::OdIndex(static_cast<uint16_t>(index), static_cast<uint8_t>(subIndex)),
+				OdMetadata{ subEntry.getDataType(), static_cast<uint8_t>(subEntry.getBitLength()), subEntry.getSdoAccess() });
+			found++;
+		}
+	}
+	return found;
+}
+
+const OdMetadata* OdMetadataCache::Find(const nlc::OdIndex& odIndex) const {
+	auto it = entries_.find(Key(odIndex.getIndex(), odIndex.getSubIndex()));
+	return it == entries_.end() ? nullptr : &it->second;
+}
+
+void OdMetadataCache::Insert(const nlc::OdIndex& odIndex, const OdMetadata& metadata) {
+	entries_[Key(odIndex.getIndex(), odIndex.getSubIndex())] = metadata;
+}
+
+uint8_t OdMetadataCache::BitLength(nlc::ObjectEntryDataType dataType) {
+	switch (dataType) {
+	case Type::Boolean:
+	case Type::Integer8:
+	case Type::Unsigned8:
+		return 8;
+	case Type::Integer16:
+	case Type::Unsigned16:
+		return 16;
+	case Type::Integer24:
+	case Type::Unsigned24:
+		return 24;
+	case Type::Integer32:
+	case Type::Unsigned32:
+	case Type::Real32:
+		return 32;
+	case Type::Integer40:
+	case Type::Unsigned40:
+		return 40;
+	case Type::Integer48:
+	case Type::Unsigned48:
+		return 48;
+	case Type::Integer56:
+	case Type::Unsigned56:
+		return 56;
+	case Type::Integer64:
+	case Type::Unsigned64:
+	case Type::Real64:
+		return 64;
+	default:
+		return 0;
+	}
+}
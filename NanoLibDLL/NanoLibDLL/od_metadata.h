@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "od_index.hpp"
+#include "od_types.hpp"
+#include "object_dictionary.hpp"
+
+/*
+Data type, bit length and SDO access of an object.
+*/
+struct OdMetadata {
+	nlc::ObjectEntryDataType dataType = nlc::ObjectEntryDataType::Invalid;
+	uint8_t bitLength = 0;
+	nlc::ObjectSdoAccessAttribute access = nlc::ObjectSdoAccessAttribute::NoAccess;
+
+	bool IsSigned() const;
+	bool IsInteger() const;
+	bool IsReadable() const;
+	bool IsWritable() const;
+	//value range of the integer and boolean types, Min() == Max() == 0 for everything else
+	int64_t Min() const;
+	int64_t Max() const;
+	//the raw value of readNumber with the sign of the data type restored
+	int64_t SignExtend(int64_t raw) const;
+};
+
+/*
+Metadata of the objects of one device, looked up by index and sub-index.
+Starts with a built-in table of the C5-E objects used by this library and takes
+over the objects of an object dictionary assigned to the device when there is one.
+*/
+class OdMetadataCache {
+public:
+
+	//fills the cache with the built-in C5-E table
+	OdMetadataCache();
+
+	//takes over type, length and access of every number object of od, adding the ones missing in the table
+	//returns the number of objects taken from od
+	size_t Refine(nlc::ObjectDictionary& od);
+
+	//nullptr if the object is unknown
+	const OdMetadata* Find(const nlc::OdIndex& odIndex) const;
+
+	void Insert(const nlc::OdIndex& odIndex, const OdMetadata& metadata);
+
+	size_t Size() const { return entries_.size(); }
+
+	//bit length written for a data type, 0 for types that are not numbers
+	static uint8_t BitLength(nlc::ObjectEntryDataType dataType);
+
+private:
+
+	//indices looked up by Refine, from the communication profile to the end of the device profiles
+	static constexpr uint32_t kFirstIndex = 0x1000;
+	static constexpr uint32_t kLastIndex = 0x9FFF;
+
+	static constexpr uint32_t Key(uint16_t index, uint8_t subIndex) {
+		return (static_cast<uint32_t>(index) << 8) | subIndex;
+	}
+
+	std::unordered_map<uint32_t, OdMetadata> entries_;
+};
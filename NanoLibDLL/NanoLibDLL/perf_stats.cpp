@@ -0,0 +1,255 @@
+#include "perf_stats.h"
+
+#include <algorithm>
+#include <bit>
+#include <format>
+
+//depth of nested calls and transfers done on this thread, calls take the difference
+static thread_local uint32_t callDepth = 0;
+static thread_local uint64_t sdoCount = 0;
+
+static void UpdateMax(std::atomic<uint64_t>& max, uint64_t value) {
+	uint64_t current = max.load(std::memory_order_relaxed);
+	while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+	}
+}
+
+PerfStats::Call::Call(PerfStats& stats, const char* name) :
+	stats_(nullptr),
+	name_(name),
+	sdosAtStart_(0)
+{
+	if (callDepth++ > 0 || !stats.IsEnabled())
+		return;
+	stats_ = &stats;
+	sdosAtStart_ = sdoCount;
+	start_ = std::chrono::steady_clock::now();
+}
+
+PerfStats::Call::~Call() {
+	callDepth--;
+	if (stats_ == nullptr)
+		return;
+	const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+	const uint64_t sdos = sdoCount - sdosAtStart_;
+	stats_->Record(stats_->FindSite(reinterpret_cast<uintptr_t>(name_), name_), ns, sdos);
+	stats_->RecordSlow(name_, ns, sdos);
+}
+
+PerfStats::Sdo::Sdo(PerfStats* stats, bool write, const nlc::OdIndex& odIndex) :
+	stats_(nullptr),
+	key_(0)
+{
+	if (stats == nullptr || !stats->IsEnabled())
+		return;
+	stats_ = stats;
+	key_ = kSdoKey | (uint64_t(write) << 24) | (uint64_t(odIndex.getIndex()) << 8) | odIndex.getSubIndex();
+	start_ = std::chrono::steady_clock::now();
+}
+
+PerfStats::Sdo::~Sdo() {
+	if (stats_ == nullptr)
+		return;
+	const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+	sdoCount++;
+	stats_->Record(stats_->FindSite(key_, nullptr), ns, 0);
+}
+
+PerfStats::PerfStats() :
+	enabled_(false),
+	overflow_(0),
+	slowFloorNs_(0)
+{
+}
+
+void PerfStats::Reset() {
+	//slots stay assigned, only the numbers start over
+	for (Site& site : sites_) {
+		site.calls = 0;
+		site.sdos = 0;
+		site.sumNs = 0;
+		site.maxNs = 0;
+		for (std::atomic<uint32_t>& bucket : site.buckets)
+			bucket.store(0, std::memory_order_relaxed);
+	}
+	overflow_ = 0;
+
+	std::lock_guard<std::mutex> lock(slowMutex_);
+	slowest_.clear();
+	slowFloorNs_ = 0;
+}
+
+size_t PerfStats::Bucket(uint64_t us) {
+	if (us < (uint64_t(1) << kSubBits))
+		return static_cast<size_t>(us);
+	uint32_t exponent = static_cast<uint32_t>(std::bit_width(us)) - 1;
+	if (exponent > kMaxExponent)
+		return kBuckets - 1;
+	const uint64_t sub = (us >> (exponent - kSubBits)) & ((uint64_t(1) << kSubBits) - 1);
+	return static_cast<size_t>(((exponent - kSubBits + 1) << kSubBits) + sub);
+}
+
+uint64_t PerfStats::BucketStart(size_t bucket) {
+	if (bucket < (size_t(1) << kSubBits))
+		return bucket;
+	const uint32_t exponent = static_cast<uint32_t>(bucket >> kSubBits) + kSubBits - 1;
+	const uint64_t sub = bucket & ((size_t(1) << kSubBits) - 1);
+	return ((uint64_t(1) << kSubBits) + sub) << (exponent - kSubBits);
+}
+
+PerfStats::Site* PerfStats::FindSite(uint64_t key, const char* name) {
+	//open addressing, a slot once taken keeps its key
+	size_t i = static_cast<size_t>((key ^ (key >> 17)) * 0x9E3779B97F4A7C15ull >> 32) % kMaxSites;
+	for (size_t probes = 0; probes < kMaxSites; probes++, i = (i + 1) % kMaxSites) {
+		Site& site = sites_[i];
+		uint64_t current = site.key.load(std::memory_order_acquire);
+		if (current == 0) {
+			//the name is set before the key is published
+			if (site.key.compare_exchange_strong(current, kSdoKey - 1, std::memory_order_acquire)) {
+				site.name = name;
+				site.key.store(key, std::memory_order_release);
+				return &site;
+			}
+		}
+		//another thread is claiming the slot
+		while (current == kSdoKey - 1)
+			current = site.key.load(std::memory_order_acquire);
+		if (current == key)
+			return &site;
+	}
+	overflow_.fetch_add(1, std::memory_order_relaxed);
+	return nullptr;
+}
+
+void PerfStats::Record(Site* site, uint64_t ns, uint64_t sdos) {
+	if (site == nullptr)
+		return;
+	site->calls.fetch_add(1, std::memory_order_relaxed);
+	site->sdos.fetch_add(sdos, std::memory_order_relaxed);
+	site->sumNs.fetch_add(ns, std::memory_order_relaxed);
+	UpdateMax(site->maxNs, ns);
+	site->buckets[Bucket(ns / 1000)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfStats::RecordSlow(const char* name, uint64_t ns, uint64_t sdos) {
+	if (ns <= slowFloorNs_.load(std::memory_order_relaxed))
+		return;
+
+	SlowCall call;
+	call.name = SiteName(name);
+	call.us = static_cast<double>(ns) / 1000.0;
+	call.sdos = static_cast<uint32_t>(sdos);
+	call.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+	std::lock_guard<std::mutex> lock(slowMutex_);
+	auto pos = std::find_if(slowest_.begin(), slowest_.end(), [&call](const SlowCall& other) { return other.us < call.us; });
+	slowest_.insert(pos, std::move(call));
+	if (slowest_.size() > kSlowest)
+		slowest_.pop_back();
+	if (slowest_.size() == kSlowest)
+		slowFloorNs_.store(static_cast<uint64_t>(slowest_.back().us * 1000.0), std::memory_order_relaxed);
+}
+
+std::string PerfStats::SiteName(const char* functionName) {
+	//"int __cdecl NanoLibWrapper::StartPositioning(void)" -> "StartPositioning"
+	std::string name(functionName);
+	//a lambda inside the export ends in "::<lambda_1>::operator ()"
+	name = name.substr(0, name.find_first_of("(<"));
+	name = name.substr(0, name.find_last_not_of(':') + 1);
+	const size_t start = name.find_last_of(": ");
+	return start == std::string::npos ? name : name.substr(start + 1);
+}
+
+std::vector<PerfStats::SiteStats> PerfStats::GetSites() const {
+	std::vector<SiteStats> calls;
+	std::vector<SiteStats> transfers;
+	std::vector<uint64_t> callsNs;
+	std::vector<uint64_t> transfersNs;
+
+	for (const Site& site : sites_) {
+		const uint64_t key = site.key.load(std::memory_order_acquire);
+		if (key == 0 || key == kSdoKey - 1)
+			continue;
+
+		std::array<uint32_t, kBuckets> buckets;
+		uint64_t count = 0;
+		for (size_t i = 0; i < kBuckets; i++) {
+			buckets[i] = site.buckets[i].load(std::memory_order_relaxed);
+			count += buckets[i];
+		}
+		if (count == 0)
+			continue;
+
+		SiteStats stats;
+		if (key & kSdoKey)
+			stats.name = std::format("{} 0x{:04X}:{:02X}", (key >> 24) & 1 ? "write" : "read", (key >> 8) & 0xFFFF, key & 0xFF);
+		else
+			stats.name = SiteName(site.name);
+		stats.calls = site.calls.load(std::memory_order_relaxed);
+		stats.sdos = site.sdos.load(std::memory_order_relaxed);
+		const uint64_t sumNs = site.sumNs.load(std::memory_order_relaxed);
+		if (stats.calls > 0)
+			stats.meanUs = static_cast<double>(sumNs) / 1000.0 / static_cast<double>(stats.calls);
+		stats.maxUs = static_cast<double>(site.maxNs.load(std::memory_order_relaxed)) / 1000.0;
+
+		//percentiles from the lower end of the bucket they fall into
+		uint64_t seen = 0;
+		bool p50 = false;
+		for (size_t i = 0; i < kBuckets; i++) {
+			seen += buckets[i];
+			if (!p50 && seen * 2 >= count) {
+				stats.p50Us = static_cast<double>(BucketStart(i));
+				p50 = true;
+			}
+			if (seen * 100 >= count * 99) {
+				stats.p99Us = static_cast<double>(BucketStart(i));
+				break;
+			}
+		}
+
+		if (key & kSdoKey) {
+			transfers.push_back(stats);
+			transfersNs.push_back(sumNs);
+		}
+		else {
+			calls.push_back(stats);
+			callsNs.push_back(sumNs);
+		}
+	}
+
+	auto byTotal = [](std::vector<SiteStats>& sites, const std::vector<uint64_t>& totals) {
+		std::vector<size_t> order(sites.size());
+		for (size_t i = 0; i < order.size(); i++)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), [&totals](size_t a, size_t b) { return totals[a] > totals[b]; });
+		std::vector<SiteStats> sorted;
+		for (size_t i : order)
+			sorted.push_back(std::move(sites[i]));
+		return sorted;
+	};
+	std::vector<SiteStats> sites = byTotal(calls, callsNs);
+	for (SiteStats& stats : byTotal(transfers, transfersNs))
+		sites.push_back(std::move(stats));
+	return sites;
+}
+
+std::vector<PerfStats::SlowCall> PerfStats::GetSlowest() const {
+	std::lock_guard<std::mutex> lock(slowMutex_);
+	return slowest_;
+}
+
+std::string PerfStats::Report() const {
+	std::string report = std::format("{:<32} {:>10} {:>8} {:>10} {:>10} {:>10} {:>10}\n", "call", "count", "sdo/call", "mean us", "p50 us", "p99 us", "max us");
+	for (const SiteStats& stats : GetSites()) {
+		const double sdosPerCall = stats.calls > 0 ? static_cast<double>(stats.sdos) / static_cast<double>(stats.calls) : 0.0;
+		report += std::format("{:<32} {:>10} {:>8.1f} {:>10.0f} {:>10.0f} {:>10.0f} {:>10.0f}\n",
+			stats.name, stats.calls, sdosPerCall, stats.meanUs, stats.p50Us, stats.p99Us, stats.maxUs);
+	}
+	if (overflow_ > 0)
+		report += std::format("{} calls not counted, all {} slots taken\n", overflow_.load(), kMaxSites);
+
+	report += std::format("\n{:<32} {:>10} {:>8} {:>14}\n", "slowest", "us", "sdos", "ms since 1970");
+	for (const SlowCall& call : GetSlowest())
+		report += std::format("{:<32} {:>10.0f} {:>8} {:>14}\n", call.name, call.us, call.sdos, call.timeMs);
+	return report;
+}
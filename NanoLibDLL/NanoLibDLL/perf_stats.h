@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "nanolib_helper.hpp"
+
+/*
+Time and SDO count of the exported calls and time of the SDO transfers themselves.
+Every call site and every object read or written gets a slot with a log-linear histogram of atomic counters,
+recording never locks or allocates. Only a call slower than the slowest kept so far takes a lock.
+Disabled it costs one relaxed load per call and per transfer.
+*/
+class PerfStats {
+public:
+
+	static constexpr size_t kMaxSites = 128;
+	static constexpr size_t kSlowest = 16;
+	//8 linear steps per power of two, about 12% resolution
+	static constexpr uint32_t kSubBits = 3;
+	//up to 2^36 us, about 19 hours
+	static constexpr uint32_t kMaxExponent = 36;
+	static constexpr size_t kBuckets = ((kMaxExponent - kSubBits + 1) << kSubBits) + (size_t(1) << kSubBits);
+
+	struct SiteStats {
+		//export name or "read 0x6041:00", "write 0x6040:00"
+		std::string name;
+		uint64_t calls = 0;
+		//SDO transfers of the calls, 0 for the transfers themselves
+		uint64_t sdos = 0;
+		double meanUs = 0.0;
+		double p50Us = 0.0;
+		double p99Us = 0.0;
+		double maxUs = 0.0;
+	};
+
+	struct SlowCall {
+		std::string name;
+		double us = 0.0;
+		uint32_t sdos = 0;
+		//ms since 1970
+		int64_t timeMs = 0;
+	};
+
+	//one exported call, nested calls on the bus thread count for the outermost one
+	class Call {
+	public:
+		Call(PerfStats& stats, const char* name);
+		~Call();
+		Call(const Call&) = delete;
+		void operator=(const Call&) = delete;
+	private:
+		PerfStats* stats_;
+		const char* name_;
+		std::chrono::steady_clock::time_point start_;
+		uint64_t sdosAtStart_;
+	};
+
+	//one SDO transfer, counted for the call running on this thread
+	class Sdo {
+	public:
+		Sdo(PerfStats* stats, bool write, const nlc::OdIndex& odIndex);
+		~Sdo();
+		Sdo(const Sdo&) = delete;
+		void operator=(const Sdo&) = delete;
+	private:
+		PerfStats* stats_;
+		uint64_t key_;
+		std::chrono::steady_clock::time_point start_;
+	};
+
+	PerfStats();
+
+	void SetEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+	bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+	void Reset();
+
+	//calls first, then transfers, each ordered by total time
+	std::vector<SiteStats> GetSites() const;
+	//slowest first
+	std::vector<SlowCall> GetSlowest() const;
+	//both as a table
+	std::string Report() const;
+
+private:
+
+	struct Site {
+		//0 for a free slot, calls use the address of their name, transfers kSdoKey | write << 24 | index << 8 | subIndex
+		std::atomic<uint64_t> key{ 0 };
+		const char* name = nullptr;
+		std::atomic<uint64_t> calls{ 0 };
+		std::atomic<uint64_t> sdos{ 0 };
+		std::atomic<uint64_t> sumNs{ 0 };
+		std::atomic<uint64_t> maxNs{ 0 };
+		std::array<std::atomic<uint32_t>, kBuckets> buckets{};
+	};
+
+	static constexpr uint64_t kSdoKey = uint64_t(1) << 63;
+
+	static size_t Bucket(uint64_t us);
+	//lower end of bucket in us
+	static uint64_t BucketStart(size_t bucket);
+	//function name of a call site without return type, scope and parameters
+	static std::string SiteName(const char* functionName);
+
+	//nullptr if all slots are taken
+	Site* FindSite(uint64_t key, const char* name);
+	void Record(Site* site, uint64_t ns, uint64_t sdos);
+	void RecordSlow(const char* name, uint64_t ns, uint64_t sdos);
+
+	std::atomic<bool> enabled_;
+	std::array<Site, kMaxSites> sites_;
+	//calls that found no free slot
+	std::atomic<uint64_t> overflow_;
+
+	//duration a call needs to enter slowest_ once it is full
+	std::atomic<uint64_t> slowFloorNs_;
+	mutable std::mutex slowMutex_;
+	std::vector<SlowCall> slowest_;
+};
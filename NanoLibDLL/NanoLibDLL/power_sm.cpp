@@ -1,22 +1,31 @@
 #include "power_sm.h"
 #include <format>
 
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
 #include <Windows.h>
+#endif
 #include <iostream>
+#include <sstream>
 #ifndef DBOUT
+#ifdef _WIN32
 #define DBOUT( s )            \
 {                             \
    std::wostringstream os_;    \
    os_ << s;                   \
    OutputDebugStringW( os_.str().c_str() );  \
 }
+#else
+//OutputDebugString only exists on Windows
+#define DBOUT( s )
+#endif
 
 #endif
 
 PowerSM::PowerSM(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle) :
 	nanolibHelper(nanolibHelper),
-	connectedDeviceHandle(connectedDeviceHandle)
+	connectedDeviceHandle(connectedDeviceHandle),
+	controlWord(nanolibHelper, connectedDeviceHandle)
 {};
 
 PowerSM::~PowerSM() {
@@ -130,177 +139,58 @@ int PowerSM::QuickStop() {
 	return EXIT_SUCCESS;
 }
 
-int PowerSM::GetCurrentState(uint8_t& state) {
-	uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper->readInteger(connectedDeviceHandle->value(), nlc::OdIndex(0x6041, 0x00)));
-	//figure out state
-	if (
-		((uWord16 >> 0) & 1U) == 0 &&
-		((uWord16 >> 1) & 1U) == 0 &&
-		((uWord16 >> 2) & 1U) == 0 &&
-		((uWord16 >> 3) & 1U) == 0 &&
-		((uWord16 >> 6) & 1U) == 0
-		)
-	{
-		state = States::NOT_READY_TO_SWITCH_ON;
-	}
-	else if (
-		((uWord16 >> 0) & 1U) == 0 &&
-		((uWord16 >> 1) & 1U) == 0 &&
-		((uWord16 >> 2) & 1U) == 0 &&
-		((uWord16 >> 3) & 1U) == 0 &&
-		((uWord16 >> 6) & 1U) == 1
-		)
-	{
-		state = States::SWITCHED_ON_DISABLED;
-	}
-	else if (
-		((uWord16 >> 0) & 1U) == 1 &&
-		((uWord16 >> 1) & 1U) == 0 &&
-		((uWord16 >> 2) & 1U) == 0 &&
-		((uWord16 >> 3) & 1U) == 0 &&
-		((uWord16 >> 5) & 1U) == 1 &&
-		((uWord16 >> 6) & 1U) == 0
-		)
-	{
-		state = States::READY_TO_SWITCH_ON;
-	}
-	else if (
-		((uWord16 >> 0) & 1U) == 1 &&
-		((uWord16 >> 1) & 1U) == 1 &&
-		((uWord16 >> 2) & 1U) == 0 &&
-		((uWord16 >> 3) & 1U) == 0 &&
-		((uWord16 >> 5) & 1U) == 1 &&
-		((uWord16 >> 6) & 1U) == 0
-		)
-	{
-		state = States::SWITCHED_ON;
-	}
-	else if (
-		((uWord16 >> 0) & 1U) == 1 &&
-		((uWord16 >> 1) & 1U) == 1 &&
-		((uWord16 >> 2) & 1U) == 1 &&
-		((uWord16 >> 3) & 1U) == 0 &&
-		((uWord16 >> 5) & 1U) == 1 &&
-		((uWord16 >> 6) & 1U) == 0
-		)
-	{
-		state = States::OPERATION_ENABLED;
-	}
-	else if (
-		((uWord16 >> 0) & 1U) == 1 &&
-		((uWord16 >> 1) & 1U) == 1 &&
-		((uWord16 >> 2) & 1U) == 1 &&
-		((uWord16 >> 3) & 1U) == 0 &&
-		((uWord16 >> 5) & 1U) == 0 &&
-		((uWord16 >> 6) & 1U) == 0
-		)
-	{
-		state = States::QUICK_STOP_ACTIVE;
-	}
-	else if (
-		((uWord16 >> 0) & 1U) == 1 &&
-		((uWord16 >> 1) & 1U) == 1 &&
-		((uWord16 >> 2) & 1U) == 1 &&
-		((uWord16 >> 3) & 1U) == 1 &&
-		((uWord16 >> 6) & 1U) == 0
-		)
-	{
-		state = States::FAULT_REACTION_ACTIVE;
-	}
-	else if (
-		((uWord16 >> 0) & 1U) == 0 &&
-		((uWord16 >> 1) & 1U) == 0 &&
-		((uWord16 >> 2) & 1U) == 0 &&
-		((uWord16 >> 3) & 1U) == 1 &&
-		((uWord16 >> 6) & 1U) == 0
-		)
-	{
-		state = States::FAULT;
-	}
-	else {
+int PowerSM::GetStatusWord(StatusWord& statusWord) {
+	uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper->readValue(connectedDeviceHandle->value(), nlc::OdIndex(0x6041, 0x00)));
+	statusWord = StatusWord::Decode(uWord16);
+	if (statusWord.state < 0) {
 		throw(nanolib_exception("Unknown CIA402 state"));
 		return EXIT_FAILURE;
 	}
+	return EXIT_SUCCESS;
+}
 
+int PowerSM::GetCurrentState(uint8_t& state) {
+	StatusWord statusWord;
+	if (GetStatusWord(statusWord))
+		return EXIT_FAILURE;
+	state = static_cast<uint8_t>(statusWord.state);
 	return EXIT_SUCCESS;
 }
 
 void PowerSM::Shutdown_2_6_8() {
-	uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper->readInteger(connectedDeviceHandle->value(), nlc::OdIndex(0x6040, 0x00)));
-	uWord16 &= ~(1U << 0);
-	uWord16 |= (1U << 1);
-	uWord16 |= (1U << 2);
-	uWord16 &= ~(1U << 7);
-	nanolibHelper->writeInteger(connectedDeviceHandle->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
+	controlWord.Modify((1U << 1) | (1U << 2), (1U << 0) | (1U << 7));
 }
 
 void PowerSM::SwitchOn_3()
 {
-		uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper->readInteger(connectedDeviceHandle->value(), nlc::OdIndex(0x6040, 0x00)));
-		uWord16 |= (1U << 0);
-		uWord16 |= (1U << 1);
-		uWord16 |= (1U << 2);
-		uWord16 &= ~(1U << 3);
-		uWord16 &= ~(1U << 7);
-		nanolibHelper->writeInteger(connectedDeviceHandle->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
+	controlWord.Modify((1U << 0) | (1U << 1) | (1U << 2), (1U << 3) | (1U << 7));
 }
 
 void PowerSM::DisableVoltage_7_10_9_12()
 {
-		uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper->readInteger(connectedDeviceHandle->value(), nlc::OdIndex(0x6040, 0x00)));
-		uWord16 &= ~(1U << 1);
-		uWord16 &= ~(1U << 7);
-		nanolibHelper->writeInteger(connectedDeviceHandle->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
+	controlWord.Modify(0, (1U << 1) | (1U << 7));
 }
 void PowerSM::QuickStop_11(){
-		uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper->readInteger(connectedDeviceHandle->value(), nlc::OdIndex(0x6040, 0x00)));
-		uWord16 |= (1U << 1);
-		uWord16 &= ~(1U << 2);
-		uWord16 &= ~(1U << 7);
-		nanolibHelper->writeInteger(connectedDeviceHandle->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
+	controlWord.Modify((1U << 1), (1U << 2) | (1U << 7));
 }
 
 void PowerSM::DisableOperation_5()
 {
-	uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper->readInteger(connectedDeviceHandle->value(), nlc::OdIndex(0x6040, 0x00)));
-	uWord16 |= (1U << 0);
-	uWord16 |= (1U << 1);
-	uWord16 |= (1U << 2);
-	uWord16 &= ~(1U << 3);
-	uWord16 &= ~(1U << 7);
-	nanolibHelper->writeInteger(connectedDeviceHandle->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
+	controlWord.Modify((1U << 0) | (1U << 1) | (1U << 2), (1U << 3) | (1U << 7));
 }
 
 void PowerSM::EnableOperation_4()
 {
-	uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper->readInteger(connectedDeviceHandle->value(), nlc::OdIndex(0x6040, 0x00)));
-	uWord16 |= (1U << 0);
-	uWord16 |= (1U << 1);
-	uWord16 |= (1U << 2);
-	uWord16 |= (1U << 3);
-	uWord16 &= ~(1U << 7);
-	nanolibHelper->writeInteger(connectedDeviceHandle->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
+	controlWord.Modify((1U << 0) | (1U << 1) | (1U << 2) | (1U << 3), (1U << 7));
 }
 
 void PowerSM::EnableOperationAfterQuickStop_16() {
-	uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper->readInteger(connectedDeviceHandle->value(), nlc::OdIndex(0x6040, 0x00)));
-	uWord16 &= ~(1U << 2);
-	nanolibHelper->writeInteger(connectedDeviceHandle->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
-	uWord16 = static_cast<uint16_t>(nanolibHelper->readInteger(connectedDeviceHandle->value(), nlc::OdIndex(0x6040, 0x00)));
-	uWord16 |= (1U << 0);
-	uWord16 |= (1U << 1);
-	uWord16 |= (1U << 2);
-	uWord16 |= (1U << 3);
-	uWord16 &= ~(1U << 7);
-	nanolibHelper->writeInteger(connectedDeviceHandle->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
+	controlWord.Modify(0, (1U << 2));
+	controlWord.Modify((1U << 0) | (1U << 1) | (1U << 2) | (1U << 3), (1U << 7));
 }
 
 void PowerSM::FaultReset_15()
 {
-	uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper->readInteger(connectedDeviceHandle->value(), nlc::OdIndex(0x6040, 0x00)));
-	if ((uWord16 >> 7) & 1U) {
-		uWord16 &= ~(1U << 7);
-		nanolibHelper->writeInteger(connectedDeviceHandle->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
-	}
-	uWord16 |= 1U << 7;
+	if ((controlWord.Get() >> 7) & 1U)
+		controlWord.Modify(0, (1U << 7));
 }
@@ -1,10 +1,14 @@
 #pragma once
+#include <array>
 #include <cstdint>
 #include "nanolib_helper.hpp"
+#include "control_word.h"
 
 
 //Die Steuerung erreicht nach Einschalten und erfolgreichem Selbsttest den Zustand Switch on disabled.
 
+struct StatusWord;
+
 class PowerSM {
 public:
 
@@ -15,8 +19,13 @@ public:
 	int DisableOperation();
 	int EnableOperation();
 	int GetCurrentState(uint8_t& state);
+	//one read of 6041h, decoded into state and flags
+	int GetStatusWord(StatusWord& statusWord);
 	int QuickStop();
 
+	//shadow of 6040h, shared with the motor classes
+	ControlWord& GetControlWord() { return controlWord; }
+
 	enum States : int8_t
 	{
 		NOT_READY_TO_SWITCH_ON=0,
@@ -34,6 +43,7 @@ private:
 
 	NanoLibHelper* nanolibHelper;
 	std::optional<nlc::DeviceHandle>* connectedDeviceHandle;
+	ControlWord controlWord;
 
 	void Shutdown_2_6_8();
 	void SwitchOn_3();
@@ -50,3 +60,71 @@ private:
 
 };
 
+//statusword 6041h bits 0-3, 5 and 6 packed into a 6 bit table index
+constexpr uint8_t StatusWordStateIndex(uint16_t uWord16) {
+	return static_cast<uint8_t>((uWord16 & 0x0F) | ((uWord16 >> 1) & 0x30));
+}
+
+//state for every combination of the state bits, -1 for combinations not defined by CiA 402
+constexpr std::array<int8_t, 64> kStatusWordStates = [] {
+	struct Pattern { uint8_t mask; uint8_t value; int8_t state; };
+	//mask/value on the packed index: bit 0-3 -> 0x0F, bit 5 -> 0x10, bit 6 -> 0x20
+	constexpr Pattern patterns[] = {
+		{0x2F, 0x00, PowerSM::States::NOT_READY_TO_SWITCH_ON},
+		{0x2F, 0x20, PowerSM::States::SWITCHED_ON_DISABLED},
+		{0x3F, 0x11, PowerSM::States::READY_TO_SWITCH_ON},
+		{0x3F, 0x13, PowerSM::States::SWITCHED_ON},
+		{0x3F, 0x17, PowerSM::States::OPERATION_ENABLED},
+		{0x3F, 0x07, PowerSM::States::QUICK_STOP_ACTIVE},
+		{0x2F, 0x0F, PowerSM::States::FAULT_REACTION_ACTIVE},
+		{0x2F, 0x08, PowerSM::States::FAULT}
+	};
+	std::array<int8_t, 64> table{};
+	for (uint8_t i = 0; i < table.size(); i++) {
+		table[i] = -1;
+		for (const Pattern& p : patterns) {
+			if ((i & p.mask) == p.value) {
+				table[i] = p.state;
+				break;
+			}
+		}
+	}
+	return table;
+}();
+
+//snapshot of the statusword 6041h
+struct StatusWord {
+	uint16_t raw = 0;
+	//PowerSM::States, -1 if unknown
+	int8_t state = -1;
+	bool fault = false;
+	bool voltageEnabled = false;
+	bool quickStop = false;
+	bool warning = false;
+	bool targetReached = false;
+	bool limitReached = false;
+	//mode specific
+	bool bit12 = false;
+	bool bit13 = false;
+
+	static constexpr StatusWord Decode(uint16_t uWord16) {
+		StatusWord sw;
+		sw.raw = uWord16;
+		sw.state = kStatusWordStates[StatusWordStateIndex(uWord16)];
+		sw.fault = uWord16 & (1U << 3);
+		sw.voltageEnabled = uWord16 & (1U << 4);
+		sw.quickStop = uWord16 & (1U << 5);
+		sw.warning = uWord16 & (1U << 7);
+		sw.targetReached = uWord16 & (1U << 10);
+		sw.limitReached = uWord16 & (1U << 11);
+		sw.bit12 = uWord16 & (1U << 12);
+		sw.bit13 = uWord16 & (1U << 13);
+		return sw;
+	}
+};
+
+static_assert(StatusWord::Decode(0x0040).state == PowerSM::States::SWITCHED_ON_DISABLED);
+static_assert(StatusWord::Decode(0x0021).state == PowerSM::States::READY_TO_SWITCH_ON);
+static_assert(StatusWord::Decode(0x0237).state == PowerSM::States::OPERATION_ENABLED);
+static_assert(StatusWord::Decode(0x0007).state == PowerSM::States::QUICK_STOP_ACTIVE);
+static_assert(StatusWord::Decode(0x0008).state == PowerSM::States::FAULT);
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <bitset>connectedDeviceHandle_nanolibHelper_
+#include <array>
+#include <bitset>
 
 #include "motor.h"
 
@@ -9,25 +10,21 @@
 class ProfilePositionMotor : public Motor402 {
 
 public:
-	ProfilePositionMotor(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle, PowerSM *powerSM) :
-		Motor402(nanolibHelper, connectedDeviceHandle,powerSM)
+	ProfilePositionMotor(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle, PowerSM *powerSM, std::optional<int8_t> *activeMode) :
+		Motor402(nanolibHelper, connectedDeviceHandle, powerSM, activeMode)
 	{
-		SetModeOfOperation(OperationMode::ProfilePosition);
+	}
+
+	//switch the drive to this mode, only touches the bus if the mode differs
+	int Activate() {
+		return SetModeOfOperation(OperationMode::ProfilePosition);
 	}
 
 	// Start the motor movement with specified speed
 	int startPositioning() {
 		//go
-		uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6040, 0x00)));
-		//immediate start of new target position
-		uWord16 |= (1U << 5);
-		//reset halt bit
-		uWord16 &= ~(1U << 8);
-		//set start bit
-		uWord16 |= (1U << 4);
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
-		uWord16 = static_cast<uint16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6040, 0x00)));
-		//set start bit
+		//immediate start of new target position (bit 5), set start bit (bit 4), reset halt bit (bit 8)
+		controlWord_->Modify((1U << 5) | (1U << 4), (1U << 8));
 
 		//power sm to ready tp switch on
 		if (powerSM_->EnableOperation())
@@ -36,53 +33,81 @@ public:
 		return EXIT_SUCCESS;
 	}
 
+	//buffered set points (bit 5 clear) with change on set point (bit 9): a target sent while a move runs
+	//is taken when the drive passes the current one, without stopping there
+	int startWaypoints() {
+		//no new set point yet (bit 4), reset halt bit (bit 8)
+		controlWord_->Modify((1U << 9), (1U << 8) | (1U << 5) | (1U << 4));
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), 2, nlc::OdIndex(0x3701, 0x00));
+
+		if (powerSM_->EnableOperation())
+			return EXIT_FAILURE;
+
+		return EXIT_SUCCESS;
+	}
+
+	//hands a target to the drive, acknowledged by 6041h bit 12 (isSetPointAcknowledged)
+	void sendWaypoint(int32_t value, bool relative) {
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), value, nlc::OdIndex(0x607A, 0x00));
+		//new set point on the rising edge of bit 4
+		controlWord_->Modify((1U << 4) | (relative ? (1U << 6) : 0), relative ? 0 : (1U << 6));
+	}
+
+	//after the acknowledge, the next target needs a new rising edge
+	void releaseWaypoint() {
+		controlWord_->Modify(0, (1U << 4));
+	}
+
+	//bit 12 is set while the drive acknowledges a set point and stays set while one is buffered
+	bool isSetPointAcknowledged() {
+		StatusWord statusWord;
+		powerSM_->GetStatusWord(statusWord);
+		return statusWord.bit12;
+	}
+
 	int Halt() override {
-		uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6040, 0x00)));
 		//set halt bit
-		uWord16 |= (1U << 8);
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
+		controlWord_->Modify((1U << 8), 0);
 		return EXIT_SUCCESS;
 	}
 
 
 	void setTargetPosition(int32_t value, uint32_t absRel) {
 
-		uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6040, 0x00)));
 		//interprate target as absolute/relative target position
+		//and reset "new setpoint" bit
 		if (absRel == 1)//1:relative
-			uWord16 |= (1U << 6);
+			controlWord_->Modify((1U << 6), (1U << 4));
 		else
-			uWord16 &= ~(1U << 6);
-
-		//reset "new setpoint" bit)
-		uWord16 &= ~(1U << 4);
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
+			controlWord_->Modify(0, (1U << 6) | (1U << 4));
 
 		//Limit Switch Error Option Code
 		/*
 		Abbremsen mit quick stop ramp und anschlieendem
 		Zustandswechsel in Switch on disabled
 		*/
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), 2, nlc::OdIndex(0x3701, 0x00), 16);
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), 2, nlc::OdIndex(0x3701, 0x00));
 		//607Ah Target Position
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), value, nlc::OdIndex(0x607A, 0x00), 32);
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), value, nlc::OdIndex(0x607A, 0x00));
 
 	}
 
 	void setProfileVelocity(uint32_t speed) {
 		//set target position
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), speed, nlc::OdIndex(0x6081, 0x00), 32);
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), speed, nlc::OdIndex(0x6081, 0x00));
 		return;
 	}
 
 	void getPositioningParameters(uint32_t& profileVelocity, int32_t& targetPosition) {
-		profileVelocity = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6081, 0x00)));
-		targetPosition = static_cast<int32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x607A, 0x00)));
+		const std::array<nlc::OdIndex, 2> odIndices{ { nlc::OdIndex(0x6081, 0x00), nlc::OdIndex(0x607A, 0x00) } };
+		std::vector<int64_t> values = nanolibHelper_->readMany(connectedDeviceHandle_->value(), odIndices);
+		profileVelocity = static_cast<uint32_t>(values[0]);
+		targetPosition = static_cast<int32_t>(values[1]);
 	}
 
 	void setProfileAcceleration(uint32_t acc) {
 		//set profile acceleration
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), acc, nlc::OdIndex(0x6083, 0x00), 32);
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), acc, nlc::OdIndex(0x6083, 0x00));
 		return;
 	}
 
@@ -91,7 +116,7 @@ public:
 		if (powerSM_->DisableOperation())
 			return EXIT_FAILURE;
 
-		uint32_t val = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x60A8, 0x00)));
+		uint32_t val = static_cast<uint32_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x60A8, 0x00)));
 
 		uint32_t unit = (posUnit << 16);
 		uint32_t exp = (posExp << 24);
@@ -101,13 +126,13 @@ public:
 		//set
 		val = ((val |= unit) |= exp);
 
-		nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), val, nlc::OdIndex(0x60A8, 0x00), 32);
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), val, nlc::OdIndex(0x60A8, 0x00));
 
 		return EXIT_SUCCESS;
 	}
 
 	void getUserUnitsPositioning(uint32_t &unit, uint32_t &exp) {
-		uint32_t val = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x60A8, 0x00)));
+		uint32_t val = static_cast<uint32_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x60A8, 0x00)));
 		exp = (val >> 24) & 0xff;
 		unit = (val >> 16) & 0xff;
 	}
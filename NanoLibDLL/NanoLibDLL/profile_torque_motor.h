@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+
+#include "motor.h"
+
+/* Motor in Profile Torque Mode
+ torques are in per mille of the rated torque (6076h), currents in per mille of the rated current (6075h)
+ special function: Bit 8 in 6040h halt, the torque ramps down to 0 with the torque slope
+*/
+class ProfileTorqueMotor : public Motor402 {
+
+public:
+	ProfileTorqueMotor(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle, PowerSM *powerSM, std::optional<int8_t> *activeMode) :
+		Motor402(nanolibHelper, connectedDeviceHandle, powerSM, activeMode)
+	{
+	}
+
+	//switch the drive to this mode, only touches the bus if the mode differs
+	int Activate() {
+		return SetModeOfOperation(OperationMode::ProfileTorque);
+	}
+
+	// Start applying the target torque
+	int startProfileTorque() {
+		//Limit Switch Error Option Code, quick stop ramp and switch on disabled
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), 2, nlc::OdIndex(0x3701, 0x00));
+
+		//reset halt bit
+		controlWord_->Modify(0, (1U << 8));
+
+		//power sm to operation enabled, the drive ramps to 6071h from now on
+		if (powerSM_->EnableOperation())
+			return EXIT_FAILURE;
+
+		return EXIT_SUCCESS;
+	}
+
+	void setTargetTorque(int16_t torque) {
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), torque, nlc::OdIndex(0x6071, 0x00));
+	}
+
+	//change of torque per second
+	void setTorqueSlope(uint32_t slope) {
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), slope, nlc::OdIndex(0x6087, 0x00));
+	}
+
+	//limits the torque in both directions
+	void setMaxTorque(uint16_t maxTorque) {
+		nanolibHelper_->writeValue(connectedDeviceHandle_->value(), maxTorque, nlc::OdIndex(0x6072, 0x00));
+	}
+
+	void getProfileTorqueParameters(int16_t& targetTorque, uint32_t& slope, uint16_t& maxTorque) {
+		const std::array<nlc::OdIndex, 3> odIndices{ { nlc::OdIndex(0x6071, 0x00), nlc::OdIndex(0x6087, 0x00), nlc::OdIndex(0x6072, 0x00) } };
+		std::vector<int64_t> values = nanolibHelper_->readMany(connectedDeviceHandle_->value(), odIndices);
+		targetTorque = static_cast<int16_t>(values[0]);
+		slope = static_cast<uint32_t>(values[1]);
+		maxTorque = static_cast<uint16_t>(values[2]);
+	}
+
+	void getTorqueStatus(int16_t& torqueActual, int16_t& currentActual) {
+		const std::array<nlc::OdIndex, 2> odIndices{ { nlc::OdIndex(0x6077, 0x00), nlc::OdIndex(0x6078, 0x00) } };
+		std::vector<int64_t> values = nanolibHelper_->readMany(connectedDeviceHandle_->value(), odIndices);
+		torqueActual = static_cast<int16_t>(values[0]);
+		currentActual = static_cast<int16_t>(values[1]);
+	}
+
+private:
+
+	uint16_t getState() {
+		return EXIT_SUCCESS;
+	}
+
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include "motor.h"
 
 /* Motor in ProfileVelocity Mode
@@ -8,10 +10,14 @@
 class ProfileVelocityMotor : public Motor402 {
 
 public:
-    ProfileVelocityMotor(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle, PowerSM *powerSM) :
-        Motor402(nanolibHelper, connectedDeviceHandle, powerSM)
+    ProfileVelocityMotor(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle, PowerSM *powerSM, std::optional<int8_t> *activeMode) :
+        Motor402(nanolibHelper, connectedDeviceHandle, powerSM, activeMode)
     {
-        SetModeOfOperation(OperationMode::ProfileVelocity);
+    }
+
+    //switch the drive to this mode, only touches the bus if the mode differs
+    int Activate() {
+        return SetModeOfOperation(OperationMode::ProfileVelocity);
     }
 
     // Start the motor movement with specified speed
@@ -22,12 +28,10 @@ public:
         Abbremsen mit quick stop ramp und anschlieendem
         Zustandswechsel in Switch on disabled
         */
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), 2, nlc::OdIndex(0x3701, 0x00), 16);
+        nanolibHelper_->writeValue(connectedDeviceHandle_->value(), 2, nlc::OdIndex(0x3701, 0x00));
 
-        uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6040, 0x00)));
         //reset halt bit
-        uWord16 &= ~(1U << 8);
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
+        controlWord_->Modify(0, (1U << 8));
 
         //power sm to ready tp switch on
         if (powerSM_->EnableOperation())
@@ -36,52 +40,44 @@ public:
         return EXIT_SUCCESS;
     }
 
-    //velocity in user defined units
-    void setTargetProfileVelocity(int16_t vel) {
-        // target velocity in user units
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), vel, nlc::OdIndex(0x6042, 0x00), 16);
-    }
-
-    void getTargetProfileVelocity(int16_t& vel) {
-        // target velocity in user units
-        vel = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6042, 0x00)));
-    }
-
-    void setProfileVelocityAcceleration(uint32_t deltaSpeed, uint16_t deltaTime) {
-        // target velocity in user units
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), deltaSpeed, nlc::OdIndex(0x6048, 0x01), 16);
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), deltaTime, nlc::OdIndex(0x6048, 0x02), 16);
+    //velocity in user defined units, 60FFh; 6042h and the 6048h/6049h ramps belong to velocity mode
+    void setTargetProfileVelocity(int32_t vel) {
+        nanolibHelper_->writeValue(connectedDeviceHandle_->value(), vel, nlc::OdIndex(0x60FF, 0x00));
     }
 
-    void getProfileVelocityAcceleration(uint32_t& deltaSpeed, uint16_t& deltaTime) {
-        // target velocity in user units
-        deltaSpeed = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6048, 0x01)));
-        deltaTime = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6048, 0x02)));
+    void getTargetProfileVelocity(int32_t& vel) {
+        vel = static_cast<int32_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x60FF, 0x00)));
     }
 
-    void setProfileVelocityDeceleration(uint32_t deltaSpeed, uint16_t deltaTime) {
-        // target velocity in user units
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), deltaSpeed, nlc::OdIndex(0x6049, 0x01), 16);
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), deltaTime, nlc::OdIndex(0x6049, 0x02), 16);
+    //profile acceleration 6083h, shared with profile position
+    void setProfileVelocityAcceleration(uint32_t acc) {
+        nanolibHelper_->writeValue(connectedDeviceHandle_->value(), acc, nlc::OdIndex(0x6083, 0x00));
     }
 
-    void getProfileVelocityDeceleration(uint32_t& deltaSpeed, uint16_t& deltaTime) {
-        // target velocity in user units
-        deltaSpeed = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6049, 0x01)));
-        deltaTime = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6049, 0x02)));
+    //profile deceleration 6084h, also the ramp of halt
+    void setProfileVelocityDeceleration(uint32_t dec) {
+        nanolibHelper_->writeValue(connectedDeviceHandle_->value(), dec, nlc::OdIndex(0x6084, 0x00));
     }
 
-    void getProfileVelocityDemanded(int16_t& demandedVel) {
-        demandedVel = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6043, 0x00)));
+    void getProfileVelocityParameters(int32_t& vel, uint32_t& acc, uint32_t& dec) {
+        const std::array<nlc::OdIndex, 3> odIndices{ { nlc::OdIndex(0x60FF, 0x00), nlc::OdIndex(0x6083, 0x00), nlc::OdIndex(0x6084, 0x00) } };
+        std::vector<int64_t> values = nanolibHelper_->readMany(connectedDeviceHandle_->value(), odIndices);
+        vel = static_cast<int32_t>(values[0]);
+        acc = static_cast<uint32_t>(values[1]);
+        dec = static_cast<uint32_t>(values[2]);
     }
 
-    void getProfileVelocityActual(int16_t& velActual) {
-        velActual = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6044, 0x00)));
+    //velocity demand 606Bh and velocity actual 606Ch
+    void getProfileVelocityStatus(int32_t& demandedVel, int32_t& velActual) {
+        const std::array<nlc::OdIndex, 2> odIndices{ { nlc::OdIndex(0x606B, 0x00), nlc::OdIndex(0x606C, 0x00) } };
+        std::vector<int64_t> values = nanolibHelper_->readMany(connectedDeviceHandle_->value(), odIndices);
+        demandedVel = static_cast<int32_t>(values[0]);
+        velActual = static_cast<int32_t>(values[1]);
     }
 
     void getUserUnitsProfileVelocity(uint32_t& unit, uint32_t& exp, uint32_t& time) {
 
-        uint32_t val = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x60A9, 0x00)));
+        uint32_t val = static_cast<uint32_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x60A9, 0x00)));
 
         exp = (val >> 24) & 0xff;
         unit = (val >> 16) & 0xff;
@@ -94,7 +90,7 @@ public:
         if (powerSM_->DisableOperation())
             return EXIT_FAILURE;
 
-        uint32_t val = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x60A9, 0x00)));
+        uint32_t val = static_cast<uint32_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x60A9, 0x00)));
 
 
         uint32_t time = (velTime << 8);
@@ -106,7 +102,7 @@ public:
         //set
         val = (((val |= exp) |= unit) |= time);
 
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), val, nlc::OdIndex(0x60A9, 0x00), 32);
+        nanolibHelper_->writeValue(connectedDeviceHandle_->value(), val, nlc::OdIndex(0x60A9, 0x00));
 
         return EXIT_SUCCESS;
     }
@@ -0,0 +1,36 @@
+#include "scan_cache.h"
+
+uint32_t ScanCache::Store(const nlc::BusHardwareId& busHwId, std::vector<nlc::DeviceId> devices) {
+	Entry& entry = entries_[Key(busHwId)];
+	entry.devices = std::move(devices);
+	entry.generation = ++generation_;
+	entry.scanned = std::chrono::steady_clock::now();
+	return entry.generation;
+}
+
+const ScanCache::Entry* ScanCache::Find(const nlc::BusHardwareId& busHwId) const {
+	auto it = entries_.find(Key(busHwId));
+	return it == entries_.end() ? nullptr : &it->second;
+}
+
+void ScanCache::StoreIdentity(const nlc::BusHardwareId& busHwId, uint32_t deviceId, const DeviceIdentity& identity) {
+	auto it = entries_.find(Key(busHwId));
+	if (it != entries_.end())
+		it->second.identities[deviceId] = identity;
+}
+
+void ScanCache::Invalidate(const nlc::BusHardwareId& busHwId) {
+	if (entries_.erase(Key(busHwId)) > 0)
+		generation_++;
+}
+
+void ScanCache::InvalidateAll() {
+	entries_.clear();
+	generation_++;
+}
+
+std::string ScanCache::Key(const nlc::BusHardwareId& busHwId) {
+	//the fields BusHardwareId::equals compares
+	return busHwId.getBusHardware() + '\n' + busHwId.getProtocol() + '\n' +
+		busHwId.getHardwareSpecifier() + '\n' + busHwId.getExtraHardwareSpecifier();
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "device_identity.h"
+#include "nanolib_helper.hpp"
+
+/*
+Devices found by the last scan of each bus hardware.
+A CANopen scan walks all 127 node ids and takes seconds, connecting picks from these lists instead of scanning again.
+Every stored scan and every invalidation starts a new generation,
+an index into a device list only means something together with the generation it was read in.
+*/
+class ScanCache {
+public:
+
+	struct Entry {
+		std::vector<nlc::DeviceId> devices;
+		uint32_t generation = 0;
+		std::chrono::steady_clock::time_point scanned;
+		//identity of the devices connected from the lists of this bus by device id (node id on CANopen),
+		//kept over rescans, a node that answers with another identity is another device
+		std::map<uint32_t, DeviceIdentity> identities;
+	};
+
+	//stores the result of a scan and returns its generation
+	uint32_t Store(const nlc::BusHardwareId& busHwId, std::vector<nlc::DeviceId> devices);
+	//nullptr if busHwId was not scanned since the last invalidation
+	const Entry* Find(const nlc::BusHardwareId& busHwId) const;
+	//ignored if busHwId was not scanned, does not start a new generation
+	void StoreIdentity(const nlc::BusHardwareId& busHwId, uint32_t deviceId, const DeviceIdentity& identity);
+	void Invalidate(const nlc::BusHardwareId& busHwId);
+	void InvalidateAll();
+
+	//generation of the last change of the cache
+	uint32_t GetGeneration() const { return generation_; }
+
+private:
+
+	static std::string Key(const nlc::BusHardwareId& busHwId);
+
+	std::map<std::string, Entry> entries_;
+	uint32_t generation_ = 0;
+};
@@ -0,0 +1,151 @@
+#include "session_profile.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <format>
+#include <string>
+#include <vector>
+
+//file layout, all numbers little endian as written by the machine:
+//magic, version, bus hardware id (5 strings), option count and key/value strings,
+//device count and for each device axis id, node id, description, extra id bytes and extra string id
+static constexpr uint32_t kMagic = 0x50534c4e; //"NLSP"
+static constexpr uint32_t kVersion = 1;
+//anything longer is a corrupted file
+static constexpr uint32_t kMaxLength = 64 * 1024;
+
+static void WriteUint32(std::ofstream& out, uint32_t value) {
+	out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void WriteBytes(std::ofstream& out, const void* data, size_t length) {
+	WriteUint32(out, static_cast<uint32_t>(length));
+	out.write(static_cast<const char*>(data), length);
+}
+
+static void WriteString(std::ofstream& out, const std::string& s) {
+	WriteBytes(out, s.data(), s.size());
+}
+
+static uint32_t ReadUint32(std::ifstream& in) {
+	uint32_t value = 0;
+	in.read(reinterpret_cast<char*>(&value), sizeof(value));
+	if (!in)
+		throw nanolib_exception("session profile is truncated");
+	return value;
+}
+
+template <class T>
+static T ReadBytes(std::ifstream& in) {
+	const uint32_t length = ReadUint32(in);
+	if (length > kMaxLength)
+		throw nanolib_exception("session profile is corrupted");
+	T bytes(length, 0);
+	in.read(reinterpret_cast<char*>(bytes.data()), length);
+	if (!in)
+		throw nanolib_exception("session profile is truncated");
+	return bytes;
+}
+
+static std::string ReadString(std::ifstream& in) {
+	return ReadBytes<std::string>(in);
+}
+
+void SessionProfile::Save(const std::filesystem::path& path) const {
+	std::error_code error;
+	std::filesystem::create_directories(path.parent_path(), error);
+
+	//written next to the profile and renamed, a crash never leaves half a profile behind
+	std::filesystem::path temporary = path;
+	temporary += ".tmp";
+	{
+		std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+		if (!out)
+			throw nanolib_exception(std::format("can't write session profile {}", temporary.string()));
+
+		WriteUint32(out, kMagic);
+		WriteUint32(out, kVersion);
+
+		WriteString(out, busHardwareId.getBusHardware());
+		WriteString(out, busHardwareId.getProtocol());
+		WriteString(out, busHardwareId.getHardwareSpecifier());
+		WriteString(out, busHardwareId.getExtraHardwareSpecifier());
+		WriteString(out, busHardwareId.getName());
+
+		const std::map<std::string, std::string> options = busHardwareOptions.getOptions();
+		WriteUint32(out, static_cast<uint32_t>(options.size()));
+		for (const auto& [key, value] : options) {
+			WriteString(out, key);
+			WriteString(out, value);
+		}
+
+		WriteUint32(out, static_cast<uint32_t>(devices.size()));
+		for (const auto& [axisId, deviceId] : devices) {
+			WriteUint32(out, axisId);
+			WriteUint32(out, deviceId.getDeviceId());
+			WriteString(out, deviceId.getDescription());
+			WriteBytes(out, deviceId.getExtraId().data(), deviceId.getExtraId().size());
+			WriteString(out, deviceId.getExtraStringId());
+		}
+
+		if (!out)
+			throw nanolib_exception(std::format("can't write session profile {}", temporary.string()));
+	}
+
+	std::filesystem::rename(temporary, path, error);
+	if (error)
+		throw nanolib_exception(std::format("can't write session profile {}: {}", path.string(), error.message()));
+}
+
+SessionProfile SessionProfile::Load(const std::filesystem::path& path) {
+	std::ifstream in(path, std::ios::binary);
+	if (!in)
+		throw nanolib_exception(std::format("no session profile {}", path.string()), nlc::NlcErrorCode::ResourceNotFound);
+
+	if (ReadUint32(in) != kMagic || ReadUint32(in) != kVersion)
+		throw nanolib_exception(std::format("{} is no session profile of this version", path.string()));
+
+	SessionProfile profile;
+	const std::string busHardware = ReadString(in);
+	const std::string protocol = ReadString(in);
+	const std::string hardwareSpecifier = ReadString(in);
+	const std::string extraHardwareSpecifier = ReadString(in);
+	const std::string name = ReadString(in);
+	profile.busHardwareId = nlc::BusHardwareId(busHardware, protocol, hardwareSpecifier, extraHardwareSpecifier, name);
+
+	const uint32_t optionCount = ReadUint32(in);
+	for (uint32_t i = 0; i < optionCount; i++) {
+		const std::string key = ReadString(in);
+		const std::string value = ReadString(in);
+		profile.busHardwareOptions.addOption(key, value);
+	}
+
+	const uint32_t deviceCount = ReadUint32(in);
+	for (uint32_t i = 0; i < deviceCount; i++) {
+		const uint32_t axisId = ReadUint32(in);
+		const uint32_t nodeId = ReadUint32(in);
+		const std::string description = ReadString(in);
+		const std::vector<uint8_t> extraId = ReadBytes<std::vector<uint8_t>>(in);
+		const std::string extraStringId = ReadString(in);
+		profile.devices[axisId] = nlc::DeviceId(profile.busHardwareId, nodeId, description, extraId, extraStringId);
+	}
+	return profile;
+}
+
+std::filesystem::path SessionProfile::DefaultPath() {
+	std::filesystem::path directory;
+#ifdef _WIN32
+	char* localAppData = nullptr;
+	size_t length = 0;
+	if (_dupenv_s(&localAppData, &length, "LOCALAPPDATA") == 0 && localAppData != nullptr) {
+		directory = std::filesystem::path(localAppData) / "NanoLibDLL";
+		free(localAppData);
+	}
+#else
+	if (const char* dataHome = std::getenv("XDG_DATA_HOME"); dataHome != nullptr && *dataHome != '\0')
+		directory = std::filesystem::path(dataHome) / "NanoLibDLL";
+	else if (const char* home = std::getenv("HOME"); home != nullptr)
+		directory = std::filesystem::path(home) / ".local" / "share" / "NanoLibDLL";
+#endif
+	return directory / "last_session.bin";
+}
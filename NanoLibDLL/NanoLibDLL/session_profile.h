@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+
+#include "nanolib_helper.hpp"
+
+/*
+Bus hardware, bus options and the device of every axis of the last successful session.
+Stored in a small binary file, so a restarted application can open the bus and connect
+the same devices again without listing the bus hardware and scanning.
+*/
+struct SessionProfile {
+
+	nlc::BusHardwareId busHardwareId;
+	nlc::BusHardwareOptions busHardwareOptions;
+	//device of each connected axis
+	std::map<uint32_t, nlc::DeviceId> devices;
+
+	//the file is replaced as a whole, throws nanolib_exception if it can't be written
+	void Save(const std::filesystem::path& path) const;
+	//throws nanolib_exception if there is no profile or it is not readable
+	static SessionProfile Load(const std::filesystem::path& path);
+
+	//%LOCALAPPDATA%\NanoLibDLL\last_session.bin, the working directory if LOCALAPPDATA is not set
+	//$XDG_DATA_HOME/NanoLibDLL or ~/.local/share/NanoLibDLL outside of Windows
+	static std::filesystem::path DefaultPath();
+};
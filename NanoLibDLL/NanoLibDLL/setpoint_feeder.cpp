@@ -0,0 +1,303 @@
+#include "setpoint_feeder.h"
+
+#include <format>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN             // Exclude rarely-used stuff from Windows headers
+#include <Windows.h>
+#endif
+
+//the last part of each wait is spun, a timer wakes up to about this late
+static constexpr std::chrono::microseconds kSpin(200);
+//a write waiting for the bus thread checks this often whether the feeder was stopped
+static constexpr std::chrono::milliseconds kStopPoll(1);
+
+const nlc::OdIndex SetpointFeeder::kTargetPosition(0x607A, 0x00);
+const nlc::OdIndex SetpointFeeder::kInterpolationData(0x60C1, 0x01);
+const nlc::OdIndex SetpointFeeder::kBufferPosition(0x60C4, 0x04);
+
+static void UpdateMax(std::atomic<uint64_t>& max, uint64_t value) {
+	uint64_t current = max.load(std::memory_order_relaxed);
+	while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+	}
+}
+
+SetpointFeeder::SetpointFeeder(NanoLibHelper* nanolibHelper, BusExecutor* busExecutor) :
+	nanolibHelper_(nanolibHelper),
+	busExecutor_(busExecutor),
+	object_(kTargetPosition),
+	period_(1000),
+	bitLength_(32),
+	lead_(0),
+	ring_(kCapacity),
+	pushed_(0),
+	endAt_(0),
+	cycles_(0),
+	written_(0),
+	underruns_(0),
+	lateWrites_(0),
+	skippedCycles_(0),
+	jitterNsSum_(0),
+	jitterNsMax_(0),
+	writeNsSum_(0),
+	writeNsMax_(0),
+	driveBuffered_(0),
+	firstWriteNs_(0),
+	lastWriteNs_(0),
+	stop_(false),
+	running_(false),
+	timer_(nullptr)
+{
+}
+
+SetpointFeeder::~SetpointFeeder() {
+	//Stop was not called, leave the thread to the unload instead of deadlocking it
+	if (thread_.joinable())
+		thread_.detach();
+}
+
+void SetpointFeeder::Start(const nlc::DeviceHandle& deviceHandle, const nlc::OdIndex& object, uint32_t periodUs, uint32_t lead) {
+	if (periodUs < 250)
+		throw nanolib_exception(std::format("set point cycle of {} us is below 250 us", periodUs), nlc::NlcErrorCode::InvalidArguments);
+
+	Stop();
+
+	//looked up on the calling thread, the metadata cache is not shared with the feeder
+	const OdMetadata& metadata = nanolibHelper_->getObjectMetadata(deviceHandle, object);
+	if (!metadata.IsWritable())
+		throw nanolib_exception(std::format("set points rejected: {} is not writable", object.toString()), nlc::NlcErrorCode::ODInvalidAccess, 0, object);
+	object_ = object;
+	bitLength_ = metadata.bitLength;
+	lead_ = lead;
+
+	ring_.Clear();
+	pushed_ = 0;
+	endAt_ = 0;
+	cycles_ = 0;
+	written_ = 0;
+	underruns_ = 0;
+	lateWrites_ = 0;
+	skippedCycles_ = 0;
+	jitterNsSum_ = 0;
+	jitterNsMax_ = 0;
+	writeNsSum_ = 0;
+	writeNsMax_ = 0;
+	driveBuffered_ = 0;
+	firstWriteNs_ = 0;
+	lastWriteNs_ = 0;
+	{
+		std::lock_guard<std::mutex> lock(errorMutex_);
+		error_.reset();
+	}
+
+	period_ = std::chrono::microseconds(periodUs);
+	deviceHandle_ = deviceHandle;
+	stop_ = false;
+	running_ = true;
+	thread_ = std::thread(&SetpointFeeder::Run, this);
+}
+
+void SetpointFeeder::Stop() {
+	if (!thread_.joinable())
+		return;
+	stop_ = true;
+	thread_.join();
+	deviceHandle_.reset();
+}
+
+size_t SetpointFeeder::Push(const int32_t* setpoints, size_t count, bool last) {
+	size_t pushed = 0;
+	while (pushed < count && ring_.TryPush(setpoints[pushed]))
+		pushed++;
+	pushed_ += pushed;
+	//the end is only known once the whole trajectory is in
+	if (last && pushed == count)
+		endAt_.store(pushed_, std::memory_order_release);
+	else if (pushed > 0)
+		endAt_.store(0, std::memory_order_release);
+	return pushed;
+}
+
+SetpointFeeder::Stats SetpointFeeder::GetStats() const {
+	Stats stats;
+	stats.cycles = cycles_;
+	stats.written = written_;
+	stats.underruns = underruns_;
+	stats.lateWrites = lateWrites_;
+	stats.skippedCycles = skippedCycles_;
+	if (stats.cycles > 0)
+		stats.meanJitterUs = static_cast<double>(jitterNsSum_) / 1000.0 / static_cast<double>(stats.cycles);
+	stats.maxJitterUs = static_cast<double>(jitterNsMax_) / 1000.0;
+	if (stats.written > 0)
+		stats.meanWriteUs = static_cast<double>(writeNsSum_) / 1000.0 / static_cast<double>(stats.written);
+	stats.maxWriteUs = static_cast<double>(writeNsMax_) / 1000.0;
+	stats.buffered = ring_.Size();
+	stats.driveBuffered = driveBuffered_;
+	stats.lead = lead_;
+	const int64_t writingNs = lastWriteNs_ - firstWriteNs_;
+	if (stats.written > 1 && writingNs > 0)
+		stats.setpointsPerSecond = static_cast<double>(stats.written - 1) * 1e9 / static_cast<double>(writingNs);
+	stats.running = running_;
+	return stats;
+}
+
+std::optional<nanolib_exception> SetpointFeeder::TakeError() {
+	std::lock_guard<std::mutex> lock(errorMutex_);
+	std::optional<nanolib_exception> error = std::move(error_);
+	error_.reset();
+	return error;
+}
+
+void SetpointFeeder::WaitUntil(std::chrono::steady_clock::time_point deadline) {
+	const std::chrono::steady_clock::duration left = deadline - std::chrono::steady_clock::now();
+	if (left > kSpin) {
+#ifdef _WIN32
+		if (timer_ != nullptr) {
+			//relative due time in 100 ns units
+			LARGE_INTEGER due;
+			due.QuadPart = -static_cast<LONGLONG>(std::chrono::duration_cast<std::chrono::nanoseconds>(left - kSpin).count() / 100);
+			if (SetWaitableTimer(timer_, &due, 0, nullptr, nullptr, FALSE))
+				WaitForSingleObject(timer_, INFINITE);
+		}
+		else {
+			std::this_thread::sleep_for(left - kSpin);
+		}
+#else
+		std::this_thread::sleep_for(left - kSpin);
+#endif
+	}
+	while (std::chrono::steady_clock::now() < deadline)
+		std::this_thread::yield();
+}
+
+std::optional<int64_t> SetpointFeeder::CallOnBus(std::function<int64_t()> call) {
+	std::shared_ptr<PendingCall> pending = std::make_shared<PendingCall>();
+	busExecutor_->PostUrgent([call = std::move(call), pending] {
+		//held through the call, a feeder that stops meanwhile waits for it
+		std::lock_guard<std::mutex> lock(pending->mutex);
+		if (!pending->cancelled) {
+			try {
+				pending->result = call();
+			}
+			catch (const nanolib_exception& e) {
+				pending->error = e;
+			}
+		}
+		pending->done = true;
+		pending->cv.notify_one();
+		return EXIT_SUCCESS;
+	});
+
+	std::unique_lock<std::mutex> lock(pending->mutex);
+	//Stop on the bus thread joins the feeder, the call cannot run before
+	while (!pending->done && !stop_)
+		pending->cv.wait_for(lock, kStopPoll);
+	if (!pending->done) {
+		pending->cancelled = true;
+		return std::nullopt;
+	}
+	if (pending->error.has_value())
+		throw *pending->error;
+	return pending->result;
+}
+
+void SetpointFeeder::Run() {
+#ifdef _WIN32
+	//the default timer of Windows ticks every 15.6 ms, far too coarse for a cycle of a few ms
+	timer_ = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#endif
+
+	const nlc::DeviceHandle deviceHandle = *deviceHandle_;
+	NanoLibHelper* nanolibHelper = nanolibHelper_;
+	const nlc::OdIndex object = object_;
+	const unsigned int bitLength = bitLength_;
+	//set points in the drive, it takes one per cycle
+	uint32_t inDrive = 0;
+	//an underrun is counted once when the drive runs dry, not for every cycle it stays dry
+	bool starved = true;
+	uint64_t elapsed = 1;
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + period_;
+
+	auto write = [&](int32_t setpoint) {
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		if (!CallOnBus([=] { nanolibHelper->writeInteger(deviceHandle, setpoint, object, bitLength); return int64_t(0); }))
+			return false;
+		const std::chrono::steady_clock::time_point done = std::chrono::steady_clock::now();
+		const uint64_t writeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(done - start).count();
+		writeNsSum_.fetch_add(writeNs, std::memory_order_relaxed);
+		UpdateMax(writeNsMax_, writeNs);
+		const int64_t doneNs = std::chrono::duration_cast<std::chrono::nanoseconds>(done.time_since_epoch()).count();
+		if (firstWriteNs_ == 0)
+			firstWriteNs_ = doneNs;
+		lastWriteNs_ = doneNs;
+		written_.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	};
+
+	while (!stop_) {
+		WaitUntil(deadline);
+		const std::chrono::steady_clock::time_point woke = std::chrono::steady_clock::now();
+		const uint64_t jitterNs = std::chrono::duration_cast<std::chrono::nanoseconds>(woke - deadline).count();
+		jitterNsSum_.fetch_add(jitterNs, std::memory_order_relaxed);
+		UpdateMax(jitterNsMax_, jitterNs);
+		cycles_.fetch_add(1, std::memory_order_relaxed);
+
+		try {
+			if (lead_ > 0) {
+				//a drive with a buffer tells how many records it still holds, the write ahead never overfills it
+				const std::optional<int64_t> buffered = CallOnBus([=] { return nanolibHelper->readInteger(deviceHandle, kBufferPosition); });
+				if (!buffered)
+					break;
+				inDrive = static_cast<uint32_t>(*buffered);
+			}
+			else {
+				//the drive took one set point per cycle since the last one
+				inDrive -= static_cast<uint32_t>(std::min<uint64_t>(inDrive, elapsed));
+			}
+			//up to lead ahead, without lead exactly one per cycle
+			while (inDrive <= lead_ && !stop_) {
+				int32_t setpoint = 0;
+				if (ring_.Consume(1, [&setpoint](const int32_t& value) { setpoint = value; }) == 0)
+					break;
+				if (!write(setpoint))
+					break;
+				inDrive++;
+				starved = false;
+			}
+		}
+		catch (const nanolib_exception& e) {
+			//the controller records it, the drive holds the last set point
+			std::lock_guard<std::mutex> lock(errorMutex_);
+			error_ = e;
+			break;
+		}
+		driveBuffered_ = inDrive;
+		if (inDrive == 0 && !starved) {
+			const uint64_t endAt = endAt_.load(std::memory_order_acquire);
+			if (endAt == 0 || written_ < endAt)
+				underruns_.fetch_add(1, std::memory_order_relaxed);
+			starved = true;
+		}
+
+		deadline += period_;
+		elapsed = 1;
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (now > deadline) {
+			lateWrites_.fetch_add(1, std::memory_order_relaxed);
+			const uint64_t missed = static_cast<uint64_t>((now - deadline) / period_) + 1;
+			skippedCycles_.fetch_add(missed, std::memory_order_relaxed);
+			//stay on the grid, the drive went on taking set points meanwhile, the next cycle refills them
+			deadline += period_ * missed;
+			elapsed += missed;
+		}
+	}
+
+#ifdef _WIN32
+	if (timer_ != nullptr) {
+		CloseHandle(timer_);
+		timer_ = nullptr;
+	}
+#endif
+	running_ = false;
+}
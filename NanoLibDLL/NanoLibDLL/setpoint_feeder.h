@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "bus_executor.h"
+#include "nanolib_helper.hpp"
+#include "spsc_ring.h"
+
+/*
+Streams position set points to one object of one device at a fixed cycle, 607Ah for cyclic synchronous
+position or 60C1h:01 for interpolated position.
+The caller pushes the trajectory in chunks into a preallocated ring buffer, a thread of its own takes the
+set points from there and writes them. The cycle runs on absolute deadlines, so a late cycle does not shift
+the following ones. The drive is assumed to take one set point per cycle; for a drive with a buffer the feeder
+reads its fill level (60C4h:04) every cycle, keeps up to lead set points in it ahead of time and refills what a
+late cycle missed at once.
+The reads and writes run on the urgent queue of the bus thread, NanoLib is never called from two threads at once;
+they wait for the command running there, not for the ones queued.
+*/
+class SetpointFeeder {
+public:
+
+	static constexpr size_t kCapacity = 65536;
+	static const nlc::OdIndex kTargetPosition;
+	static const nlc::OdIndex kInterpolationData;
+	//records in the buffer of the drive for interpolated position
+	static const nlc::OdIndex kBufferPosition;
+
+	struct Stats {
+		//cycles run since Start
+		uint64_t cycles = 0;
+		//set points written to 607Ah
+		uint64_t written = 0;
+		//times the buffer ran empty before the end of the trajectory was pushed
+		uint64_t underruns = 0;
+		//cycles that finished after the next one was due, without lead the cycles missed are skipped
+		uint64_t lateWrites = 0;
+		uint64_t skippedCycles = 0;
+		//wake up after the deadline of a cycle
+		double meanJitterUs = 0.0;
+		double maxJitterUs = 0.0;
+		//duration of one write of the set point, with the wait for the bus thread
+		double meanWriteUs = 0.0;
+		double maxWriteUs = 0.0;
+		//set points not written yet
+		size_t buffered = 0;
+		//set points in the buffer of the drive as of the last cycle, read with lead, counted down one per cycle without
+		uint32_t driveBuffered = 0;
+		uint32_t lead = 0;
+		//set points written per second since the first one
+		double setpointsPerSecond = 0.0;
+		//false once a write failed, see TakeError
+		bool running = false;
+	};
+
+	SetpointFeeder(NanoLibHelper* nanolibHelper, BusExecutor* busExecutor);
+	//joining here would block on the loader lock at DLL unload, without Stop the thread is left to the unload
+	~SetpointFeeder();
+
+	SetpointFeeder(const SetpointFeeder&) = delete;
+	void operator=(const SetpointFeeder&) = delete;
+
+	//starts the cycle with an empty buffer writing to object, stops a feed running before
+	//lead is the number of set points written ahead into the buffer of the drive, 0 for a drive without one;
+	//with lead the drive must report its fill level in 60C4h:04
+	void Start(const nlc::DeviceHandle& deviceHandle, const nlc::OdIndex& object, uint32_t periodUs, uint32_t lead);
+	//may run on the bus thread, a write the feeder waits for there is dropped
+	void Stop();
+	bool IsRunning() const { return deviceHandle_.has_value(); }
+	//object the set points are written to while running
+	const nlc::OdIndex& GetObject() const { return object_; }
+	uint32_t GetPeriodUs() const { return static_cast<uint32_t>(period_.count()); }
+
+	//copies as many set points as fit and returns their number, one thread only
+	//last marks the end of the trajectory, running empty after it is no underrun
+	size_t Push(const int32_t* setpoints, size_t count, bool last);
+	size_t GetFree() const { return ring_.Capacity() - ring_.Size(); }
+
+	Stats GetStats() const;
+	//error of the write that stopped the feed, empty if none, cleared by reading it
+	std::optional<nanolib_exception> TakeError();
+
+private:
+
+	//one call handed to the bus thread, shared with it since the feeder stops waiting once stopped
+	struct PendingCall {
+		std::mutex mutex;
+		std::condition_variable cv;
+		bool done = false;
+		//set by the feeder when it stops waiting, the call is not made anymore
+		bool cancelled = false;
+		int64_t result = 0;
+		std::optional<nanolib_exception> error;
+	};
+
+	//runs call on the bus thread and returns its result, empty if stopped meanwhile, throws what call threw
+	//call must not use the feeder, it may run after the feeder is gone
+	std::optional<int64_t> CallOnBus(std::function<int64_t()> call);
+	void Run();
+	//blocks until deadline, sleeps for most of it and spins the rest
+	void WaitUntil(std::chrono::steady_clock::time_point deadline);
+
+	NanoLibHelper* nanolibHelper_;
+	BusExecutor* busExecutor_;
+	std::optional<nlc::DeviceHandle> deviceHandle_;
+	nlc::OdIndex object_;
+	std::chrono::microseconds period_;
+	unsigned int bitLength_;
+	uint32_t lead_;
+
+	SpscRing<int32_t> ring_;
+	//set points pushed and the count at which the trajectory ends, 0 while it is open
+	uint64_t pushed_;
+	std::atomic<uint64_t> endAt_;
+
+	std::atomic<uint64_t> cycles_;
+	std::atomic<uint64_t> written_;
+	std::atomic<uint64_t> underruns_;
+	std::atomic<uint64_t> lateWrites_;
+	std::atomic<uint64_t> skippedCycles_;
+	std::atomic<uint64_t> jitterNsSum_;
+	std::atomic<uint64_t> jitterNsMax_;
+	std::atomic<uint64_t> writeNsSum_;
+	std::atomic<uint64_t> writeNsMax_;
+	std::atomic<uint32_t> driveBuffered_;
+	//time of the first write, 0 before it
+	std::atomic<int64_t> firstWriteNs_;
+	std::atomic<int64_t> lastWriteNs_;
+
+	std::mutex errorMutex_;
+	std::optional<nanolib_exception> error_;
+
+	std::atomic<bool> stop_;
+	std::atomic<bool> running_;
+	std::thread thread_;
+	//high resolution waitable timer of the feeder thread, nullptr where Windows has none and on other systems
+	void* timer_;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/*
+Single producer single consumer ring buffer with a fixed capacity.
+The storage is allocated in the constructor, push and pop never allocate or lock.
+Exactly one thread may push and exactly one thread may pop.
+*/
+template <class T>
+class SpscRing {
+public:
+
+	//capacity is rounded up to a power of two
+	explicit SpscRing(size_t capacity) :
+		mask_(RoundUp(capacity) - 1),
+		buffer_(mask_ + 1),
+		head_(0),
+		tail_(0)
+	{
+	}
+
+	SpscRing(const SpscRing&) = delete;
+	SpscRing& operator=(const SpscRing&) = delete;
+
+	//producer, false if the ring is full
+	bool TryPush(const T& item) {
+		const size_t head = head_.load(std::memory_order_relaxed);
+		if (head - tail_.load(std::memory_order_acquire) > mask_)
+			return false;
+		buffer_[head & mask_] = item;
+		head_.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	//consumer, calls consume(const T&) for up to maxCount items and returns the number consumed
+	template <class F>
+	size_t Consume(size_t maxCount, F&& consume) {
+		const size_t tail = tail_.load(std::memory_order_relaxed);
+		size_t available = head_.load(std::memory_order_acquire) - tail;
+		if (available > maxCount)
+			available = maxCount;
+		for (size_t i = 0; i < available; i++)
+			consume(buffer_[(tail + i) & mask_]);
+		tail_.store(tail + available, std::memory_order_release);
+		return available;
+	}
+
+	//consumer, drops everything pushed so far
+	void Clear() {
+		tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+	}
+
+	size_t Size() const {
+		return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+	}
+
+	size_t Capacity() const { return mask_ + 1; }
+
+private:
+
+	static size_t RoundUp(size_t capacity) {
+		size_t rounded = 1;
+		while (rounded < capacity)
+			rounded <<= 1;
+		return rounded;
+	}
+
+	const size_t mask_;
+	std::vector<T> buffer_;
+
+	//written by the producer
+	alignas(64) std::atomic<size_t> head_;
+	//written by the consumer
+	alignas(64) std::atomic<size_t> tail_;
+};
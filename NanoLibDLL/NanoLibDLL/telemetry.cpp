@@ -0,0 +1,149 @@
+#include "telemetry.h"
+
+#include <format>
+
+const std::array<nlc::OdIndex, 4> Telemetry::kDefaultObjects{ {
+	nlc::OdIndex(0x6064, 0x00),
+	nlc::OdIndex(0x606C, 0x00),
+	nlc::OdIndex(0x6041, 0x00),
+	nlc::OdIndex(0x6078, 0x00)
+} };
+
+Telemetry::Telemetry(NanoLibHelper* nanolibHelper) :
+	nanolibHelper_(nanolibHelper),
+	channels_(0),
+	ring_(kCapacity),
+	samples_(0),
+	overruns_(0),
+	drops_(0),
+	errors_(0),
+	firstTimeMs_(0),
+	lastTimeMs_(0),
+	firstSampleSeen_(false)
+{
+}
+
+Telemetry::~Telemetry() {
+	try {
+		Stop();
+	}
+	catch (const nanolib_exception&) {
+	}
+}
+
+void Telemetry::Start(const nlc::DeviceHandle& deviceHandle, const std::vector<nlc::OdIndex>& objects, uint16_t periodMs) {
+	if (objects.empty() || objects.size() > kMaxChannels)
+		throw nanolib_exception(std::format("telemetry needs 1 to {} objects", kMaxChannels), nlc::NlcErrorCode::InvalidArguments);
+
+	Stop();
+
+	for (size_t i = 0; i < objects.size(); i++) {
+		try {
+			metadata_[i] = nanolibHelper_->getObjectMetadata(deviceHandle, objects[i]);
+		}
+		catch (const nanolib_exception&) {
+			//unknown objects are passed as read
+			metadata_[i] = OdMetadata();
+		}
+	}
+	channels_ = objects.size();
+
+	ring_.Clear();
+	samples_ = 0;
+	overruns_ = 0;
+	drops_ = 0;
+	errors_ = 0;
+	firstTimeMs_ = 0;
+	lastTimeMs_ = 0;
+	firstSampleSeen_ = false;
+
+	nlc::SamplerConfiguration configuration;
+	configuration.trackedAddresses = objects;
+	configuration.triggerCondition = nlc::SamplerTriggerCondition::TC_TRUE;
+	configuration.triggerValue = 0;
+	configuration.periodMilliseconds = periodMs;
+	//samples per notification
+	configuration.numberOfSamples = 100;
+	configuration.preTriggerNumberOfSamples = 0;
+	configuration.mode = nlc::SamplerMode::Continuous;
+	//continuous sampling is only available in software
+	configuration.forceSoftwareImplementation = true;
+
+	nanolibHelper_->configureSampler(deviceHandle, configuration);
+	nanolibHelper_->startSampler(deviceHandle, this, 0);
+	deviceHandle_ = deviceHandle;
+}
+
+void Telemetry::Stop() {
+	if (!deviceHandle_.has_value())
+		return;
+	nlc::DeviceHandle deviceHandle = *deviceHandle_;
+	deviceHandle_.reset();
+	nanolibHelper_->stopSampler(deviceHandle);
+}
+
+size_t Telemetry::Drain(int64_t* rows, size_t maxRows) {
+	const size_t channels = channels_;
+	return ring_.Consume(maxRows, [&rows, channels](const Sample& sample) {
+		*rows++ = static_cast<int64_t>(sample.timeMs);
+		for (size_t i = 0; i < channels; i++)
+			*rows++ = sample.values[i];
+	});
+}
+
+Telemetry::Stats Telemetry::GetStats() const {
+	Stats stats;
+	stats.samples = samples_;
+	stats.overruns = overruns_;
+	stats.drops = drops_;
+	stats.errors = errors_;
+	const uint64_t span = lastTimeMs_ - firstTimeMs_;
+	const uint64_t received = stats.samples + stats.drops;
+	if (span > 0 && received > 1)
+		stats.sampleRate = static_cast<double>(received - 1) * 1000.0 / static_cast<double>(span);
+	return stats;
+}
+
+void Telemetry::notify(const nlc::ResultVoid& lastError, const nlc::SamplerState samplerState,
+	const std::vector<nlc::SampleData>& sampleDatas, int64_t applicationData) {
+	(void)applicationData;
+
+	if (lastError.hasError() || samplerState == nlc::SamplerState::Failed)
+		errors_++;
+
+	const size_t channels = channels_;
+	if (channels == 0)
+		return;
+
+	bool overrun = false;
+	Sample sample;
+	for (const nlc::SampleData& sampleData : sampleDatas) {
+		//the values of all channels of one sample follow each other
+		const std::vector<nlc::SampledValue>& values = sampleData.sampledValues;
+		const size_t complete = values.size() / channels;
+		drops_ += values.size() % channels != 0 ? 1 : 0;
+
+		for (size_t s = 0; s < complete; s++) {
+			const nlc::SampledValue* first = &values[s * channels];
+			sample.timeMs = first->collectTimeMsec;
+			for (size_t i = 0; i < channels; i++)
+				sample.values[i] = metadata_[i].SignExtend(first[i].value);
+
+			if (!firstSampleSeen_) {
+				firstTimeMs_ = sample.timeMs;
+				firstSampleSeen_ = true;
+			}
+			lastTimeMs_ = sample.timeMs;
+
+			if (ring_.TryPush(sample)) {
+				samples_++;
+			}
+			else {
+				overrun = true;
+				drops_++;
+			}
+		}
+	}
+	if (overrun)
+		overruns_++;
+}
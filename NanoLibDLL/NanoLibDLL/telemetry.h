@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "nanolib_helper.hpp"
+#include "spsc_ring.h"
+
+/*
+Continuous sampling of a set of objects with the NanoLib sampler.
+NanoLib delivers the samples on its own thread through notify, they are pushed into a
+preallocated ring buffer and drained by the caller without blocking.
+*/
+class Telemetry : public nlc::SamplerNotify {
+public:
+
+	static constexpr size_t kMaxChannels = nlc::SamplerConfiguration::MAX_TRACKED_ADDRESSES;
+	static constexpr size_t kCapacity = 4096;
+
+	//position actual, velocity actual, statusword, current actual
+	static const std::array<nlc::OdIndex, 4> kDefaultObjects;
+
+	struct Sample {
+		uint64_t timeMs;
+		std::array<int64_t, kMaxChannels> values;
+	};
+
+	struct Stats {
+		//samples per second, measured from the device timestamps
+		double sampleRate = 0.0;
+		//samples stored in the ring buffer
+		uint64_t samples = 0;
+		//notifications that found the ring buffer full
+		uint64_t overruns = 0;
+		//samples lost, either because the ring buffer was full or the data was incomplete
+		uint64_t drops = 0;
+		//notifications with an error of the sampler
+		uint64_t errors = 0;
+	};
+
+	Telemetry(NanoLibHelper* nanolibHelper);
+	~Telemetry();
+
+	void Start(const nlc::DeviceHandle& deviceHandle, const std::vector<nlc::OdIndex>& objects, uint16_t periodMs);
+	void Stop();
+	bool IsRunning() const { return deviceHandle_.has_value(); }
+	bool IsRunningOn(const nlc::DeviceHandle& deviceHandle) const { return deviceHandle_.has_value() && deviceHandle_->get() == deviceHandle.get(); }
+
+	size_t GetChannelCount() const { return channels_; }
+
+	//copies up to maxRows samples to rows, each row is the timestamp in ms followed by one value per channel
+	size_t Drain(int64_t* rows, size_t maxRows);
+
+	//like Drain, timestamps go to timesMs and the values of each row to values, converted to T
+	template <class T>
+	size_t Drain(double* timesMs, T* values, size_t maxRows) {
+		const size_t channels = channels_;
+		return ring_.Consume(maxRows, [&timesMs, &values, channels](const Sample& sample) {
+			*timesMs++ = static_cast<double>(sample.timeMs);
+			for (size_t i = 0; i < channels; i++)
+				*values++ = static_cast<T>(sample.values[i]);
+		});
+	}
+
+	Stats GetStats() const;
+
+	void notify(const nlc::ResultVoid& lastError, const nlc::SamplerState samplerState,
+		const std::vector<nlc::SampleData>& sampleDatas, int64_t applicationData) override;
+
+private:
+
+	NanoLibHelper* nanolibHelper_;
+	std::optional<nlc::DeviceHandle> deviceHandle_;
+
+	size_t channels_;
+	//to restore the sign of the sampled values
+	std::array<OdMetadata, kMaxChannels> metadata_;
+
+	SpscRing<Sample> ring_;
+
+	std::atomic<uint64_t> samples_;
+	std::atomic<uint64_t> overruns_;
+	std::atomic<uint64_t> drops_;
+	std::atomic<uint64_t> errors_;
+	std::atomic<uint64_t> firstTimeMs_;
+	std::atomic<uint64_t> lastTimeMs_;
+	//only touched by notify and by Start while the sampler is stopped
+	bool firstSampleSeen_;
+};
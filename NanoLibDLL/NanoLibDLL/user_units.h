@@ -1,7 +1,10 @@
 #pragma once
 
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
 #include <string>
 
 namespace  UNITS {
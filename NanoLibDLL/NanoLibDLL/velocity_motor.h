@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include "motor.h"
 
 /* Motor in Velocity Mode
@@ -9,10 +11,14 @@
 class VelocityMotor : public Motor402 {
 
 public:
-    VelocityMotor(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle, PowerSM *powerSM) : 
-        Motor402(nanolibHelper, connectedDeviceHandle,powerSM)
+    VelocityMotor(NanoLibHelper *nanolibHelper, std::optional<nlc::DeviceHandle> *connectedDeviceHandle, PowerSM *powerSM, std::optional<int8_t> *activeMode) :
+        Motor402(nanolibHelper, connectedDeviceHandle, powerSM, activeMode)
     {
-        SetModeOfOperation(OperationMode::Velocity);
+    }
+
+    //switch the drive to this mode, only touches the bus if the mode differs
+    int Activate() {
+        return SetModeOfOperation(OperationMode::Velocity);
     }
 
     // Start the motor movement with specified speed
@@ -23,12 +29,10 @@ public:
         Abbremsen mit quick stop ramp und anschlieendem
         Zustandswechsel in Switch on disabled
         */
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), 2, nlc::OdIndex(0x3701, 0x00), 16);
+        nanolibHelper_->writeValue(connectedDeviceHandle_->value(), 2, nlc::OdIndex(0x3701, 0x00));
 
-        uint16_t uWord16 = static_cast<uint16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6040, 0x00)));
         //reset halt bit
-        uWord16 &= ~(1U << 8);
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), uWord16, nlc::OdIndex(0x6040, 0x00), 16);
+        controlWord_->Modify(0, (1U << 8));
 
         //power sm to ready tp switch on
         if (powerSM_->EnableOperation())
@@ -40,41 +44,45 @@ public:
     //velocity in user defined units
     void SetTargetVelocity(int16_t vel) {
         // target velocity in user units
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), vel, nlc::OdIndex(0x6042, 0x00), 16);
+        nanolibHelper_->writeValue(connectedDeviceHandle_->value(), vel, nlc::OdIndex(0x6042, 0x00));
     }
 
     void GetTargetVelocity(int16_t &vel) {
         // target velocity in user units
-        vel = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6042, 0x00)));
+        vel = static_cast<int16_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x6042, 0x00)));
     }
 
     void SetVelocityAcceleration(uint32_t deltaSpeed, uint16_t deltaTime) {
         // target velocity in user units
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), deltaSpeed, nlc::OdIndex(0x6048, 0x01), 16);
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), deltaTime, nlc::OdIndex(0x6048, 0x02), 16);
+        nanolibHelper_->writeValue(connectedDeviceHandle_->value(), deltaSpeed, nlc::OdIndex(0x6048, 0x01));
+        nanolibHelper_->writeValue(connectedDeviceHandle_->value(), deltaTime, nlc::OdIndex(0x6048, 0x02));
     }
 
     void GetVelocityAcceleration(uint32_t &deltaSpeed, uint16_t &deltaTime) {
         // target velocity in user units
-        deltaSpeed = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6048, 0x01)));
-        deltaTime = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6048, 0x02)));
+        const std::array<nlc::OdIndex, 2> odIndices{ { nlc::OdIndex(0x6048, 0x01), nlc::OdIndex(0x6048, 0x02) } };
+        std::vector<int64_t> values = nanolibHelper_->readMany(connectedDeviceHandle_->value(), odIndices);
+        deltaSpeed = static_cast<uint32_t>(values[0]);
+        deltaTime = static_cast<uint16_t>(values[1]);
     }
 
     void SetVelocityDeceleration(uint32_t deltaSpeed, uint16_t deltaTime) {
         // target velocity in user units
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), deltaSpeed, nlc::OdIndex(0x6049, 0x01), 16);
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), deltaTime, nlc::OdIndex(0x6049, 0x02), 16);
+        nanolibHelper_->writeValue(connectedDeviceHandle_->value(), deltaSpeed, nlc::OdIndex(0x6049, 0x01));
+        nanolibHelper_->writeValue(connectedDeviceHandle_->value(), deltaTime, nlc::OdIndex(0x6049, 0x02));
     }
 
     void GetVelocityDeceleration(uint32_t& deltaSpeed, uint16_t& deltaTime) {
         // target velocity in user units
-        deltaSpeed = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6049, 0x01)));
-        deltaTime = static_cast<int16_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x6049, 0x02)));
+        const std::array<nlc::OdIndex, 2> odIndices{ { nlc::OdIndex(0x6049, 0x01), nlc::OdIndex(0x6049, 0x02) } };
+        std::vector<int64_t> values = nanolibHelper_->readMany(connectedDeviceHandle_->value(), odIndices);
+        deltaSpeed = static_cast<uint32_t>(values[0]);
+        deltaTime = static_cast<uint16_t>(values[1]);
     }
 
     void GetUserUnitsVelocity(uint32_t& unit, uint32_t& exp, uint32_t& time) {
 
-        uint32_t val = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x60A9, 0x00)));
+        uint32_t val = static_cast<uint32_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x60A9, 0x00)));
 
         exp = (val >> 24) & 0xff;
         unit = (val >> 16) & 0xff;
@@ -87,7 +95,7 @@ public:
         if (powerSM_->DisableOperation())
             return EXIT_FAILURE;
 
-        uint32_t val = static_cast<uint32_t>(nanolibHelper_->readInteger(connectedDeviceHandle_->value(), nlc::OdIndex(0x60A9, 0x00)));
+        uint32_t val = static_cast<uint32_t>(nanolibHelper_->readValue(connectedDeviceHandle_->value(), nlc::OdIndex(0x60A9, 0x00)));
 
 
         uint32_t time = (velTime << 8);
@@ -99,7 +107,7 @@ public:
         //set
         val = (((val |= exp) |= unit) |= time);
 
-        nanolibHelper_->writeInteger(connectedDeviceHandle_->value(), val, nlc::OdIndex(0x60A9, 0x00), 32);
+        nanolibHelper_->writeValue(connectedDeviceHandle_->value(), val, nlc::OdIndex(0x60A9, 0x00));
 
         return EXIT_SUCCESS;
     }
@@ -0,0 +1,97 @@
+#include "waypoint_queue.h"
+
+#include <algorithm>
+
+static double MsSince(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point now) {
+	return std::chrono::duration<double, std::milli>(now - start).count();
+}
+
+bool WaypointQueue::Append(const int32_t* positions, const uint32_t* velocities, size_t count, bool relative) {
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	std::lock_guard<std::mutex> lock(mutex_);
+	for (size_t i = 0; i < count; i++) {
+		Waypoint waypoint{ positions[i], std::nullopt, relative, now };
+		if (velocities != nullptr)
+			waypoint.velocity = velocities[i];
+		waypoints_.push_back(waypoint);
+	}
+	stats_.queued += count;
+	stats_.maxDepth = std::max(stats_.maxDepth, waypoints_.size());
+
+	const bool start = !running_ && !waypoints_.empty();
+	if (start)
+		running_ = true;
+	return start;
+}
+
+std::optional<WaypointQueue::Waypoint> WaypointQueue::Next() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (waypoints_.empty())
+		return std::nullopt;
+	const Waypoint waypoint = waypoints_.front();
+	waypoints_.pop_front();
+
+	sentAt_ = std::chrono::steady_clock::now();
+	const double queueMs = MsSince(waypoint.queuedAt, sentAt_);
+	stats_.sent++;
+	queueMsSum_ += queueMs;
+	stats_.maxQueueMs = std::max(stats_.maxQueueMs, queueMs);
+	return waypoint;
+}
+
+void WaypointQueue::Acknowledged() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	const double acknowledgeMs = MsSince(sentAt_, std::chrono::steady_clock::now());
+	stats_.acknowledged++;
+	acknowledgeMsSum_ += acknowledgeMs;
+	stats_.maxAcknowledgeMs = std::max(stats_.maxAcknowledgeMs, acknowledgeMs);
+	stats_.lastAcknowledgeMs = acknowledgeMs;
+}
+
+bool WaypointQueue::IsEmpty() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return waypoints_.empty();
+}
+
+bool WaypointQueue::Finish() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!waypoints_.empty())
+		return false;
+	running_ = false;
+	jobId_ = 0;
+	return true;
+}
+
+void WaypointQueue::Stop() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	waypoints_.clear();
+	running_ = false;
+	jobId_ = 0;
+}
+
+void WaypointQueue::Clear() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	waypoints_.clear();
+}
+
+WaypointQueue::Stats WaypointQueue::GetStats() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	Stats stats = stats_;
+	stats.depth = waypoints_.size();
+	if (stats.sent > 0)
+		stats.meanQueueMs = queueMsSum_ / static_cast<double>(stats.sent);
+	if (stats.acknowledged > 0)
+		stats.meanAcknowledgeMs = acknowledgeMsSum_ / static_cast<double>(stats.acknowledged);
+	stats.running = running_;
+	return stats;
+}
+
+uint32_t WaypointQueue::GetJobId() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return jobId_;
+}
+
+void WaypointQueue::SetJobId(uint32_t jobId) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	jobId_ = jobId;
+}
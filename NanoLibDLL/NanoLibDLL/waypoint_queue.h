@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+/*
+Profile position targets of one axis waiting to be handed to the drive.
+The caller appends targets from the bus thread, a job takes them one by one and passes each on
+as soon as the drive has a free set point buffer, see Controller::QueueTargets.
+Records how long targets waited in the queue and how long the drive took to acknowledge them.
+*/
+class WaypointQueue {
+public:
+
+	struct Waypoint {
+		int32_t position;
+		//profile velocity 6081h for the move to this target, empty keeps the one set before
+		std::optional<uint32_t> velocity;
+		bool relative;
+		std::chrono::steady_clock::time_point queuedAt;
+	};
+
+	struct Stats {
+		//targets waiting now and the most ever waiting
+		size_t depth = 0;
+		size_t maxDepth = 0;
+		uint64_t queued = 0;
+		uint64_t sent = 0;
+		uint64_t acknowledged = 0;
+		//time from appending a target to sending it
+		double meanQueueMs = 0.0;
+		double maxQueueMs = 0.0;
+		//time from sending a target to the set point acknowledge of the drive
+		double meanAcknowledgeMs = 0.0;
+		double maxAcknowledgeMs = 0.0;
+		double lastAcknowledgeMs = 0.0;
+		//a job is feeding the drive
+		bool running = false;
+	};
+
+	WaypointQueue() = default;
+
+	WaypointQueue(const WaypointQueue&) = delete;
+	void operator=(const WaypointQueue&) = delete;
+
+	//appends count targets, velocities may be nullptr; true if no job is feeding and the caller has to start one
+	bool Append(const int32_t* positions, const uint32_t* velocities, size_t count, bool relative);
+	//next target for the feeding job, counted as sent
+	std::optional<Waypoint> Next();
+	//the drive acknowledged the target last sent
+	void Acknowledged();
+	bool IsEmpty() const;
+	//ends the feeding if nothing was appended meanwhile, false if there is more to send
+	bool Finish();
+	//drops the waiting targets and ends the feeding, for a job that gave up
+	void Stop();
+	//drops the waiting targets, the move already handed to the drive goes on
+	void Clear();
+
+	Stats GetStats() const;
+
+	//job feeding the drive, 0 if none
+	uint32_t GetJobId() const;
+	void SetJobId(uint32_t jobId);
+
+private:
+
+	mutable std::mutex mutex_;
+	std::deque<Waypoint> waypoints_;
+	bool running_ = false;
+	uint32_t jobId_ = 0;
+	std::chrono::steady_clock::time_point sentAt_;
+
+	Stats stats_;
+	double queueMsSum_ = 0.0;
+	double acknowledgeMsSum_ = 0.0;
+};
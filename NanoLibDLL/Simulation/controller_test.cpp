@@ -0,0 +1,482 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "simulation_test.h"
+
+/*
+The controller through its exported calls against simulated drives, without latency so a test takes as long as
+the motion it waits for.
+*/
+
+static SimulatedAccessor::Config FastBus(uint32_t drives = 1) {
+	SimulatedAccessor::Config config;
+	config.drives = drives;
+	config.latencyUs = 0;
+	config.drive.saveMs = 50;
+	config.drive.autoSetupMs = 200;
+	return config;
+}
+
+struct State {
+	std::string name;
+	bool fault = false;
+	bool voltageEnabled = false;
+	bool quickStop = false;
+	bool warning = false;
+	bool targetReached = false;
+	bool limitReached = false;
+	bool bit12 = false;
+	bool bit13 = false;
+};
+
+static bool ReadState(State& s) {
+	Controller* c = Controller::GetInstance();
+	return OnBus([&] {
+		return c->GetCiA402State(s.name, s.fault, s.voltageEnabled, s.quickStop, s.warning, s.targetReached, s.limitReached, s.bit12, s.bit13);
+	}) == EXIT_SUCCESS;
+}
+
+//polls condition every ms until it holds or timeoutMs passed
+template <class F>
+static bool Eventually(uint32_t timeoutMs, F&& condition) {
+	const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+	while (!condition()) {
+		if (std::chrono::steady_clock::now() > end)
+			return false;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return true;
+}
+
+static RegisterTest connectAndScan("connect_and_scan", [] {
+	SimulatedBus bus(FastBus(3));
+	Controller* c = Controller::GetInstance();
+
+	std::vector<std::string> ports;
+	CHECK(OnBus([&] { return c->GetAvailablePorts(ports); }) == EXIT_SUCCESS);
+	CHECK(ports.size() == 1);
+	CHECK(bus.Open());
+
+	std::vector<std::string> devices;
+	CHECK(OnBus([&] { return c->ScanBus(devices); }) == EXIT_SUCCESS);
+	CHECK(devices.size() == 3);
+	CHECK(OnBus([&] { return c->ConnectDevice(2); }) == EXIT_SUCCESS);
+
+	std::vector<uint32_t> axes;
+	CHECK(OnBus([&] { return c->GetConnectedAxes(axes); }) == EXIT_SUCCESS);
+	CHECK(axes == std::vector<uint32_t>{ 0 });
+
+	//the second connect does not scan again
+	uint32_t generation = 0, deviceCount = 0;
+	double ageMs = 0.0;
+	CHECK(OnBus([&] { return c->GetScanInfo(generation, deviceCount, ageMs); }) == EXIT_SUCCESS);
+	CHECK(OnBus([&] { return c->ConnectDevice(1); }) == EXIT_SUCCESS);
+	uint32_t generationAfter = 0;
+	CHECK(OnBus([&] { return c->GetScanInfo(generationAfter, deviceCount, ageMs); }) == EXIT_SUCCESS);
+	CHECK(generationAfter == generation);
+
+	CHECK(OnBus([&] { return c->ClosePort(); }) == EXIT_SUCCESS);
+	CHECK(OnBus([&] { return c->ConnectDevice(0); }) == EXIT_FAILURE);
+	return true;
+});
+
+static RegisterTest powerStateMachine("power_state_machine", [] {
+	SimulatedBus bus(FastBus());
+	CHECK(bus.Connect());
+	Controller* c = Controller::GetInstance();
+
+	State state;
+	CHECK(ReadState(state));
+	CHECK(!state.voltageEnabled);
+
+	//starting a mode goes through Switched on to Operation enabled
+	CHECK(OnBus([&] { return c->StartPositioning(); }) == EXIT_SUCCESS);
+	CHECK(ReadState(state));
+	CHECK(state.voltageEnabled);
+	CHECK(state.quickStop);
+	CHECK(!state.fault);
+
+	CHECK(OnBus([&] { return c->QuickStop(); }) == EXIT_SUCCESS);
+	CHECK(ReadState(state));
+	CHECK(!state.quickStop);
+	return true;
+});
+
+static RegisterTest profilePositionMove("profile_position_move", [] {
+	SimulatedBus bus(FastBus());
+	CHECK(bus.Connect());
+	Controller* c = Controller::GetInstance();
+
+	CHECK(OnBus([&] { return c->SetProfileVelocity(2000); }) == EXIT_SUCCESS);
+	CHECK(OnBus([&] { return c->SetTargetPosition(500, 0); }) == EXIT_SUCCESS);
+	CHECK(OnBus([&] { return c->StartPositioning(); }) == EXIT_SUCCESS);
+	CHECK(c->WaitTargetReached(5000) == EXIT_SUCCESS);
+	int32_t position = 0;
+	CHECK(OnBus([&] { return c->GetPositionActual(position); }) == EXIT_SUCCESS);
+	CHECK(position == 500);
+
+	//relative to the last target
+	CHECK(OnBus([&] { return c->SetTargetPosition(-200, 1); }) == EXIT_SUCCESS);
+	CHECK(OnBus([&] { return c->StartPositioning(); }) == EXIT_SUCCESS);
+	CHECK(c->WaitTargetReached(5000) == EXIT_SUCCESS);
+	CHECK(OnBus([&] { return c->GetPositionActual(position); }) == EXIT_SUCCESS);
+	CHECK(position == 300);
+
+	uint32_t profileVelocity = 0;
+	int32_t targetPosition = 0;
+	CHECK(OnBus([&] { return c->GetPositioningParameters(profileVelocity, targetPosition); }) == EXIT_SUCCESS);
+	CHECK(profileVelocity == 2000);
+	CHECK(targetPosition == -200);
+	return true;
+});
+
+static RegisterTest velocityRamp("velocity_ramp", [] {
+	SimulatedBus bus(FastBus());
+	CHECK(bus.Connect());
+	Controller* c = Controller::GetInstance();
+
+	CHECK(OnBus([&] { return c->SetVelocityAcceleration(1000, 1); }) == EXIT_SUCCESS);
+	//beyond the range of int16_t, 6049h:01 is UNSIGNED32
+	CHECK(OnBus([&] { return c->SetVelocityDeceleration(40000, 1); }) == EXIT_SUCCESS);
+	CHECK(OnBus([&] { return c->SetTargetVelocity(200); }) == EXIT_SUCCESS);
+	CHECK(OnBus([&] { return c->StartVelocity(); }) == EXIT_SUCCESS);
+	CHECK(Eventually(2000, [&] {
+		int16_t velActual = 0;
+		return OnBus([&] { return c->GetVelocityActual(velActual); }) == EXIT_SUCCESS && velActual == 200;
+	}));
+
+	int16_t vel = 0;
+	uint32_t deltaSpeedAcc = 0, deltaSpeedDec = 0;
+	uint16_t deltaTimeAcc = 0, deltaTimeDec = 0;
+	CHECK(OnBus([&] { return c->GetVelocityParameters(vel, deltaSpeedAcc, deltaTimeAcc, deltaSpeedDec, deltaTimeDec); }) == EXIT_SUCCESS);
+	CHECK(vel == 200);
+	CHECK(deltaSpeedAcc == 1000);
+	CHECK(deltaTimeAcc == 1);
+	CHECK(deltaSpeedDec == 40000);
+	CHECK(deltaTimeDec == 1);
+	CHECK(OnBus([&] { return c->GetVelocityDeceleration(deltaSpeedDec, deltaTimeDec); }) == EXIT_SUCCESS);
+	CHECK(deltaSpeedDec == 40000);
+
+	CHECK(OnBus([&] { return c->SetTargetVelocity(-100); }) == EXIT_SUCCESS);
+	CHECK(Eventually(2000, [&] {
+		int16_t velActual = 0;
+		return OnBus([&] { return c->GetVelocityActual(velActual); }) == EXIT_SUCCESS && velActual == -100;
+	}));
+	CHECK(OnBus([&] { return c->Halt(); }) == EXIT_SUCCESS);
+	CHECK(Eventually(2000, [&] {
+		int16_t velActual = 0;
+		return OnBus([&] { return c->GetVelocityActual(velActual); }) == EXIT_SUCCESS && velActual == 0;
+	}));
+	return true;
+});
+
+static RegisterTest faultAndErrorStack("fault_and_error_stack", [] {
+	SimulatedBus bus(FastBus());
+	CHECK(bus.Connect());
+	Controller* c = Controller::GetInstance();
+
+	CHECK(OnBus([&] { return c->StartPositioning(); }) == EXIT_SUCCESS);
+	CHECK(bus.Accessor().InjectFault(1, 0x2310));
+	State state;
+	CHECK(ReadState(state));
+	CHECK(state.fault);
+
+	std::vector<std::string> errorStack;
+	CHECK(OnBus([&] { return c->GetDeviceErrorStack(errorStack); }) == EXIT_SUCCESS);
+	CHECK(errorStack.size() == 1);
+	CHECK(errorStack[0].find("2310") != std::string::npos);
+
+	//the drive stays in Fault, the motion calls do not reset it
+	CHECK(OnBus([&] { return c->SetTargetPosition(100, 0); }) == EXIT_SUCCESS);
+	CHECK(ReadState(state));
+	CHECK(state.fault);
+	return true;
+});
+
+static RegisterTest saveJob("save_job", [] {
+	SimulatedBus bus(FastBus());
+	CHECK(bus.Connect());
+	Controller* c = Controller::GetInstance();
+
+	uint32_t jobId = 0;
+	CHECK(OnBus([&] { return c->StartSaveGroupsAsync({ 0x06, 0x05 }, jobId); }) == EXIT_SUCCESS);
+	//the bus thread stays free while the job waits for the drive
+	int32_t position = 0;
+	CHECK(OnBus([&] { return c->GetPositionActual(position); }) == EXIT_SUCCESS);
+	CHECK(c->WaitJob(jobId, 5000) == EXIT_SUCCESS);
+	int32_t progress = 0, jobState = 0;
+	CHECK(c->PollJob(jobId, progress, jobState) == EXIT_SUCCESS);
+	CHECK(progress == 100);
+	return true;
+});
+
+static RegisterTest quickStopAhead("quick_stop_ahead", [] {
+	SimulatedBus bus(FastBus());
+	CHECK(bus.Connect());
+	Controller* c = Controller::GetInstance();
+
+	//one call keeps the bus thread busy, another one waits behind it
+	std::atomic<bool> queuedRan{ false };
+	c->Post([] { std::this_thread::sleep_for(std::chrono::milliseconds(200)); return EXIT_SUCCESS; });
+	c->Post([&] { queuedRan = true; return EXIT_SUCCESS; });
+	bool quickStopFirst = false;
+	c->ExecuteUrgent([&] { quickStopFirst = !queuedRan; return c->QuickStop(); });
+	CHECK(quickStopFirst);
+	CHECK(Eventually(1000, [&] { return queuedRan.load(); }));
+	return true;
+});
+
+static RegisterTest homingJob("homing_job", [] {
+	SimulatedBus bus(FastBus());
+	CHECK(bus.Connect());
+	Controller* c = Controller::GetInstance();
+
+	CHECK(OnBus([&] { return c->SetProfileVelocity(5000); }) == EXIT_SUCCESS);
+	CHECK(OnBus([&] { return c->SetTargetPosition(400, 0); }) == EXIT_SUCCESS);
+	CHECK(OnBus([&] { return c->StartPositioning(); }) == EXIT_SUCCESS);
+	CHECK(c->WaitTargetReached(5000) == EXIT_SUCCESS);
+
+	uint32_t jobId = 0;
+	CHECK(OnBus([&] { return c->StartHomeAsync(100, 1000, jobId); }) == EXIT_SUCCESS);
+	CHECK(c->WaitJob(jobId, 10000) == EXIT_SUCCESS);
+	int32_t position = -1;
+	CHECK(OnBus([&] { return c->GetPositionActual(position); }) == EXIT_SUCCESS);
+	CHECK(position == 0);
+	return true;
+});
+
+static RegisterTest twoAxes("two_axes", [] {
+	SimulatedBus bus(FastBus(2));
+	CHECK(bus.Open());
+	Controller* c = Controller::GetInstance();
+
+	CHECK(OnBus([&] { return c->ConnectAxes({ 0, 1 }); }) == EXIT_SUCCESS);
+	std::vector<uint32_t> axes;
+	CHECK(OnBus([&] { return c->GetConnectedAxes(axes); }) == EXIT_SUCCESS);
+	CHECK(axes == (std::vector<uint32_t>{ 0, 1 }));
+
+	for (uint32_t axis : { 0U, 1U }) {
+		CHECK(c->ExecuteOnAxis(axis, [&] { return c->SetProfileVelocity(2000); }) == EXIT_SUCCESS);
+		CHECK(c->ExecuteOnAxis(axis, [&] { return c->SetTargetPosition(100 * static_cast<int32_t>(axis + 1), 0); }) == EXIT_SUCCESS);
+		CHECK(c->ExecuteOnAxis(axis, [&] { return c->StartPositioning(); }) == EXIT_SUCCESS);
+	}
+	for (uint32_t axis : { 0U, 1U }) {
+		CHECK(c->WaitTargetReachedOnAxis(axis, 5000) == EXIT_SUCCESS);
+		int32_t position = 0;
+		CHECK(c->ExecuteOnAxis(axis, [&] { return c->GetPositionActual(position); }) == EXIT_SUCCESS);
+		CHECK(position == 100 * static_cast<int32_t>(axis + 1));
+	}
+
+	//the selection is kept by the calls on an axis
+	uint32_t selected = 1;
+	CHECK(OnBus([&] { return c->GetSelectedAxis(selected); }) == EXIT_SUCCESS);
+	CHECK(selected == 0);
+	CHECK(c->ExecuteOnAxis(5, [&] { return c->StartPositioning(); }) == EXIT_FAILURE);
+	return true;
+});
+
+static RegisterTest postSelectedAxis("post_selected_axis", [] {
+	SimulatedBus bus(FastBus(2));
+	CHECK(bus.Open());
+	Controller* c = Controller::GetInstance();
+	CHECK(OnBus([&] { return c->ConnectAxes({ 0, 1 }); }) == EXIT_SUCCESS);
+
+	//the bus thread is held while a torque is posted for axis 0, axis 1 is selected before its write runs
+	std::atomic<bool> busy{ false };
+	std::thread holder([&] {
+		OnBus([&] {
+			busy = true;
+			std::this_thread::sleep_for(std::chrono::milliseconds(200));
+			return EXIT_SUCCESS;
+		});
+	});
+	CHECK(Eventually(1000, [&] { return busy.load(); }));
+	c->PostTargetTorque(std::nullopt, 100);
+	std::thread selector([&] { c->ExecuteUrgent([&] { return c->SelectAxis(1); }); });
+	holder.join();
+	selector.join();
+
+	//the torque still goes to the axis selected when it was posted
+	int16_t torques[2] = {};
+	uint32_t slope = 0;
+	uint16_t maxTorque = 0;
+	CHECK(Eventually(1000, [&] {
+		return c->ExecuteOnAxis(0, [&] { return c->GetProfileTorqueParameters(torques[0], slope, maxTorque); }) == EXIT_SUCCESS && torques[0] == 100;
+	}));
+	CHECK(c->ExecuteOnAxis(1, [&] { return c->GetProfileTorqueParameters(torques[1], slope, maxTorque); }) == EXIT_SUCCESS);
+	CHECK(torques[1] == 0);
+	return true;
+});
+
+static RegisterTest cyclicPositionFeed("cyclic_position_feed", [] {
+	SimulatedBus bus(FastBus());
+	CHECK(bus.Connect());
+	Controller* c = Controller::GetInstance();
+
+	CHECK(OnBus([&] { return c->StartCyclicPosition(2000); }) == EXIT_SUCCESS);
+	std::vector<int32_t> setpoints;
+	for (int32_t i = 1; i <= 200; i++)
+		setpoints.push_back(i);
+	size_t pushed = 0;
+	CHECK(Eventually(5000, [&] {
+		int32_t accepted = 0, free = 0;
+		if (OnBus([&] { return c->PushSetpoints(setpoints.data() + pushed, static_cast<int32_t>(setpoints.size() - pushed), true, accepted, free); }) != EXIT_SUCCESS)
+			return true;
+		pushed += static_cast<size_t>(accepted);
+		return pushed == setpoints.size();
+	}));
+	CHECK(pushed == setpoints.size());
+
+	SetpointFeeder::Stats stats;
+	CHECK(Eventually(5000, [&] {
+		OnBus([&] { return c->GetSetpointFeederStats(stats); });
+		return stats.written == setpoints.size();
+	}));
+	CHECK(stats.running);
+	CHECK(stats.underruns == 0);
+	CHECK(Eventually(2000, [&] {
+		int32_t position = 0;
+		return OnBus([&] { return c->GetPositionActual(position); }) == EXIT_SUCCESS && position == 200;
+	}));
+
+	CHECK(OnBus([&] { return c->StopCyclicPosition(); }) == EXIT_SUCCESS);
+	CHECK(OnBus([&] { return c->GetSetpointFeederStats(stats); }) == EXIT_SUCCESS);
+	CHECK(!stats.running);
+	return true;
+});
+
+static RegisterTest cyclicPositionStop("cyclic_position_stop", [] {
+	SimulatedAccessor::Config config = FastBus();
+	config.latencyUs = 300;
+	SimulatedBus bus(config);
+	CHECK(bus.Connect());
+	Controller* c = Controller::GetInstance();
+
+	//the writes of the feeder and the calls below share the bus thread
+	CHECK(OnBus([&] { return c->StartCyclicPosition(1000); }) == EXIT_SUCCESS);
+	std::vector<int32_t> setpoints(2000);
+	for (size_t i = 0; i < setpoints.size(); i++)
+		setpoints[i] = static_cast<int32_t>(i);
+	int32_t accepted = 0, free = 0;
+	CHECK(OnBus([&] { return c->PushSetpoints(setpoints.data(), static_cast<int32_t>(setpoints.size()), true, accepted, free); }) == EXIT_SUCCESS);
+	for (int i = 0; i < 50; i++) {
+		int32_t position = 0;
+		CHECK(OnBus([&] { return c->GetPositionActual(position); }) == EXIT_SUCCESS);
+	}
+
+	//stopped on the bus thread while a write of the feeder may wait there
+	CHECK(OnBus([&] { return c->StopCyclicPosition(); }) == EXIT_SUCCESS);
+	SetpointFeeder::Stats stats;
+	CHECK(OnBus([&] { return c->GetSetpointFeederStats(stats); }) == EXIT_SUCCESS);
+	CHECK(!stats.running);
+	CHECK(stats.written > 0 && stats.written < setpoints.size());
+	return true;
+});
+
+static RegisterTest cyclicPositionTwoAxes("cyclic_position_two_axes", [] {
+	SimulatedBus bus(FastBus(2));
+	CHECK(bus.Open());
+	Controller* c = Controller::GetInstance();
+	CHECK(OnBus([&] { return c->ConnectAxes({ 0, 1 }); }) == EXIT_SUCCESS);
+
+	//each axis feeds from a buffer of its own
+	const std::vector<int32_t> setpoints{ 10, 20, 30 };
+	for (uint32_t axis : { 0U, 1U }) {
+		CHECK(c->ExecuteOnAxis(axis, [&] { return c->StartCyclicPosition(2000); }) == EXIT_SUCCESS);
+		int32_t accepted = 0, free = 0;
+		CHECK(c->ExecuteOnAxis(axis, [&] {
+			return c->PushSetpoints(setpoints.data(), static_cast<int32_t>(setpoints.size()), false, accepted, free);
+		}) == EXIT_SUCCESS);
+		CHECK(accepted == static_cast<int32_t>(setpoints.size()));
+	}
+	for (uint32_t axis : { 0U, 1U }) {
+		CHECK(Eventually(2000, [&] {
+			int32_t position = 0;
+			return c->ExecuteOnAxis(axis, [&] { return c->GetPositionActual(position); }) == EXIT_SUCCESS && position == 30;
+		}));
+	}
+
+	//stopping one axis leaves the other one running
+	CHECK(c->ExecuteOnAxis(0, [&] { return c->StopCyclicPosition(); }) == EXIT_SUCCESS);
+	SetpointFeeder::Stats stats;
+	CHECK(c->ExecuteOnAxis(0, [&] { return c->GetSetpointFeederStats(stats); }) == EXIT_SUCCESS);
+	CHECK(!stats.running);
+	CHECK(c->ExecuteOnAxis(1, [&] { return c->GetSetpointFeederStats(stats); }) == EXIT_SUCCESS);
+	CHECK(stats.running);
+	CHECK(stats.written == setpoints.size());
+	return true;
+});
+
+static RegisterTest interpolatedPositionBuffer("interpolated_position_buffer", [] {
+	SimulatedAccessor::Config config = FastBus();
+	config.drive.interpolationBuffer = 8;
+	SimulatedBus bus(config);
+	CHECK(bus.Connect());
+	Controller* c = Controller::GetInstance();
+
+	//written ahead by the fill level the drive reports, a record written to its full buffer would fail the feed
+	CHECK(OnBus([&] { return c->StartInterpolatedPosition(2000); }) == EXIT_SUCCESS);
+	std::vector<int32_t> setpoints;
+	for (int32_t i = 1; i <= 300; i++)
+		setpoints.push_back(i);
+	int32_t accepted = 0, free = 0;
+	CHECK(OnBus([&] { return c->PushSetpoints(setpoints.data(), static_cast<int32_t>(setpoints.size()), true, accepted, free); }) == EXIT_SUCCESS);
+	CHECK(accepted == static_cast<int32_t>(setpoints.size()));
+
+	SetpointFeeder::Stats stats;
+	uint32_t maxDriveBuffered = 0;
+	CHECK(Eventually(5000, [&] {
+		OnBus([&] { return c->GetSetpointFeederStats(stats); });
+		maxDriveBuffered = std::max(maxDriveBuffered, stats.driveBuffered);
+		return stats.written == setpoints.size() || !stats.running;
+	}));
+	CHECK(stats.running);
+	CHECK(stats.lead == 7);
+	CHECK(maxDriveBuffered > 1 && maxDriveBuffered <= 8);
+	CHECK(stats.underruns == 0);
+	CHECK(Eventually(2000, [&] {
+		int32_t position = 0;
+		return OnBus([&] { return c->GetPositionActual(position); }) == EXIT_SUCCESS && position == 300;
+	}));
+
+	CHECK(OnBus([&] { return c->StopInterpolatedPosition(); }) == EXIT_SUCCESS);
+	return true;
+});
+
+static RegisterTest telemetrySampler("telemetry_sampler", [] {
+	SimulatedBus bus(FastBus());
+	CHECK(bus.Connect());
+	Controller* c = Controller::GetInstance();
+
+	//a negative position shows that the samples are sign extended
+	CHECK(OnBus([&] { return c->SetProfileVelocity(5000); }) == EXIT_SUCCESS);
+	CHECK(OnBus([&] { return c->SetTargetPosition(-300, 0); }) == EXIT_SUCCESS);
+	CHECK(OnBus([&] { return c->StartPositioning(); }) == EXIT_SUCCESS);
+	CHECK(c->WaitTargetReached(5000) == EXIT_SUCCESS);
+
+	const std::vector<nlc::OdIndex> objects{ nlc::OdIndex(0x6064, 0x00), nlc::OdIndex(0x6041, 0x00) };
+	CHECK(OnBus([&] { return c->StartTelemetry(objects, 2); }) == EXIT_SUCCESS);
+	std::vector<int64_t> rows(3 * 1000);
+	int32_t rowsCopied = 0, channels = 0;
+	CHECK(Eventually(5000, [&] {
+		c->DrainTelemetry(rows.data(), 1000, rowsCopied, channels);
+		return rowsCopied > 0;
+	}));
+	CHECK(channels == 2);
+	for (int32_t row = 0; row < rowsCopied; row++) {
+		CHECK(rows[row * 3 + 1] == -300);
+		CHECK((rows[row * 3 + 2] & 0x006F) == 0x0027);
+	}
+	CHECK(OnBus([&] { return c->StopTelemetry(); }) == EXIT_SUCCESS);
+
+	double sampleRate = 0.0;
+	uint64_t samples = 0, overruns = 0, drops = 0, errors = 0;
+	CHECK(OnBus([&] { return c->GetTelemetryStats(sampleRate, samples, overruns, drops, errors); }) == EXIT_SUCCESS);
+	CHECK(samples >= static_cast<uint64_t>(rowsCopied));
+	CHECK(errors == 0);
+	CHECK(drops == 0);
+	return true;
+});
@@ -0,0 +1,92 @@
+#include <map>
+
+#include "od_metadata.h"
+#include "simulation_test.h"
+
+/*
+OdMetadataCache::Refine with an object dictionary that is not a file of NanoLib.
+*/
+
+namespace {
+
+	class SubEntry : public nlc::ObjectSubEntry {
+	public:
+		SubEntry(nlc::ObjectEntryDataType dataType, uint32_t bitLength, nlc::ObjectSdoAccessAttribute access) :
+			dataType_(dataType), bitLength_(bitLength), access_(access) {
+		}
+		nlc::ObjectEntryDataType getDataType() const override { return dataType_; }
+		uint32_t getBitLength() const override { return bitLength_; }
+		nlc::ObjectSdoAccessAttribute getSdoAccess() const override { return access_; }
+	private:
+		nlc::ObjectEntryDataType dataType_;
+		uint32_t bitLength_;
+		nlc::ObjectSdoAccessAttribute access_;
+	};
+
+	class Entry : public nlc::ObjectEntry {
+	public:
+		uint8_t getMaxSubIndex() const override { return subEntries_.empty() ? 0 : subEntries_.rbegin()->first; }
+		nlc::ObjectSubEntry& getSubEntry(uint8_t subIndex) override {
+			auto it = subEntries_.find(subIndex);
+			return it == subEntries_.end() ? invalidObject : it->second;
+		}
+		std::map<uint8_t, SubEntry> subEntries_;
+	};
+
+	class Dictionary : public nlc::ObjectDictionary {
+	public:
+		void Add(uint16_t index, uint8_t subIndex, nlc::ObjectEntryDataType dataType, uint32_t bitLength, nlc::ObjectSdoAccessAttribute access) {
+			entries_[index].subEntries_.emplace(subIndex, SubEntry(dataType, bitLength, access));
+		}
+		nlc::ResultObjectEntry getObjectEntry(uint16_t index) override {
+			auto it = entries_.find(index);
+			if (it == entries_.end())
+				return nlc::ResultObjectEntry(nlc::NlcErrorCode::ODDoesNotExist, "no such object");
+			return nlc::ResultObjectEntry(it->second);
+		}
+	private:
+		std::map<uint16_t, Entry> entries_;
+	};
+}
+
+static RegisterTest odMetadataRefine("od_metadata_refine", [] {
+	using Type = nlc::ObjectEntryDataType;
+	using Access = nlc::ObjectSdoAccessAttribute;
+
+	Dictionary od;
+	//in the table, the dictionary wins
+	od.Add(0x6042, 0x00, Type::Integer32, 32, Access::ReadWrite);
+	//not in the table
+	od.Add(0x2300, 0x00, Type::Unsigned16, 16, Access::ReadOnly);
+	od.Add(0x6502, 0x00, Type::Unsigned32, 32, Access::ReadOnly);
+	od.Add(0x1018, 0x01, Type::Unsigned32, 32, Access::ReadOnly);
+	od.Add(0x1018, 0x04, Type::Unsigned32, 32, Access::ReadOnly);
+	//strings are not numbers
+	od.Add(0x1008, 0x00, Type::VisibleString, 64, Access::ReadOnly);
+
+	OdMetadataCache cache;
+	const size_t tableSize = cache.Size();
+	CHECK(cache.Find(nlc::OdIndex(0x2300, 0x00)) == nullptr);
+	CHECK(cache.Refine(od) == 5);
+	CHECK(cache.Size() == tableSize + 4);
+
+	const OdMetadata* targetVelocity = cache.Find(nlc::OdIndex(0x6042, 0x00));
+	CHECK(targetVelocity != nullptr);
+	CHECK(targetVelocity->dataType == Type::Integer32);
+	CHECK(targetVelocity->bitLength == 32);
+
+	const OdMetadata* added = cache.Find(nlc::OdIndex(0x2300, 0x00));
+	CHECK(added != nullptr);
+	CHECK(added->bitLength == 16);
+	CHECK(!added->IsSigned());
+	CHECK(!added->IsWritable());
+	CHECK(cache.Find(nlc::OdIndex(0x1018, 0x04)) != nullptr);
+	CHECK(cache.Find(nlc::OdIndex(0x1018, 0x02)) == nullptr);
+	CHECK(cache.Find(nlc::OdIndex(0x1008, 0x00)) == nullptr);
+
+	//objects the dictionary does not have keep the table values
+	const OdMetadata* position = cache.Find(nlc::OdIndex(0x6064, 0x00));
+	CHECK(position != nullptr);
+	CHECK(position->dataType == Type::Integer32);
+	return true;
+});
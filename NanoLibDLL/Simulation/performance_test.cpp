@@ -0,0 +1,83 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "simulation_test.h"
+
+/*
+Throughput of the bus thread with the latency of a CAN adapter. The bounds are loose, they catch a call that
+costs several transfers more than it should, not a slow machine; the measured numbers are printed.
+*/
+
+static constexpr uint32_t kLatencyUs = 500;
+
+static SimulatedAccessor::Config SlowBus() {
+	SimulatedAccessor::Config config;
+	config.latencyUs = kLatencyUs;
+	config.jitterUs = 50;
+	return config;
+}
+
+static RegisterTest performanceRoundTrip("performance_round_trip", [] {
+	SimulatedBus bus(SlowBus());
+	CHECK(bus.Connect());
+	Controller* c = Controller::GetInstance();
+
+	//one read of 6064h each, the connection is not checked on the bus
+	const int calls = 200;
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < calls; i++) {
+		int32_t position = 0;
+		CHECK(OnBus([&] { return c->GetPositionActual(position); }) == EXIT_SUCCESS);
+	}
+	const double usPerCall = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / calls;
+	std::printf("GetPositionActual %.0f us per call at %u us per transfer\n", usPerCall, kLatencyUs);
+	CHECK(usPerCall < 3.0 * kLatencyUs);
+	return true;
+});
+
+static RegisterTest performanceParallelCallers("performance_parallel_callers", [] {
+	SimulatedBus bus(SlowBus());
+	CHECK(bus.Connect());
+	Controller* c = Controller::GetInstance();
+
+	//callers of several VIs at once are served one after the other, none of them is starved
+	const int threads = 4;
+	const int callsPerThread = 50;
+	std::atomic<int> failed{ 0 };
+	std::vector<double> maxUs(threads, 0.0);
+	std::vector<std::thread> callers;
+	const auto start = std::chrono::steady_clock::now();
+	for (int t = 0; t < threads; t++) {
+		callers.emplace_back([&, t] {
+			for (int i = 0; i < callsPerThread; i++) {
+				const auto callStart = std::chrono::steady_clock::now();
+				int32_t position = 0;
+				if (OnBus([&] { return c->GetPositionActual(position); }) != EXIT_SUCCESS)
+					failed++;
+				maxUs[t] = std::max(maxUs[t], std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - callStart).count());
+			}
+		});
+	}
+	for (std::thread& caller : callers)
+		caller.join();
+	const double totalUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+	const double usPerCall = totalUs / (threads * callsPerThread);
+	double worstUs = 0.0;
+	for (double us : maxUs)
+		worstUs = std::max(worstUs, us);
+
+	uint32_t depth = 0, maxDepth = 0;
+	uint64_t executed = 0, posted = 0;
+	double avgWaitUs = 0.0, maxWaitUs = 0.0;
+	c->GetBusQueueStats(depth, maxDepth, executed, posted, avgWaitUs, maxWaitUs);
+	std::printf("%d callers: %.0f us per call, slowest call %.0f us, queue depth up to %u, wait %.0f us on average\n",
+		threads, usPerCall, worstUs, maxDepth, avgWaitUs);
+
+	CHECK(failed == 0);
+	CHECK(usPerCall < 3.0 * kLatencyUs);
+	//a call waits at most for the one of every other caller
+	CHECK(worstUs < 3.0 * threads * kLatencyUs + 20000.0);
+	return true;
+});
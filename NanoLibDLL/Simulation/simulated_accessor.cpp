@@ -0,0 +1,636 @@
+#include "simulated_accessor.h"
+#include "nano_lib_hw_strings.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <format>
+#include <thread>
+
+using nlc::NlcErrorCode;
+
+static const char* kNotSupported = "not supported by the simulation";
+
+//error code NanoLib reports for an SDO abort
+static NlcErrorCode ErrorOfAbort(uint32_t abortCode) {
+	switch (abortCode) {
+	case SimulatedDrive::kAbortNoObject:
+	case SimulatedDrive::kAbortNoSubIndex:
+		return NlcErrorCode::ODDoesNotExist;
+	case SimulatedDrive::kAbortUnsupportedAccess:
+	case SimulatedDrive::kAbortWriteOnly:
+	case SimulatedDrive::kAbortReadOnly:
+		return NlcErrorCode::ODInvalidAccess;
+	default:
+		return NlcErrorCode::ProtocolError;
+	}
+}
+
+static std::string AbortMessage(const char* what, const nlc::OdIndex& odIndex, uint32_t abortCode) {
+	return std::format("{} {} aborted with 0x{:08X}", what, odIndex.toString(), abortCode);
+}
+
+class SimulatedAccessor::OdLibrary : public nlc::OdLibrary {
+public:
+	uint32_t getObjectDictionaryCount() const override { return 0; }
+	nlc::ResultObjectDictionary getObjectDictionary(uint32_t) override {
+		return nlc::ResultObjectDictionary(NlcErrorCode::OperationNotSupported, kNotSupported);
+	}
+	nlc::ResultObjectDictionary addObjectDictionaryFromFile(std::string const&) override {
+		return nlc::ResultObjectDictionary(NlcErrorCode::OperationNotSupported, kNotSupported);
+	}
+	nlc::ResultObjectDictionary addObjectDictionary(std::vector<uint8_t> const&, const std::string&) override {
+		return nlc::ResultObjectDictionary(NlcErrorCode::OperationNotSupported, kNotSupported);
+	}
+};
+
+class SimulatedAccessor::ProfinetDCP : public nlc::ProfinetDCP {
+public:
+	uint32_t getScanTimeout() const override { return scanTimeout_; }
+	void setScanTimeout(uint32_t timeoutMsec) override { scanTimeout_ = timeoutMsec; }
+	uint32_t getResponseTimeout() const override { return responseTimeout_; }
+	void setResponseTimeout(uint32_t timeoutMsec) override { responseTimeout_ = timeoutMsec; }
+	nlc::ResultVoid isServiceAvailable(const nlc::BusHardwareId&) override {
+		return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+	}
+	nlc::ResultProfinetDevices scanProfinetDevices(const nlc::BusHardwareId&) override {
+		return nlc::ResultProfinetDevices(kNotSupported, NlcErrorCode::OperationNotSupported);
+	}
+	nlc::ResultVoid setupProfinetDevice(const nlc::BusHardwareId&, const nlc::ProfinetDevice&, bool) override {
+		return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+	}
+	nlc::ResultVoid resetProfinetDevice(const nlc::BusHardwareId&, const nlc::ProfinetDevice&) override {
+		return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+	}
+	nlc::ResultVoid blinkProfinetDevice(const nlc::BusHardwareId&, const nlc::ProfinetDevice&) override {
+		return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+	}
+	nlc::ResultVoid validateProfinetDeviceIp(const nlc::BusHardwareId&, const nlc::ProfinetDevice&) override {
+		return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+	}
+private:
+	uint32_t scanTimeout_ = 2000;
+	uint32_t responseTimeout_ = 1000;
+};
+
+//software sampler of NanoLib, reads the tracked objects with SDO every period on a thread of its own
+//only the immediate trigger, the samples go to the notification or are kept for getData
+class SimulatedAccessor::SamplerInterface : public nlc::SamplerInterface {
+public:
+	explicit SamplerInterface(SimulatedAccessor* accessor) : accessor_(accessor) {
+	}
+
+	~SamplerInterface() override {
+		std::vector<uint32_t> handles;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (const auto& [handle, sampler] : samplers_)
+				handles.push_back(handle);
+		}
+		for (uint32_t handle : handles)
+			stop(nlc::DeviceHandle(handle));
+	}
+
+	nlc::ResultVoid configure(const nlc::DeviceHandle deviceHandle, const nlc::SamplerConfiguration& configuration) override {
+		if (configuration.trackedAddresses.empty() || configuration.trackedAddresses.size() > nlc::SamplerConfiguration::MAX_TRACKED_ADDRESSES)
+			return nlc::ResultVoid(NlcErrorCode::InvalidArguments, "1 to 12 tracked addresses");
+		if (configuration.triggerCondition != nlc::SamplerTriggerCondition::TC_TRUE)
+			return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, "only the immediate trigger is simulated");
+		if (configuration.numberOfSamples == 0)
+			return nlc::ResultVoid(NlcErrorCode::InvalidArguments, "no samples");
+		std::lock_guard<std::mutex> lock(mutex_);
+		Sampler& sampler = samplers_[deviceHandle.get()];
+		if (sampler.thread.joinable())
+			return nlc::ResultVoid(NlcErrorCode::InvalidOperation, "sampler is running");
+		sampler.configuration = configuration;
+		sampler.state = nlc::SamplerState::Configured;
+		sampler.data.clear();
+		return nlc::ResultVoid();
+	}
+
+	nlc::ResultVoid start(const nlc::DeviceHandle deviceHandle, nlc::SamplerNotify* notify, int64_t applicationData) override {
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = samplers_.find(deviceHandle.get());
+		if (it == samplers_.end() || it->second.state == nlc::SamplerState::Unconfigured)
+			return nlc::ResultVoid(NlcErrorCode::InvalidOperation, "sampler is not configured");
+		Sampler& sampler = it->second;
+		if (sampler.thread.joinable())
+			return nlc::ResultVoid(NlcErrorCode::InvalidOperation, "sampler is running");
+		sampler.state = nlc::SamplerState::Running;
+		sampler.stop = false;
+		sampler.data.clear();
+		sampler.thread = std::thread([this, deviceHandle, notify, applicationData] { Run(deviceHandle, notify, applicationData); });
+		return nlc::ResultVoid();
+	}
+
+	nlc::ResultSampleDataArray getData(const nlc::DeviceHandle deviceHandle) override {
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = samplers_.find(deviceHandle.get());
+		if (it == samplers_.end())
+			return nlc::ResultSampleDataArray("sampler is not configured", NlcErrorCode::InvalidOperation);
+		std::vector<nlc::SampleData> data;
+		data.swap(it->second.data);
+		return nlc::ResultSampleDataArray(data);
+	}
+
+	nlc::ResultVoid stop(const nlc::DeviceHandle deviceHandle) override {
+		std::thread thread;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto it = samplers_.find(deviceHandle.get());
+			if (it == samplers_.end())
+				return nlc::ResultVoid();
+			it->second.stop = true;
+			thread = std::move(it->second.thread);
+			if (it->second.state == nlc::SamplerState::Running)
+				it->second.state = nlc::SamplerState::Cancelled;
+		}
+		stopped_.notify_all();
+		if (thread.joinable())
+			thread.join();
+		return nlc::ResultVoid();
+	}
+
+	nlc::ResultSamplerState getState(const nlc::DeviceHandle deviceHandle) override {
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = samplers_.find(deviceHandle.get());
+		return nlc::ResultSamplerState(it == samplers_.end() ? nlc::SamplerState::Unconfigured : it->second.state);
+	}
+
+	nlc::ResultVoid getLastError(const nlc::DeviceHandle deviceHandle) override {
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = samplers_.find(deviceHandle.get());
+		return it == samplers_.end() ? nlc::ResultVoid() : it->second.lastError;
+	}
+
+private:
+	struct Sampler {
+		nlc::SamplerConfiguration configuration{};
+		nlc::SamplerState state = nlc::SamplerState::Unconfigured;
+		nlc::ResultVoid lastError;
+		//samples of a start without notification
+		std::vector<nlc::SampleData> data;
+		bool stop = false;
+		std::thread thread;
+	};
+
+	void Run(const nlc::DeviceHandle deviceHandle, nlc::SamplerNotify* notify, int64_t applicationData) {
+		nlc::SamplerConfiguration configuration;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			configuration = samplers_[deviceHandle.get()].configuration;
+		}
+		const std::chrono::milliseconds period(std::max<uint16_t>(configuration.periodMilliseconds, 1));
+		const SimulatedDrive::Clock::time_point begin = SimulatedDrive::Clock::now();
+		SimulatedDrive::Clock::time_point next = begin;
+		uint64_t iteration = 0;
+		nlc::SampleData block{ 0, {} };
+		uint16_t samples = 0;
+
+		//hands a block to the notification or keeps it, false once the sampler ended
+		auto deliver = [&](nlc::SamplerState state, const nlc::ResultVoid& error) {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				Sampler& sampler = samplers_[deviceHandle.get()];
+				if (sampler.stop)
+					return false;
+				sampler.state = state;
+				sampler.lastError = error;
+				if (notify == nullptr && !block.sampledValues.empty())
+					sampler.data.push_back(block);
+			}
+			if (notify != nullptr)
+				notify->notify(error, state, { block }, applicationData);
+			return state == nlc::SamplerState::Running;
+		};
+
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				if (stopped_.wait_until(lock, next, [&] { return samplers_[deviceHandle.get()].stop; }))
+					return;
+			}
+			const uint64_t timeMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(SimulatedDrive::Clock::now() - begin).count());
+			for (const nlc::OdIndex& odIndex : configuration.trackedAddresses) {
+				const nlc::ResultInt value = accessor_->readNumber(deviceHandle, odIndex);
+				if (value.hasError()) {
+					deliver(nlc::SamplerState::Failed, nlc::ResultVoid(value.getErrorCode(), value.getExErrorCode(), value.getError()));
+					return;
+				}
+				block.sampledValues.push_back(nlc::SampledValue{ value.getResult(), timeMs });
+			}
+			next += period;
+
+			if (++samples < configuration.numberOfSamples)
+				continue;
+			const bool last = configuration.mode == nlc::SamplerMode::Normal;
+			if (!deliver(last ? nlc::SamplerState::Completed : nlc::SamplerState::Running, nlc::ResultVoid()) || last)
+				return;
+			if (configuration.mode == nlc::SamplerMode::Repetitive)
+				iteration++;
+			block = nlc::SampleData{ iteration, {} };
+			samples = 0;
+		}
+	}
+
+	SimulatedAccessor* accessor_;
+	std::mutex mutex_;
+	std::condition_variable stopped_;
+	std::map<uint32_t, Sampler> samplers_;
+};
+
+SimulatedAccessor::SimulatedAccessor(const Config& config) :
+	latencyUs_(config.latencyUs),
+	jitterUs_(config.jitterUs),
+	odLibrary_(std::make_unique<OdLibrary>()),
+	profinetDCP_(std::make_unique<ProfinetDCP>()),
+	sampler_(std::make_unique<SamplerInterface>(this))
+{
+	for (uint32_t nodeId = 1; nodeId <= config.drives; nodeId++)
+		drives_.push_back(std::make_unique<SimulatedDrive>(nodeId, config.drive));
+}
+
+SimulatedAccessor::~SimulatedAccessor() {
+}
+
+nlc::BusHardwareId SimulatedAccessor::GetBusHardwareId() {
+	return nlc::BusHardwareId("Simulation", nlc::BUS_HARDWARE_ID_PROTOCOL_CANOPEN, "sim0", "Simulated CANopen bus");
+}
+
+void SimulatedAccessor::SetLatency(uint32_t latencyUs, uint32_t jitterUs) {
+	latencyUs_ = latencyUs;
+	jitterUs_ = jitterUs;
+}
+
+bool SimulatedAccessor::InjectFault(uint32_t nodeId, uint16_t errorCode) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (nodeId == 0 || nodeId > drives_.size())
+		return false;
+	drives_[nodeId - 1]->InjectFault(errorCode, SimulatedDrive::Clock::now());
+	return true;
+}
+
+void SimulatedAccessor::Transfer() {
+	const uint32_t latencyUs = latencyUs_;
+	const uint32_t jitterUs = std::min(jitterUs_.load(), latencyUs);
+	int64_t us = latencyUs;
+	if (jitterUs > 0) {
+		std::lock_guard<std::mutex> lock(randomMutex_);
+		us += std::uniform_int_distribution<int64_t>(-static_cast<int64_t>(jitterUs), jitterUs)(random_);
+	}
+	if (us <= 0)
+		return;
+
+	//sleep is only accurate to a few ms, the rest is spun
+	const SimulatedDrive::Clock::time_point end = SimulatedDrive::Clock::now() + std::chrono::microseconds(us);
+	if (us > 3000)
+		std::this_thread::sleep_for(std::chrono::microseconds(us - 2000));
+	while (SimulatedDrive::Clock::now() < end)
+		std::this_thread::yield();
+}
+
+SimulatedDrive* SimulatedAccessor::FindConnected(const nlc::DeviceHandle& deviceHandle, std::string& error) {
+	auto it = devices_.find(deviceHandle.get());
+	if (it == devices_.end()) {
+		error = std::format("device handle {} unknown", deviceHandle.get());
+		return nullptr;
+	}
+	if (!open_ || !it->second.connected) {
+		error = std::format("{} is not connected", it->second.deviceId.getDescription());
+		return nullptr;
+	}
+	return drives_[it->second.deviceId.getDeviceId() - 1].get();
+}
+
+void SimulatedAccessor::setLoggingLevel(nlc::LogLevel) {
+}
+
+nlc::ResultBusHwIds SimulatedAccessor::listAvailableBusHardware() {
+	return nlc::ResultBusHwIds(std::vector<nlc::BusHardwareId>{ GetBusHardwareId() });
+}
+
+nlc::ResultVoid SimulatedAccessor::openBusHardwareWithProtocol(const nlc::BusHardwareId& busHwId, const nlc::BusHardwareOptions&) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!busHwId.equals(GetBusHardwareId()))
+		return nlc::ResultVoid(NlcErrorCode::ResourceNotFound, std::format("no bus hardware {}", busHwId.getName()));
+	if (open_)
+		return nlc::ResultVoid(NlcErrorCode::InvalidOperation, "bus hardware is already open");
+	open_ = true;
+	return nlc::ResultVoid();
+}
+
+nlc::ResultVoid SimulatedAccessor::closeBusHardware(const nlc::BusHardwareId& busHwId) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!open_ || !busHwId.equals(GetBusHardwareId()))
+		return nlc::ResultVoid(NlcErrorCode::InvalidOperation, "bus hardware is not open");
+	open_ = false;
+	for (auto& [handle, device] : devices_)
+		device.connected = false;
+	return nlc::ResultVoid();
+}
+
+nlc::ResultVoid SimulatedAccessor::setBusState(const nlc::BusHardwareId&, const std::string&) {
+	return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultDeviceHandle SimulatedAccessor::addDevice(const nlc::DeviceId& deviceId) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!deviceId.getBusHardwareId().equals(GetBusHardwareId()))
+		return nlc::ResultDeviceHandle(NlcErrorCode::InvalidArguments, "device is not on the simulated bus");
+	for (const auto& [handle, device] : devices_) {
+		if (device.deviceId.getDeviceId() == deviceId.getDeviceId())
+			return nlc::ResultDeviceHandle(NlcErrorCode::InvalidOperation, std::format("node {} was added already", deviceId.getDeviceId()));
+	}
+	const uint32_t handle = nextHandle_++;
+	devices_[handle] = Device{ deviceId, false };
+	return nlc::ResultDeviceHandle(nlc::DeviceHandle(handle));
+}
+
+nlc::ResultVoid SimulatedAccessor::removeDevice(const nlc::DeviceHandle deviceHandle) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (devices_.erase(deviceHandle.get()) == 0)
+		return nlc::ResultVoid(NlcErrorCode::ResourceNotFound, std::format("device handle {} unknown", deviceHandle.get()));
+	return nlc::ResultVoid();
+}
+
+nlc::ResultDeviceId SimulatedAccessor::getDeviceId(const nlc::DeviceHandle deviceHandle) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = devices_.find(deviceHandle.get());
+	if (it == devices_.end())
+		return nlc::ResultDeviceId(NlcErrorCode::ResourceNotFound, std::format("device handle {} unknown", deviceHandle.get()));
+	return nlc::ResultDeviceId(it->second.deviceId);
+}
+
+nlc::ResultDeviceIds SimulatedAccessor::getDeviceIds() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::vector<nlc::DeviceId> deviceIds;
+	for (const auto& [handle, device] : devices_)
+		deviceIds.push_back(device.deviceId);
+	return nlc::ResultDeviceIds(deviceIds);
+}
+
+nlc::ResultVoid SimulatedAccessor::connectDevice(const nlc::DeviceHandle deviceHandle) {
+	Transfer();
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = devices_.find(deviceHandle.get());
+	if (it == devices_.end())
+		return nlc::ResultVoid(NlcErrorCode::ResourceNotFound, std::format("device handle {} unknown", deviceHandle.get()));
+	if (!open_)
+		return nlc::ResultVoid(NlcErrorCode::BusUnavailable, "bus hardware is not open");
+	const uint32_t nodeId = it->second.deviceId.getDeviceId();
+	if (nodeId == 0 || nodeId > drives_.size())
+		return nlc::ResultVoid(NlcErrorCode::TimeoutError, std::format("node {} does not answer", nodeId));
+	it->second.connected = true;
+	return nlc::ResultVoid();
+}
+
+nlc::ResultVoid SimulatedAccessor::disconnectDevice(const nlc::DeviceHandle deviceHandle) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = devices_.find(deviceHandle.get());
+	if (it == devices_.end())
+		return nlc::ResultVoid(NlcErrorCode::ResourceNotFound, std::format("device handle {} unknown", deviceHandle.get()));
+	it->second.connected = false;
+	return nlc::ResultVoid();
+}
+
+nlc::ResultVoid SimulatedAccessor::rebootDevice(const nlc::DeviceHandle deviceHandle) {
+	Transfer();
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::string error;
+	SimulatedDrive* drive = FindConnected(deviceHandle, error);
+	if (drive == nullptr)
+		return nlc::ResultVoid(NlcErrorCode::ResourceUnavailable, error);
+	drive->Reboot(SimulatedDrive::Clock::now());
+	return nlc::ResultVoid();
+}
+
+nlc::ResultInt SimulatedAccessor::getDeviceVendorId(const nlc::DeviceHandle deviceHandle) {
+	nlc::ResultInt value = readNumber(deviceHandle, nlc::OdIndex(0x1018, 0x01));
+	//Nanotec
+	return value.hasError() ? nlc::ResultInt(0x026C) : value;
+}
+
+nlc::ResultInt SimulatedAccessor::getDeviceProductCode(const nlc::DeviceHandle) {
+	return nlc::ResultInt(0);
+}
+
+nlc::ResultString SimulatedAccessor::getDeviceName(const nlc::DeviceHandle deviceHandle) {
+	return readString(deviceHandle, nlc::OdIndex(0x1008, 0x00));
+}
+
+nlc::ResultString SimulatedAccessor::getDeviceHardwareVersion(const nlc::DeviceHandle deviceHandle) {
+	return readString(deviceHandle, nlc::OdIndex(0x1009, 0x00));
+}
+
+nlc::ResultString SimulatedAccessor::getDeviceFirmwareBuildId(const nlc::DeviceHandle deviceHandle) {
+	return readString(deviceHandle, nlc::OdIndex(0x100A, 0x00));
+}
+
+nlc::ResultString SimulatedAccessor::getDeviceBootloaderBuildId(const nlc::DeviceHandle) {
+	return nlc::ResultString(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultString SimulatedAccessor::getDeviceSerialNumber(const nlc::DeviceHandle deviceHandle) {
+	Transfer();
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::string error;
+	SimulatedDrive* drive = FindConnected(deviceHandle, error);
+	if (drive == nullptr)
+		return nlc::ResultString(NlcErrorCode::ResourceUnavailable, error);
+	return nlc::ResultString(drive->GetSerialNumber(), false);
+}
+
+nlc::ResultArrayByte SimulatedAccessor::getDeviceUid(const nlc::DeviceHandle) {
+	return nlc::ResultArrayByte(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultInt SimulatedAccessor::getDeviceBootloaderVersion(const nlc::DeviceHandle) {
+	return nlc::ResultInt(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultInt SimulatedAccessor::getDeviceHardwareGroup(const nlc::DeviceHandle) {
+	return nlc::ResultInt(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultConnectionState SimulatedAccessor::getConnectionState(const nlc::DeviceHandle deviceHandle) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = devices_.find(deviceHandle.get());
+	if (it == devices_.end())
+		return nlc::ResultConnectionState(NlcErrorCode::ResourceNotFound, std::format("device handle {} unknown", deviceHandle.get()));
+	return nlc::ResultConnectionState(open_ && it->second.connected ? nlc::DeviceConnectionStateInfo::Connected : nlc::DeviceConnectionStateInfo::Disconnected);
+}
+
+nlc::ResultConnectionState SimulatedAccessor::checkConnectionState(const nlc::DeviceHandle deviceHandle) {
+	//asks the device
+	Transfer();
+	return getConnectionState(deviceHandle);
+}
+
+nlc::ResultString SimulatedAccessor::getDeviceState(const nlc::DeviceHandle) {
+	return nlc::ResultString(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultVoid SimulatedAccessor::setDeviceState(const nlc::DeviceHandle, const std::string&) {
+	return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultDeviceIds SimulatedAccessor::scanDevices(const nlc::BusHardwareId& busHwId, nlc::NlcScanBusCallback* callback) {
+	size_t drives = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (!open_ || !busHwId.equals(GetBusHardwareId()))
+			return nlc::ResultDeviceIds(NlcErrorCode::BusUnavailable, "bus hardware is not open");
+		drives = drives_.size();
+	}
+
+	std::vector<nlc::DeviceId> found;
+	auto report = [callback](nlc::BusScanInfo info, const std::vector<nlc::DeviceId>& devices, int32_t data) {
+		return callback == nullptr || !callback->callback(info, devices, data).hasError();
+	};
+	if (!report(nlc::BusScanInfo::Start, found, 0))
+		return nlc::ResultDeviceIds(NlcErrorCode::OperationAborted, "scan aborted");
+
+	//one transfer per node id like a CANopen scan, nodes without a drive cost the same
+	constexpr uint32_t kNodeIds = 127;
+	for (uint32_t nodeId = 1; nodeId <= kNodeIds; nodeId++) {
+		Transfer();
+		if (nodeId <= drives) {
+			found.emplace_back(GetBusHardwareId(), nodeId, std::format("Simulated C5-E node {}", nodeId));
+			if (!report(nlc::BusScanInfo::FoundDevice, found, static_cast<int32_t>(nodeId)))
+				return nlc::ResultDeviceIds(NlcErrorCode::OperationAborted, "scan aborted");
+		}
+		if (!report(nlc::BusScanInfo::Progress, found, static_cast<int32_t>(nodeId * 100 / kNodeIds)))
+			return nlc::ResultDeviceIds(NlcErrorCode::OperationAborted, "scan aborted");
+	}
+
+	report(nlc::BusScanInfo::Finished, found, 0);
+	return nlc::ResultDeviceIds(found);
+}
+
+nlc::ResultVoid SimulatedAccessor::getProtocolSpecificAccessor(const nlc::BusHardwareId&) {
+	return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+bool SimulatedAccessor::isBusHardwareOpen(const nlc::BusHardwareId& busHardwareId) const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return open_ && busHardwareId.equals(GetBusHardwareId());
+}
+
+nlc::ResultInt SimulatedAccessor::readNumber(const nlc::DeviceHandle deviceHandle, const nlc::OdIndex odIndex) {
+	Transfer();
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::string error;
+	SimulatedDrive* drive = FindConnected(deviceHandle, error);
+	if (drive == nullptr)
+		return nlc::ResultInt(NlcErrorCode::ResourceUnavailable, error);
+	int64_t value = 0;
+	const uint32_t abortCode = drive->Read(odIndex, value, SimulatedDrive::Clock::now());
+	if (abortCode != 0)
+		return nlc::ResultInt(ErrorOfAbort(abortCode), abortCode, AbortMessage("read", odIndex, abortCode));
+	return nlc::ResultInt(value);
+}
+
+nlc::ResultString SimulatedAccessor::readString(const nlc::DeviceHandle deviceHandle, const nlc::OdIndex odIndex) {
+	Transfer();
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::string error;
+	SimulatedDrive* drive = FindConnected(deviceHandle, error);
+	if (drive == nullptr)
+		return nlc::ResultString(NlcErrorCode::ResourceUnavailable, error);
+	std::string value;
+	const uint32_t abortCode = drive->ReadString(odIndex, value);
+	if (abortCode != 0)
+		return nlc::ResultString(ErrorOfAbort(abortCode), abortCode, AbortMessage("read", odIndex, abortCode));
+	return nlc::ResultString(value, false);
+}
+
+nlc::ResultArrayByte SimulatedAccessor::readBytes(const nlc::DeviceHandle, const nlc::OdIndex) {
+	return nlc::ResultArrayByte(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultVoid SimulatedAccessor::writeNumber(const nlc::DeviceHandle deviceHandle, int64_t value, const nlc::OdIndex odIndex, unsigned int) {
+	Transfer();
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::string error;
+	SimulatedDrive* drive = FindConnected(deviceHandle, error);
+	if (drive == nullptr)
+		return nlc::ResultVoid(NlcErrorCode::ResourceUnavailable, error);
+	const uint32_t abortCode = drive->Write(odIndex, value, SimulatedDrive::Clock::now());
+	if (abortCode != 0)
+		return nlc::ResultVoid(ErrorOfAbort(abortCode), abortCode, AbortMessage("write", odIndex, abortCode));
+	return nlc::ResultVoid();
+}
+
+nlc::ResultVoid SimulatedAccessor::writeBytes(const nlc::DeviceHandle, const std::vector<uint8_t>&, const nlc::OdIndex) {
+	return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultArrayInt SimulatedAccessor::readNumberArray(const nlc::DeviceHandle deviceHandle, const uint16_t index) {
+	Transfer();
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::string error;
+	SimulatedDrive* drive = FindConnected(deviceHandle, error);
+	if (drive == nullptr)
+		return nlc::ResultArrayInt(NlcErrorCode::ResourceUnavailable, error);
+	std::vector<int64_t> values;
+	const uint32_t abortCode = drive->ReadArray(index, values, SimulatedDrive::Clock::now());
+	if (abortCode != 0)
+		return nlc::ResultArrayInt(ErrorOfAbort(abortCode), abortCode, AbortMessage("read", nlc::OdIndex(index, 0), abortCode));
+	return nlc::ResultArrayInt(values);
+}
+
+nlc::ResultVoid SimulatedAccessor::uploadFirmwareFromFile(const nlc::DeviceHandle, const std::string&, nlc::NlcDataTransferCallback*) {
+	return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultVoid SimulatedAccessor::uploadFirmware(const nlc::DeviceHandle, const std::vector<uint8_t>&, nlc::NlcDataTransferCallback*) {
+	return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultVoid SimulatedAccessor::uploadBootloaderFromFile(const nlc::DeviceHandle, const std::string&, nlc::NlcDataTransferCallback*) {
+	return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultVoid SimulatedAccessor::uploadBootloader(const nlc::DeviceHandle, const std::vector<uint8_t>&, nlc::NlcDataTransferCallback*) {
+	return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultVoid SimulatedAccessor::uploadBootloaderFirmwareFromFile(const nlc::DeviceHandle, const std::string&, const std::string&, nlc::NlcDataTransferCallback*) {
+	return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultVoid SimulatedAccessor::uploadBootloaderFirmware(const nlc::DeviceHandle, const std::vector<uint8_t>&, const std::vector<uint8_t>&, nlc::NlcDataTransferCallback*) {
+	return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultVoid SimulatedAccessor::uploadNanoJFromFile(const nlc::DeviceHandle, const std::string&, nlc::NlcDataTransferCallback*) {
+	return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultVoid SimulatedAccessor::uploadNanoJ(const nlc::DeviceHandle, const std::vector<uint8_t>&, nlc::NlcDataTransferCallback*) {
+	return nlc::ResultVoid(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::OdLibrary& SimulatedAccessor::getObjectDictionaryLibrary() {
+	return *odLibrary_;
+}
+
+nlc::ResultObjectDictionary SimulatedAccessor::assignObjectDictionary(const nlc::DeviceHandle, const nlc::ObjectDictionary&) {
+	return nlc::ResultObjectDictionary(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultObjectDictionary SimulatedAccessor::autoAssignObjectDictionary(const nlc::DeviceHandle, const std::string&) {
+	return nlc::ResultObjectDictionary(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ResultObjectDictionary SimulatedAccessor::getAssignedObjectDictionary(const nlc::DeviceHandle) {
+	//NanoLibHelper falls back to its built-in metadata
+	return nlc::ResultObjectDictionary(NlcErrorCode::OperationNotSupported, kNotSupported);
+}
+
+nlc::ProfinetDCP& SimulatedAccessor::getProfinetDCP() {
+	return *profinetDCP_;
+}
+
+nlc::SamplerInterface& SimulatedAccessor::getSamplerInterface() {
+	return *sampler_;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "nano_lib_accessor.hpp"
+#include "simulated_drive.h"
+
+/*
+NanoLib in process, with one CANopen bus of simulated drives (node id 1 to drives) instead of hardware.
+Give it to NanoLibHelper in place of getNanoLibAccessor() to run the controller without a device.
+Every object read and write takes the configured latency, spread evenly by the jitter, outside of the lock
+so several threads see a bus that is busy like a real one. The sampler is the software one, reading the tracked
+objects with SDO and starting immediately. Firmware, NanoJ, object dictionaries, Profinet and the other sampler
+triggers are not simulated and fail with OperationNotSupported.
+*/
+class SimulatedAccessor : public nlc::NanoLibAccessor {
+public:
+
+	struct Config {
+		uint32_t drives = 1;
+		//time of one object read or write, +-jitterUs
+		uint32_t latencyUs = 1000;
+		uint32_t jitterUs = 0;
+		SimulatedDrive::Config drive;
+	};
+
+	explicit SimulatedAccessor(const Config& config);
+	~SimulatedAccessor() override;
+
+	//the only bus, CANopen so everything that depends on the protocol behaves like on a CAN adapter
+	static nlc::BusHardwareId GetBusHardwareId();
+
+	void SetLatency(uint32_t latencyUs, uint32_t jitterUs);
+	//error on the drive with nodeId, see SimulatedDrive::InjectFault, false if there is no such drive
+	bool InjectFault(uint32_t nodeId, uint16_t errorCode);
+
+	void setLoggingLevel(nlc::LogLevel level) override;
+	nlc::ResultBusHwIds listAvailableBusHardware() override;
+	nlc::ResultVoid openBusHardwareWithProtocol(const nlc::BusHardwareId& busHwId, const nlc::BusHardwareOptions& busHwOpt) override;
+	nlc::ResultVoid closeBusHardware(const nlc::BusHardwareId& busHwId) override;
+	nlc::ResultVoid setBusState(const nlc::BusHardwareId& busHwId, const std::string& state) override;
+	nlc::ResultDeviceHandle addDevice(const nlc::DeviceId& deviceId) override;
+	nlc::ResultVoid removeDevice(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultDeviceId getDeviceId(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultDeviceIds getDeviceIds() override;
+	nlc::ResultVoid connectDevice(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultVoid disconnectDevice(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultVoid rebootDevice(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultInt getDeviceVendorId(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultInt getDeviceProductCode(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultString getDeviceName(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultString getDeviceHardwareVersion(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultString getDeviceFirmwareBuildId(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultString getDeviceBootloaderBuildId(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultString getDeviceSerialNumber(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultArrayByte getDeviceUid(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultInt getDeviceBootloaderVersion(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultInt getDeviceHardwareGroup(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultConnectionState getConnectionState(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultConnectionState checkConnectionState(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultString getDeviceState(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ResultVoid setDeviceState(const nlc::DeviceHandle deviceHandle, const std::string& state) override;
+	nlc::ResultDeviceIds scanDevices(const nlc::BusHardwareId& busHwId, nlc::NlcScanBusCallback* callback) override;
+	nlc::ResultVoid getProtocolSpecificAccessor(const nlc::BusHardwareId& busHwId) override;
+	bool isBusHardwareOpen(const nlc::BusHardwareId& busHardwareId) const override;
+	nlc::ResultInt readNumber(const nlc::DeviceHandle deviceHandle, const nlc::OdIndex odIndex) override;
+	nlc::ResultString readString(const nlc::DeviceHandle deviceHandle, const nlc::OdIndex odIndex) override;
+	nlc::ResultArrayByte readBytes(const nlc::DeviceHandle deviceHandle, const nlc::OdIndex odIndex) override;
+	nlc::ResultVoid writeNumber(const nlc::DeviceHandle deviceHandle, int64_t value, const nlc::OdIndex odIndex, unsigned int bitLength) override;
+	nlc::ResultVoid writeBytes(const nlc::DeviceHandle deviceHandle, const std::vector<uint8_t>& data, const nlc::OdIndex odIndex) override;
+	nlc::ResultArrayInt readNumberArray(const nlc::DeviceHandle deviceHandle, const uint16_t index) override;
+	nlc::ResultVoid uploadFirmwareFromFile(const nlc::DeviceHandle deviceHandle, const std::string& absoluteFilePath, nlc::NlcDataTransferCallback* callback) override;
+	nlc::ResultVoid uploadFirmware(const nlc::DeviceHandle deviceHandle, const std::vector<uint8_t>& fwData, nlc::NlcDataTransferCallback* callback) override;
+	nlc::ResultVoid uploadBootloaderFromFile(const nlc::DeviceHandle deviceHandle, const std::string& bootloaderAbsoluteFilePath, nlc::NlcDataTransferCallback* callback) override;
+	nlc::ResultVoid uploadBootloader(const nlc::DeviceHandle deviceHandle, const std::vector<uint8_t>& btData, nlc::NlcDataTransferCallback* callback) override;
+	nlc::ResultVoid uploadBootloaderFirmwareFromFile(const nlc::DeviceHandle deviceHandle, const std::string& bootloaderAbsoluteFilePath,
+		const std::string& absoluteFilePath, nlc::NlcDataTransferCallback* callback) override;
+	nlc::ResultVoid uploadBootloaderFirmware(const nlc::DeviceHandle deviceHandle, const std::vector<uint8_t>& btData,
+		const std::vector<uint8_t>& fwData, nlc::NlcDataTransferCallback* callback) override;
+	nlc::ResultVoid uploadNanoJFromFile(const nlc::DeviceHandle deviceHandle, const std::string& absoluteFilePath, nlc::NlcDataTransferCallback* callback) override;
+	nlc::ResultVoid uploadNanoJ(const nlc::DeviceHandle deviceHandle, const std::vector<uint8_t>& vmmData, nlc::NlcDataTransferCallback* callback) override;
+	nlc::OdLibrary& getObjectDictionaryLibrary() override;
+	nlc::ResultObjectDictionary assignObjectDictionary(const nlc::DeviceHandle deviceHandle, const nlc::ObjectDictionary& objectDictionary) override;
+	nlc::ResultObjectDictionary autoAssignObjectDictionary(const nlc::DeviceHandle deviceHandle, const std::string& dictionariesLocationPath) override;
+	nlc::ResultObjectDictionary getAssignedObjectDictionary(const nlc::DeviceHandle deviceHandle) override;
+	nlc::ProfinetDCP& getProfinetDCP() override;
+	nlc::SamplerInterface& getSamplerInterface() override;
+
+private:
+
+	class OdLibrary;
+	class ProfinetDCP;
+	class SamplerInterface;
+
+	struct Device {
+		nlc::DeviceId deviceId;
+		bool connected = false;
+	};
+
+	//the drive behind a connected device, nullptr with the reason in error
+	SimulatedDrive* FindConnected(const nlc::DeviceHandle& deviceHandle, std::string& error);
+	//waits the time of one transfer, without holding the lock
+	void Transfer();
+
+	mutable std::mutex mutex_;
+	//drive with node id n at n - 1
+	std::vector<std::unique_ptr<SimulatedDrive>> drives_;
+	std::map<uint32_t, Device> devices_;
+	uint32_t nextHandle_ = 1;
+	bool open_ = false;
+
+	std::atomic<uint32_t> latencyUs_;
+	std::atomic<uint32_t> jitterUs_;
+	std::mutex randomMutex_;
+	std::minstd_rand random_;
+
+	std::unique_ptr<OdLibrary> odLibrary_;
+	std::unique_ptr<ProfinetDCP> profinetDCP_;
+	std::unique_ptr<SamplerInterface> sampler_;
+};
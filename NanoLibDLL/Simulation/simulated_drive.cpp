@@ -0,0 +1,638 @@
+#include "simulated_drive.h"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+//"save" written to 1010h
+static constexpr int64_t kSaveSignature = 0x65766173;
+//CiA 402 drive, 1000h
+static constexpr int64_t kDeviceType = 0x00040192;
+
+//modes of operation of 6060h the simulation knows
+static bool IsSupportedMode(int64_t mode) {
+	switch (mode) {
+	case -2: //auto setup
+	case 1: //profile position
+	case 2: //velocity
+	case 3: //profile velocity
+	case 4: //profile torque
+	case 6: //homing
+	case 7: //interpolated position
+	case 8: //cyclic synchronous position
+		return true;
+	default:
+		return false;
+	}
+}
+
+SimulatedDrive::SimulatedDrive(uint32_t nodeId, const Config& config) :
+	nodeId_(nodeId),
+	config_(config),
+	time_(Clock::now())
+{
+	//objects only the simulation reads or writes without metadata
+	metadata_.Insert(nlc::OdIndex(0x1000, 0x00), OdMetadata{ nlc::ObjectEntryDataType::Unsigned32, 32, nlc::ObjectSdoAccessAttribute::ReadOnly });
+	for (uint8_t subIndex : { 0x01, 0x02, 0x04 })
+		metadata_.Insert(nlc::OdIndex(0x1018, subIndex), OdMetadata{ nlc::ObjectEntryDataType::Unsigned32, 32, nlc::ObjectSdoAccessAttribute::ReadOnly });
+
+	SetDefaults();
+	saved_ = objects_;
+	mode_ = static_cast<int8_t>(Get(0x6060, 0x00));
+}
+
+int64_t SimulatedDrive::Get(uint16_t index, uint8_t subIndex) const {
+	auto it = objects_.find(Key(index, subIndex));
+	return it != objects_.end() ? it->second : 0;
+}
+
+void SimulatedDrive::Set(uint16_t index, uint8_t subIndex, int64_t value) {
+	objects_[Key(index, subIndex)] = value;
+}
+
+void SimulatedDrive::SetDefaults() {
+	objects_.clear();
+	Set(0x1000, 0x00, kDeviceType);
+	//identity: Nanotec, the serial number is the node id
+	Set(0x1018, 0x01, 0x026C);
+	Set(0x1018, 0x04, nodeId_);
+	//motor, closed loop stepper
+	Set(0x2030, 0x00, 50);
+	Set(0x2031, 0x00, 1800);
+	Set(0x2037, 0x00, 300);
+	Set(0x203B, 0x01, 1800);
+	Set(0x203B, 0x02, 1000);
+	Set(0x3202, 0x00, 0x01);
+	//halt and quick stop ramps, quick stop ends in switch on disabled
+	Set(0x605A, 0x00, 2);
+	Set(0x605D, 0x00, 1);
+	Set(0x6060, 0x00, 1);
+	//velocity mode ramps: delta speed per delta time in s
+	Set(0x6048, 0x01, 500);
+	Set(0x6048, 0x02, 1);
+	Set(0x6049, 0x01, 500);
+	Set(0x6049, 0x02, 1);
+	Set(0x6080, 0x00, 3000);
+	Set(0x6081, 0x00, 200);
+	Set(0x6083, 0x00, 500);
+	Set(0x6084, 0x00, 500);
+	Set(0x6072, 0x00, 1000);
+	Set(0x6087, 0x00, 1000);
+	//without a buffer interpolated position follows each record at once
+	Set(0x60C4, 0x01, std::max<uint32_t>(config_.interpolationBuffer, 1));
+	Set(0x6091, 0x01, 1);
+	Set(0x6091, 0x02, 1);
+	Set(0x6092, 0x01, 2000);
+	Set(0x6092, 0x02, 1);
+	Set(0x6098, 0x00, 35);
+	Set(0x6099, 0x01, 50);
+	Set(0x6099, 0x02, 10);
+	Set(0x609A, 0x00, 500);
+	//1 ms
+	Set(0x60C2, 0x01, 1);
+	Set(0x60C2, 0x02, -3);
+}
+
+void SimulatedDrive::Reboot(Clock::time_point now) {
+	objects_ = saved_;
+	state_ = State::SwitchOnDisabled;
+	controlWord_ = 0;
+	mode_ = static_cast<int8_t>(Get(0x6060, 0x00));
+	StopMotion();
+	homingAttained_ = false;
+	homingError_ = false;
+	saveDone_.fill(Clock::time_point());
+	time_ = now;
+}
+
+std::string SimulatedDrive::GetSerialNumber() const {
+	return std::format("SIM{:06}", nodeId_);
+}
+
+uint32_t SimulatedDrive::Read(const nlc::OdIndex& odIndex, int64_t& value, Clock::time_point now) {
+	Advance(now);
+	const uint16_t index = odIndex.getIndex();
+	const uint8_t subIndex = odIndex.getSubIndex();
+
+	if (index == 0x1003) {
+		if (subIndex > kErrorStackSize)
+			return kAbortNoSubIndex;
+		value = subIndex == 0 ? errors_.size() : (subIndex <= errors_.size() ? errors_[subIndex - 1] : 0);
+		return 0;
+	}
+
+	const OdMetadata* metadata = metadata_.Find(odIndex);
+	if (metadata == nullptr)
+		return kAbortNoObject;
+	if (!metadata->IsReadable())
+		return kAbortWriteOnly;
+
+	switch (Key(index, subIndex)) {
+	case Key(0x1001, 0x00):
+		//generic error
+		value = state_ == State::Fault ? 1 : 0;
+		break;
+	case Key(0x6041, 0x00):
+		value = GetStatusWord(now);
+		break;
+	case Key(0x6061, 0x00):
+		value = mode_;
+		break;
+	case Key(0x6062, 0x00):
+	case Key(0x6064, 0x00):
+		value = std::llround(position_);
+		break;
+	case Key(0x6043, 0x00):
+	case Key(0x6044, 0x00):
+	case Key(0x606B, 0x00):
+	case Key(0x606C, 0x00):
+		value = std::llround(velocity_);
+		break;
+	case Key(0x6077, 0x00):
+	case Key(0x6078, 0x00):
+		value = std::llround(torque_);
+		break;
+	case Key(0x60C4, 0x04):
+		value = static_cast<int64_t>(records_.size());
+		break;
+	case Key(0x60F4, 0x00):
+		if (mode_ == 7 || mode_ == 8)
+			value = (mode_ == 8 ? Get(0x607A, 0x00) : Get(0x60C1, 0x01)) - std::llround(position_);
+		else
+			value = 0;
+		break;
+	default:
+		if (index == 0x1010 && subIndex < saveDone_.size()) {
+			//0 while the save is running
+			value = now < saveDone_[subIndex] ? 0 : 1;
+			break;
+		}
+		value = Get(index, subIndex);
+		break;
+	}
+
+	//raw like on the bus
+	if (metadata->bitLength > 0 && metadata->bitLength < 64)
+		value &= (int64_t(1) << metadata->bitLength) - 1;
+	return 0;
+}
+
+uint32_t SimulatedDrive::Write(const nlc::OdIndex& odIndex, int64_t value, Clock::time_point now) {
+	Advance(now);
+	const uint16_t index = odIndex.getIndex();
+	const uint8_t subIndex = odIndex.getSubIndex();
+
+	if (index == 0x1003) {
+		if (subIndex != 0)
+			return kAbortReadOnly;
+		//only 0 is accepted, it clears the stack
+		if (value != 0)
+			return kAbortValueRange;
+		errors_.clear();
+		return 0;
+	}
+
+	const OdMetadata* metadata = metadata_.Find(odIndex);
+	if (metadata == nullptr)
+		return kAbortNoObject;
+	if (!metadata->IsWritable())
+		return kAbortReadOnly;
+	if (metadata->bitLength > 0 && metadata->bitLength < 64)
+		value = metadata->SignExtend(value & ((int64_t(1) << metadata->bitLength) - 1));
+
+	switch (Key(index, subIndex)) {
+	case Key(0x6040, 0x00):
+		Set(index, subIndex, value);
+		OnControlWord(static_cast<uint16_t>(value), now);
+		break;
+	case Key(0x6060, 0x00):
+		if (!IsSupportedMode(value))
+			return kAbortValueRange;
+		Set(index, subIndex, value);
+		if (value != mode_) {
+			StopMotion();
+			mode_ = static_cast<int8_t>(value);
+		}
+		break;
+	case Key(0x60C1, 0x01):
+		if (config_.interpolationBuffer == 0 || mode_ != 7 || !(controlWord_ & (1U << 4))) {
+			Set(index, subIndex, value);
+			break;
+		}
+		//a record written to a full buffer is lost
+		if (records_.size() >= config_.interpolationBuffer)
+			return kAbortValueRange;
+		records_.push_back(value);
+		break;
+	default:
+		if (index == 0x1010 && subIndex < saveDone_.size()) {
+			if (value != kSaveSignature)
+				return kAbortNotStored;
+			saved_ = objects_;
+			saveDone_[subIndex] = now + std::chrono::milliseconds(config_.saveMs);
+			break;
+		}
+		Set(index, subIndex, value);
+		break;
+	}
+	return 0;
+}
+
+uint32_t SimulatedDrive::ReadString(const nlc::OdIndex& odIndex, std::string& value) const {
+	switch (Key(odIndex.getIndex(), odIndex.getSubIndex())) {
+	case Key(0x1008, 0x00):
+		value = "Simulated C5-E";
+		return 0;
+	case Key(0x1009, 0x00):
+		value = "SIM";
+		return 0;
+	case Key(0x100A, 0x00):
+		value = "FIR-v0000B000000";
+		return 0;
+	default:
+		return kAbortNoObject;
+	}
+}
+
+uint32_t SimulatedDrive::ReadArray(uint16_t index, std::vector<int64_t>& values, Clock::time_point now) {
+	Advance(now);
+	if (index != 0x1003)
+		return kAbortUnsupportedAccess;
+	values.assign(1, static_cast<int64_t>(errors_.size()));
+	for (uint32_t error : errors_)
+		values.push_back(error);
+	return 0;
+}
+
+void SimulatedDrive::InjectFault(uint16_t errorCode, Clock::time_point now) {
+	Advance(now);
+	errors_.push_front((static_cast<uint32_t>(++errorNumber_) << 24) | errorCode);
+	if (errors_.size() > kErrorStackSize)
+		errors_.pop_back();
+	state_ = State::Fault;
+	StopMotion();
+	velocity_ = 0.0;
+	torque_ = 0.0;
+}
+
+void SimulatedDrive::Advance(Clock::time_point now) {
+	constexpr Clock::duration kStep = std::chrono::milliseconds(1);
+	while (time_ + kStep <= now) {
+		if (IsIdle()) {
+			time_ = now;
+			break;
+		}
+		Step(std::chrono::duration<double>(kStep).count());
+		time_ += kStep;
+	}
+}
+
+bool SimulatedDrive::IsIdle() const {
+	if (state_ == State::QuickStopActive)
+		return velocity_ == 0.0 && Get(0x605A, 0x00) > 3;
+	if (state_ != State::OperationEnabled)
+		return true;
+	if (velocity_ != 0.0 || moving_ || homing_)
+		return false;
+	switch (mode_) {
+	case 2:
+		return controlWord_ & (1U << 8) || Get(0x6042, 0x00) == 0;
+	case 3:
+		return controlWord_ & (1U << 8) || Get(0x60FF, 0x00) == 0;
+	case 4:
+		return torque_ == TargetTorque();
+	case 7:
+		return controlWord_ & (1U << 8) || !(controlWord_ & (1U << 4)) || (std::llround(position_) == Get(0x60C1, 0x01) && records_.empty());
+	case 8:
+		return controlWord_ & (1U << 8) || std::llround(position_) == Get(0x607A, 0x00);
+	default:
+		return true;
+	}
+}
+
+double SimulatedDrive::TargetTorque() const {
+	if (controlWord_ & (1U << 8))
+		return 0.0;
+	const double limit = static_cast<double>(Get(0x6072, 0x00));
+	return std::clamp(static_cast<double>(Get(0x6071, 0x00)), -limit, limit);
+}
+
+void SimulatedDrive::Ramp(double target, double acc, double dec, double dt) {
+	//speeding up means moving away from 0 in the direction of travel
+	const bool speedingUp = std::abs(target) > std::abs(velocity_) && (velocity_ == 0.0 || (target > 0) == (velocity_ > 0));
+	const double step = std::max(speedingUp ? acc : dec, 1.0) * dt;
+	if (std::abs(target - velocity_) <= step)
+		velocity_ = target;
+	else
+		velocity_ += target > velocity_ ? step : -step;
+}
+
+bool SimulatedDrive::MoveTo(double target, double speed, double acc, double dec, double dt) {
+	const double distance = target - position_;
+	dec = std::max(dec, 1.0);
+	if (std::abs(distance) < 0.5 && std::abs(velocity_) <= dec * dt) {
+		position_ = target;
+		velocity_ = 0.0;
+		return true;
+	}
+	//fastest speed that still stops at the target
+	const double reachable = std::min(speed, std::sqrt(2.0 * dec * std::abs(distance)));
+	Ramp(distance > 0 ? reachable : -reachable, acc, dec, dt);
+	//the last step would pass the target, stop on it instead
+	if (std::abs(velocity_ * dt) >= std::abs(distance) && (velocity_ > 0) == (distance > 0)) {
+		position_ = target;
+		velocity_ = 0.0;
+		return true;
+	}
+	position_ += velocity_ * dt;
+	return false;
+}
+
+void SimulatedDrive::Step(double dt) {
+	const double dec = static_cast<double>(Get(0x6084, 0x00));
+
+	if (state_ == State::QuickStopActive) {
+		Ramp(0.0, dec, dec, dt);
+		position_ += velocity_ * dt;
+		//605Ah 1-3 end in switch on disabled once stopped, 5-7 stay in quick stop active
+		const int64_t option = Get(0x605A, 0x00);
+		if (velocity_ == 0.0 && option >= 0 && option <= 3)
+			state_ = State::SwitchOnDisabled;
+		return;
+	}
+
+	const bool halt = controlWord_ & (1U << 8);
+	switch (mode_) {
+	case 1: {
+		const double acc = static_cast<double>(Get(0x6083, 0x00));
+		if (halt || !moving_) {
+			Ramp(0.0, acc, dec, dt);
+			position_ += velocity_ * dt;
+			break;
+		}
+		//with change on set point (bit 9) the move runs into a buffered set point further in the same direction without stopping
+		const bool blend = (controlWord_ & (1U << 9)) && pending_.has_value() && (pending_->target - target_) * (target_ - position_) >= 0.0;
+		const double before = target_ - position_;
+		const bool arrived = MoveTo(blend ? pending_->target : target_, speed_, acc, dec, dt);
+		if (!(blend ? arrived || (target_ - position_) * before <= 0.0 : arrived))
+			break;
+		if (pending_.has_value()) {
+			//the buffered set point becomes the active one, the buffer is free again
+			target_ = pending_->target;
+			speed_ = pending_->speed;
+			pending_.reset();
+			moving_ = !(blend && arrived);
+		}
+		else {
+			moving_ = false;
+		}
+		break;
+	}
+	case 2: {
+		//delta speed per delta time
+		auto rate = [this](uint16_t index) {
+			const int64_t time = std::max<int64_t>(Get(index, 0x02), 1);
+			return static_cast<double>(Get(index, 0x01)) / static_cast<double>(time);
+		};
+		Ramp(halt ? 0.0 : static_cast<double>(Get(0x6042, 0x00)), rate(0x6048), rate(0x6049), dt);
+		position_ += velocity_ * dt;
+		break;
+	}
+	case 3:
+		Ramp(halt ? 0.0 : static_cast<double>(Get(0x60FF, 0x00)), static_cast<double>(Get(0x6083, 0x00)), dec, dt);
+		position_ += velocity_ * dt;
+		break;
+	case 4: {
+		//no load, the torque follows the target with the slope and nothing moves
+		const double target = TargetTorque();
+		const double step = std::max(static_cast<double>(Get(0x6087, 0x00)), 1.0) * dt;
+		torque_ = std::abs(target - torque_) <= step ? target : torque_ + (target > torque_ ? step : -step);
+		break;
+	}
+	case 6: {
+		const double acc = static_cast<double>(Get(0x609A, 0x00));
+		if (!homing_) {
+			Ramp(0.0, acc, acc, dt);
+			position_ += velocity_ * dt;
+		}
+		else if (MoveTo(0.0, static_cast<double>(Get(0x6099, 0x01)), acc, acc, dt)) {
+			//the home position is 0
+			homing_ = false;
+			homingAttained_ = true;
+		}
+		break;
+	}
+	case 7:
+	case 8: {
+		//no ramp, the position follows each set point within one interpolation period (60C2h)
+		//interpolated position takes 60C1h:01 while enabled by bit 4, with a buffer the next record once per period
+		const bool follow = mode_ == 8 || (controlWord_ & (1U << 4));
+		const double period = std::max(static_cast<double>(Get(0x60C2, 0x01)) * std::pow(10.0, static_cast<double>(Get(0x60C2, 0x02))), dt);
+		if (mode_ == 7 && follow && !halt && !records_.empty()) {
+			recordTime_ += dt;
+			if (recordTime_ >= period - dt / 2) {
+				Set(0x60C1, 0x01, records_.front());
+				records_.pop_front();
+				recordTime_ = 0.0;
+			}
+		}
+		const double target = static_cast<double>(mode_ == 8 ? Get(0x607A, 0x00) : Get(0x60C1, 0x01));
+		const double distance = target - position_;
+		velocity_ = halt || !follow ? 0.0 : distance / period;
+		if (follow && !halt && (std::abs(distance) < 0.5 || std::abs(velocity_ * dt) >= std::abs(distance))) {
+			position_ += distance;
+			velocity_ = 0.0;
+		}
+		else {
+			position_ += velocity_ * dt;
+		}
+		break;
+	}
+	default:
+		velocity_ = 0.0;
+		break;
+	}
+}
+
+void SimulatedDrive::OnControlWord(uint16_t controlWord, Clock::time_point now) {
+	const uint16_t previous = controlWord_;
+	const bool wasEnabled = state_ == State::OperationEnabled;
+	controlWord_ = controlWord;
+
+	if (state_ == State::Fault) {
+		//fault reset on the rising edge of bit 7
+		if ((controlWord & 0x80) && !(previous & 0x80))
+			state_ = State::SwitchOnDisabled;
+		return;
+	}
+
+	//commands of CiA 402, transitions take effect at once
+	State next = state_;
+	if ((controlWord & 0x02) == 0) {
+		//disable voltage
+		next = State::SwitchOnDisabled;
+	}
+	else if ((controlWord & 0x06) == 0x02) {
+		//quick stop
+		next = state_ == State::OperationEnabled || state_ == State::QuickStopActive ? State::QuickStopActive : State::SwitchOnDisabled;
+	}
+	else if ((controlWord & 0x87) == 0x06) {
+		//shutdown
+		if (state_ != State::QuickStopActive)
+			next = State::ReadyToSwitchOn;
+	}
+	else if ((controlWord & 0x8F) == 0x07) {
+		//switch on, disable operation
+		if (state_ == State::ReadyToSwitchOn || state_ == State::OperationEnabled)
+			next = State::SwitchedOn;
+	}
+	else if ((controlWord & 0x8F) == 0x0F) {
+		//enable operation, from ready to switch on as 3 and 4 at once
+		if (state_ != State::SwitchOnDisabled)
+			next = State::OperationEnabled;
+	}
+
+	if (next != State::OperationEnabled && next != State::QuickStopActive) {
+		//power stage off
+		StopMotion();
+		velocity_ = 0.0;
+		torque_ = 0.0;
+	}
+	state_ = next;
+
+	//bit 4 already set when operation gets enabled counts as a rising edge
+	if (state_ == State::OperationEnabled) {
+		const bool bit4 = controlWord & 0x10;
+		const bool previousBit4 = wasEnabled && (previous & 0x10);
+		if (bit4 != previousBit4)
+			OnModeBit4(bit4, now);
+	}
+}
+
+void SimulatedDrive::OnModeBit4(bool rising, Clock::time_point now) {
+	switch (mode_) {
+	case -2:
+		if (rising)
+			autoSetupDone_ = now + std::chrono::milliseconds(config_.autoSetupMs);
+		else
+			autoSetupDone_.reset();
+		break;
+	case 1:
+		if (rising) {
+			//new set point, relative to the last target with bit 6
+			const SetPoint setPoint{ static_cast<double>(Get(0x607A, 0x00)), static_cast<double>(Get(0x6081, 0x00)) };
+			if (controlWord_ & (1U << 5) || !moving_) {
+				//change set immediately, also taken at once while standing
+				target_ = controlWord_ & (1U << 6) ? target_ + setPoint.target : setPoint.target;
+				speed_ = setPoint.speed;
+				pending_.reset();
+				moving_ = true;
+			}
+			else if (!pending_.has_value()) {
+				//one buffered set point, a new one while the buffer is full is ignored
+				pending_ = SetPoint{ controlWord_ & (1U << 6) ? target_ + setPoint.target : setPoint.target, setPoint.speed };
+			}
+		}
+		break;
+	case 6:
+		if (rising) {
+			homingAttained_ = false;
+			homingError_ = Get(0x6099, 0x01) == 0;
+			homing_ = !homingError_;
+		}
+		else {
+			//interrupted
+			homing_ = false;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void SimulatedDrive::StopMotion() {
+	moving_ = false;
+	target_ = position_;
+	pending_.reset();
+	records_.clear();
+	recordTime_ = 0.0;
+	homing_ = false;
+	autoSetupDone_.reset();
+}
+
+uint16_t SimulatedDrive::GetStatusWord(Clock::time_point now) const {
+	//remote (bit 9) is always set
+	uint16_t statusWord = 1U << 9;
+	switch (state_) {
+	case State::SwitchOnDisabled:
+		statusWord |= 0x0040;
+		break;
+	case State::ReadyToSwitchOn:
+		statusWord |= 0x0031;
+		break;
+	case State::SwitchedOn:
+		statusWord |= 0x0033;
+		break;
+	case State::OperationEnabled:
+		statusWord |= 0x0037;
+		break;
+	case State::QuickStopActive:
+		statusWord |= 0x0017;
+		break;
+	case State::Fault:
+		statusWord |= 0x0008;
+		break;
+	}
+	if (state_ != State::OperationEnabled)
+		return statusWord;
+
+	const bool halt = controlWord_ & (1U << 8);
+	bool targetReached = false;
+	switch (mode_) {
+	case -2:
+		//auto setup done
+		if (autoSetupDone_.has_value() && now >= *autoSetupDone_)
+			statusWord |= 1U << 12;
+		break;
+	case 1:
+		targetReached = !moving_ && velocity_ == 0.0;
+		//set point acknowledge follows bit 4 and stays set while a set point is buffered
+		if ((controlWord_ & 0x10) || pending_.has_value())
+			statusWord |= 1U << 12;
+		break;
+	case 2:
+		targetReached = velocity_ == (halt ? 0.0 : static_cast<double>(Get(0x6042, 0x00)));
+		break;
+	case 3:
+		targetReached = velocity_ == (halt ? 0.0 : static_cast<double>(Get(0x60FF, 0x00)));
+		//speed is 0
+		if (velocity_ == 0.0)
+			statusWord |= 1U << 12;
+		break;
+	case 4:
+		targetReached = torque_ == TargetTorque();
+		break;
+	case 6:
+		targetReached = !homing_;
+		if (homingAttained_)
+			statusWord |= 1U << 12;
+		if (homingError_)
+			statusWord |= 1U << 13;
+		break;
+	case 7:
+		//ip mode active
+		if (!halt && (controlWord_ & (1U << 4)))
+			statusWord |= 1U << 12;
+		break;
+	case 8:
+		//target position ignored while halted, otherwise followed
+		if (!halt)
+			statusWord |= 1U << 12;
+		break;
+	default:
+		break;
+	}
+	if (targetReached)
+		statusWord |= 1U << 10;
+	return statusWord;
+}
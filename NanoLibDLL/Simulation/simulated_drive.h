@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "od_index.hpp"
+#include "od_metadata.h"
+
+/*
+Object dictionary and behavior of one CiA 402 drive, close enough to a C5-E for the controller and the motor classes.
+Models the power state machine (6040h/6041h), the modes of operation (6060h/6061h), trapezoidal moves of
+profile position with one buffered set point, ramps of velocity and profile velocity, the torque slope of profile torque, homing as a move
+to the home position, interpolated position with an optional buffer of records (60C4h), cyclic synchronous position
+following its set point, the auto setup, saving with 1010h and the error stack 1003h.
+Motion is integrated in 1 ms steps up to the time of each access, so it runs in real time between transfers.
+Not thread-safe, SimulatedAccessor serializes all access.
+*/
+class SimulatedDrive {
+public:
+
+	using Clock = std::chrono::steady_clock;
+
+	struct Config {
+		//1010h:xx reads 0 for this long after a save was started
+		uint32_t saveMs = 300;
+		//statusword bit 12 is set this long after the auto setup was started
+		uint32_t autoSetupMs = 2000;
+		//records interpolated position buffers (60C4h:01), one is taken per interpolation period; 0 follows each record at once
+		uint32_t interpolationBuffer = 0;
+	};
+
+	SimulatedDrive(uint32_t nodeId, const Config& config);
+
+	uint32_t GetNodeId() const { return nodeId_; }
+
+	//SDO transfers at time now, return the SDO abort code, 0 on success
+	//values are raw like on the bus, the sign of signed objects is not extended
+	uint32_t Read(const nlc::OdIndex& odIndex, int64_t& value, Clock::time_point now);
+	uint32_t Write(const nlc::OdIndex& odIndex, int64_t value, Clock::time_point now);
+	uint32_t ReadString(const nlc::OdIndex& odIndex, std::string& value) const;
+	//all sub-indices of index starting with 0, only for the error stack 1003h
+	uint32_t ReadArray(uint16_t index, std::vector<int64_t>& values, Clock::time_point now);
+
+	//adds errorCode (low 16 bit of 1003h) to the error stack and switches to Fault
+	void InjectFault(uint16_t errorCode, Clock::time_point now);
+	//power cycle, objects are back to their last saved values
+	void Reboot(Clock::time_point now);
+
+	std::string GetSerialNumber() const;
+
+	//SDO abort codes
+	static constexpr uint32_t kAbortUnsupportedAccess = 0x06010000;
+	static constexpr uint32_t kAbortWriteOnly = 0x06010001;
+	static constexpr uint32_t kAbortReadOnly = 0x06010002;
+	static constexpr uint32_t kAbortNoObject = 0x06020000;
+	static constexpr uint32_t kAbortNoSubIndex = 0x06090011;
+	static constexpr uint32_t kAbortValueRange = 0x06090030;
+	static constexpr uint32_t kAbortNotStored = 0x08000020;
+	static constexpr uint32_t kAbortDeviceState = 0x08000022;
+
+private:
+
+	enum class State : uint8_t {
+		SwitchOnDisabled,
+		ReadyToSwitchOn,
+		SwitchedOn,
+		OperationEnabled,
+		QuickStopActive,
+		Fault
+	};
+
+	static constexpr size_t kErrorStackSize = 8;
+
+	static constexpr uint32_t Key(uint16_t index, uint8_t subIndex) {
+		return (static_cast<uint32_t>(index) << 8) | subIndex;
+	}
+
+	int64_t Get(uint16_t index, uint8_t subIndex) const;
+	void Set(uint16_t index, uint8_t subIndex, int64_t value);
+	void SetDefaults();
+
+	//integrates the motion up to now
+	void Advance(Clock::time_point now);
+	void Step(double dt);
+	//moves velocity_ towards target with acc when speeding up and dec when slowing down
+	void Ramp(double target, double acc, double dec, double dt);
+	//profile move to target, true once it is there
+	bool MoveTo(double target, double speed, double acc, double dec, double dt);
+	bool IsIdle() const;
+	//6071h limited by 6072h, 0 while halted
+	double TargetTorque() const;
+
+	void OnControlWord(uint16_t controlWord, Clock::time_point now);
+	void OnModeBit4(bool rising, Clock::time_point now);
+	void StopMotion();
+	uint16_t GetStatusWord(Clock::time_point now) const;
+
+	uint32_t nodeId_;
+	Config config_;
+	OdMetadataCache metadata_;
+
+	//raw values with the sign extended
+	std::unordered_map<uint32_t, int64_t> objects_;
+	//values restored on Reboot
+	std::unordered_map<uint32_t, int64_t> saved_;
+
+	State state_ = State::SwitchOnDisabled;
+	int8_t mode_ = 0;
+	uint16_t controlWord_ = 0;
+	Clock::time_point time_;
+
+	double position_ = 0.0;
+	//units per second
+	double velocity_ = 0.0;
+	double torque_ = 0.0;
+
+	//profile position set point being moved to and its profile velocity
+	bool moving_ = false;
+	double target_ = 0.0;
+	double speed_ = 0.0;
+	//set point buffered behind it while bit 5 (change set immediately) is clear
+	struct SetPoint {
+		double target;
+		double speed;
+	};
+	std::optional<SetPoint> pending_;
+	//records of interpolated position not taken yet and the time since the last one was taken
+	std::deque<int64_t> records_;
+	double recordTime_ = 0.0;
+	bool homing_ = false;
+	bool homingAttained_ = false;
+	bool homingError_ = false;
+	std::optional<Clock::time_point> autoSetupDone_;
+
+	//end of the save started on each sub-index of 1010h
+	std::array<Clock::time_point, 14> saveDone_{};
+
+	//newest first, number in bits 24-31 and the error code in bits 0-15
+	std::deque<uint32_t> errors_;
+	uint8_t errorNumber_ = 0;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "controller.h"
+#include "simulated_accessor.h"
+
+/*
+Tests of the controller against the simulated drives, one test per process by name (see CMakeLists.txt),
+the controller is a singleton and keeps its state for the whole process.
+CHECK prints the condition that failed and ends the test with failure.
+*/
+
+using TestFunction = std::function<bool()>;
+
+std::map<std::string, TestFunction>& Tests();
+
+struct RegisterTest {
+	RegisterTest(const char* name, TestFunction test) { Tests().emplace(name, std::move(test)); }
+};
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			return false; \
+		} \
+	} while (0)
+
+//controller on a simulated bus with the port open, Shutdown and back to NanoLib when it goes
+class SimulatedBus {
+public:
+	explicit SimulatedBus(const SimulatedAccessor::Config& config);
+	~SimulatedBus();
+
+	SimulatedAccessor& Accessor() { return *accessor_; }
+	//both print the exceptions recorded when they fail
+	bool Open();
+	//opens the port and connects the first scanned device as the selected axis
+	bool Connect();
+
+private:
+	std::unique_ptr<SimulatedAccessor> accessor_;
+	std::string sessionPath_;
+};
+
+//the calls of the exports, on the bus thread
+template <class F>
+int OnBus(F&& command) {
+	Controller* c = Controller::GetInstance();
+	return c->Execute(std::forward<F>(command));
+}
@@ -0,0 +1,79 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#include "simulation_test.h"
+
+std::map<std::string, TestFunction>& Tests() {
+	static std::map<std::string, TestFunction> tests;
+	return tests;
+}
+
+SimulatedBus::SimulatedBus(const SimulatedAccessor::Config& config) :
+	accessor_(std::make_unique<SimulatedAccessor>(config)),
+	sessionPath_((std::filesystem::temp_directory_path() / "nanolibdll_simulation_session.json").string())
+{
+	Controller* c = Controller::GetInstance();
+	OnBus([&] { return c->UseAccessor(accessor_.get()); });
+	//the session saved on connect must not replace the one of a real device
+	OnBus([&] { return c->SetSessionProfilePath(sessionPath_); });
+}
+
+SimulatedBus::~SimulatedBus() {
+	Controller* c = Controller::GetInstance();
+	c->Shutdown();
+	OnBus([&] { return c->UseAccessor(nullptr); });
+	c->Shutdown();
+	std::error_code error;
+	std::filesystem::remove(sessionPath_, error);
+}
+
+static void PrintExceptions() {
+	Controller* c = Controller::GetInstance();
+	//the journal is thread-safe, going through the bus thread would start it again after Shutdown
+	std::vector<std::string> exceptions;
+	c->GetExceptions(exceptions);
+	for (const std::string& exception : exceptions)
+		std::fprintf(stderr, "exception: %s\n", exception.c_str());
+}
+
+bool SimulatedBus::Open() {
+	Controller* c = Controller::GetInstance();
+	if (OnBus([&] { return c->OpenPort(0); }) != EXIT_SUCCESS) {
+		PrintExceptions();
+		return false;
+	}
+	return true;
+}
+
+bool SimulatedBus::Connect() {
+	Controller* c = Controller::GetInstance();
+	if (!Open())
+		return false;
+	if (OnBus([&] { return c->ConnectDevice(0); }) != EXIT_SUCCESS) {
+		PrintExceptions();
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char** argv) {
+	if (argc != 2) {
+		std::fprintf(stderr, "usage: %s <test>\n", argv[0]);
+		for (const auto& [name, test] : Tests())
+			std::fprintf(stderr, "  %s\n", name.c_str());
+		return EXIT_FAILURE;
+	}
+	auto it = Tests().find(argv[1]);
+	if (it == Tests().end()) {
+		std::fprintf(stderr, "unknown test %s\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	const bool passed = it->second();
+	if (!passed)
+		PrintExceptions();
+	//a failed CHECK may leave the bus thread running
+	Controller::GetInstance()->Shutdown();
+	std::printf("%s %s\n", argv[1], passed ? "passed" : "failed");
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}